@@ -1,4 +1,5 @@
 #pragma once
+#include "weapon_type.h"
 
 #pragma pack(push, 1)
 namespace sead {
@@ -406,15 +407,6 @@ struct AttackSensorOtherArg {
 };
 static_assert(sizeof(AttackSensorOtherArg) == 0x24, "AttackSensorOtherArg size mismatch");
 
-enum WeaponType : uint32_t {
-    SmallSword = 0x0,
-    LargeSword = 0x1,
-    Spear = 0x2,
-    Bow = 0x3,
-    Shield = 0x4,
-    UnknownWeapon = 0x5,
-};
-
 enum class EquipType {
     None = 0,
     Melee = 1,
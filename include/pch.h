@@ -6,6 +6,7 @@
 #include <functional>
 #include <type_traits>
 #include <ranges>
+#include <span>
 #include <set>
 #include <unordered_set>
 #include <queue>
@@ -535,6 +536,8 @@ struct ModSettings {
     std::atomic_uint32_t performanceOverlay = 0;
     std::atomic_uint32_t performanceOverlayFrequency = 90;
     std::atomic_bool tutorialPromptShown = false;
+    std::atomic_bool shareShadowCascades = true;
+    std::atomic_uint32_t shadowUpdateInterval = 1;
 
     // Input settings
     std::atomic<float> axisThreshold = kDefaultAxisThreshold;
@@ -565,6 +568,9 @@ struct ModSettings {
     
     bool ShowDebugOverlay() const { return enableDebugOverlay; }
     AngularVelocityFixerMode AngularVelocityFixer_GetMode() const { return buggyAngularVelocity; }
+    bool ShareShadowCascadesBetweenEyes() const { return shareShadowCascades; }
+    // 1 updates the shadow cascades every frame, higher values reuse them for more frames to save GPU time
+    uint32_t GetShadowUpdateInterval() const { return std::clamp(shadowUpdateInterval.load(), 1u, 4u); }
 
     // By default BotW's camera uses 0.1f for near plane and 25000.0f for far plane, except maybe some indoor areas? But for simplicity, we'll use the default values everywhere.
     float GetZNear() const { return 0.1f; }
@@ -578,6 +584,8 @@ struct ModSettings {
         std::format_to(std::back_inserter(buffer), " - Player Height: {} meters\n", GetPlayerHeightOffset());
         std::format_to(std::back_inserter(buffer), " - Crop Flat to 16:9: {}\n", ShouldFlatPreviewBeCroppedTo16x9() ? "Yes" : "No");
         std::format_to(std::back_inserter(buffer), " - Debug Overlay: {}\n", ShowDebugOverlay() ? "Enabled" : "Disabled");
+        std::format_to(std::back_inserter(buffer), " - Shared Shadow Cascades: {}\n", ShareShadowCascadesBetweenEyes() ? "Yes" : "No");
+        std::format_to(std::back_inserter(buffer), " - Shadow Update Interval: Every {} frame(s)\n", GetShadowUpdateInterval());
         std::format_to(std::back_inserter(buffer), " - Cutscene Camera Mode: {}\n", GetCutsceneCameraMode() == EventMode::ALWAYS_FIRST_PERSON ? "Always First Person" : (GetCutsceneCameraMode() == EventMode::ALWAYS_THIRD_PERSON ? "Always Third Person" : "Follow Default Event Settings"));
         std::format_to(std::back_inserter(buffer), " - Show Black Bars for Third-Person Cutscenes: {}\n", UseBlackBarsForCutscenes() ? "Yes" : "No");
         std::format_to(std::back_inserter(buffer), " - Performance Overlay: {}\n", performanceOverlay == 0 ? "Disabled" : (performanceOverlay == 1 ? "2D Only" : "Enabled"));
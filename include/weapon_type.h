@@ -0,0 +1,11 @@
+#pragma once
+
+// the value of Weapon.type, kept apart from the other guest structs so that the motion trace runner can use it without them
+enum WeaponType : uint32_t {
+    SmallSword = 0x0,
+    LargeSword = 0x1,
+    Spear = 0x2,
+    Bow = 0x3,
+    Shield = 0x4,
+    UnknownWeapon = 0x5,
+};
@@ -7,6 +7,23 @@ moduleMatches = 0x6267BFD0
 
 0x03821B64 = ksys_phys_ModelBoneAccessor_getBoneName:
 
+; the gsys::Model that was last handed to hook_PrepareModelBones, cleared every frame by vr_updateSettings
+bonePaletteModel:
+.int 0
+; set when hook_PrepareModelBones found that the bones of that model don't need hook_ModifyBoneMatrix
+bonePaletteUnmodified:
+.int 0
+; a bit for each of the first 256 bones of that model, set by hook_PrepareModelBones for the bones that still need hook_ModifyBoneMatrix
+boneHookMask:
+.int 0
+.int 0
+.int 0
+.int 0
+.int 0
+.int 0
+.int 0
+.int 0
+
 custom_gsys_ModelUnit_getBoneLocalMatrix:
 ; original function prologue
 stwu r1, -0x30(r1)
@@ -25,6 +42,31 @@ stw r9, 0x20(r1)
 ; r4 = sead::Matrix34*
 ; r5 = Vec3*
 ; r6 = int boneIdx
+
+; the first bone that gets copied from a model this frame lets the host prepare the transforms of all of the model's bones at once
+lwz r28, 0x10(r31) ; ModelBoneAccessor::gsysModel
+lis r29, bonePaletteModel@ha
+lwz r0, bonePaletteModel@l(r29)
+cmpw r0, r28
+beq bonePaletteChecked
+stw r28, bonePaletteModel@l(r29)
+
+stw r3, 0x10(r1)
+stw r4, 0x24(r1)
+stw r5, 0x28(r1)
+stw r6, 0x2C(r1)
+mr r3, r28
+lis r4, boneHookMask@ha
+addi r4, r4, boneHookMask@l
+bla import.coreinit.hook_PrepareModelBones
+lis r29, bonePaletteUnmodified@ha
+stw r3, bonePaletteUnmodified@l(r29)
+lwz r3, 0x10(r1)
+lwz r4, 0x24(r1)
+lwz r5, 0x28(r1)
+lwz r6, 0x2C(r1)
+
+bonePaletteChecked:
 lwz r9, 0x9C(r3)
 lwz r12, 0xC(r9)
 slwi r0, r6, 6
@@ -46,6 +88,7 @@ lfs f0, 0xC(r31)
 stfs f0, 8(r30)
 
 ; call custom bone matrix function
+; r7 = int boneIdx
 ; r6 = char* boneName
 ; r5 = Vec3* scale
 ; r4 = sead::Matrix34*
@@ -53,6 +96,28 @@ stfs f0, 8(r30)
 
 mr r27, r6
 
+; the bones of every model but the player's are copied as the game animated them
+lis r29, bonePaletteUnmodified@ha
+lwz r0, bonePaletteUnmodified@l(r29)
+cmpwi r0, 0
+bne skipModifyBoneMatrix
+
+; and the player's bones that the host has nothing to write for are left alone too
+cmplwi r6, 256
+bge callModifyBoneMatrix
+lis r29, boneHookMask@ha
+addi r29, r29, boneHookMask@l
+srwi r0, r6, 5
+slwi r0, r0, 2
+lwzx r0, r29, r0
+clrlwi r9, r6, 27
+srw r0, r0, r9
+andi. r0, r0, 1
+beq skipModifyBoneMatrix
+
+callModifyBoneMatrix:
+mr r7, r6 ; pass bone index so the hook can look up the bone without reading its name
+
 lwz r6, 0x20(r1) ; load name
 
 lwz r3, 0x0C(r1) ; r31 = ksys::phys::ModelBoneAccessor*
@@ -60,6 +125,7 @@ lwz r3, 0x10(r3) ; ModelBoneAccessor::gsysModel
 
 bla import.coreinit.hook_ModifyBoneMatrix
 
+skipModifyBoneMatrix:
 ; restore bone index finally
 mr r6, r27
 
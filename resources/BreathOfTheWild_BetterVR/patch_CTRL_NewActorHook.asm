@@ -18,6 +18,9 @@ stw r6, 0x04(r1)
 ; r4 is the ListNode within the just created actor
 ; r3 is the actor list ptr
 ; r30 is the newly created actor
+mr r3, r30
+bl import.coreinit.hook_CreateNewActor
+
 addi r3, r28, 0x18 ; this->actorList ptr (holds ptr to first ListNode?)
 lwz r0, 0x24(r28)
 
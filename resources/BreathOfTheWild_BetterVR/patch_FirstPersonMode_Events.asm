@@ -18,6 +18,12 @@ stw r6, 0x10(r1)
 lis r6, data_TableOfCutsceneEventsSettings@ha
 addi r6, r6, data_TableOfCutsceneEventsSettings@l
 bl import.coreinit.hook_UpdateSettings
+
+; let the first bone of every model have the host prepare its bones again in the new frame
+li r3, 0
+lis r4, bonePaletteModel@ha
+stw r3, bonePaletteModel@l(r4)
+
 lwz r5, 0x14(r1)
 lwz r6, 0x10(r1)
 
@@ -36,6 +36,13 @@ blr
 
 ; --------------------------------------------------------------------------------
 ; Patches below disable the shadow map projection matrices updates to prevent a mismatch when applying the old one
+; The left eye calculates the cascades using a camera that covers both eyes (see hook_BeginShadowCascadeUpdate), and can skip updating them for a few frames depending on the settings
+
+; set by hook_BeginShadowCascadeUpdate, the shadow map is only redrawn on frames where its matrices were updated
+; ShadowUpdateInterval defaults to 1, so this stays 1 and the cascades are updated and redrawn every frame unless a slower rate is picked in the menu.
+; skipping frames relies on the shadow map keeping its contents until it's drawn again
+shadowCascadesUpdated:
+.int 1
 
 hook_skipShadowUpdateShadowMatrix:
 mflr r0
@@ -49,13 +56,22 @@ lwz r3, currentEyeSide@l(r3)
 cmpwi r3, 1
 beq exit_SkipShadowCalcView
 
+bla import.coreinit.hook_BeginShadowCascadeUpdate
+lis r4, shadowCascadesUpdated@ha
+stw r3, shadowCascadesUpdated@l(r4)
+cmpwi r3, 0
+beq exit_SkipShadowCalcView
+
 0x03B0ACD0 = depthShadow_updateShadowMatrix:
 lis r3, depthShadow_updateShadowMatrix@ha
 addi r3, r3, depthShadow_updateShadowMatrix@l
 mtctr r3
 lwz r3, 0x0C(r1)
+lwz r4, 0x08(r1)
 bctrl ; bl depthShadow_updateShadowMatrix
 
+bla import.coreinit.hook_EndShadowCascadeUpdate
+
 exit_SkipShadowCalcView:
 lwz r4, 0x08(r1)
 lwz r3, 0x0C(r1)
@@ -165,6 +181,11 @@ lwz r3, currentEyeSide@l(r3)
 cmpwi r3, 1
 beq exit_ShadowDrawMapLeftOnly
 
+lis r3, shadowCascadesUpdated@ha
+lwz r3, shadowCascadesUpdated@l(r3)
+cmpwi r3, 0
+beq exit_ShadowDrawMapLeftOnly
+
 0x03B0ADF0 = depthShadow_drawShadowMap:
 lis r3, depthShadow_drawShadowMap@ha
 addi r3, r3, depthShadow_drawShadowMap@l
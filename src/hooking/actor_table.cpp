@@ -0,0 +1,82 @@
+#include "actor_table.h"
+#include "cemu_hooks.h"
+
+namespace {
+    const char* ReadActorName(uint32_t actorPtr) {
+        uint32_t actorNamePtr = CemuHooks::getMemory<BEType<uint32_t>>(actorPtr + offsetof(ActorWiiU, name) + offsetof(sead::FixedSafeString40, c_str)).getLE();
+        if (actorNamePtr == 0)
+            return nullptr;
+        return (const char*)CemuHooks::s_memoryBaseAddress + actorNamePtr;
+    }
+}
+
+void ActorTable::OnActorCreated(uint32_t address) {
+    if (auto it = m_slotByAddress.find(address); it != m_slotByAddress.end()) {
+        RemoveActor(it->second);
+    }
+}
+
+const ActorTable::Actor* ActorTable::OnActorVisited(uint32_t index, uint32_t listSize, uint32_t address) {
+    if (index == 0) {
+        ++m_walk;
+    }
+
+    const Actor* actor = nullptr;
+    if (auto it = m_slotByAddress.find(address); it != m_slotByAddress.end()) {
+        m_slots[it->second].lastSeenWalk = m_walk;
+        actor = &m_slots[it->second];
+    }
+    else {
+        actor = AddActor(address);
+    }
+
+    // the walk is done, remove the actors that are no longer in the list
+    if (index + 1 >= listSize) {
+        for (uint32_t i = 0; i < (uint32_t)m_slots.size(); ++i) {
+            if (m_slots[i].alive && m_slots[i].lastSeenWalk != m_walk) {
+                RemoveActor(i);
+            }
+        }
+    }
+    return actor;
+}
+
+const ActorTable::Actor* ActorTable::AddActor(uint32_t address) {
+    const char* actorName = ReadActorName(address);
+    if (actorName == nullptr || actorName[0] == '\0')
+        return nullptr;
+
+    uint32_t slot;
+    if (!m_freeSlots.empty()) {
+        slot = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else {
+        slot = (uint32_t)m_slots.size();
+        m_slots.emplace_back();
+    }
+
+    std::string_view nameView = actorName;
+    auto nameIt = m_names.find(nameView);
+    if (nameIt == m_names.end()) {
+        nameIt = m_names.emplace(nameView).first;
+    }
+
+    Actor& actor = m_slots[slot];
+    actor.address = address;
+    actor.id = address + stringToHash(actorName);
+    actor.lastSeenWalk = m_walk;
+    actor.name = &*nameIt;
+    actor.role = nameView == "GameROMPlayer" ? Role::PLAYER : nameView == "GameRomCamera" ? Role::CAMERA : Role::NONE;
+    actor.alive = true;
+    m_slotByAddress.emplace(address, slot);
+    return &actor;
+}
+
+void ActorTable::RemoveActor(uint32_t slot) {
+    Actor& actor = m_slots[slot];
+    m_slotByAddress.erase(actor.address);
+    actor.alive = false;
+    actor.generation++;
+    m_freeSlots.emplace_back(slot);
+}
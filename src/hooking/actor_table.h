@@ -0,0 +1,69 @@
+#pragma once
+
+// Stable slots for the game's actors, keyed by their guest address.
+// hook_UpdateActorList walks the entire actor list every time the game creates an actor, so actors that are already known only cost
+// a single lookup. Their name, id and whether they're the player or camera are only resolved when they first show up.
+class ActorTable {
+public:
+    enum class Role : uint8_t {
+        NONE,
+        PLAYER,
+        CAMERA
+    };
+
+    // stays valid until the actor leaves the list or another actor gets created at its address
+    struct Handle {
+        uint32_t slot = UINT32_MAX;
+        uint32_t generation = 0;
+    };
+
+    struct Actor {
+        uint32_t address = 0;
+        // the guest address plus the hash of its name, same as the ids the entity debugger always used
+        uint32_t id = 0;
+        uint32_t generation = 0;
+        uint32_t lastSeenWalk = 0;
+        const std::string* name = nullptr;
+        Role role = Role::NONE;
+        bool alive = false;
+    };
+
+    // the game reuses the memory of deleted actors, so a new actor at a known address retires the old slot
+    void OnActorCreated(uint32_t address);
+
+    // index 0 starts a new walk, once the last index is visited every actor that wasn't seen during the walk is removed
+    // returns nullptr for entries without a name
+    const Actor* OnActorVisited(uint32_t index, uint32_t listSize, uint32_t address);
+
+    bool IsAlive(Handle handle) const {
+        return handle.slot < m_slots.size() && m_slots[handle.slot].alive && m_slots[handle.slot].generation == handle.generation;
+    }
+
+    template <typename F>
+    void ForEach(F&& callback) const {
+        for (uint32_t i = 0; i < (uint32_t)m_slots.size(); ++i) {
+            if (m_slots[i].alive) {
+                callback(Handle{ i, m_slots[i].generation }, m_slots[i]);
+            }
+        }
+    }
+
+    size_t GetActorCount() const { return m_slotByAddress.size(); }
+    size_t GetInternedNameCount() const { return m_names.size(); }
+
+private:
+    const Actor* AddActor(uint32_t address);
+    void RemoveActor(uint32_t slot);
+
+    struct NameHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view name) const { return std::hash<std::string_view>{}(name); }
+    };
+
+    std::vector<Actor> m_slots;
+    std::vector<uint32_t> m_freeSlots;
+    std::unordered_map<uint32_t, uint32_t> m_slotByAddress;
+    // actor names repeat a lot (e.g. every Bokoblin), so each one is only stored once
+    std::unordered_set<std::string, NameHash, std::equal_to<>> m_names;
+    uint32_t m_walk = 0;
+};
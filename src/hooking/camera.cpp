@@ -1,6 +1,9 @@
 #include "cemu_hooks.h"
+#include "culling.h"
 #include "instance.h"
 #include "rendering/openxr.h"
+#include "projection.h"
+#include "frame_context.h"
 
 bool CemuHooks::UseMonoFrameBufferTemporarilyDuringMenusOrPictures() {
     return IsScreenOpen(ScreenId::PauseMenuInfo_00) || VRManager::instance().XR->GetRenderer()->IsGameCapturing3DFrameBuffer();
@@ -11,6 +14,8 @@ void CemuHooks::hook_BeginCameraSide(PPCInterpreter_t* hCPU) {
 
     OpenXR::EyeSide side = hCPU->gpr[0] == 0 ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
 
+    StereoCullingCache::Invalidate();
+
     Log::print<RENDERING>("");
     Log::print<RENDERING>("===============================================================================");
     Log::print<RENDERING>("{0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0} {0}", side);
@@ -39,6 +44,11 @@ float actualCrouchOffset = 0.0f;
 std::chrono::steady_clock::time_point crouch_state_change_time;
 
 uint32_t s_isLadderClimbing = 0;
+
+// set while the left eye updates the shadow cascades, so that the render camera and projection hooks return a view that covers both eyes
+// depthShadow_updateShadowMatrix calls those hooks on the PPC thread that runs it, so the other threads keep getting the eye's own view
+thread_local std::optional<CombinedStereoView> s_combinedShadowView;
+uint32_t s_shadowCascadeFrame = 0;
 uint32_t s_isRiding = 0;
 uint32_t s_isRidingSandSeal = 0;
 
@@ -90,12 +100,12 @@ void CemuHooks::hook_UpdateCameraForGameplay(PPCInterpreter_t* hCPU) {
         s_isCrouching = HAS_FLAG(moveBits, PlayerMoveBitFlags::IS_CROUCHING); 
 
         // Todo: move those and their hooks in controls.cpp ?
-        auto gameState = VRManager::instance().XR->m_gameState.load();
+        OpenXR::GameState& gameState = HookFrameContext::GetGameState();
         // Unreliable flag, need to investigate
         gameState.is_climbing = HAS_FLAG(moveBits, PlayerMoveBitFlags::IS_SWIMMING_OR_CLIMBING | PlayerMoveBitFlags::IS_CLIMBING_WALL) || s_isLadderClimbing == 2;
         gameState.is_riding_mount = (s_isRiding == 2 || s_isRidingSandSeal == 2) ? true : false;
         gameState.is_paragliding = HAS_FLAG(moveBits, PlayerMoveBitFlags::IS_GLIDER_ACTIVE);
-        VRManager::instance().XR->m_gameState.store(gameState);
+        HookFrameContext::StoreGameState();
 
         auto now = std::chrono::steady_clock::now();
         std::chrono::milliseconds crouchLerpDuration{ 150 };
@@ -163,13 +173,18 @@ void CemuHooks::hook_UpdateCameraForGameplay(PPCInterpreter_t* hCPU) {
         existingGameMtx = playerMtx4;
     }
 
-    // current VR headset camera matrix
-    auto viewsOpt = VRManager::instance().XR->GetRenderer()->GetMiddlePose();
+    // current VR headset camera matrix, which gets re-located once per frame right before it's written to the game's camera
+    // the right eye uses the same latched views, even when the XR thread started its next frame in between
+    RND_Renderer* renderer = VRManager::instance().XR->GetRenderer();
+    if (side == OpenXR::EyeSide::LEFT) {
+        renderer->LateLatchViews();
+    }
+    auto viewsOpt = renderer->GetViewsUsedByGame();
     if (!viewsOpt) {
         Log::print<ERROR>("hook_UpdateCameraForGameplay: No views available for the middle pose.");
         return;
     }
-    auto& views = viewsOpt.value();
+    glm::fmat4 views = RND_Renderer::GetMiddlePose(viewsOpt.value());
 
     // calculate final camera matrix
     glm::mat4 finalPose = glm::inverse(existingGameMtx) * views;
@@ -191,6 +206,7 @@ void CemuHooks::hook_UpdateCameraForGameplay(PPCInterpreter_t* hCPU) {
     uint32_t ppc_cameraMatrixOffsetOut = hCPU->gpr[31];
     writeMemory(ppc_cameraMatrixOffsetOut, &actCam);
     s_framesSinceLastCameraUpdate = 0;
+    StereoCullingCache::Invalidate();
 }
 
 glm::mat4 CemuHooks::s_lastCameraMtx = glm::mat4(1.0f);
@@ -261,6 +277,11 @@ void CemuHooks::hook_GetRenderCamera(PPCInterpreter_t* hCPU) {
     glm::fvec3 eyePos = ToGLM(currPoseOpt.value().position);
     glm::fquat eyeRot = ToGLM(currPoseOpt.value().orientation);
 
+    if (s_combinedShadowView.has_value()) {
+        eyePos = s_combinedShadowView->position;
+        eyeRot = s_combinedShadowView->orientation;
+    }
+
     glm::vec3 newPos = basePos + (baseYaw * eyePos);
     glm::fquat newRot = baseYaw * eyeRot;
 
@@ -291,50 +312,6 @@ constexpr uint32_t seadOrthoProjection = 0x1027B5BC;
 constexpr uint32_t seadPerspectiveProjection = 0x1027B54C;
 
 
-// https://github.com/KhronosGroup/OpenXR-SDK/blob/858912260ca616f4c23f7fb61c89228c353eb124/src/common/xr_linear.h#L564C1-L632C2
-// https://github.com/aboood40091/sead/blob/45b629fb032d88b828600a1b787729f2d398f19d/engine/library/modules/src/gfx/seadProjection.cpp#L166
-
-static data_VRProjectionMatrixOut calculateFOVAndOffset(XrFovf viewFOV) {
-    float totalHorizontalFov = viewFOV.angleRight - viewFOV.angleLeft;
-    float totalVerticalFov = viewFOV.angleUp - viewFOV.angleDown;
-
-    float aspectRatio = totalHorizontalFov / totalVerticalFov;
-    float fovY = totalVerticalFov;
-    float projectionCenter_offsetX = (viewFOV.angleRight + viewFOV.angleLeft) / 2.0f;
-    float projectionCenter_offsetY = (viewFOV.angleUp + viewFOV.angleDown) / 2.0f;
-
-    data_VRProjectionMatrixOut ret = {};
-    ret.aspectRatio = aspectRatio;
-    ret.fovY = fovY;
-    ret.offsetX = projectionCenter_offsetX;
-    ret.offsetY = projectionCenter_offsetY;
-
-    return ret;
-}
-
-static glm::mat4 calculateProjectionMatrix(float nearZ, float farZ, const XrFovf& fov) {
-    float l = tanf(fov.angleLeft) * nearZ;
-    float r = tanf(fov.angleRight) * nearZ;
-    float b = tanf(fov.angleDown) * nearZ;
-    float t = tanf(fov.angleUp) * nearZ;
-
-    float invW = 1.0f / (r - l);
-    float invH = 1.0f / (t - b);
-    float invD = 1.0f / (farZ - nearZ);
-
-    glm::mat4 dst = {};
-    dst[0][0] = 2.0f * nearZ * invW;
-    dst[1][1] = 2.0f * nearZ * invH;
-    dst[0][2] = (r + l) * invW;
-    dst[1][2] = (t + b) * invH;
-    dst[2][2] = -(farZ + nearZ) * invD;
-    dst[2][3] = -(2.0f * farZ * nearZ) * invD;
-    dst[3][2] = -1.0f;
-    dst[3][3] = 0.0f;
-
-    return dst;
-}
-
 void CemuHooks::hook_GetRenderProjection(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
@@ -367,35 +344,12 @@ void CemuHooks::hook_GetRenderProjection(PPCInterpreter_t* hCPU) {
         return;
     }
     XrFovf currFOV = VRManager::instance().XR->GetRenderer()->GetFOV(side).value();
-    auto newProjection = calculateFOVAndOffset(currFOV);
-
-    perspectiveProjection.aspect = newProjection.aspectRatio;
-    perspectiveProjection.fovYRadiansOrAngle = newProjection.fovY;
-    float halfAngle = newProjection.fovY.getLE() * 0.5f;
-    perspectiveProjection.fovySin = sinf(halfAngle);
-    perspectiveProjection.fovyCos = cosf(halfAngle);
-    perspectiveProjection.fovyTan = tanf(halfAngle);
-    perspectiveProjection.offset.x = newProjection.offsetX;
-    perspectiveProjection.offset.y = newProjection.offsetY;
 
-    glm::fmat4 newMatrix = calculateProjectionMatrix(perspectiveProjection.zNear.getLE(), perspectiveProjection.zFar.getLE(), currFOV);
-    perspectiveProjection.matrix = newMatrix;
-
-    // calculate device matrix
-    glm::fmat4 newDeviceMatrix = newMatrix;
-
-    float zScale = perspectiveProjection.deviceZScale.getLE();
-    float zOffset = perspectiveProjection.deviceZOffset.getLE();
-
-    newDeviceMatrix[2][0] *= zScale;
-    newDeviceMatrix[2][1] *= zScale;
-    newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * zOffset) * zScale;
-    newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * zScale + newDeviceMatrix[3][3] * zOffset;
-
-    perspectiveProjection.deviceMatrix = newDeviceMatrix;
+    if (s_combinedShadowView.has_value()) {
+        currFOV = s_combinedShadowView->fov;
+    }
 
-    perspectiveProjection.dirty = false;
-    perspectiveProjection.deviceDirty = false;
+    ProjectionCache::Apply(side, currFOV, perspectiveProjection);
 
     writeMemory(projectionOut, &perspectiveProjection);
     hCPU->gpr[3] = projectionOut;
@@ -431,35 +385,7 @@ void CemuHooks::hook_ModifyLightPrePassProjectionMatrix(PPCInterpreter_t* hCPU)
 
 
     XrFovf currFOV = VRManager::instance().XR->GetRenderer()->GetFOV(side).value();
-    auto newProjection = calculateFOVAndOffset(currFOV);
-
-    perspectiveProjection.aspect = newProjection.aspectRatio;
-    perspectiveProjection.fovYRadiansOrAngle = newProjection.fovY;
-    float halfAngle = newProjection.fovY.getLE() * 0.5f;
-    perspectiveProjection.fovySin = sinf(halfAngle);
-    perspectiveProjection.fovyCos = cosf(halfAngle);
-    perspectiveProjection.fovyTan = tanf(halfAngle);
-    perspectiveProjection.offset.x = newProjection.offsetX;
-    perspectiveProjection.offset.y = newProjection.offsetY;
-
-    glm::fmat4 newMatrix = calculateProjectionMatrix(perspectiveProjection.zNear.getLE(), perspectiveProjection.zFar.getLE(), currFOV);
-    perspectiveProjection.matrix = newMatrix;
-
-    // calculate device matrix
-    glm::fmat4 newDeviceMatrix = newMatrix;
-
-    float zScale = perspectiveProjection.deviceZScale.getLE();
-    float zOffset = perspectiveProjection.deviceZOffset.getLE();
-
-    newDeviceMatrix[2][0] *= zScale;
-    newDeviceMatrix[2][1] *= zScale;
-    newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * zOffset) * zScale;
-    newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * zScale + newDeviceMatrix[3][3] * zOffset;
-
-    perspectiveProjection.deviceMatrix = newDeviceMatrix;
-
-    perspectiveProjection.dirty = false;
-    perspectiveProjection.deviceDirty = false;
+    ProjectionCache::Apply(side, currFOV, perspectiveProjection);
 
     writeMemory(projectionIn, &perspectiveProjection);
 }
@@ -559,35 +485,7 @@ void CemuHooks::hook_ModifyProjectionUsingCamera(PPCInterpreter_t* hCPU) {
     Log::print<RENDERING>("[{}] ModifyProjectionUsingCamera: {}", side, perspectiveProjection);
 
     XrFovf currFOV = VRManager::instance().XR->GetRenderer()->GetFOV(side).value();
-    auto newProjection = calculateFOVAndOffset(currFOV);
-
-    perspectiveProjection.aspect = newProjection.aspectRatio;
-    perspectiveProjection.fovYRadiansOrAngle = newProjection.fovY;
-    float halfAngle = newProjection.fovY.getLE() * 0.5f;
-    perspectiveProjection.fovySin = sinf(halfAngle);
-    perspectiveProjection.fovyCos = cosf(halfAngle);
-    perspectiveProjection.fovyTan = tanf(halfAngle);
-    perspectiveProjection.offset.x = newProjection.offsetX;
-    perspectiveProjection.offset.y = newProjection.offsetY;
-
-    glm::fmat4 newMatrix = calculateProjectionMatrix(perspectiveProjection.zNear.getLE(), perspectiveProjection.zFar.getLE(), currFOV);
-    perspectiveProjection.matrix = newMatrix;
-
-    // calculate device matrix
-    glm::fmat4 newDeviceMatrix = newMatrix;
-
-    float zScale = perspectiveProjection.deviceZScale.getLE();
-    float zOffset = perspectiveProjection.deviceZOffset.getLE();
-
-    newDeviceMatrix[2][0] *= zScale;
-    newDeviceMatrix[2][1] *= zScale;
-    newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * zOffset) * zScale;
-    newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * zScale + newDeviceMatrix[3][3] * zOffset;
-
-    perspectiveProjection.deviceMatrix = newDeviceMatrix;
-
-    perspectiveProjection.dirty = false;
-    perspectiveProjection.deviceDirty = false;
+    ProjectionCache::Apply(side, currFOV, perspectiveProjection);
 
     writeMemory(projectionPtr, &perspectiveProjection);
 }
@@ -645,6 +543,30 @@ std::pair<glm::vec3, glm::fquat> CemuHooks::CalculateVRWorldPose(const BESeadLoo
     return { newPos, newRot };
 }
 
+// the eye frustums are only rebuilt once per camera update for each camera and pair of clip planes that the game uses
+const StereoFrustum& CemuHooks::GetStereoFrustum(uint32_t camPtr, float nearClip, float farClip) {
+    return StereoCullingCache::Get(camPtr, nearClip, farClip, [camPtr](float nearClip, float farClip) {
+        BESeadLookAtCamera camera = {};
+        readMemory(camPtr, &camera);
+
+        StereoFrustum stereoFrustum;
+        for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+            if (auto fovOpt = VRManager::instance().XR->GetRenderer()->GetFOV(side)) {
+                auto [pos, rot] = CalculateVRWorldPose(camera, side);
+
+                // pull the camera backwards a bit to account for it being a third-person game that encompassed a bigger area
+                pos += rot * glm::vec3(0.0f, 0.0f, 1.0f);
+
+                glm::mat4 view = glm::inverse(glm::translate(glm::mat4(1.0f), pos) * glm::mat4_cast(rot));
+                glm::mat4 proj = glm::transpose(calculateProjectionMatrix(nearClip, farClip, fovOpt.value()));
+                stereoFrustum.addEye(proj * view);
+            }
+        }
+        stereoFrustum.finalize();
+        return stereoFrustum;
+    });
+}
+
 void CemuHooks::hook_CheckIfCameraCanSeePos(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
@@ -659,9 +581,6 @@ void CemuHooks::hook_CheckIfCameraCanSeePos(PPCInterpreter_t* hCPU) {
     float nearClip = hCPU->fpr[2].fp0;
     float farClip = hCPU->fpr[3].fp0;
 
-    BESeadLookAtCamera camera = {};
-    readMemory(camPtr, &camera);
-
     //uint32_t mainProjectionPtr = hCPU->gpr[5];
     //BESeadPerspectiveProjection mainProjection = {};
     //readMemory(mainProjectionPtr, &mainProjection);
@@ -675,32 +594,35 @@ void CemuHooks::hook_CheckIfCameraCanSeePos(PPCInterpreter_t* hCPU) {
     BEVec3 center;
     readMemory(posPtr, &center);
 
-    Frustum frustum;
-    bool visible = false;
+    const StereoFrustum& frustum = GetStereoFrustum(camPtr, nearClip, farClip);
+    bool visible = frustum.checkSphere(center.getLE(), radius);
 
-    for (int i = 0; i < 2; ++i) {
-        OpenXR::EyeSide side = (i == 0) ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
-        if (auto fovOpt = VRManager::instance().XR->GetRenderer()->GetFOV(side)) {
-            auto [pos, rot] = CalculateVRWorldPose(camera, side);
+    Log::print<PPC>("Checking visibility of {} (rad = {}, near = {}, far = {}): {}", center, radius, nearClip, farClip, visible ? "visible" : "invisible");
 
-            // pull the camera backwards a bit to account for it being a third-person game that encompassed a bigger area
-            pos += rot * glm::vec3(0.0f, 0.0f, 1.0f);
+    hCPU->gpr[3] = visible ? 1 : 0;
+}
 
-            glm::mat4 view = glm::inverse(glm::translate(glm::mat4(1.0f), pos) * glm::mat4_cast(rot));
-            glm::mat4 proj = glm::transpose(calculateProjectionMatrix(nearClip, farClip, fovOpt.value()));
-            glm::mat4 vp = proj * view;
+// r3 is set to 1 if the left eye should update and draw the shadow cascades this frame, otherwise the previous ones are reused
+void CemuHooks::hook_BeginShadowCascadeUpdate(PPCInterpreter_t* hCPU) {
+    hCPU->instructionPointer = hCPU->sprNew.LR;
 
-            frustum.update(vp);
-            if (frustum.checkSphere(center.getLE(), radius)) {
-                visible = true;
-                break;
-            }
+    const uint32_t interval = GetSettings().GetShadowUpdateInterval();
+    const bool updateCascades = (s_shadowCascadeFrame++ % interval) == 0;
+    hCPU->gpr[3] = updateCascades ? 1 : 0;
+
+    s_combinedShadowView.reset();
+    if (updateCascades && GetSettings().ShareShadowCascadesBetweenEyes() && VRManager::instance().XR->GetRenderer() != nullptr) {
+        if (auto views = VRManager::instance().XR->GetRenderer()->GetPoses()) {
+            s_combinedShadowView = CombinedStereoView::Calculate({ (*views)[0].pose, (*views)[1].pose }, { (*views)[0].fov, (*views)[1].fov }, GetSettings().GetZNear(), GetSettings().GetZFar());
         }
+        Log::print<RENDERING>("Updating shadow cascades {}", s_combinedShadowView ? "using the combined stereo view" : "using the left eye");
     }
+}
 
-    Log::print<PPC>("Checking visibility of {} (rad = {}, near = {}, far = {}): {}", center, radius, nearClip, farClip, visible ? "visible" : "invisible");
+void CemuHooks::hook_EndShadowCascadeUpdate(PPCInterpreter_t* hCPU) {
+    hCPU->instructionPointer = hCPU->sprNew.LR;
 
-    hCPU->gpr[3] = visible ? 1 : 0;
+    s_combinedShadowView.reset();
 }
 
 void CemuHooks::hook_EndCameraSide(PPCInterpreter_t* hCPU) {
@@ -992,7 +914,7 @@ void CemuHooks::hook_OverwriteCameraParam(PPCInterpreter_t* hCPU) {
 void CemuHooks::hook_FixLadder(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
-    auto input = VRManager::instance().XR->m_input.load();
+    const OpenXR::InputState& input = HookFrameContext::GetInput();
 
     if (input.shared.in_game && s_isLadderClimbing == 0) {
         return;
@@ -1,6 +1,7 @@
 #pragma once
 #include "entity_debugger.h"
 
+struct StereoFrustum;
 
 class CemuHooks {
 public:
@@ -37,6 +38,8 @@ public:
         osLib_registerHLEFunction("coreinit", "hook_GetRenderCamera", &hook_GetRenderCamera);
         osLib_registerHLEFunction("coreinit", "hook_GetRenderProjection", &hook_GetRenderProjection);
         osLib_registerHLEFunction("coreinit", "hook_EndCameraSide", &hook_EndCameraSide);
+        osLib_registerHLEFunction("coreinit", "hook_BeginShadowCascadeUpdate", &hook_BeginShadowCascadeUpdate);
+        osLib_registerHLEFunction("coreinit", "hook_EndShadowCascadeUpdate", &hook_EndShadowCascadeUpdate);
         osLib_registerHLEFunction("coreinit", "hook_RouteActorJob", &hook_RouteActorJob);
 
         osLib_registerHLEFunction("coreinit", "hook_UseCameraDistance", &hook_UseCameraDistance);
@@ -51,6 +54,7 @@ public:
         osLib_registerHLEFunction("coreinit", "hook_SetActorOpacity", &hook_SetActorOpacity);
         osLib_registerHLEFunction("coreinit", "hook_CalculateModelOpacity", &hook_CalculateModelOpacity);
         osLib_registerHLEFunction("coreinit", "hook_ModifyBoneMatrix", &hook_ModifyBoneMatrix);
+        osLib_registerHLEFunction("coreinit", "hook_PrepareModelBones", &hook_PrepareModelBones);
         osLib_registerHLEFunction("coreinit", "hook_ChangeWeaponMtx", &hook_ChangeWeaponMtx);
 
         // First-Person Weapon Hooks
@@ -197,7 +201,11 @@ public:
 
         return GetSettings().UseBlackBarsForCutscenes();
     }
+    // the open screens are only looked up once per guest frame, BeginGuestFrame() is called by hook_UpdateSettings at the start of each one
     static bool IsScreenOpen(ScreenId screen);
+    static void BeginGuestFrame() { s_guestFrame.fetch_add(1, std::memory_order_relaxed); }
+    static uint32_t GetGuestFrame() { return s_guestFrame.load(std::memory_order_relaxed); }
+    static uint64_t GetScreenLookups() { return s_screenLookups.load(std::memory_order_relaxed); }
 
     static void DrawDebugOverlays();
 
@@ -210,9 +218,15 @@ private:
 
     static std::atomic_uint32_t s_framesSinceLastCameraUpdate;
 
+    // each entry stores the guest frame it was looked up in, shifted left by one, and whether the screen was open in the lowest bit
+    static std::atomic_uint32_t s_guestFrame;
+    static std::array<std::atomic_uint64_t, std::to_underlying(ScreenId::ScreenId_END) + 1> s_openScreens;
+    static std::atomic_uint64_t s_screenLookups;
+
     static void InitWindowHandles();
 
     static std::pair<glm::vec3, glm::fquat> CalculateVRWorldPose(const BESeadLookAtCamera& camera, uint8_t side);
+    static const StereoFrustum& GetStereoFrustum(uint32_t camPtr, float nearClip, float farClip);
 
     static void hook_UpdateSettings(PPCInterpreter_t* hCPU);
 
@@ -230,6 +244,8 @@ private:
     static void hook_GetRenderCamera(PPCInterpreter_t* hCPU);
     static void hook_GetRenderProjection(PPCInterpreter_t* hCPU);
     static void hook_EndCameraSide(PPCInterpreter_t* hCPU);
+    static void hook_BeginShadowCascadeUpdate(PPCInterpreter_t* hCPU);
+    static void hook_EndShadowCascadeUpdate(PPCInterpreter_t* hCPU);
     static void hook_RouteActorJob(PPCInterpreter_t* hCPU);
 
     static void hook_UseCameraDistance(PPCInterpreter_t* hCPU);
@@ -245,6 +261,7 @@ private:
     static void hook_SetActorOpacity(PPCInterpreter_t* hCPU);
     static void hook_CalculateModelOpacity(PPCInterpreter_t* hCPU);
     static void hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU);
+    static void hook_PrepareModelBones(PPCInterpreter_t* hCPU);
     static void hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU);
 
     // First-Person Weapon Hooks
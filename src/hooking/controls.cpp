@@ -1,6 +1,10 @@
 #include "cemu_hooks.h"
 #include "../instance.h"
 #include "openxr_motion_bridge.h"
+#include "frame_context.h"
+#include "hand_gestures.h"
+#include "input_bindings.h"
+#include "rendering/input_sampler.h"
 
 
 Direction getJoystickDirection(const XrVector2f& stick)
@@ -45,19 +49,6 @@ void spreadWeaponDetectionOverFrames(OpenXR::GameState& gameState) {
 }
 
 
-struct HandGestureState {
-    bool isBehindHead;
-    bool isBehindHeadWithWaistOffset;
-    bool isCloseToHead;
-    bool isCloseToMouth;
-    bool isCloseToWaist;
-    bool isNearChestHeight;
-    bool isOnLeftSide;  // true = left side of body, false = right side
-    bool isFarEnoughFromStoredPosition;
-    float magnesisForwardAmount;
-    float magnesisVerticalAmount;
-};
-
 int getMagnesisForwardFrameInterval(float v)
 {
     if (v <= 0.0f)    return 0;
@@ -67,58 +58,18 @@ int getMagnesisForwardFrameInterval(float v)
     return 1;
 }
 
-// Gesture detection functions
-HandGestureState calculateHandGesture(
+// Magnesis gesture, the body slots are tracked by HandGestureRecognizer
+void calculateMagnesisGesture(
     OpenXR::GameState& gameState,
+    HandGestureState& gesture,
     const glm::fvec3& handPos,
     const glm::fmat4& headsetMatrix,
-    const glm::fvec3& headsetPos,
     const bool ProcessStoredPositionDistanceCheck,
     const glm::fvec3& storedHandPos
 ) {
-    HandGestureState gesture = {};
-    
-    // Calculate directional vectors
     glm::fvec3 headsetForward = -glm::normalize(glm::fvec3(headsetMatrix[2]));
     headsetForward.y = 0.0f;
     headsetForward = glm::normalize(headsetForward);
-    
-    glm::fvec3 headsetRight = glm::normalize(glm::fvec3(headsetMatrix[0]));
-    glm::fvec3 headToHand = handPos - headsetPos;
-    
-    // Check if hand is behind head (for shoulder slots)
-    float forwardDot = glm::dot(headsetForward, headToHand);
-    gesture.isBehindHead = (forwardDot < 0.0f);
-    
-    // Check if hand is behind head (for waist slot) - uses flattened vectors
-    glm::vec3 flatForward = glm::normalize(glm::vec3(headsetForward.x, 0.0f, headsetForward.z));
-    glm::vec3 flatHandOffset = glm::vec3(headToHand.x, 0.0f, headToHand.z);
-    
-    constexpr float WAIST_BEHIND_OFFSET = -0.05f; //0.15f
-    float flatForwardDot = glm::dot(flatForward, flatHandOffset) + WAIST_BEHIND_OFFSET;
-    gesture.isBehindHeadWithWaistOffset = (flatForwardDot < 0.0f);
-    
-    // Check which side of body the hand is on
-    float rightDot = glm::dot(headsetRight, headToHand);
-    gesture.isOnLeftSide = (rightDot < 0.0f);
-    
-    // Check distance from head (for shoulder slots)
-    constexpr float SHOULDER_RADIUS = 0.35f;
-    constexpr float SHOULDER_RADIUS_SQ = SHOULDER_RADIUS * SHOULDER_RADIUS;
-    gesture.isCloseToHead = (glm::length2(headToHand) < SHOULDER_RADIUS_SQ);
-
-    // Check distance from head (for mouth slot)
-    constexpr float MOUTH_RADIUS = 0.2f;
-    constexpr float MOUTH_RADIUS_SQ = MOUTH_RADIUS * MOUTH_RADIUS;
-    gesture.isCloseToMouth = (glm::length2(headToHand) < MOUTH_RADIUS_SQ);
-    
-    // Check distance from waist (rough estimate)
-    glm::fvec3 waistPos = headsetPos - glm::fvec3(0.0f, 0.45f, 0.0f);
-    gesture.isCloseToWaist = (handPos.y < waistPos.y);
-
-    // Check hand height for shield (rough estimate)
-    glm::fvec3 chestPos = headsetPos - glm::fvec3(0.0f, 0.3f, 0.0f);
-    gesture.isNearChestHeight = (handPos.y > chestPos.y);
 
     // Check distance from stored position
     if (ProcessStoredPositionDistanceCheck) {
@@ -163,8 +114,6 @@ HandGestureState calculateHandGesture(
             //Log::print<INFO>("gesture.magnesisForwardAmount  : {}", gesture.magnesisForwardAmount);
         }
     }
-
-    return gesture;
 }
 
 bool isHandOverLeftShoulderSlot(const HandGestureState& gesture) {
@@ -792,33 +741,23 @@ void processRightTriggerBindings(
     }
 }
 
-void processMenuInput(
-    uint32_t& buttonHold,
-    OpenXR::InputState& inputs,
-    OpenXR::GameState& gameState,
-    Direction leftStickDir
-) {
-    auto mapButton = [](XrActionStateBoolean& state, VPADButtons btn) -> uint32_t { 
-        return state.currentState ? btn : 0;
-    };
-
-    if (!closeDpadMenu(inputs, buttonHold, gameState))
-        buttonHold |= mapButton(inputs.inMenu.sort, VPAD_BUTTON_Y);
-
-    if (!gameState.prevent_inputs) {
-        buttonHold |= mapButton(inputs.inMenu.back, VPAD_BUTTON_B);
-        if (gameState.map_open)
-            buttonHold |= mapButton(inputs.shared.inventory_map, VPAD_BUTTON_MINUS);
-        else
-            buttonHold |= mapButton(inputs.shared.inventory_map, VPAD_BUTTON_PLUS);
-    }
-
-    buttonHold |= mapButton(inputs.inMenu.select, VPAD_BUTTON_A);
-    buttonHold |= mapButton(inputs.inMenu.leftTrigger, VPAD_BUTTON_L);
-    buttonHold |= mapButton(inputs.inMenu.rightTrigger, VPAD_BUTTON_R);
-
-    if (inputs.inMenu.holdState.lastEvent == ButtonState::Event::ShortPress)
-        buttonHold |= VPAD_BUTTON_X;
+uint32_t getBindingConditions(const OpenXR::GameState& gameState, const HandGestureState& leftGesture, const HandGestureState& rightGesture, bool dpadMenuOpen) {
+    uint32_t conditions = gameState.in_game ? InputBindings::IN_GAME : InputBindings::IN_MENU;
+    if (gameState.prevent_inputs)
+        conditions |= InputBindings::PREVENTING_INPUTS;
+    if (gameState.is_climbing || gameState.is_paragliding)
+        conditions |= InputBindings::CLIMBING;
+    if (gameState.is_riding_mount)
+        conditions |= InputBindings::RIDING;
+    if (gameState.map_open)
+        conditions |= InputBindings::MAP_OPEN;
+    if (dpadMenuOpen)
+        conditions |= InputBindings::DPAD_MENU_OPEN;
+    if (!isHandNotOverAnySlot(leftGesture))
+        conditions |= InputBindings::LEFT_HAND_OVER_SLOT;
+    if (!isHandNotOverAnySlot(rightGesture))
+        conditions |= InputBindings::RIGHT_HAND_OVER_SLOT;
+    return conditions;
 }
 
 void processInputPrevention(OpenXR::GameState& gameState, std::chrono::steady_clock::time_point now, std::chrono::milliseconds delay)
@@ -859,15 +798,27 @@ void processModMenuInput(std::atomic_bool& isMenuOpen, OpenXR::InputState& input
 void processHandGesture(RND_Renderer* renderer, OpenXR::InputState& inputs, HandGestureState& leftGesture, HandGestureState& rightGesture, OpenXR::GameState& gameState)
 {
     auto headsetPose = renderer->GetMiddlePose();
-    if (headsetPose.has_value()) {
+    const bool handsValid = (inputs.shared.poseLocation[0].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) && (inputs.shared.poseLocation[1].locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT);
+
+    // the slots that the hands were in don't carry over when the hands couldn't be tracked, or between the game and its menus
+    HandGestureRecognizer& recognizer = HandGestureRecognizer::Get();
+    if (!headsetPose.has_value() || !handsValid || gameState.in_game != gameState.was_in_game) {
+        recognizer.Reset(inputs.shared.inputTime);
+    }
+
+    if (headsetPose.has_value() && handsValid) {
         const auto headsetMtx = headsetPose.value();
-        const glm::fvec3 headsetPos(headsetMtx[3]);
         
         const auto leftHandPos = ToGLM(inputs.shared.poseLocation[0].pose.position);
         const auto rightHandPos = ToGLM(inputs.shared.poseLocation[1].pose.position);
         
-        leftGesture = calculateHandGesture(gameState, leftHandPos, headsetMtx, headsetPos, gameState.left_hand_position_stored, gameState.stored_left_hand_position);
-        rightGesture = calculateHandGesture(gameState, rightHandPos, headsetMtx, headsetPos, gameState.right_hand_position_stored, gameState.stored_right_hand_position);
+        // the hook runs on every VPAD read, but the hands only need to be recognized again once there's a new input sample
+        recognizer.Update(inputs.shared.inputTime, headsetMtx, leftHandPos, rightHandPos);
+        leftGesture = recognizer.GetGesture(OpenXR::EyeSide::LEFT);
+        rightGesture = recognizer.GetGesture(OpenXR::EyeSide::RIGHT);
+
+        calculateMagnesisGesture(gameState, leftGesture, leftHandPos, headsetMtx, gameState.left_hand_position_stored, gameState.stored_left_hand_position);
+        calculateMagnesisGesture(gameState, rightGesture, rightHandPos, headsetMtx, gameState.right_hand_position_stored, gameState.stored_right_hand_position);
     }
 }
 
@@ -935,10 +886,6 @@ void updatePreviousValues(OpenXR::GameState& gameState, uint32_t& buttonHold, Ha
 void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
-    auto mapXRButtonToVpad = [](XrActionStateBoolean& state, VPADButtons mapping) -> uint32_t {
-        return state.currentState ? mapping : 0;
-    };
-
     // read existing vpad as to not overwrite it
     uint32_t vpadStatusOffset = hCPU->gpr[4];
     VPADStatus vpadStatus = {};
@@ -976,14 +923,14 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
 
     auto* rumbleMgr = VRManager::instance().XR->GetRumbleManager();
 
-    // fetch input state
-    OpenXR::InputState inputs = VRManager::instance().XR->m_input.load();
+    // fetch input state, sampled just now unless an XR frame started right before
+    OpenXR::InputState inputs = InputSampler::SampleBeforeVPADRead(IsShowingMenu());
     inputs.inGame.drop_weapon[0] = inputs.inGame.drop_weapon[1] = false;
 
     float dt = (float)(inputs.shared.inputTime - prev_sample) / 1000000000.0f;
 
     // fetch game state
-    auto gameState = VRManager::instance().XR->m_gameState.load(); 
+    OpenXR::GameState& gameState = HookFrameContext::GetGameState();
     gameState.in_game = inputs.shared.in_game;
 
     // buttons
@@ -1031,59 +978,11 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
 
         equipWeaponOnDpadMenuExit(newXRBtnHold, gameState, dt);
 
-        if (!gameState.prevent_inputs) {
-            // prevent jump when exiting menus with B button
-            newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.jump_cancel, VPAD_BUTTON_X);
-
-            //// Scope
-            if (inputs.inGame.crouch_scopeState.lastEvent == ButtonState::Event::LongPress) {
-                newXRBtnHold |= VPAD_BUTTON_STICK_R;
-            }
-
-            // Handle map and inventory menu toggle
-            if (inputs.shared.inventory_mapState.lastEvent == ButtonState::Event::ShortPress) {
-                newXRBtnHold |= VPAD_BUTTON_PLUS;
-                gameState.map_open = false;
-            }
-            if (inputs.shared.inventory_mapState.lastEvent == ButtonState::Event::LongPress) {
-                newXRBtnHold |= VPAD_BUTTON_MINUS;
-                gameState.map_open = true;
-            }
-        }
-
-        if (inputs.inGame.crouch_scopeState.lastEvent == ButtonState::Event::ShortPress) {
-            newXRBtnHold |= VPAD_BUTTON_STICK_L;
-        }
-        
         // Optional rune inputs (for seated players)
         openDpadMenuRuneButton(inputs.inGame.useRune_runeMenuState.lastEvent, newXRBtnHold, gameState);
-        if (inputs.inGame.useRune_runeMenuState.lastEvent == ButtonState::Event::ShortPress) {
-            newXRBtnHold |= VPAD_BUTTON_L;  // Equip rune
-            gameState.last_equip_type_held = EquipType::SheikahSlate;
-        }
-        
-        // If climbing or paragliding, make the B button cancel instantly the action instead of long press to run
-        if (gameState.is_climbing || gameState.is_paragliding) {
-            newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.run_interact, VPAD_BUTTON_B);
-        }
-        else if (gameState.is_riding_mount)
-        {
-            // A button to interact when riding a mount
-            newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.run_interact, VPAD_BUTTON_A);
-            // grabs to accelerate and brake when riding master cycle
-            // Skip when the respective hand is inside a body slot so grips can still equip/unequip
-            if (inputs.inGame.grab[1].currentState && isHandNotOverAnySlot(rightGesture))
-                newXRBtnHold |= VPAD_BUTTON_A;
-            if (inputs.inGame.grab[0].currentState && isHandNotOverAnySlot(leftGesture))
-                newXRBtnHold |= VPAD_BUTTON_B;
-        }
-        else {
-            if (inputs.inGame.runState.lastEvent == ButtonState::Event::LongPress) {
-                newXRBtnHold |= VPAD_BUTTON_B; // Run
-            }
-            else
-                newXRBtnHold |= mapXRButtonToVpad(inputs.inGame.run_interact, VPAD_BUTTON_A);
-        }
+
+        // jumping, running, crouching, the map and inventory etc. which can be rebound in BetterVR_bindings.txt next to Cemu.exe
+        newXRBtnHold |= InputBindings::Get().Evaluate(inputs, gameState, getBindingConditions(gameState, leftGesture, rightGesture, false));
 
         // Whistle gesture
         if (isHandOverMouthSlot(leftGesture) && isHandOverMouthSlot(rightGesture)) {
@@ -1104,7 +1003,8 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
         processRightTriggerBindings(newXRBtnHold, inputs, gameState, rightGesture);
     }
     else {
-        processMenuInput(newXRBtnHold, inputs, gameState, leftJoystickDir);
+        const bool dpadMenuOpen = closeDpadMenu(inputs, newXRBtnHold, gameState);
+        newXRBtnHold |= InputBindings::Get().Evaluate(inputs, gameState, getBindingConditions(gameState, leftGesture, rightGesture, dpadMenuOpen));
     }
 
     // Update rumble/haptics
@@ -1141,8 +1041,8 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
 
     updatePreviousValues(gameState, newXRBtnHold, leftGesture, rightGesture, inputs.shared.inputTime);
 
-    VRManager::instance().XR->m_gameState.store(gameState);
-    VRManager::instance().XR->m_input.store(inputs);
+    HookFrameContext::StoreGameState();
+    InputSampler::StoreAfterVPADRead(inputs);
 }
 
 
@@ -1151,32 +1051,3 @@ void CemuHooks::hook_InjectXRInput(PPCInterpreter_t* hCPU) {
 // - holding the grip button without a weapon while there's a nearby weapon = temporarily hold weapon
 // - holding the grip button a weapon equipped = opens weapon dpad menu
 // - quickly press the grip button while holding a weapon = drops current weapon
-
-void CemuHooks::hook_CreateNewActor(PPCInterpreter_t* hCPU) {
-    hCPU->instructionPointer = hCPU->sprNew.LR;
-
-    // if (VRManager::instance().XR->GetRenderer() == nullptr || VRManager::instance().XR->GetRenderer()->m_layer3D.GetStatus() == RND_Renderer::Layer3D::Status3D::UNINITIALIZED) {
-    //     hCPU->gpr[3] = 0;
-    //     return;
-    // }
-    hCPU->gpr[3] = 0;
-
-    // OpenXR::InputState inputs = VRManager::instance().XR->m_input.load();
-    // if (!inputs.shared.in_game) {
-    //     hCPU->gpr[3] = 0;
-    //     return;
-    // }
-    //
-    // // test if controller is connected
-    // if (inputs.inGame.grab[OpenXR::EyeSide::LEFT].currentState == XR_TRUE && inputs.inGame.grab[OpenXR::EyeSide::LEFT].changedSinceLastSync == XR_TRUE) {
-    //     Log::print("Trying to spawn new thing!");
-    //     hCPU->gpr[3] = 1;
-    // }
-    // else if (inputs.inGame.grab[OpenXR::EyeSide::RIGHT].currentState == XR_TRUE && inputs.inGame.grab[OpenXR::EyeSide::RIGHT].changedSinceLastSync == XR_TRUE) {
-    //     Log::print("Trying to spawn new thing!");
-    //     hCPU->gpr[3] = 1;
-    // }
-    // else {
-    //     hCPU->gpr[3] = 0;
-    // }
-}
\ No newline at end of file
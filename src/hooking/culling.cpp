@@ -0,0 +1,66 @@
+#include "culling.h"
+
+namespace {
+    struct FrustumCorner {
+        glm::vec3 pos;
+        // how much the corner moves when every plane is pushed outwards by one unit, like a sphere's radius does for the plane tests
+        glm::vec3 expansion;
+    };
+
+    // the corners are where a left/right, bottom/top and near/far plane meet
+    std::array<FrustumCorner, 8> GetCorners(const Frustum& frustum) {
+        std::array<FrustumCorner, 8> corners = {};
+        for (int i = 0; i < 8; ++i) {
+            const glm::vec4& a = frustum.planes[0 + ((i >> 0) & 1)];
+            const glm::vec4& b = frustum.planes[2 + ((i >> 1) & 1)];
+            const glm::vec4& c = frustum.planes[4 + ((i >> 2) & 1)];
+            glm::mat3 invNormals = glm::inverse(glm::transpose(glm::mat3(glm::vec3(a), glm::vec3(b), glm::vec3(c))));
+            corners[i].pos = invNormals * -glm::vec3(a.w, b.w, c.w);
+            corners[i].expansion = invNormals * glm::vec3(-1.0f);
+        }
+        return corners;
+    }
+}
+
+void StereoFrustum::finalize() {
+    hasCombined = false;
+    if (eyeCount != 2) {
+        return;
+    }
+
+    std::array<std::array<FrustumCorner, 8>, 2> corners = { GetCorners(eyes[0]), GetCorners(eyes[1]) };
+    for (const auto& eyeCorners : corners) {
+        for (const FrustumCorner& corner : eyeCorners) {
+            if (!glm::all(glm::isfinite(corner.pos)) || !glm::all(glm::isfinite(corner.expansion))) {
+                return;
+            }
+        }
+    }
+
+    edgeBands = {};
+    for (int i = 0; i < 6; ++i) {
+        // a plane that faces the average direction of both eyes' planes, pushed out until it contains every corner of both eyes
+        glm::vec3 normal = glm::normalize(glm::vec3(eyes[0].planes[i]) + glm::vec3(eyes[1].planes[i]));
+        float offset = std::numeric_limits<float>::lowest();
+        float radiusScale = 0.0f;
+        for (const auto& eyeCorners : corners) {
+            for (const FrustumCorner& corner : eyeCorners) {
+                offset = std::max(offset, -glm::dot(normal, corner.pos));
+                radiusScale = std::max(radiusScale, -glm::dot(normal, corner.expansion));
+            }
+        }
+        combined.planes[i] = glm::vec4(normal, offset);
+        combinedRadiusScale[i] = radiusScale;
+
+        // objects further inside than this from the plane are inside both eyes' planes in practice, so they skip the per-eye tests
+        for (int eye = 0; eye < 2; ++eye) {
+            for (const FrustumCorner& corner : corners[eye]) {
+                float eyeDist = glm::dot(glm::vec3(eyes[eye].planes[i]), corner.pos) + eyes[eye].planes[i].w;
+                if (std::abs(eyeDist) < 1e-3f * std::max(1.0f, glm::length(corner.pos))) {
+                    edgeBands[i] = std::max(edgeBands[i], glm::dot(normal, corner.pos) + offset);
+                }
+            }
+        }
+    }
+    hasCombined = true;
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+// The frustums of both eyes for a single pair of clip planes. Eyes without a known FOV are left out.
+// Once both eyes are added, finalize() merges them into a single conservative volume so that most objects only need 6 plane
+// tests instead of up to 12, and only objects near its edges are tested against the eyes separately.
+struct StereoFrustum {
+    std::array<Frustum, 2> eyes = {};
+    uint8_t eyeCount = 0;
+
+    // the combined volume contains both eyes, its radius scales make sure a sphere that passes the per-eye plane tests is never rejected
+    Frustum combined = {};
+    std::array<float, 6> combinedRadiusScale = {};
+    // per plane, how far inside the combined plane the eyes' own planes can still cut through. with parallel eyes only the left and right planes
+    // differ between them, so the other bands stay close to zero and only spheres near the sides get tested against each eye
+    std::array<float, 6> edgeBands = {};
+    bool hasCombined = false;
+
+    void addEye(const glm::mat4& viewProjection) {
+        eyes[eyeCount++].update(viewProjection);
+    }
+
+    void finalize();
+
+    bool checkSphereForEachEye(const glm::vec3& center, float radius) const {
+        for (uint8_t i = 0; i < eyeCount; ++i) {
+            if (eyes[i].checkSphere(center, radius)) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool checkSphere(const glm::vec3& center, float radius, bool refineEdges = true) const {
+        if (!hasCombined) {
+            return checkSphereForEachEye(center, radius);
+        }
+
+        bool nearEdge = false;
+        for (int i = 0; i < 6; ++i) {
+            float dist = glm::dot(glm::vec3(combined.planes[i]), center) + combined.planes[i].w;
+            float expandedRadius = radius * combinedRadiusScale[i];
+            if (dist < -expandedRadius) {
+                return false;
+            }
+            nearEdge |= dist < expandedRadius + edgeBands[i];
+        }
+        return !(refineEdges && nearEdge) || checkSphereForEachEye(center, radius);
+    }
+};
+
+// The game asks whether a position is visible for every object, while the eye frustums only change when the camera does.
+// Each thread that runs visibility queries keeps a few frustums around, keyed by the guest camera and the clip planes the game passes along,
+// until the camera hooks invalidate them. The game culls against more than one camera per frame (e.g. the main and the shadow camera),
+// which can share their clip planes.
+class StereoCullingCache {
+public:
+    static void Invalidate() { s_generation.fetch_add(1, std::memory_order_relaxed); }
+
+    template <typename BuildFn>
+    static const StereoFrustum& Get(uint32_t camPtr, float nearClip, float farClip, BuildFn&& build) {
+        thread_local StereoCullingCache s_cache;
+        return s_cache.GetOrBuild(camPtr, nearClip, farClip, std::forward<BuildFn>(build));
+    }
+
+    static uint64_t GetRebuilds() { return s_rebuilds.load(std::memory_order_relaxed); }
+
+private:
+    template <typename BuildFn>
+    const StereoFrustum& GetOrBuild(uint32_t camPtr, float nearClip, float farClip, BuildFn&& build) {
+        const uint32_t generation = s_generation.load(std::memory_order_relaxed);
+        for (Entry& entry : m_entries) {
+            if (entry.generation == generation && entry.camPtr == camPtr && entry.nearClip == nearClip && entry.farClip == farClip) {
+                return entry.frustum;
+            }
+        }
+
+        s_rebuilds.fetch_add(1, std::memory_order_relaxed);
+        Entry& entry = m_entries[m_nextEntry];
+        m_nextEntry = (m_nextEntry + 1) % m_entries.size();
+        entry.frustum = build(nearClip, farClip);
+        entry.camPtr = camPtr;
+        entry.nearClip = nearClip;
+        entry.farClip = farClip;
+        entry.generation = generation;
+        return entry.frustum;
+    }
+
+    struct Entry {
+        uint32_t generation = 0;
+        uint32_t camPtr = 0;
+        float nearClip = 0.0f;
+        float farClip = 0.0f;
+        StereoFrustum frustum;
+    };
+    std::array<Entry, 8> m_entries = {};
+    uint32_t m_nextEntry = 0;
+
+    static inline std::atomic_uint32_t s_generation = 1;
+    static inline std::atomic_uint64_t s_rebuilds = 0;
+};
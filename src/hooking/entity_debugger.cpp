@@ -1,14 +1,18 @@
 #include "pch.h"
 #include "entity_debugger.h"
 #include "instance.h"
+#include "guest_snapshot.h"
+#include "actor_table.h"
+#include "hand_gestures.h"
 #include "rendering/vulkan.h"
+#include "rendering/input_sampler.h"
 
 #include <imgui_memory_editor.h>
 
 #include "implot3d_internal.h"
 
 std::mutex g_actorListMutex;
-std::unordered_map<uint32_t, std::pair<std::string, uint32_t>> s_knownActors;
+ActorTable s_actorTable;
 glm::fvec3 CemuHooks::s_playerPos = {};
 uint32_t CemuHooks::s_playerMtxAddress = 0;
 uint32_t CemuHooks::s_cameraMtxAddress = 0;
@@ -21,27 +25,13 @@ void CemuHooks::hook_UpdateActorList(PPCInterpreter_t* hCPU) {
     // r7 holds actor list size
     // r5 holds current actor index
     // r6 holds current actor* list entry
-
-    // clear actor list when reiterating actor list again
-    if (hCPU->gpr[5] == 0) {
-        s_knownActors.clear();
-    }
-
-    uint32_t actorLinkPtr = hCPU->gpr[6] + offsetof(ActorWiiU, name) + offsetof(sead::FixedSafeString40, c_str);
-    uint32_t actorNamePtr = 0;
-    readMemoryBE(actorLinkPtr, &actorNamePtr);
-    if (actorNamePtr == 0)
+    const ActorTable::Actor* actor = s_actorTable.OnActorVisited(hCPU->gpr[5], hCPU->gpr[7], hCPU->gpr[6]);
+    if (actor == nullptr)
         return;
 
-    char* actorName = (char*)s_memoryBaseAddress + actorNamePtr;
+    // Log::print("Updating actor list [{}/{}] {:08x} - {}", hCPU->gpr[5], hCPU->gpr[7], hCPU->gpr[6], *actor->name);
 
-    if (actorName[0] != '\0') {
-        // Log::print("Updating actor list [{}/{}] {:08x} - {}", hCPU->gpr[5], hCPU->gpr[7], hCPU->gpr[6], actorName);
-        uint32_t actorId = hCPU->gpr[6] + stringToHash(actorName);
-        s_knownActors.emplace(actorId, std::make_pair(actorName, hCPU->gpr[6]));
-    }
-
-    // if (strcmp(actorName, "Weapon_Sword_056") == 0) {
+    // if (*actor->name == "Weapon_Sword_056") {
     //     // Log::print("Updating actor list [{}/{}] {:08x} - {}", hCPU->gpr[5], hCPU->gpr[7], hCPU->gpr[6], actorName);
     //     // float velocityY = 0.0f;
     //     // readMemoryBE(hCPU->gpr[6] + offsetof(ActorWiiU, velocity.y), &velocityY);
@@ -49,7 +39,7 @@ void CemuHooks::hook_UpdateActorList(PPCInterpreter_t* hCPU) {
     //     // writeMemoryBE(hCPU->gpr[6] + offsetof(ActorWiiU, velocity.y), &velocityY);
     //     s_currActorPtrs.emplace_back(hCPU->gpr[6]);
     // }
-     if (strcmp(actorName, "GameROMPlayer") == 0) {
+     if (actor->role == ActorTable::Role::PLAYER) {
          BEMatrix34 mtx = {};
          uint32_t actorMtxPtr = hCPU->gpr[6] + offsetof(ActorWiiU, mtx);
          readMemory(actorMtxPtr, &mtx);
@@ -59,109 +49,206 @@ void CemuHooks::hook_UpdateActorList(PPCInterpreter_t* hCPU) {
          //uint32_t vtableAddr = getMemory<BEType<uint32_t>>(hCPU->gpr[6] + offsetof(ActorWiiU, vtable)).getLE();
          //Log::print<INFO>("VTABLE = {:08X}", vtableAddr);
      }
-     else if (strcmp(actorName, "GameRomCamera") == 0) {
+     else if (actor->role == ActorTable::Role::CAMERA) {
          uint32_t actorMtxPtr = hCPU->gpr[6] + offsetof(ActorWiiU, mtx);
          s_cameraMtxAddress = actorMtxPtr;
      }
 }
 
+void CemuHooks::hook_CreateNewActor(PPCInterpreter_t* hCPU) {
+    hCPU->instructionPointer = hCPU->sprNew.LR;
+
+    // r3 holds the newly created actor, which might reuse the memory of an actor that got deleted since the last actor list walk
+    if (uint32_t actorPtr = hCPU->gpr[3]; actorPtr != 0) {
+        std::scoped_lock lock(g_actorListMutex);
+        s_actorTable.OnActorCreated(actorPtr);
+    }
+
+    // if (VRManager::instance().XR->GetRenderer() == nullptr || VRManager::instance().XR->GetRenderer()->m_layer3D.GetStatus() == RND_Renderer::Layer3D::Status3D::UNINITIALIZED) {
+    //     hCPU->gpr[3] = 0;
+    //     return;
+    // }
+    hCPU->gpr[3] = 0;
+
+    // OpenXR::InputState inputs = VRManager::instance().XR->m_input.load();
+    // if (!inputs.shared.in_game) {
+    //     hCPU->gpr[3] = 0;
+    //     return;
+    // }
+    //
+    // // test if controller is connected
+    // if (inputs.inGame.grab[OpenXR::EyeSide::LEFT].currentState == XR_TRUE && inputs.inGame.grab[OpenXR::EyeSide::LEFT].changedSinceLastSync == XR_TRUE) {
+    //     Log::print("Trying to spawn new thing!");
+    //     hCPU->gpr[3] = 1;
+    // }
+    // else if (inputs.inGame.grab[OpenXR::EyeSide::RIGHT].currentState == XR_TRUE && inputs.inGame.grab[OpenXR::EyeSide::RIGHT].changedSinceLastSync == XR_TRUE) {
+    //     Log::print("Trying to spawn new thing!");
+    //     hCPU->gpr[3] = 1;
+    // }
+    // else {
+    //     hCPU->gpr[3] = 0;
+    // }
+}
+
 // ksys::phys::RigidBodyFromShape::create to create a RigidBody from a shape
 // use Actor::getRigidBodyByName
 
-std::unordered_map<uint32_t, std::pair<std::string, uint32_t>> s_alreadyAddedActors;
+EntityDebugger::EntityDebugger(bool startRefreshThread) {
+    if (startRefreshThread) {
+        m_refreshThread = std::thread(&EntityDebugger::RefreshThread, this);
+    }
+}
+
+EntityDebugger::~EntityDebugger() {
+    m_shutdown.store(true);
+    m_refreshCondition.notify_all();
+    if (m_refreshThread.joinable()) {
+        m_refreshThread.join();
+    }
+}
 
 void EntityDebugger::UpdateEntityMemory() {
-    std::scoped_lock lock(g_actorListMutex);
+    // other systems might've added memory to the overlay too, so this doesn't only contain values from actors
+    std::scoped_lock lock(m_frozenMutex);
+    for (const FrozenValue& frozen : m_frozenValues) {
+        memcpy((void*)(CemuHooks::s_memoryBaseAddress + frozen.address), frozen.bytes.data(), frozen.size);
+    }
+}
 
-    // remove actors in s_alreadyAddedActors that are no longer in s_knownActors
-    for (const auto& hash : s_alreadyAddedActors | std::views::keys) {
-        if (!s_knownActors.contains(hash)) {
-            RemoveEntity(hash);
+void EntityDebugger::RefreshThread() {
+    std::vector<WatchedActor> actors;
+    while (!m_shutdown.load()) {
+        auto nextRefresh = std::chrono::steady_clock::now() + std::chrono::milliseconds(std::clamp(m_refreshIntervalMs.load(), 10, 1000));
+
+        if (GetSettings().ShowDebugOverlay() && CemuHooks::s_memoryBaseAddress != 0) {
+            {
+                std::scoped_lock lock(g_actorListMutex);
+                CollectActors(s_actorTable, actors);
+            }
+            RefreshEntities(actors);
         }
+
+        std::unique_lock lock(m_refreshMutex);
+        m_refreshCondition.wait_until(lock, nextRefresh, [this]() { return m_shutdown.load(); });
     }
+}
+
+void EntityDebugger::CollectActors(const ActorTable& table, std::vector<WatchedActor>& actors) {
+    actors.clear();
+    table.ForEach([&](ActorTable::Handle, const ActorTable::Actor& actor) {
+        actors.emplace_back(actor.id, actor.address, actor.name, actor.role == ActorTable::Role::PLAYER);
+    });
+}
 
-    s_alreadyAddedActors = s_knownActors;
+void EntityDebugger::RefreshEntities(std::span<const WatchedActor> actors) {
+    const uint32_t refresh = ++m_refreshCount;
+
+    std::string filter;
+    {
+        std::scoped_lock lock(m_entitiesMutex);
+        filter = m_filter.c_str();
+    }
 
     // find the current player (GameROMPlayer)
     BEMatrix34 playerPos = {};
-    for (const auto& actorData : s_knownActors | std::views::values) {
-        if (actorData.first == "GameROMPlayer") {
-            CemuHooks::readMemory(actorData.second + offsetof(ActorWiiU, mtx), &playerPos);
-            glm::fvec3 newPlayerPos = playerPos.getPos().getLE();
-            if (glm::distance(newPlayerPos, m_playerPos) > 25.0f) {
-                m_resetPlot = true;
-            }
-            m_playerPos = newPlayerPos;
-
-            // // set invisibility flag
-            // {
-            //     BEType<int32_t> flags = 0;
-            //     readMemory(actorData.second + offsetof(ActorWiiU, flags3), &flags);
-            //     flags = flags.getLE() | 0x800;
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, flags3), &flags);
-            // }
-            // {
-            //     BEType<int32_t> flags = 0;
-            //     readMemory(actorData.second + offsetof(ActorWiiU, flags2), &flags);
-            //     flags = flags.getLE() | 0x20;
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, flags2), &flags);
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, flags2Copy), &flags);
-            // }
-            // {
-            //     float lodDrawDistanceMultiplier = 0;
-            //     readMemory(actorData.second + offsetof(ActorWiiU, lodDrawDistanceMultiplier), &lodDrawDistanceMultiplier);
-            //     lodDrawDistanceMultiplier = 0.0f;
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, lodDrawDistanceMultiplier), &lodDrawDistanceMultiplier);
-            // }
-            // {
-            //     float startModelOpacity = 0;
-            //     readMemory(actorData.second + offsetof(ActorWiiU, startModelOpacity), &startModelOpacity);
-            //     startModelOpacity = 0.0f;
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, startModelOpacity), &startModelOpacity);
-            // }
-            // {
-            //     BEType<float> modelOpacity = 1.0f;
-            //     readMemory(actorData.second + offsetof(ActorWiiU, modelOpacity), &modelOpacity);
-            //     modelOpacity = 1.0f;
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, modelOpacity), &modelOpacity);
-            // }
-            // {
-            //     uint8_t opacityOrDoFlushOpacityToGPU = 0;
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU), &opacityOrDoFlushOpacityToGPU);
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU)+1, &opacityOrDoFlushOpacityToGPU);
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU)-1, &opacityOrDoFlushOpacityToGPU);
-            //     writeMemory(actorData.second + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU)-2, &opacityOrDoFlushOpacityToGPU);
-            // }
-        }
-        else if (actorData.first == "GameRomCamera") {
-            CemuHooks::readMemory(actorData.second + offsetof(ActorWiiU, mtx), &playerPos);
-            glm::fvec3 newPlayerPos = playerPos.getPos().getLE();
-        }
-        else if (actorData.first.starts_with("Weapon_Sword")) {
-            // BEType<float> modelOpacity = 1.0f;
-            // writeMemory(actorData.second + offsetof(ActorWiiU, modelOpacity), &modelOpacity);
-            // uint8_t opacityOrDoFlushOpacityToGPU = 1;
-            // writeMemory(actorData.second + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU), &opacityOrDoFlushOpacityToGPU);
+    if (auto player = std::ranges::find_if(actors, &WatchedActor::isPlayer); player != actors.end()) {
+        CemuHooks::readMemory(player->address + offsetof(ActorWiiU, mtx), &playerPos);
+        glm::fvec3 newPlayerPos = playerPos.getPos().getLE();
+
+        std::scoped_lock lock(m_entitiesMutex);
+        if (glm::distance(newPlayerPos, m_playerPos) > 25.0f) {
+            m_resetPlot = true;
         }
+        m_playerPos = newPlayerPos;
+
+        // // set invisibility flag
+        // {
+        //     BEType<int32_t> flags = 0;
+        //     readMemory(player->address + offsetof(ActorWiiU, flags3), &flags);
+        //     flags = flags.getLE() | 0x800;
+        //     writeMemory(player->address + offsetof(ActorWiiU, flags3), &flags);
+        // }
+        // {
+        //     BEType<int32_t> flags = 0;
+        //     readMemory(player->address + offsetof(ActorWiiU, flags2), &flags);
+        //     flags = flags.getLE() | 0x20;
+        //     writeMemory(player->address + offsetof(ActorWiiU, flags2), &flags);
+        //     writeMemory(player->address + offsetof(ActorWiiU, flags2Copy), &flags);
+        // }
+        // {
+        //     float lodDrawDistanceMultiplier = 0;
+        //     readMemory(player->address + offsetof(ActorWiiU, lodDrawDistanceMultiplier), &lodDrawDistanceMultiplier);
+        //     lodDrawDistanceMultiplier = 0.0f;
+        //     writeMemory(player->address + offsetof(ActorWiiU, lodDrawDistanceMultiplier), &lodDrawDistanceMultiplier);
+        // }
+        // {
+        //     float startModelOpacity = 0;
+        //     readMemory(player->address + offsetof(ActorWiiU, startModelOpacity), &startModelOpacity);
+        //     startModelOpacity = 0.0f;
+        //     writeMemory(player->address + offsetof(ActorWiiU, startModelOpacity), &startModelOpacity);
+        // }
+        // {
+        //     BEType<float> modelOpacity = 1.0f;
+        //     readMemory(player->address + offsetof(ActorWiiU, modelOpacity), &modelOpacity);
+        //     modelOpacity = 1.0f;
+        //     writeMemory(player->address + offsetof(ActorWiiU, modelOpacity), &modelOpacity);
+        // }
+        // {
+        //     uint8_t opacityOrDoFlushOpacityToGPU = 0;
+        //     writeMemory(player->address + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU), &opacityOrDoFlushOpacityToGPU);
+        //     writeMemory(player->address + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU)+1, &opacityOrDoFlushOpacityToGPU);
+        //     writeMemory(player->address + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU)-1, &opacityOrDoFlushOpacityToGPU);
+        //     writeMemory(player->address + offsetof(ActorWiiU, opacityOrDoFlushOpacityToGPU)-2, &opacityOrDoFlushOpacityToGPU);
+        // }
     }
 
-    // add actors that aren't in the overlay already
-    for (auto& [actorId, actorInfo] : s_knownActors) {
-        uint32_t actorPtr = actorInfo.second;
-        const std::string& actorName = actorInfo.first;
+    GuestSnapshot actorSnapshot;
+    for (const WatchedActor& actor : actors) {
+        uint32_t actorId = actor.id;
+        uint32_t actorPtr = actor.address;
+        const std::string& actorName = *actor.name;
+
+        // copy the actor once instead of once for every field, only weapon fields past the ActorWiiU part are read separately
+        actorSnapshot.capture(actorPtr, sizeof(ActorWiiU));
+
+        // the inspector is only drawing between actors, not while all of them get read
+        std::scoped_lock lock(m_entitiesMutex);
 
         auto addField = [&]<typename T>(const std::string& name, uint32_t offset) -> void {
             uint32_t address = actorPtr + offset;
-            AddOrUpdateEntity(actorId, actorName, name, address, CemuHooks::getMemory<T>(address), true);
+            AddOrUpdateEntity(actorId, actorName, name, address, actorSnapshot.contains(address, sizeof(T)) ? actorSnapshot.get<T>(address) : CemuHooks::getMemory<T>(address), true);
         };
 
+        // the memory editor itself only gets created once the range is opened in the inspector
         auto addMemoryRange = [&](const std::string& name, const uint32_t addressPtr, const uint32_t size) -> void {
             uint32_t address = 0;
             if (CemuHooks::readMemoryBE(addressPtr, &address); address != 0) {
-                AddOrUpdateEntity(actorId, actorName, name, address, MemoryRange{ address, address + size, std::make_unique<MemoryEditor>() }, true);
+                AddOrUpdateEntity(actorId, actorName, name, address, MemoryRange{ address, address + size, nullptr }, true);
             }
         };
 
+        BEMatrix34 mtx = actorSnapshot.get<BEMatrix34>(actorPtr + offsetof(ActorWiiU, mtx));
+        AddOrUpdateEntity(actorId, actorName, "mtx", actorPtr + offsetof(ActorWiiU, mtx), mtx, true);
+        if (playerPos.pos_x.getLE() != 0.0f) {
+            SetPosition(actorId, playerPos.getPos(), mtx.getPos());
+        }
+        SetRotation(actorId, mtx.getRotLE());
+
+        BEVec3 aabbMin = actorSnapshot.get<BEVec3>(actorPtr + offsetof(ActorWiiU, aabb.minX));
+        BEVec3 aabbMax = actorSnapshot.get<BEVec3>(actorPtr + offsetof(ActorWiiU, aabb.maxX));
+        if (aabbMin.x.getLE() != 0.0f) {
+            SetAABB(actorId, aabbMin.getLE(), aabbMax.getLE());
+        }
+
+        if (auto it = m_entities.find(actorId); it != m_entities.end()) {
+            it->second.lastRefresh = refresh;
+        }
+
+        // actors that are filtered out of the entity list only need their position for the world space inspector
+        if (!filter.empty() && actorName.find(filter) == std::string::npos) {
+            continue;
+        }
+
         if (actorName.starts_with("Weapon")) {
             addField.operator()<BEVec3>("Weapon::originalScale", offsetof(Weapon, originalScale));
             addMemoryRange("Weapon::actorAtk.struct7Ptr", actorPtr + offsetof(Weapon, actorAtk.struct7Ptr), 0x2D8);
@@ -180,19 +267,6 @@ void EntityDebugger::UpdateEntityMemory() {
             //Log::print<VERBOSE>("CanUseCamera = {:08X}", hexFlags);
         }
 
-        BEMatrix34 mtx = CemuHooks::getMemory<BEMatrix34>(actorPtr + offsetof(ActorWiiU, mtx));
-        AddOrUpdateEntity(actorId, actorName, "mtx", actorPtr + offsetof(ActorWiiU, mtx), mtx);
-        if (playerPos.pos_x.getLE() != 0.0f) {
-            SetPosition(actorId, playerPos.getPos(), mtx.getPos());
-        }
-        SetRotation(actorId, mtx.getRotLE());
-
-        BEVec3 aabbMin = CemuHooks::getMemory<BEVec3>(actorPtr + offsetof(ActorWiiU, aabb.minX));
-        BEVec3 aabbMax = CemuHooks::getMemory<BEVec3>(actorPtr + offsetof(ActorWiiU, aabb.maxX));
-        if (aabbMin.x.getLE() != 0.0f) {
-            SetAABB(actorId, aabbMin.getLE(), aabbMax.getLE());
-        }
-
         // uint32_t physicsMtxPtr = 0;
         // if (readMemoryBE(actorPtr + offsetof(ActorWiiU, physicsMtxPtr), &physicsMtxPtr); physicsMtxPtr != 0) {
         //     overlay->AddOrUpdateEntity(actorId, actorName, "physicsMtx", physicsMtxPtr, getMemory<BEMatrix34>(physicsMtxPtr));
@@ -225,41 +299,51 @@ void EntityDebugger::UpdateEntityMemory() {
         // addField.operator()<float>("lodDrawDistanceMultiplier", offsetof(ActorWiiU, lodDrawDistanceMultiplier));
     }
 
-    // other systems might've added memory to the overlay, so hence this is a separate loop
-    for (auto& entity : m_entities | std::views::values) {
-        if (!entity.isEntity)
-            continue;
+    std::scoped_lock lock(m_entitiesMutex);
+
+    // remove the actors that weren't refreshed, so the ones that are no longer in the actor table
+    size_t removedEntities = std::erase_if(m_entities, [&](const auto& entity) {
+        return entity.second.isEntity && entity.second.lastRefresh != refresh;
+    });
+    if (removedEntities > 0) {
+        RebuildFrozenValues();
+    }
+
+    // give priority to frozen entities
+    std::vector<std::pair<float, uint32_t>> sortedEntities;
+    sortedEntities.reserve(m_entities.size());
+    for (const auto& [entityId, entity] : m_entities) {
+        bool isAnyValueFrozen = std::ranges::any_of(entity.values, [](auto& value) { return value.frozen; });
+        sortedEntities.emplace_back(isAnyValueFrozen ? 0.0f - entity.priority : entity.priority, entityId);
+    }
+    std::ranges::sort(sortedEntities);
+    m_sortedEntityIds.clear();
+    for (const auto& entityId : sortedEntities | std::views::values) {
+        m_sortedEntityIds.emplace_back(entityId);
+    }
+}
 
-        for (auto& value : entity.values) {
+void EntityDebugger::RebuildFrozenValues() {
+    std::vector<FrozenValue> frozenValues;
+    for (const auto& entity : m_entities | std::views::values) {
+        for (const auto& value : entity.values) {
             if (!value.frozen)
                 continue;
 
             std::visit([&](auto&& arg) {
                 using T = std::decay_t<decltype(arg)>;
-                if constexpr (std::is_same_v<T, BEType<uint32_t>>) {
-                    CemuHooks::setMemory(value.value_address, arg);
-                }
-                else if constexpr (std::is_same_v<T, BEType<int32_t>>) {
-                    CemuHooks::setMemory(value.value_address, arg);
-                }
-                else if constexpr (std::is_same_v<T, BEType<float>>) {
-                    CemuHooks::setMemory(value.value_address, arg);
-                }
-                else if constexpr (std::is_same_v<T, BEVec3>) {
-                    CemuHooks::setMemory(value.value_address, arg);
-                }
-                else if constexpr (std::is_same_v<T, BEMatrix34>) {
-                    CemuHooks::setMemory(value.value_address, arg);
-                }
-                else if constexpr (std::is_same_v<T, uint8_t>) {
-                    CemuHooks::setMemory(value.value_address, arg);
+                if constexpr (!std::is_same_v<T, MemoryRange> && !std::is_same_v<T, std::string>) {
+                    static_assert(sizeof(T) <= sizeof(FrozenValue::bytes));
+                    FrozenValue& frozen = frozenValues.emplace_back(value.value_address, (uint32_t)sizeof(T));
+                    memcpy(frozen.bytes.data(), &arg, sizeof(T));
                 }
             }, value.value);
-
         }
     }
-}
 
+    std::scoped_lock lock(m_frozenMutex);
+    m_frozenValues = std::move(frozenValues);
+}
 
 void DrawAABBInPlot(glm::fvec3 pos, glm::fvec3& min, glm::fvec3& max, glm::fquat& rotation) {
     glm::fvec3 corners[8] = {
@@ -297,10 +381,17 @@ void DrawAABBInPlot(glm::fvec3 pos, glm::fvec3& min, glm::fvec3& max, glm::fquat
 void EntityDebugger::DrawEntityInspector() {
     ImGui::Begin("BetterVR Debugger");
 
+    std::scoped_lock lock(m_entitiesMutex);
+
     static char buf[256];
     ImGui::InputText("Entity Filter", buf, std::size(buf));
     m_filter = buf;
 
+    int refreshIntervalMs = m_refreshIntervalMs.load();
+    if (ImGui::SliderInt("Refresh Interval (ms)", &refreshIntervalMs, 10, 1000)) {
+        m_refreshIntervalMs.store(refreshIntervalMs);
+    }
+
     ImGui::BeginChild("ScrollArea", ImVec2(0, 0));
 
     if (ImGui::CollapsingHeader("World Space Inspector")) {
@@ -353,27 +444,37 @@ void EntityDebugger::DrawEntityInspector() {
         }
     }
 
+    constexpr size_t MAX_GESTURE_EVENT_LOG = 16;
+    HandGestureRecognizer::Get().ConsumeEvents(m_gestureEventCursor, [this](const HandGestureRecognizer::Event& event) {
+        m_gestureEventLog.emplace_front(std::format("{:.2f}s: {} hand {} the {} slot", (double)event.time / 1e9, event.hand == OpenXR::EyeSide::LEFT ? "left" : "right", event.entered ? "entered" : "left", HandGestureRecognizer::GetSlotName(event.slot)));
+        if (m_gestureEventLog.size() > MAX_GESTURE_EVENT_LOG)
+            m_gestureEventLog.pop_back();
+    });
+    if (ImGui::CollapsingHeader("Hand Gestures")) {
+        for (const std::string& line : m_gestureEventLog) {
+            ImGui::TextUnformatted(line.c_str());
+        }
+    }
+
     // display entities
     if (ImGui::CollapsingHeader("Entity List")) {
-        // sort m_entities by priority
-        std::multimap<float, std::reference_wrapper<Entity>> sortedEntities;
-        for (auto& entity : m_entities | std::views::values) {
-            if (m_filter.empty() || entity.name.find(m_filter) != std::string::npos) {
-                bool isAnyValueFrozen = std::ranges::any_of(entity.values, [](auto& value) { return value.frozen; });
-                // give priority to frozen entities
-                sortedEntities.emplace(isAnyValueFrozen ? 0.0f - entity.priority : entity.priority, entity);
-            }
-        }
+        bool valuesChanged = false;
+        for (uint32_t entityId : m_sortedEntityIds) {
+            auto entityIt = m_entities.find(entityId);
+            if (entityIt == m_entities.end() || entityIt->second.values.empty())
+                continue;
+            if (!m_filter.empty() && entityIt->second.name.find(m_filter) == std::string::npos)
+                continue;
 
-        for (auto& entity : sortedEntities | std::views::values) {
-            std::string id = entity.get().name + "##" + std::to_string(entity.get().values[0].value_address);
-            ImGui::Text(std::format("{}: dist={}", entity.get().name, std::abs(entity.get().priority)).c_str());
+            Entity& entity = entityIt->second;
+            std::string id = entity.name + "##" + std::to_string(entity.values[0].value_address);
+            ImGui::Text(std::format("{}: dist={}", entity.name, std::abs(entity.priority)).c_str());
             ImGui::PushID(id.c_str());
 
-            for (auto& value : entity.get().values) {
+            for (auto& value : entity.values) {
                 ImGui::PushID(value.value_name.c_str());
 
-                ImGui::Checkbox("##Frozen", &value.frozen);
+                valuesChanged |= ImGui::Checkbox("##Frozen", &value.frozen);
                 ImGui::SameLine();
                 if (ImGui::Button("Copy")) {
                     ImGui::SetClipboardText(std::format("0x{:08x}", value.value_address).c_str());
@@ -389,30 +490,35 @@ void EntityDebugger::DrawEntityInspector() {
                         uint32_t val = std::get<BEType<uint32_t>>(value.value).getLE();
                         if (ImGui::DragScalar(value.value_name.c_str(), ImGuiDataType_U32, &val)) {
                             std::get<BEType<uint32_t>>(value.value) = val;
+                            valuesChanged = true;
                         }
                     }
                     else if constexpr (std::is_same_v<T, BEType<int32_t>>) {
                         int32_t val = std::get<BEType<int32_t>>(value.value).getLE();
                         if (ImGui::DragScalar(value.value_name.c_str(), ImGuiDataType_S32, &val)) {
                             std::get<BEType<int32_t>>(value.value) = val;
+                            valuesChanged = true;
                         }
                     }
                     else if constexpr (std::is_same_v<T, BEType<float>>) {
                         float val = std::get<BEType<float>>(value.value).getLE();
                         if (ImGui::DragScalar(value.value_name.c_str(), ImGuiDataType_Float, &val)) {
                             std::get<BEType<float>>(value.value) = val;
+                            valuesChanged = true;
                         }
                     }
                     else if constexpr (std::is_same_v<T, BEType<uint8_t>>) {
                         uint8_t val = std::get<BEType<uint8_t>>(value.value).getLE();
                         if (ImGui::DragScalar(value.value_name.c_str(), ImGuiDataType_U8, &val)) {
                             std::get<BEType<uint8_t>>(value.value) = val;
+                            valuesChanged = true;
                         }
                     }
                     else if constexpr (std::is_same_v<T, BEType<uint16_t>>) {
                         uint16_t val = std::get<BEType<uint16_t>>(value.value).getLE();
                         if (ImGui::DragScalar(value.value_name.c_str(), ImGuiDataType_U16, &val)) {
                             std::get<BEType<uint16_t>>(value.value) = val;
+                            valuesChanged = true;
                         }
                     }
                     else if constexpr (std::is_same_v<T, BEVec3>) {
@@ -421,6 +527,7 @@ void EntityDebugger::DrawEntityInspector() {
                             std::get<BEVec3>(value.value).x = xyz[0];
                             std::get<BEVec3>(value.value).y = xyz[1];
                             std::get<BEVec3>(value.value).z = xyz[2];
+                            valuesChanged = true;
                         }
                     }
                     else if constexpr (std::is_same_v<T, BEMatrix34>) {
@@ -431,6 +538,7 @@ void EntityDebugger::DrawEntityInspector() {
                             ImGui::Indent(); bool row2Changed = ImGui::DragFloat4("Row 2", &mtx[2].x, 10.0f, 0, 0, nullptr, ImGuiSliderFlags_NoRoundToFormat); ImGui::Unindent();
                             if (row0Changed || row1Changed || row2Changed) {
                                 std::get<BEMatrix34>(value.value).setLEMatrix(mtx);
+                                valuesChanged = true;
                             }
                         }
                         else {
@@ -439,6 +547,7 @@ void EntityDebugger::DrawEntityInspector() {
                                 std::get<BEMatrix34>(value.value).pos_x = xyz[0];
                                 std::get<BEMatrix34>(value.value).pos_y = xyz[1];
                                 std::get<BEMatrix34>(value.value).pos_z = xyz[2];
+                                valuesChanged = true;
                             }
                         }
 
@@ -454,6 +563,9 @@ void EntityDebugger::DrawEntityInspector() {
                         }
                         if (value.expanded) {
                             auto& mem_edit = std::get<MemoryRange>(value.value).editor;
+                            if (mem_edit == nullptr) {
+                                mem_edit = std::make_unique<MemoryEditor>();
+                            }
                             uint32_t data = std::get<MemoryRange>(value.value).start;
                             uint32_t size = std::get<MemoryRange>(value.value).end - std::get<MemoryRange>(value.value).start;
                             std::string windowName = std::format("{} at {:08X} with size of {:08X}", value.value_name, value.value_address, size);
@@ -476,6 +588,10 @@ void EntityDebugger::DrawEntityInspector() {
 
             ImGui::PopID();
         }
+
+        if (valuesChanged) {
+            RebuildFrozenValues();
+        }
     }
     ImGui::EndChild();
     ImGui::End();
@@ -660,6 +776,8 @@ void EntityDebugger::DrawFPSOverlayContent(RND_Renderer* renderer, bool renderTe
         ImGui::Text("");
         ImGui::Text("OpenXR waited %.1f ms so that it can interpolate/have low latency.", waitMs);
         ImGui::Text("Theoretically, it'd run at %.1f FPS if that didn't matter", workFps);
+        ImGui::Text("Head pose was sampled %.1f ms later than the frame start, %.1f ms before being displayed", (float)renderer->GetLastLatchGainMs(), (float)renderer->GetLastLatchPredictionMs());
+        ImGui::Text("Controller input was %.1f ms old when the game read it (%.1f ms on average, %.0f%% sampled on read)", (float)InputSampler::GetLastInputAgeMs(), (float)InputSampler::GetAverageInputAgeMs(), (float)(InputSampler::GetVPADSampleRatio() * 100.0));
     }
 
     if (predictedHz > 0.0f && workFps >= 0.0f) {
@@ -758,4 +876,4 @@ void EntityDebugger::DrawFPSOverlayContent(RND_Renderer* renderer, bool renderTe
 
         ImPlot::EndPlot();
     }
-}
\ No newline at end of file
+}
@@ -1,6 +1,8 @@
 #pragma once
 
 #include <imgui_memory_editor.h>
+#include <condition_variable>
+#include <deque>
 
 struct MemoryRange {
     uint32_t start;
@@ -13,14 +15,31 @@ using ValueVariant = std::variant<BEType<uint32_t>, BEType<int32_t>, BEType<uint
 
 class EntityDebugger {
 public:
+    // the actor fields are read on a separate thread, the benchmark creates a debugger without one to refresh it manually
+    explicit EntityDebugger(bool startRefreshThread = true);
+    ~EntityDebugger();
+
     void AddOrUpdateEntity(uint32_t actorId, const std::string& entityName, const std::string& valueName, uint32_t address, ValueVariant&& value, bool isEntity = false);
     void SetPosition(uint32_t actorId, const BEVec3& ws_playerPos, const BEVec3& ws_entityPos);
     void SetRotation(uint32_t actorId, const glm::fquat rotation);
     void SetAABB(uint32_t actorId, glm::fvec3 min, glm::fvec3 max);
     void RemoveEntity(uint32_t actorId);
     void RemoveEntityValue(uint32_t actorId, const std::string& valueName);
+    // called once per guest frame, only writes the frozen values back to the game
     void UpdateEntityMemory();
 
+    struct WatchedActor {
+        uint32_t id;
+        uint32_t address;
+        const std::string* name;
+        bool isPlayer;
+    };
+    static void CollectActors(const class ActorTable& table, std::vector<WatchedActor>& actors);
+    // reads the actors into m_entities, only actors that match the filter get all of their fields refreshed
+    void RefreshEntities(std::span<const WatchedActor> actors);
+    // needs to be called with m_entitiesMutex locked whenever a value gets (un)frozen or edited
+    void RebuildFrozenValues();
+
     void UpdateKeyboardControls();
     void DrawEntityInspector();
     static void DrawFPSOverlay(class RND_Renderer* renderer);
@@ -43,16 +62,42 @@ public:
         glm::fvec3 aabbMin;
         glm::fvec3 aabbMax;
         std::vector<EntityValue> values;
+        uint32_t lastRefresh = 0;
     };
 
+    // locked by the refresh thread while it updates an actor and by DrawEntityInspector while it draws
+    std::mutex m_entitiesMutex;
     std::unordered_map<uint32_t, Entity> m_entities;
+    // sorted by the refresh thread, so that drawing doesn't have to
+    std::vector<uint32_t> m_sortedEntityIds;
     glm::fvec3 m_playerPos = {};
     bool m_resetPlot = false;
+    std::atomic_int32_t m_refreshIntervalMs = 100;
 
 private:
+    void RefreshThread();
+
+    struct FrozenValue {
+        uint32_t address;
+        uint32_t size;
+        std::array<std::byte, sizeof(BEMatrix34)> bytes;
+    };
+    std::mutex m_frozenMutex;
+    std::vector<FrozenValue> m_frozenValues;
+
+    uint32_t m_refreshCount = 0;
+    std::atomic_bool m_shutdown = false;
+    std::mutex m_refreshMutex;
+    std::condition_variable m_refreshCondition;
+    std::thread m_refreshThread;
+
     std::string m_filter = std::string(256, '\0');
     bool m_disablePoints = true;
     bool m_disableTexts = false;
     bool m_disableRotations = true;
     bool m_disableAABBs = false;
+
+    // the newest body slot changes of the hands, read from the gesture events since the last time the debugger was drawn
+    uint64_t m_gestureEventCursor = 0;
+    std::deque<std::string> m_gestureEventLog;
 };
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "frame_context.h"
+#include "instance.h"
+
+thread_local HookFrameContext::ThreadFrame HookFrameContext::s_threadFrame;
+SeqLock<HookFrameContext::CapturedFrame> HookFrameContext::s_capturedFrame;
+std::atomic_uint32_t HookFrameContext::s_generation = 0;
+std::atomic<SeqLock<OpenXR::GameState>*> HookFrameContext::s_gameState = nullptr;
+std::mutex HookFrameContext::s_storeMutex;
+std::atomic_uint64_t HookFrameContext::s_snapshotLoads = 0;
+std::atomic_uint32_t HookFrameContext::s_frameSnapshotLoads = 0;
+std::atomic_uint32_t HookFrameContext::s_lastFrameSnapshotLoads = 0;
+
+void HookFrameContext::Capture() {
+    Capture(VRManager::instance().XR->m_input, VRManager::instance().XR->m_gameState);
+}
+
+// copies the bytes of changed that differ from stored over target. the hooks on other threads can store their own changes in the meantime,
+// and most fields are bools, so this keeps the changes of every hook to neighbouring fields
+static void ApplyChangedBytes(OpenXR::GameState& target, const OpenXR::GameState& changed, const OpenXR::GameState& stored) {
+    auto* targetBytes = reinterpret_cast<uint8_t*>(&target);
+    const auto* changedBytes = reinterpret_cast<const uint8_t*>(&changed);
+    const auto* storedBytes = reinterpret_cast<const uint8_t*>(&stored);
+    for (size_t i = 0; i < sizeof(OpenXR::GameState); ++i) {
+        if (changedBytes[i] != storedBytes[i]) {
+            targetBytes[i] = changedBytes[i];
+        }
+    }
+}
+
+void HookFrameContext::Capture(const SeqLock<OpenXR::InputState>& input, SeqLock<OpenXR::GameState>& gameState) {
+    s_lastFrameSnapshotLoads.store(s_frameSnapshotLoads.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+
+    s_gameState.store(&gameState, std::memory_order_relaxed);
+    CapturedFrame captured = { s_generation.load(std::memory_order_relaxed) + 1, input.load(), gameState.load() };
+    CountSnapshotLoads(1);
+    s_capturedFrame.store(captured);
+    s_generation.store(captured.generation, std::memory_order_release);
+
+    // the thread that captured it doesn't need to load it again
+    SetThreadFrame(captured);
+}
+
+void HookFrameContext::SetThreadFrame(const CapturedFrame& captured) {
+    // a hook that was still running on this thread when the frame got captured keeps the changes that it didn't store yet
+    OpenXR::GameState gameState = captured.gameState;
+    ApplyChangedBytes(gameState, s_threadFrame.gameState, s_threadFrame.storedGameState);
+
+    s_threadFrame.generation = captured.generation;
+    s_threadFrame.input = captured.input;
+    s_threadFrame.gameState = gameState;
+    s_threadFrame.storedGameState = captured.gameState;
+}
+
+HookFrameContext::ThreadFrame& HookFrameContext::GetThreadFrame() {
+    if (s_threadFrame.generation != s_generation.load(std::memory_order_acquire)) {
+        SetThreadFrame(s_capturedFrame.load());
+        CountSnapshotLoads(1);
+    }
+    return s_threadFrame;
+}
+
+void HookFrameContext::StoreGameState() {
+    ThreadFrame& frame = GetThreadFrame();
+    SeqLock<OpenXR::GameState>* gameState = s_gameState.load(std::memory_order_relaxed);
+    if (gameState == nullptr || memcmp(&frame.gameState, &frame.storedGameState, sizeof(OpenXR::GameState)) == 0) {
+        return;
+    }
+
+    std::lock_guard lock(s_storeMutex);
+    OpenXR::GameState newest = gameState->load();
+    CountSnapshotLoads(1);
+    ApplyChangedBytes(newest, frame.gameState, frame.storedGameState);
+    gameState->store(newest);
+    frame.storedGameState = frame.gameState;
+}
@@ -0,0 +1,56 @@
+#pragma once
+#include "rendering/openxr.h"
+
+// The input and game state that the hooks read, captured once per guest frame by hook_UpdateSettings.
+// hook_ChangeWeaponMtx runs for every weapon matrix update and hook_ModifyBoneMatrix for every bone, so loading them from their SeqLocks
+// in each call added up to hundreds of loads per frame, and bones of the same frame could end up with poses from different XR frames.
+// The game runs these hooks on more than one PPC thread, so each thread copies the captured frame the first time it needs it during a frame.
+class HookFrameContext {
+public:
+    static void Capture();
+    static void Capture(const SeqLock<OpenXR::InputState>& input, SeqLock<OpenXR::GameState>& gameState);
+
+    static const OpenXR::InputState& GetInput() { return GetThreadFrame().input; }
+
+    // the game state from the start of the frame, plus the changes that the hooks on this thread made to it since.
+    // the hooks that change it call StoreGameState afterwards, which only publishes the parts that this thread changed, so that hooks
+    // on other threads don't undo each other's changes. the VPAD read needs the newest input instead of the one from the start of the
+    // frame, so it loads and stores its input through InputSampler
+    static OpenXR::GameState& GetGameState() { return GetThreadFrame().gameState; }
+    static void StoreGameState();
+
+    // amount of times the hooks loaded the input or game state from their SeqLocks during the last complete guest frame,
+    // which is once for the capture and once for every other thread that used it
+    static uint32_t GetLastFrameSnapshotLoads() { return s_lastFrameSnapshotLoads.load(std::memory_order_relaxed); }
+    static uint64_t GetSnapshotLoads() { return s_snapshotLoads.load(std::memory_order_relaxed); }
+
+private:
+    struct CapturedFrame {
+        uint32_t generation = 0;
+        OpenXR::InputState input = {};
+        OpenXR::GameState gameState = {};
+    };
+
+    struct ThreadFrame : CapturedFrame {
+        // the game state as this thread last captured or stored it, to find out what StoreGameState needs to publish
+        OpenXR::GameState storedGameState = {};
+    };
+
+    static ThreadFrame& GetThreadFrame();
+    static void SetThreadFrame(const CapturedFrame& captured);
+
+    static void CountSnapshotLoads(uint32_t loads) {
+        s_snapshotLoads.fetch_add(loads, std::memory_order_relaxed);
+        s_frameSnapshotLoads.fetch_add(loads, std::memory_order_relaxed);
+    }
+
+    static thread_local ThreadFrame s_threadFrame;
+    static SeqLock<CapturedFrame> s_capturedFrame;
+    static std::atomic_uint32_t s_generation;
+    static std::atomic<SeqLock<OpenXR::GameState>*> s_gameState;
+    static std::mutex s_storeMutex;
+
+    static std::atomic_uint64_t s_snapshotLoads;
+    static std::atomic_uint32_t s_frameSnapshotLoads;
+    static std::atomic_uint32_t s_lastFrameSnapshotLoads;
+};
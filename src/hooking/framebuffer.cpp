@@ -1,6 +1,7 @@
 #include "framebuffer.h"
 #include "instance.h"
 #include "layer.h"
+#include "utils/frame_recorder.h"
 #include "utils/vulkan_utils.h"
 
 
@@ -18,6 +19,10 @@ using namespace VRLayer;
 VkResult VkDeviceOverrides::CreateImage(const vkroots::VkDeviceDispatch& pDispatch, VkDevice device, const VkImageCreateInfo* pCreateInfo, const VkAllocationCallbacks* pAllocator, VkImage* pImage) {
     VkResult res = pDispatch.CreateImage(device, pCreateInfo, pAllocator, pImage);
 
+    if (auto* recorder = FrameRecorder::Get()) {
+        recorder->RecordCreateImage(pCreateInfo, *pImage, res);
+    }
+
     if (pCreateInfo->extent.width >= 1280 && pCreateInfo->extent.height >= 720) {
         lockImageResolutions.lock();
         checkAssert(imageResolutions.try_emplace(*pImage, std::make_pair(VkExtent2D{ pCreateInfo->extent.width, pCreateInfo->extent.height }, pCreateInfo->format)).second, "Couldn't insert image resolution into map!");
@@ -27,6 +32,10 @@ VkResult VkDeviceOverrides::CreateImage(const vkroots::VkDeviceDispatch& pDispat
 }
 
 void VkDeviceOverrides::DestroyImage(const vkroots::VkDeviceDispatch& pDispatch, VkDevice device, VkImage image, const VkAllocationCallbacks* pAllocator) {
+    if (auto* recorder = FrameRecorder::Get()) {
+        recorder->RecordDestroyImage(image);
+    }
+
     lockImageResolutions.lock();
     imageResolutions.erase(image);
     if (s_curr3DColorImage == image) {
@@ -54,6 +63,10 @@ void CemuHooks::hook_FixCameraSaveFilesAndInventory(PPCInterpreter_t* hCPU) {
 
 
 void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatch& pDispatch, VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, const VkClearColorValue* pColor, uint32_t rangeCount, const VkImageSubresourceRange* pRanges) {
+    if (auto* recorder = FrameRecorder::Get()) {
+        recorder->RecordClearColorImage(commandBuffer, image, imageLayout, pColor, rangeCount, pRanges);
+    }
+
     // check whether the magic values are there, and which order they are in to determine which eye
     OpenXR::EyeSide side = (OpenXR::EyeSide)-1;
     if (pColor->float32[1] >= 0.12 && pColor->float32[1] <= 0.13 && pColor->float32[2] >= 0.97 && pColor->float32[2] <= 0.99) {
@@ -275,6 +288,10 @@ void VkDeviceOverrides::CmdClearColorImage(const vkroots::VkCommandBufferDispatc
 }
 
 void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBufferDispatch& pDispatch, VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, const VkClearDepthStencilValue* pDepthStencil, uint32_t rangeCount, const VkImageSubresourceRange* pRanges) {
+    if (auto* recorder = FrameRecorder::Get()) {
+        recorder->RecordClearDepthStencilImage(commandBuffer, image, imageLayout, pDepthStencil, rangeCount, pRanges);
+    }
+
     // check for magical clear values
     // check order and whether there's a match with the magical clear value
     OpenXR::EyeSide side = (OpenXR::EyeSide)-1;
@@ -290,10 +307,14 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
         const uint32_t frameCounter = pDepthStencil->stencil;
         checkAssert(frameCounter == 0 || frameCounter == 1, "Invalid frame counter for depth clear!");
 
-        auto& layer3D = VRManager::instance().XR->GetRenderer()->m_layer3D;
-        auto& layer2D = VRManager::instance().XR->GetRenderer()->m_layer2D;
+        auto* renderer = VRManager::instance().XR->GetRenderer();
+        if (!renderer) {
+            Log::print<RENDERING>("Renderer is not initialized yet!");
+            return pDispatch.CmdClearDepthStencilImage(commandBuffer, image, imageLayout, pDepthStencil, rangeCount, pRanges);
+        }
+        auto& layer3D = renderer->m_layer3D;
 
-        if (!VRManager::instance().XR->GetRenderer()->IsInitialized()) {
+        if (!renderer->IsInitialized()) {
             return;
         }
 
@@ -326,7 +347,7 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
                 return;
             }
 
-            if (VRManager::instance().XR->GetRenderer()->GetFrame(frameCounter).copiedDepth[side]) {
+            if (renderer->GetFrame(frameCounter).copiedDepth[side]) {
                 // the depth texture has already been copied to the layer
                 Log::print<RENDERING>("A depth texture is already bound for the current frame!");
                 returnToLayout();
@@ -342,7 +363,7 @@ void VkDeviceOverrides::CmdClearDepthStencilImage(const vkroots::VkCommandBuffer
             // checkAssert(layer3D.GetStatus() == Status3D::LEFT_BINDING_COLOR || layer3D.GetStatus() == Status3D::RIGHT_BINDING_COLOR, "3D layer is not in the correct state for capturing depth images!");
 
             SharedTexture* texture = layer3D->CopyDepthToLayer(side, commandBuffer, image, frameCounter);
-            VRManager::instance().XR->GetRenderer()->On3DDepthCopied(side, frameCounter);
+            renderer->On3DDepthCopied(side, frameCounter);
 
             {
                 std::lock_guard lk(s_activeCopyMutex);
@@ -471,6 +492,10 @@ VkResult VkDeviceOverrides::QueueSubmit(const vkroots::VkQueueDispatch& pDispatc
         Log::print<ERROR>("QueueSubmit failed with error {}", result);
     }
 
+    if (auto* recorder = FrameRecorder::Get()) {
+        recorder->RecordQueueSubmit(queue, submitCount, pSubmits, result);
+    }
+
     return result;
 }
 
@@ -485,5 +510,10 @@ VkResult VkDeviceOverrides::QueuePresentKHR(const vkroots::VkQueueDispatch& pDis
         renderer->StartFrame();
     }
 
-    return pDispatch.QueuePresentKHR(queue, pPresentInfo);
+    VkResult result = pDispatch.QueuePresentKHR(queue, pPresentInfo);
+
+    if (auto* recorder = FrameRecorder::Get()) {
+        recorder->RecordQueuePresent(queue, pPresentInfo, result);
+    }
+    return result;
 }
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "cemu_hooks.h"
+
+// Describes a single member of one of the guest structs from game_structs.h, so that hooks can read just the fields they need
+// instead of copying the whole struct (e.g. Weapon is over 0xA00 bytes). The offset and type come straight from the struct layout.
+template <typename Struct, typename Field, size_t Offset>
+struct GuestField {
+    using StructType = Struct;
+    using Type = Field;
+    static constexpr size_t OFFSET = Offset;
+
+    static_assert(Offset + sizeof(Field) <= sizeof(Struct), "Guest field lies outside of its struct");
+    static_assert(std::is_trivially_copyable_v<Field>, "Guest fields are copied straight from guest memory");
+};
+
+#define GUEST_FIELD(Struct, member) GuestField<Struct, decltype(Struct::member), offsetof(Struct, member)>
+
+// only copies the field itself, the BEType<T> members are swapped once they're read with getLE()
+template <typename Field>
+typename Field::Type readGuestField(uint32_t structAddress) {
+    typename Field::Type result;
+    CemuHooks::readMemory(structAddress + Field::OFFSET, &result);
+    return result;
+}
+
+// e.g. auto [name, type] = readGuestFields<WeaponFields::Name, WeaponFields::Type>(weaponPtr);
+template <typename... Fields>
+std::tuple<typename Fields::Type...> readGuestFields(uint32_t structAddress) {
+    return { readGuestField<Fields>(structAddress)... };
+}
+
+template <typename Field>
+void writeGuestField(uint32_t structAddress, typename Field::Type value) {
+    CemuHooks::writeMemory(structAddress + Field::OFFSET, &value);
+}
+
+namespace WeaponFields {
+    using Name = GUEST_FIELD(Weapon, name);
+    using Flags2 = GUEST_FIELD(Weapon, flags2);
+    using Type = GUEST_FIELD(Weapon, type);
+    using OriginalScale = GUEST_FIELD(Weapon, originalScale);
+
+    // known offsets from the game's code, these fail to compile if the struct layout in game_structs.h ever drifts
+    static_assert(Name::OFFSET == 0x04, "Weapon.name offset mismatch");
+    static_assert(Flags2::OFFSET == 0x364, "Weapon.flags2 offset mismatch");
+    static_assert(Type::OFFSET == 0x938, "Weapon.type offset mismatch");
+    static_assert(std::is_same_v<Type::Type, BEType<WeaponType>>, "Weapon.type should be a big-endian WeaponType");
+}
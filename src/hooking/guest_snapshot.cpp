@@ -0,0 +1,67 @@
+#include "guest_snapshot.h"
+#include <intrin.h>
+
+namespace {
+    void SwapWords32Scalar(const uint8_t* src, uint32_t* dst, size_t start, size_t count) {
+        for (size_t i = start; i < count; ++i) {
+            uint32_t word;
+            memcpy(&word, src + i * 4, sizeof(word));
+            dst[i] = swapEndianness(word);
+        }
+    }
+
+    // only needs SSE2, which every x64 CPU has
+    size_t SwapWords32SSE2(const uint8_t* src, uint32_t* dst, size_t count) {
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128i words = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            // swap the 16-bit halves of each word, then the bytes within each half
+            words = _mm_shufflehi_epi16(_mm_shufflelo_epi16(words, 0xB1), 0xB1);
+            words = _mm_or_si128(_mm_slli_epi16(words, 8), _mm_srli_epi16(words, 8));
+            _mm_storeu_si128((__m128i*)(dst + i), words);
+        }
+        return i;
+    }
+
+#if defined(__SSSE3__) || (defined(_MSC_VER) && !defined(__clang__))
+    constexpr bool SSSE3_AVAILABLE_AT_COMPILE_TIME = true;
+
+    // a single byte shuffle per 4 words
+    size_t SwapWords32SSSE3(const uint8_t* src, uint32_t* dst, size_t count) {
+        const __m128i shuffle = _mm_setr_epi8(3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m128i words0 = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            __m128i words1 = _mm_loadu_si128((const __m128i*)(src + i * 4 + 16));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(words0, shuffle));
+            _mm_storeu_si128((__m128i*)(dst + i + 4), _mm_shuffle_epi8(words1, shuffle));
+        }
+        for (; i + 4 <= count; i += 4) {
+            __m128i words = _mm_loadu_si128((const __m128i*)(src + i * 4));
+            _mm_storeu_si128((__m128i*)(dst + i), _mm_shuffle_epi8(words, shuffle));
+        }
+        return i;
+    }
+#else
+    constexpr bool SSSE3_AVAILABLE_AT_COMPILE_TIME = false;
+
+    size_t SwapWords32SSSE3(const uint8_t* src, uint32_t* dst, size_t count) {
+        return SwapWords32SSE2(src, dst, count);
+    }
+#endif
+
+    bool CpuSupportsSSSE3() {
+        static const bool supported = []() {
+            int info[4] = {};
+            __cpuid(info, 1);
+            return SSSE3_AVAILABLE_AT_COMPILE_TIME && (info[2] & (1 << 9)) != 0;
+        }();
+        return supported;
+    }
+}
+
+void SwapWords32(const void* src, uint32_t* dst, size_t count) {
+    const uint8_t* srcBytes = (const uint8_t*)src;
+    size_t handled = CpuSupportsSSSE3() ? SwapWords32SSSE3(srcBytes, dst, count) : SwapWords32SSE2(srcBytes, dst, count);
+    SwapWords32Scalar(srcBytes, dst, handled, count);
+}
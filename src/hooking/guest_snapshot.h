@@ -0,0 +1,58 @@
+#pragma once
+
+#include "cemu_hooks.h"
+
+// swaps big-endian 32-bit words from src into dst using SIMD byte shuffles where possible, src and dst are allowed to be the same
+void SwapWords32(const void* src, uint32_t* dst, size_t count);
+
+// A copy of a contiguous range of guest memory, taken once and then read as often as needed.
+// Hooks that look at many fields of the same structs (or the same struct from multiple places) can capture the range once instead
+// of doing a separate memcpy for every field, and read arrays of floats or integers with a single batched byte swap.
+class GuestSnapshot {
+public:
+    GuestSnapshot() = default;
+    GuestSnapshot(uint32_t address, uint32_t size) { capture(address, size); }
+
+    // reuses the previous allocation when capturing ranges of the same size, e.g. once per actor
+    void capture(uint32_t address, uint32_t size) {
+        m_address = address;
+        m_bytes.resize(size);
+        memcpy(m_bytes.data(), (void*)(CemuHooks::s_memoryBaseAddress + address), size);
+    }
+
+    bool contains(uint32_t address, uint32_t size) const {
+        return address >= m_address && (uint64_t)(address - m_address) + size <= m_bytes.size();
+    }
+
+    // typed view over the BEType<T> layouts from game_structs.h, fields are only swapped once they're read with getLE()
+    template <typename T>
+    const T& view(uint32_t address) const {
+        checkAssert(contains(address, sizeof(T)), "Tried to view memory outside of the guest snapshot!");
+        return *reinterpret_cast<const T*>(m_bytes.data() + (address - m_address));
+    }
+
+    // same results as CemuHooks::getMemory, but from the snapshot
+    template <typename T>
+    auto get(uint32_t address) const {
+        if constexpr (is_BEType_v<T>) {
+            return view<T>(address);
+        }
+        else {
+            return view<BEType<T>>(address);
+        }
+    }
+
+    // reads an array of 32-bit floats or integers (e.g. a BEMatrix34) as little-endian values in one go
+    template <typename T> requires (sizeof(T) == 4 && std::is_trivially_copyable_v<T>)
+    void readArrayLE(uint32_t address, std::span<T> out) const {
+        checkAssert(contains(address, (uint32_t)out.size_bytes()), "Tried to read memory outside of the guest snapshot!");
+        SwapWords32(m_bytes.data() + (address - m_address), reinterpret_cast<uint32_t*>(out.data()), out.size());
+    }
+
+    uint32_t GetAddress() const { return m_address; }
+    uint32_t GetSize() const { return (uint32_t)m_bytes.size(); }
+
+private:
+    uint32_t m_address = 0;
+    std::vector<std::byte> m_bytes;
+};
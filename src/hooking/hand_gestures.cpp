@@ -0,0 +1,134 @@
+#include "hand_gestures.h"
+
+namespace {
+    // a flag is set while a value in body space is below its threshold, once it's set it stays set until the value goes past exit instead
+    struct Threshold {
+        float value;
+        float enter;
+        float exit;
+
+        bool Check(float v, bool wasSet, bool useHysteresis) const {
+            if (!useHysteresis)
+                return v < value;
+            return v < (wasSet ? exit : enter);
+        }
+    };
+
+    constexpr Threshold Below(float value) {
+        return { value, value - HandGestureRecognizer::HYSTERESIS, value + HandGestureRecognizer::HYSTERESIS };
+    }
+
+    // compared against the squared distance from the head
+    constexpr Threshold WithinRadius(float radius) {
+        constexpr float H = HandGestureRecognizer::HYSTERESIS;
+        return { radius * radius, (radius - H) * (radius - H), (radius + H) * (radius + H) };
+    }
+
+    constexpr Threshold BEHIND_HEAD = Below(0.0f);                     // forward, for the shoulder slots
+    constexpr Threshold BEHIND_HEAD_WITH_WAIST_OFFSET = Below(0.05f);  // forward, for the waist slots
+    constexpr Threshold ON_LEFT_SIDE = Below(0.0f);                    // right
+    constexpr Threshold CLOSE_TO_HEAD = WithinRadius(0.35f);           // for the shoulder slots
+    constexpr Threshold CLOSE_TO_MOUTH = WithinRadius(0.2f);
+    constexpr Threshold CLOSE_TO_WAIST = Below(-0.45f);                // up, a rough estimate of the waist height
+    constexpr Threshold NEAR_CHEST_HEIGHT = Below(0.3f);               // down, a rough estimate of the chest height for the shield
+
+    // the body space of the headset, which only follows its yaw for the forward and up axes
+    struct BodySpace {
+        glm::fvec3 position;
+        glm::fvec3 forward;
+        glm::fvec3 right;
+
+        explicit BodySpace(const glm::fmat4& headsetMatrix) {
+            position = glm::fvec3(headsetMatrix[3]);
+            forward = -glm::fvec3(headsetMatrix[2]);
+            forward.y = 0.0f;
+            forward = glm::normalize(forward);
+            right = glm::normalize(glm::fvec3(headsetMatrix[0]));
+        }
+
+        // x to the right, y up and z forward, relative to the head
+        glm::fvec3 ToBodySpace(const glm::fvec3& handPos) const {
+            const glm::fvec3 headToHand = handPos - position;
+            return { glm::dot(right, headToHand), headToHand.y, glm::dot(forward, headToHand) };
+        }
+    };
+}
+
+HandGestureRecognizer& HandGestureRecognizer::Get() {
+    static HandGestureRecognizer s_recognizer;
+    return s_recognizer;
+}
+
+bool HandGestureRecognizer::Update(XrTime inputTime, const glm::fmat4& headsetMatrix, const glm::fvec3& leftHandPos, const glm::fvec3& rightHandPos) {
+    if (m_hasSample && inputTime == m_lastInputTime)
+        return false;
+
+    const BodySpace body(headsetMatrix);
+    UpdateHand(OpenXR::EyeSide::LEFT, inputTime, leftHandPos - body.position, body.ToBodySpace(leftHandPos), m_hasSample);
+    UpdateHand(OpenXR::EyeSide::RIGHT, inputTime, rightHandPos - body.position, body.ToBodySpace(rightHandPos), m_hasSample);
+
+    m_lastInputTime = inputTime;
+    m_hasSample = true;
+    return true;
+}
+
+void HandGestureRecognizer::Reset(XrTime inputTime) {
+    for (OpenXR::EyeSide side : { OpenXR::EyeSide::LEFT, OpenXR::EyeSide::RIGHT }) {
+        if (m_hands[side].slot != BodySlot::None)
+            PushEvent({ inputTime, side, m_hands[side].slot, false });
+    }
+    m_hands = {};
+    m_hasSample = false;
+}
+
+void HandGestureRecognizer::UpdateHand(OpenXR::EyeSide side, XrTime inputTime, const glm::fvec3& headToHand, const glm::fvec3& bodySpacePos, bool useHysteresis) {
+    Hand& hand = m_hands[side];
+    HandGestureState& gesture = hand.gesture;
+
+    // the body axes aren't orthogonal once the head rolls, so the distance is taken before the hand got moved into body space
+    const float distanceSq = glm::length2(headToHand);
+    gesture.isBehindHead = BEHIND_HEAD.Check(bodySpacePos.z, gesture.isBehindHead, useHysteresis);
+    gesture.isBehindHeadWithWaistOffset = BEHIND_HEAD_WITH_WAIST_OFFSET.Check(bodySpacePos.z, gesture.isBehindHeadWithWaistOffset, useHysteresis);
+    gesture.isOnLeftSide = ON_LEFT_SIDE.Check(bodySpacePos.x, gesture.isOnLeftSide, useHysteresis);
+    gesture.isCloseToHead = CLOSE_TO_HEAD.Check(distanceSq, gesture.isCloseToHead, useHysteresis);
+    gesture.isCloseToMouth = CLOSE_TO_MOUTH.Check(distanceSq, gesture.isCloseToMouth, useHysteresis);
+    gesture.isCloseToWaist = CLOSE_TO_WAIST.Check(bodySpacePos.y, gesture.isCloseToWaist, useHysteresis);
+    gesture.isNearChestHeight = NEAR_CHEST_HEIGHT.Check(-bodySpacePos.y, gesture.isNearChestHeight, useHysteresis);
+
+    const BodySlot slot = GetSlot(gesture);
+    if (slot == hand.slot)
+        return;
+
+    if (hand.slot != BodySlot::None)
+        PushEvent({ inputTime, side, hand.slot, false });
+    if (slot != BodySlot::None)
+        PushEvent({ inputTime, side, slot, true });
+    hand.slot = slot;
+}
+
+void HandGestureRecognizer::PushEvent(const Event& event) {
+    std::scoped_lock lock(m_eventMutex);
+    m_events[m_eventCount % MAX_EVENTS] = event;
+    m_eventCount++;
+}
+
+BodySlot HandGestureRecognizer::GetSlot(const HandGestureState& gesture) {
+    if (gesture.isBehindHead && gesture.isCloseToHead)
+        return gesture.isOnLeftSide ? BodySlot::LeftShoulder : BodySlot::RightShoulder;
+    if (gesture.isBehindHeadWithWaistOffset && gesture.isCloseToWaist)
+        return gesture.isOnLeftSide ? BodySlot::LeftWaist : BodySlot::RightWaist;
+    if (gesture.isCloseToMouth && !gesture.isBehindHead)
+        return BodySlot::Mouth;
+    return BodySlot::None;
+}
+
+const char* HandGestureRecognizer::GetSlotName(BodySlot slot) {
+    switch (slot) {
+        case BodySlot::LeftShoulder: return "left shoulder";
+        case BodySlot::RightShoulder: return "right shoulder";
+        case BodySlot::LeftWaist: return "left waist";
+        case BodySlot::RightWaist: return "right waist";
+        case BodySlot::Mouth: return "mouth";
+        default: return "no slot";
+    }
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include "rendering/openxr.h"
+
+struct HandGestureState {
+    bool isBehindHead;
+    bool isBehindHeadWithWaistOffset;
+    bool isCloseToHead;
+    bool isCloseToMouth;
+    bool isCloseToWaist;
+    bool isNearChestHeight;
+    bool isOnLeftSide;  // true = left side of body, false = right side
+    bool isFarEnoughFromStoredPosition;
+    float magnesisForwardAmount;
+    float magnesisVerticalAmount;
+};
+
+enum class BodySlot : uint8_t {
+    None,
+    LeftShoulder,
+    RightShoulder,
+    LeftWaist,
+    RightWaist,
+    Mouth
+};
+
+// Keeps track of where each hand is relative to the body (the flags of HandGestureState and the body slot they add up to) once per input sample,
+// instead of recomputing it from scratch on every VPAD read. The hand gets moved into body space once, with x to the right of the head, y up and z
+// along the flattened view direction, after which every flag is a single comparison against a threshold that's precomputed below.
+// A flag only turns off again once the hand moved HYSTERESIS back past its threshold, so a hand that rests on the edge of a slot
+// doesn't flicker in and out of it from one frame to the next (and e.g. draw the bow twice from a single reach).
+// The magnesis amounts depend on the game state and where the hand was when magnesis started, so they're still filled in by controls.cpp.
+// Update, Reset and the gesture getters are only used from the game's thread, the events can be read from any thread.
+class HandGestureRecognizer {
+public:
+    static constexpr float HYSTERESIS = 0.01f; // in meters, on each side of a threshold
+    static constexpr size_t MAX_EVENTS = 64;
+
+    // a hand entering or leaving a body slot
+    struct Event {
+        XrTime time;
+        OpenXR::EyeSide hand;
+        BodySlot slot;
+        bool entered;
+    };
+
+    static HandGestureRecognizer& Get();
+
+    // returns false if this input sample was already recognized
+    bool Update(XrTime inputTime, const glm::fmat4& headsetMatrix, const glm::fvec3& leftHandPos, const glm::fvec3& rightHandPos);
+    // forgets where the hands were (e.g. when tracking got lost or the game went in or out of a menu), the hands leave their slots
+    // and the next sample gets recognized from scratch without the hysteresis
+    void Reset(XrTime inputTime);
+
+    const HandGestureState& GetGesture(OpenXR::EyeSide side) const { return m_hands[side].gesture; }
+    BodySlot GetSlot(OpenXR::EyeSide side) const { return m_hands[side].slot; }
+
+    // calls onEvent for each event after the cursor and moves the cursor past them, events that were already overwritten get skipped
+    template <typename F>
+    void ConsumeEvents(uint64_t& cursor, F&& onEvent) const {
+        std::scoped_lock lock(m_eventMutex);
+        cursor = std::max(cursor, m_eventCount > MAX_EVENTS ? m_eventCount - MAX_EVENTS : 0);
+        for (; cursor < m_eventCount; ++cursor) {
+            onEvent(m_events[cursor % MAX_EVENTS]);
+        }
+    }
+    uint64_t GetEventCount() const {
+        std::scoped_lock lock(m_eventMutex);
+        return m_eventCount;
+    }
+
+    static BodySlot GetSlot(const HandGestureState& gesture);
+    static const char* GetSlotName(BodySlot slot);
+
+private:
+    struct Hand {
+        HandGestureState gesture = {};
+        BodySlot slot = BodySlot::None;
+    };
+
+    void UpdateHand(OpenXR::EyeSide side, XrTime inputTime, const glm::fvec3& headToHand, const glm::fvec3& bodySpacePos, bool useHysteresis);
+    void PushEvent(const Event& event);
+
+    std::array<Hand, 2> m_hands = {};
+    XrTime m_lastInputTime = 0;
+    bool m_hasSample = false;
+
+    mutable std::mutex m_eventMutex;
+    std::array<Event, MAX_EVENTS> m_events = {};
+    uint64_t m_eventCount = 0;
+};
@@ -0,0 +1,288 @@
+#include "input_bindings.h"
+#include <filesystem>
+#include <sstream>
+
+namespace {
+    // the same bindings that hook_InjectXRInput had before they could be rebound
+    constexpr std::string_view DEFAULT_PROFILE = R"(# BetterVR input bindings
+# <game|menu> <action> <held|short_press|long_press> <button> [condition]... [!condition]... [effect=<effect>] [group=<name>]
+# actions: crouch_scope, jump_cancel, run_interact, rune, grab_left, grab_right, use_left_item, use_right_item, inventory_map,
+#          select, back, sort, hold, left_grip, right_grip, left_trigger, right_trigger
+# buttons: A, B, X, Y, L, R, ZL, ZR, PLUS, MINUS, UP, DOWN, LEFT, RIGHT, STICK_L, STICK_R
+# conditions: preventing_inputs, climbing, riding, map_open, dpad_menu_open, left_hand_over_slot, right_hand_over_slot
+# effects: open_map, close_map, hold_rune
+# only the first binding of a group that fires holds its button, delete this file to get the default bindings back
+# changes are picked up after reloading the bindings in the Input section of the mod menu, or after restarting Cemu
+
+game jump_cancel held X !preventing_inputs
+game crouch_scope long_press STICK_R !preventing_inputs
+game inventory_map short_press PLUS !preventing_inputs effect=close_map
+game inventory_map long_press MINUS !preventing_inputs effect=open_map
+game crouch_scope short_press STICK_L
+game rune short_press L effect=hold_rune
+game run_interact held B climbing
+game run_interact held A riding !climbing
+game grab_right held A riding !climbing !right_hand_over_slot
+game grab_left held B riding !climbing !left_hand_over_slot
+game run_interact long_press B !climbing !riding group=run
+game run_interact held A !climbing !riding group=run
+
+menu sort held Y !dpad_menu_open
+menu back held B !preventing_inputs
+menu inventory_map held MINUS !preventing_inputs map_open
+menu inventory_map held PLUS !preventing_inputs !map_open
+menu select held A
+menu left_trigger held L
+menu right_trigger held R
+menu hold short_press X
+)";
+
+    // where an action is stored in OpenXR::InputState, the press offset points to its ButtonState if it tracks short and long presses
+    struct ActionSource {
+        std::string_view name;
+        uint32_t heldOffset;
+        bool heldIsFloat;
+        std::optional<uint32_t> pressOffset;
+    };
+
+#define BOOLEAN_ACTION(name, action) ActionSource{ name, offsetof(OpenXR::InputState, action), false, std::nullopt }
+#define BUTTON_ACTION(name, action, state) ActionSource{ name, offsetof(OpenXR::InputState, action), false, offsetof(OpenXR::InputState, state) }
+    const std::array ACTION_SOURCES = {
+        BUTTON_ACTION("crouch_scope", inGame.crouch_scope, inGame.crouch_scopeState),
+        BOOLEAN_ACTION("jump_cancel", inGame.jump_cancel),
+        BUTTON_ACTION("run_interact", inGame.run_interact, inGame.runState),
+        BUTTON_ACTION("rune", inGame.useRune_dpadMenu, inGame.useRune_runeMenuState),
+        ActionSource{ "grab_left", offsetof(OpenXR::InputState, inGame.grab[0]), true, offsetof(OpenXR::InputState, inGame.grabState[0]) },
+        ActionSource{ "grab_right", offsetof(OpenXR::InputState, inGame.grab[1]), true, offsetof(OpenXR::InputState, inGame.grabState[1]) },
+        BOOLEAN_ACTION("use_left_item", inGame.useLeftItem),
+        BOOLEAN_ACTION("use_right_item", inGame.useRightItem),
+        BUTTON_ACTION("inventory_map", shared.inventory_map, shared.inventory_mapState),
+        BOOLEAN_ACTION("select", inMenu.select),
+        BOOLEAN_ACTION("back", inMenu.back),
+        BOOLEAN_ACTION("sort", inMenu.sort),
+        BUTTON_ACTION("hold", inMenu.hold, inMenu.holdState),
+        BOOLEAN_ACTION("left_grip", inMenu.leftGrip),
+        BOOLEAN_ACTION("right_grip", inMenu.rightGrip),
+        BOOLEAN_ACTION("left_trigger", inMenu.leftTrigger),
+        BOOLEAN_ACTION("right_trigger", inMenu.rightTrigger),
+    };
+#undef BOOLEAN_ACTION
+#undef BUTTON_ACTION
+
+    constexpr std::array<std::pair<std::string_view, VPADButtons>, 16> BUTTON_NAMES = {{
+        { "A", VPAD_BUTTON_A }, { "B", VPAD_BUTTON_B }, { "X", VPAD_BUTTON_X }, { "Y", VPAD_BUTTON_Y },
+        { "L", VPAD_BUTTON_L }, { "R", VPAD_BUTTON_R }, { "ZL", VPAD_BUTTON_ZL }, { "ZR", VPAD_BUTTON_ZR },
+        { "PLUS", VPAD_BUTTON_PLUS }, { "MINUS", VPAD_BUTTON_MINUS },
+        { "UP", VPAD_BUTTON_UP }, { "DOWN", VPAD_BUTTON_DOWN }, { "LEFT", VPAD_BUTTON_LEFT }, { "RIGHT", VPAD_BUTTON_RIGHT },
+        { "STICK_L", VPAD_BUTTON_STICK_L }, { "STICK_R", VPAD_BUTTON_STICK_R },
+    }};
+
+    constexpr std::array<std::pair<std::string_view, InputBindings::Condition>, 7> CONDITION_NAMES = {{
+        { "preventing_inputs", InputBindings::PREVENTING_INPUTS },
+        { "climbing", InputBindings::CLIMBING },
+        { "riding", InputBindings::RIDING },
+        { "map_open", InputBindings::MAP_OPEN },
+        { "dpad_menu_open", InputBindings::DPAD_MENU_OPEN },
+        { "left_hand_over_slot", InputBindings::LEFT_HAND_OVER_SLOT },
+        { "right_hand_over_slot", InputBindings::RIGHT_HAND_OVER_SLOT },
+    }};
+
+    constexpr std::array<std::pair<std::string_view, InputBindings::Effect>, 3> EFFECT_NAMES = {{
+        { "open_map", InputBindings::Effect::OpenMap },
+        { "close_map", InputBindings::Effect::CloseMap },
+        { "hold_rune", InputBindings::Effect::HoldRune },
+    }};
+
+    template <typename T, size_t N>
+    std::optional<T> FindByName(const std::array<std::pair<std::string_view, T>, N>& names, std::string_view name) {
+        for (const auto& [entryName, value] : names) {
+            if (entryName == name) {
+                return value;
+            }
+        }
+        return std::nullopt;
+    }
+
+    // set by the mod menu, the game's thread loads the profile again on its next VPAD read
+    std::atomic_bool s_reloadRequested = false;
+}
+
+std::string_view InputBindings::GetDefaultProfile() {
+    return DEFAULT_PROFILE;
+}
+
+std::filesystem::path InputBindings::GetProfilePath() {
+    char path[MAX_PATH] = {};
+    if (GetModuleFileNameA(nullptr, path, MAX_PATH) == 0) {
+        return PROFILE_FILE_NAME;
+    }
+    return std::filesystem::path(path).parent_path() / PROFILE_FILE_NAME;
+}
+
+void InputBindings::RequestReload() {
+    s_reloadRequested = true;
+}
+
+const InputBindings& InputBindings::Get() {
+    auto load = []() -> InputBindings {
+        const std::filesystem::path profilePath = GetProfilePath();
+        const std::string profileName = profilePath.string();
+        if (!std::filesystem::exists(profilePath)) {
+            std::ofstream file(profilePath, std::ios::out | std::ios::trunc);
+            file << DEFAULT_PROFILE;
+            return Compile(DEFAULT_PROFILE, "default input bindings").value();
+        }
+
+        std::ifstream file(profilePath);
+        std::stringstream profile;
+        profile << file.rdbuf();
+        if (std::optional<InputBindings> bindings = Compile(profile.str(), profileName)) {
+            Log::print<INFO>("Loaded {} input bindings from {}", bindings->GetInstructionCount(), profileName);
+            return std::move(bindings.value());
+        }
+        Log::print<WARNING>("Using the default input bindings since {} couldn't be loaded", profileName);
+        return Compile(DEFAULT_PROFILE, "default input bindings").value();
+    };
+
+    static InputBindings s_bindings = load();
+    if (s_reloadRequested.exchange(false)) {
+        s_bindings = load();
+    }
+    return s_bindings;
+}
+
+std::optional<InputBindings> InputBindings::Compile(std::string_view profile, std::string_view profileName) {
+    InputBindings bindings;
+    std::vector<std::string> groups;
+
+    std::istringstream lines{ std::string(profile) };
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(lines, line)) {
+        lineNumber++;
+        std::istringstream fields(line);
+        std::string context, action, trigger, button;
+        if (!(fields >> context) || context[0] == '#') {
+            continue;
+        }
+        fields >> action >> trigger >> button;
+
+        auto fail = [&](std::string_view reason) -> std::optional<InputBindings> {
+            Log::print<ERROR>("Invalid input binding on line {} of {}: {}", lineNumber, profileName, reason);
+            return std::nullopt;
+        };
+
+        Instruction& instruction = bindings.m_instructions.emplace_back();
+        instruction = { .event = ButtonState::Event::None, .effect = Effect::None };
+
+        if (context == "game") {
+            instruction.required = IN_GAME;
+        }
+        else if (context == "menu") {
+            instruction.required = IN_MENU;
+        }
+        else {
+            return fail(std::format("unknown context {}", context));
+        }
+
+        auto source = std::ranges::find(ACTION_SOURCES, action, &ActionSource::name);
+        if (source == ACTION_SOURCES.end()) {
+            return fail(std::format("unknown action {}", action));
+        }
+        if (trigger == "held") {
+            instruction.sourceOffset = source->heldOffset;
+            instruction.sourceType = source->heldIsFloat ? SourceType::Float : SourceType::Boolean;
+        }
+        else if (trigger == "short_press" || trigger == "long_press") {
+            if (!source->pressOffset.has_value()) {
+                return fail(std::format("{} can only be held", action));
+            }
+            instruction.sourceOffset = source->pressOffset.value();
+            instruction.sourceType = SourceType::ButtonEvent;
+            instruction.event = trigger == "short_press" ? ButtonState::Event::ShortPress : ButtonState::Event::LongPress;
+        }
+        else {
+            return fail(std::format("unknown trigger {}", trigger));
+        }
+
+        std::optional<VPADButtons> vpadButton = FindByName(BUTTON_NAMES, button);
+        if (!vpadButton.has_value()) {
+            return fail(std::format("unknown button {}", button));
+        }
+        instruction.button = vpadButton.value();
+
+        std::string option;
+        while (fields >> option) {
+            if (option.starts_with("effect=")) {
+                std::optional<Effect> effect = FindByName(EFFECT_NAMES, std::string_view(option).substr(7));
+                if (!effect.has_value()) {
+                    return fail(std::format("unknown effect {}", option.substr(7)));
+                }
+                instruction.effect = effect.value();
+            }
+            else if (option.starts_with("group=")) {
+                auto group = std::ranges::find(groups, option.substr(6));
+                if (group == groups.end()) {
+                    if (groups.size() >= 32) {
+                        return fail("there can't be more than 32 groups");
+                    }
+                    group = groups.insert(groups.end(), option.substr(6));
+                }
+                instruction.group = 1u << (uint32_t)std::distance(groups.begin(), group);
+            }
+            else {
+                const bool negated = option[0] == '!';
+                std::optional<Condition> condition = FindByName(CONDITION_NAMES, std::string_view(option).substr(negated ? 1 : 0));
+                if (!condition.has_value()) {
+                    return fail(std::format("unknown condition {}", option));
+                }
+                (negated ? instruction.forbidden : instruction.required) |= condition.value();
+            }
+        }
+    }
+    return bindings;
+}
+
+uint32_t InputBindings::Evaluate(const OpenXR::InputState& inputs, OpenXR::GameState& gameState, uint32_t conditions) const {
+    const std::byte* source = reinterpret_cast<const std::byte*>(&inputs);
+    uint32_t buttons = 0;
+    uint32_t firedGroups = 0;
+    for (const Instruction& instruction : m_instructions) {
+        if ((conditions & instruction.required) != instruction.required || (conditions & instruction.forbidden) != 0 || (firedGroups & instruction.group) != 0) {
+            continue;
+        }
+
+        bool active = false;
+        switch (instruction.sourceType) {
+            case SourceType::Boolean:
+                active = reinterpret_cast<const XrActionStateBoolean*>(source + instruction.sourceOffset)->currentState;
+                break;
+            case SourceType::Float:
+                active = reinterpret_cast<const XrActionStateFloat*>(source + instruction.sourceOffset)->currentState != 0.0f;
+                break;
+            case SourceType::ButtonEvent:
+                active = reinterpret_cast<const ButtonState*>(source + instruction.sourceOffset)->lastEvent == instruction.event;
+                break;
+        }
+        if (!active) {
+            continue;
+        }
+
+        buttons |= instruction.button;
+        firedGroups |= instruction.group;
+        switch (instruction.effect) {
+            case Effect::OpenMap:
+                gameState.map_open = true;
+                break;
+            case Effect::CloseMap:
+                gameState.map_open = false;
+                break;
+            case Effect::HoldRune:
+                gameState.last_equip_type_held = EquipType::SheikahSlate;
+                break;
+            default:
+                break;
+        }
+    }
+    return buttons;
+}
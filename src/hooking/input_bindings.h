@@ -0,0 +1,70 @@
+#pragma once
+#include "rendering/openxr.h"
+#include <filesystem>
+
+// The plain button bindings of hook_InjectXRInput, where holding an XR action (or a short or long press of it) holds a VPAD button.
+// A profile lists one binding per line and gets compiled once into a flat list of instructions, which is evaluated on every VPAD read:
+//   <game|menu> <action> <held|short_press|long_press> <button> [condition]... [!condition]... [effect=<effect>] [group=<name>]
+// Only the first binding of a group that fires holds its button. Lines starting with # are comments.
+// The body slots, gestures and dpad menus keep their own state between frames and are still handled in controls.cpp.
+// Players can rebind these by editing BetterVR_bindings.txt next to Cemu.exe, which gets created with the default profile.
+// The profile is loaded once, edits are picked up after reloading it from the Input section of the mod menu or restarting Cemu.
+class InputBindings {
+public:
+    // taken once before the bindings are evaluated
+    enum Condition : uint32_t {
+        IN_GAME = 1 << 0,
+        IN_MENU = 1 << 1,
+        PREVENTING_INPUTS = 1 << 2,
+        CLIMBING = 1 << 3, // or paragliding
+        RIDING = 1 << 4,
+        MAP_OPEN = 1 << 5,
+        DPAD_MENU_OPEN = 1 << 6,
+        LEFT_HAND_OVER_SLOT = 1 << 7,
+        RIGHT_HAND_OVER_SLOT = 1 << 8,
+    };
+
+    // game state that a binding changes when it fires
+    enum class Effect : uint8_t {
+        None,
+        OpenMap,
+        CloseMap,
+        HoldRune
+    };
+
+    static constexpr const char* PROFILE_FILE_NAME = "BetterVR_bindings.txt";
+
+    // only used from the game's thread, which loads the profile again on the first call after RequestReload
+    static const InputBindings& Get();
+    // can be called from any thread, e.g. the mod menu
+    static void RequestReload();
+    // next to Cemu.exe, instead of Cemu's working directory which depends on how it was started
+    static std::filesystem::path GetProfilePath();
+    static std::string_view GetDefaultProfile();
+    static std::optional<InputBindings> Compile(std::string_view profile, std::string_view profileName);
+
+    // returns the VPAD buttons that are held by the bindings
+    uint32_t Evaluate(const OpenXR::InputState& inputs, OpenXR::GameState& gameState, uint32_t conditions) const;
+
+    size_t GetInstructionCount() const { return m_instructions.size(); }
+
+private:
+    enum class SourceType : uint8_t {
+        Boolean,
+        Float,
+        ButtonEvent
+    };
+
+    struct Instruction {
+        uint32_t required;
+        uint32_t forbidden;
+        uint32_t group;
+        uint32_t button;
+        uint32_t sourceOffset; // into OpenXR::InputState
+        SourceType sourceType;
+        OpenXR::InputState::ButtonState::Event event;
+        Effect effect;
+    };
+
+    std::vector<Instruction> m_instructions;
+};
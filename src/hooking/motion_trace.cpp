@@ -0,0 +1,223 @@
+#include "motion_trace.h"
+#include "weapon.h"
+#include <sstream>
+
+namespace {
+    constexpr std::array<std::string_view, 4> LABEL_NAMES = { "-", "idle", "slash", "stab" };
+
+    std::optional<MotionTrace::Label> ParseLabel(std::string_view label) {
+        for (size_t i = 0; i < LABEL_NAMES.size(); ++i) {
+            if (label == LABEL_NAMES[i]) {
+                return (MotionTrace::Label)i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    AttackType ToAttackType(MotionTrace::Label label) {
+        switch (label) {
+            case MotionTrace::Label::Slash:
+                return AttackType::Slash;
+            case MotionTrace::Label::Stab:
+                return AttackType::Stab;
+            default:
+                return AttackType::None;
+        }
+    }
+}
+
+std::optional<MotionTrace> MotionTrace::Load(const std::filesystem::path& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        Log::print<ERROR>("Failed to open motion trace {}", path.string());
+        return std::nullopt;
+    }
+
+    MotionTrace trace;
+    trace.name = path.filename().string();
+
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        lineNumber++;
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        std::istringstream fields(line);
+        uint32_t side = 0;
+        uint32_t weaponType = 0;
+        std::string label;
+        Sample& sample = trace.samples.emplace_back();
+        sample.location = { XR_TYPE_SPACE_LOCATION };
+        sample.velocity = { XR_TYPE_SPACE_VELOCITY };
+        XrPosef& pose = sample.location.pose;
+        fields >> side >> weaponType >> sample.inputTime
+            >> pose.position.x >> pose.position.y >> pose.position.z
+            >> pose.orientation.x >> pose.orientation.y >> pose.orientation.z >> pose.orientation.w
+            >> sample.velocity.linearVelocity.x >> sample.velocity.linearVelocity.y >> sample.velocity.linearVelocity.z
+            >> sample.velocity.angularVelocity.x >> sample.velocity.angularVelocity.y >> sample.velocity.angularVelocity.z
+            >> sample.headsetPosition.x >> sample.headsetPosition.y >> sample.headsetPosition.z
+            >> sample.headsetRotation.x >> sample.headsetRotation.y >> sample.headsetRotation.z >> sample.headsetRotation.w
+            >> label;
+
+        std::optional<Label> parsedLabel = ParseLabel(label);
+        if (fields.fail() || side > 1 || !parsedLabel.has_value()) {
+            Log::print<ERROR>("Invalid sample on line {} of motion trace {}", lineNumber, path.string());
+            return std::nullopt;
+        }
+        sample.side = (uint8_t)side;
+        sample.weaponType = (WeaponType)weaponType;
+        sample.label = parsedLabel.value();
+    }
+    return trace;
+}
+
+std::string MotionTrace::FormatSample(const Sample& sample) {
+    const XrPosef& pose = sample.location.pose;
+    const XrVector3f& linVel = sample.velocity.linearVelocity;
+    const XrVector3f& angVel = sample.velocity.angularVelocity;
+    return std::format("{} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {} {}\n",
+        sample.side, std::to_underlying(sample.weaponType), sample.inputTime,
+        pose.position.x, pose.position.y, pose.position.z,
+        pose.orientation.x, pose.orientation.y, pose.orientation.z, pose.orientation.w,
+        linVel.x, linVel.y, linVel.z,
+        angVel.x, angVel.y, angVel.z,
+        sample.headsetPosition.x, sample.headsetPosition.y, sample.headsetPosition.z,
+        sample.headsetRotation.x, sample.headsetRotation.y, sample.headsetRotation.z, sample.headsetRotation.w,
+        LABEL_NAMES[std::to_underlying(sample.label)]);
+}
+
+MotionTraceRecorder* MotionTraceRecorder::Get() {
+    // same as the frame recorder, the recorder lives until the process exits
+    static MotionTraceRecorder* s_recorder = []() -> MotionTraceRecorder* {
+        const char* path = std::getenv("BETTERVR_RECORD_MOTION");
+        if (path == nullptr || path[0] == '\0') {
+            return nullptr;
+        }
+
+        Log::print<INFO>("Recording the hand motion of held weapons to {}", path);
+        return new MotionTraceRecorder(path);
+    }();
+    return s_recorder;
+}
+
+MotionTraceRecorder::MotionTraceRecorder(const std::filesystem::path& path) {
+    m_file.open(path, std::ios::out | std::ios::trunc);
+    if (!m_file.is_open()) {
+        Log::print<ERROR>("Failed to open {} for recording hand motion!", path.string());
+        return;
+    }
+    m_file << MotionTrace::FILE_HEADER << "\n";
+}
+
+void MotionTraceRecorder::RecordSample(uint8_t side, WeaponType weaponType, const XrSpaceLocation& location, const XrSpaceVelocity& velocity, const glm::fmat4& headsetMtx, XrTime inputTime) {
+    MotionTrace::Sample sample = {
+        .side = side,
+        .weaponType = weaponType,
+        .inputTime = inputTime,
+        .location = location,
+        .velocity = velocity,
+        .headsetPosition = glm::fvec3(headsetMtx[3]),
+        .headsetRotation = glm::quat_cast(headsetMtx),
+        .label = MotionTrace::Label::Unlabelled
+    };
+    std::string line = MotionTrace::FormatSample(sample);
+
+    std::lock_guard lk(m_mutex);
+    if (!m_file.is_open()) {
+        return;
+    }
+    m_file << line;
+    // flush about once a second, so that closing Cemu doesn't lose much of the recording
+    if (++m_unflushedSamples >= 90) {
+        m_file.flush();
+        m_unflushedSamples = 0;
+    }
+}
+
+namespace MotionTraceRunner {
+    Stats Run(const MotionTrace& trace, uint32_t iterations) {
+        Stats stats = {};
+        stats.samples = (uint32_t)trace.samples.size();
+
+        struct LabelledAttack {
+            MotionTrace::Label label = MotionTrace::Label::Unlabelled;
+            uint32_t frames = 0;
+            bool resolved = false;
+        };
+
+        std::array<WeaponMotionAnalyser, 2> analysers = {};
+        std::array<LabelledAttack, 2> attacks = {};
+        std::array<bool, 2> wasAttacking = { false, false };
+
+        auto finishAttack = [&](LabelledAttack& attack) {
+            if (ToAttackType(attack.label) != AttackType::None && !attack.resolved) {
+                stats.missedAttacks++;
+            }
+            attack = {};
+        };
+
+        for (const MotionTrace::Sample& sample : trace.samples) {
+            WeaponMotionAnalyser& analyser = analysers[sample.side];
+            analyser.ResetIfWeaponTypeChanged(sample.weaponType);
+            analyser.Update(sample.location, sample.velocity, ToMat4(sample.headsetPosition, sample.headsetRotation), sample.inputTime);
+
+            const bool isAttacking = analyser.IsAttacking();
+            const bool startedAttacking = isAttacking && !wasAttacking[sample.side];
+            wasAttacking[sample.side] = isAttacking;
+
+            if (sample.label == MotionTrace::Label::Unlabelled) {
+                continue;
+            }
+            stats.labelledSamples++;
+
+            LabelledAttack& attack = attacks[sample.side];
+            if (attack.label != sample.label) {
+                finishAttack(attack);
+                attack.label = sample.label;
+                if (ToAttackType(sample.label) != AttackType::None) {
+                    stats.labelledAttacks++;
+                }
+            }
+
+            if (ToAttackType(sample.label) == AttackType::None) {
+                stats.falsePositives += startedAttacking ? 1 : 0;
+                continue;
+            }
+
+            // an attack that was already going on before the label started still counts, since it's active during the labelled motion
+            if (isAttacking && !attack.resolved) {
+                attack.resolved = true;
+                if (analyser.GetLockedAttackType() == ToAttackType(sample.label)) {
+                    stats.detectedAttacks++;
+                    stats.totalLatencyFrames += attack.frames;
+                    stats.maxLatencyFrames = std::max(stats.maxLatencyFrames, attack.frames);
+                }
+                else {
+                    stats.misclassifiedAttacks++;
+                }
+            }
+            attack.frames++;
+        }
+        finishAttack(attacks[0]);
+        finishAttack(attacks[1]);
+
+        // time the analysers on their own, without the bookkeeping above
+        double totalNs = 0.0;
+        for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+            std::array<WeaponMotionAnalyser, 2> timedAnalysers = {};
+            auto start = std::chrono::high_resolution_clock::now();
+            for (const MotionTrace::Sample& sample : trace.samples) {
+                WeaponMotionAnalyser& analyser = timedAnalysers[sample.side];
+                analyser.ResetIfWeaponTypeChanged(sample.weaponType);
+                analyser.Update(sample.location, sample.velocity, ToMat4(sample.headsetPosition, sample.headsetRotation), sample.inputTime);
+            }
+            totalNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+        }
+        if (iterations > 0 && !trace.samples.empty()) {
+            stats.nsPerSample = totalNs / ((double)iterations * (double)trace.samples.size());
+        }
+        return stats;
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+#include <filesystem>
+
+// A recording of the hand motion that WeaponMotionAnalyser sees, so that attack detection can be measured and tuned without a headset.
+// Traces are plain text with one sample per line, so that recorded traces can be labelled afterwards by editing the label column:
+//   <side> <weaponType> <inputTime> <hand position xyz> <hand orientation xyzw> <linear velocity xyz> <angular velocity xyz> <headset position xyz> <headset orientation xyzw> <label>
+// The label is the attack that the sample is part of (idle, slash or stab), or - for samples that weren't labelled yet.
+// Lines starting with # are comments.
+struct MotionTrace {
+    enum class Label : uint8_t {
+        Unlabelled,
+        Idle,
+        Slash,
+        Stab
+    };
+
+    struct Sample {
+        uint8_t side;
+        WeaponType weaponType;
+        XrTime inputTime;
+        XrSpaceLocation location;
+        XrSpaceVelocity velocity;
+        glm::fvec3 headsetPosition;
+        glm::fquat headsetRotation;
+        Label label;
+    };
+
+    static constexpr const char* FILE_HEADER = "# BetterVR motion trace v1";
+    static constexpr const char* FILE_EXTENSION = ".bvrmotion";
+
+    static std::optional<MotionTrace> Load(const std::filesystem::path& path);
+    static std::string FormatSample(const Sample& sample);
+
+    std::string name;
+    std::vector<Sample> samples;
+};
+
+// Appends every sample that hook_EnableWeaponAttackSensor feeds into the motion analysers to a trace.
+// Recording is opt-in using BETTERVR_RECORD_MOTION=<path>, the recorded samples are left unlabelled.
+class MotionTraceRecorder {
+public:
+    static MotionTraceRecorder* Get();
+
+    void RecordSample(uint8_t side, WeaponType weaponType, const XrSpaceLocation& location, const XrSpaceVelocity& velocity, const glm::fmat4& headsetMtx, XrTime inputTime);
+
+private:
+    explicit MotionTraceRecorder(const std::filesystem::path& path);
+
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    uint32_t m_unflushedSamples = 0;
+};
+
+// Feeds traces through a WeaponMotionAnalyser per hand, the same way hook_EnableWeaponAttackSensor does.
+// Labelled slashes and stabs count as detected when the analyser starts attacking with the same attack type while the label lasts,
+// the latency is the amount of samples between the start of the label and the detection. Attacks that start during idle samples are false positives.
+namespace MotionTraceRunner {
+    struct Stats {
+        uint32_t samples = 0;
+        uint32_t labelledSamples = 0;
+        uint32_t labelledAttacks = 0;
+        uint32_t detectedAttacks = 0;
+        uint32_t misclassifiedAttacks = 0;
+        uint32_t missedAttacks = 0;
+        uint32_t falsePositives = 0;
+        uint64_t totalLatencyFrames = 0;
+        uint32_t maxLatencyFrames = 0;
+        double nsPerSample = 0.0;
+
+        double GetAverageLatencyFrames() const { return detectedAttacks > 0 ? (double)totalLatencyFrames / detectedAttacks : 0.0; }
+    };
+
+    // iterations is how often the trace is replayed to measure the CPU time per sample
+    Stats Run(const MotionTrace& trace, uint32_t iterations);
+}
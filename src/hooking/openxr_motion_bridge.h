@@ -128,63 +128,106 @@ public:
         return out;
     }
 
-    static void UpdateVPADStatus(const OpenXR::InputState& inputs, VPADStatus& vpadStatus) {
-        // motion
-        static OpenXRMotionBridge motionBridge;
-        static glm::vec3 lastWorldVelocity = { 0.0f, 0.0f, 0.0f };
-        static XrTime lastInputTime = 0;
-
-        // Using Right Hand (index 1) for motion controls
-        const int handIdx = 1;
-        auto& poseState = inputs.shared.poseLocation[handIdx];
-        auto& velState = inputs.shared.poseVelocity[handIdx];
-
-        if ((poseState.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) && inputs.shared.in_game) {
-            glm::quat orientation = ToGLM(poseState.pose.orientation);
-            glm::vec3 angularVel = ToGLM(velState.angularVelocity);
-            glm::vec3 linearVel = ToGLM(velState.linearVelocity);
-
-            float dt = 1.0f / 60.0f;
-            if (lastInputTime != 0) {
-                dt = (float)(inputs.shared.inputTime - lastInputTime) * 1e-9f;
-            }
-            if (dt <= 1e-5f) dt = 1.0f / 60.0f;
-            if (dt > 0.1f) dt = 0.1f;
-            lastInputTime = inputs.shared.inputTime;
-
-            // Calculate Acceleration (World Space) + Gravity
-            glm::vec3 accWorld = (linearVel - lastWorldVelocity) / dt;
-            accWorld += glm::vec3(0.0f, 9.81f, 0.0f);
-            lastWorldVelocity = linearVel;
-
-            // Convert to Local Space
-            glm::quat invRot = glm::inverse(orientation);
-            glm::vec3 accLocal = invRot * accWorld;
-            glm::vec3 gyroLocal = invRot * angularVel;
-
-            WiiUMotionData motion = motionBridge.Process(orientation, gyroLocal, accLocal);
-
-            vpadStatus.acc = motion.acc;
-            vpadStatus.accMagnitude = glm::length(motion.acc);
-            vpadStatus.accAcceleration = motion.jerk;
-            vpadStatus.gyroChange = motion.gyro;
-            vpadStatus.gyroOrientation = motion.orientation;
-            vpadStatus.accXY = { motion.acc.x, motion.acc.y };
-
-            // Construct corrected orientation for 'dir' to match Bridge logic
-            // Bridge Logic: Invert Pitch, Invert Roll, Keep Yaw.
-            glm::vec3 euler = glm::eulerAngles(orientation); // Pitch(x), Yaw(y), Roll(z)
-            glm::quat corrected = glm::quat(glm::vec3(-euler.x, euler.y, -euler.z));
-
-            vpadStatus.dir.x = corrected * glm::vec3(1, 0, 0);
-            vpadStatus.dir.y = corrected * glm::vec3(0, 1, 0);
-            vpadStatus.dir.z = corrected * glm::vec3(0, 0, 1);
+    static void UpdateVPADStatus(const OpenXR::InputState& inputs, VPADStatus& vpadStatus);
+};
+
+// Runs the bridge once per pose that the runtime sampled, with the gyro taken from the rotation between the last two samples.
+// The game integrates the gyro over its own frame time, so handing it the angular velocity of a single instant made gyro aiming drift
+// further off the lower the frame rate got. The rotation between the samples divided by the time between their timestamps is what the
+// hand actually turned by since the last one, which keeps the game's integrated orientation on the sampled poses.
+class SampledMotionIntegrator {
+public:
+    // after longer gaps (e.g. tracking was lost or the game was in a menu) it starts over from the new pose
+    static constexpr XrDuration MAX_GAP = 250'000'000;
+
+    struct Sample {
+        XrTime time;
+        glm::quat orientation;
+        glm::vec3 angularVelocity; // world space in radians/sec
+        glm::vec3 linearVelocity;  // world space in meters/sec
+    };
+
+    WiiUMotionData Update(const Sample& sample) {
+        const glm::vec3 GRAVITY = { 0.0f, 9.81f, 0.0f };
+
+        const glm::quat invRot = glm::inverse(sample.orientation);
+        const XrDuration elapsed = m_lastSample.has_value() ? sample.time - m_lastSample->time : 0;
+        if (!m_lastSample.has_value() || elapsed > MAX_GAP) {
+            // nothing to take the rotation from, so use the runtime's angular velocity until the next sample
+            m_linearAcceleration = { 0.0f, 0.0f, 0.0f };
+            m_lastAccLocal.reset();
+            m_gyroLocal = invRot * sample.angularVelocity;
         }
-        else {
-            vpadStatus.dir.x = glm::fvec3{ 1, 0, 0 };
-            vpadStatus.dir.y = glm::fvec3{ 0, 1, 0 };
-            vpadStatus.dir.z = glm::fvec3{ 0, 0, 1 };
-            vpadStatus.accXY = { 1.0f, 0.0f };
+        else if (elapsed > 0) {
+            const float dt = (float)elapsed * 1e-9f;
+            m_gyroLocal = ToRotationVector(glm::inverse(m_lastSample->orientation) * sample.orientation) / dt;
+            m_linearAcceleration = (sample.linearVelocity - m_lastSample->linearVelocity) / dt;
         }
+        // otherwise the game read the VPAD twice during the same XR frame, which keeps the gyro of that frame
+        m_lastSample = sample;
+
+        const glm::vec3 accLocal = invRot * (m_linearAcceleration + GRAVITY);
+        return Finish(m_bridge.Process(sample.orientation, m_gyroLocal, accLocal), accLocal);
+    }
+
+private:
+    static glm::vec3 ToRotationVector(glm::quat q) {
+        if (q.w < 0.0f) q = -q;
+        const glm::vec3 axis = { q.x, q.y, q.z };
+        const float sinHalfAngle = glm::length(axis);
+        return sinHalfAngle > 1e-8f ? axis * (2.0f * std::atan2(sinHalfAngle, q.w) / sinHalfAngle) : axis * 2.0f;
+    }
+
+    WiiUMotionData Finish(WiiUMotionData out, const glm::vec3& accLocal) {
+        out.jerk = m_lastAccLocal.has_value() ? glm::length(accLocal - m_lastAccLocal.value()) : 0.0f;
+        m_lastAccLocal = accLocal;
+        return out;
     }
+
+    OpenXRMotionBridge m_bridge;
+    std::optional<Sample> m_lastSample;
+    std::optional<glm::vec3> m_lastAccLocal;
+    glm::vec3 m_gyroLocal = { 0.0f, 0.0f, 0.0f };
+    glm::vec3 m_linearAcceleration = { 0.0f, 0.0f, 0.0f };
 };
+
+inline void OpenXRMotionBridge::UpdateVPADStatus(const OpenXR::InputState& inputs, VPADStatus& vpadStatus) {
+    // motion
+    static SampledMotionIntegrator motionIntegrator;
+
+    // Using Right Hand (index 1) for motion controls
+    const int handIdx = 1;
+    auto& poseState = inputs.shared.poseLocation[handIdx];
+    auto& velState = inputs.shared.poseVelocity[handIdx];
+
+    if ((poseState.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) && inputs.shared.in_game) {
+        glm::quat orientation = ToGLM(poseState.pose.orientation);
+        glm::vec3 angularVel = ToGLM(velState.angularVelocity);
+        glm::vec3 linearVel = ToGLM(velState.linearVelocity);
+
+        // takes the gyro from the runtime's timestamped samples, which converts to local space and adds gravity to the acceleration as well
+        WiiUMotionData motion = motionIntegrator.Update({ inputs.shared.inputTime, orientation, angularVel, linearVel });
+
+        vpadStatus.acc = motion.acc;
+        vpadStatus.accMagnitude = glm::length(motion.acc);
+        vpadStatus.accAcceleration = motion.jerk;
+        vpadStatus.gyroChange = motion.gyro;
+        vpadStatus.gyroOrientation = motion.orientation;
+        vpadStatus.accXY = { motion.acc.x, motion.acc.y };
+
+        // Construct corrected orientation for 'dir' to match Bridge logic
+        // Bridge Logic: Invert Pitch, Invert Roll, Keep Yaw.
+        glm::vec3 euler = glm::eulerAngles(orientation); // Pitch(x), Yaw(y), Roll(z)
+        glm::quat corrected = glm::quat(glm::vec3(-euler.x, euler.y, -euler.z));
+
+        vpadStatus.dir.x = corrected * glm::vec3(1, 0, 0);
+        vpadStatus.dir.y = corrected * glm::vec3(0, 1, 0);
+        vpadStatus.dir.z = corrected * glm::vec3(0, 0, 1);
+    }
+    else {
+        vpadStatus.dir.x = glm::fvec3{ 1, 0, 0 };
+        vpadStatus.dir.y = glm::fvec3{ 0, 1, 0 };
+        vpadStatus.dir.z = glm::fvec3{ 0, 0, 1 };
+        vpadStatus.accXY = { 1.0f, 0.0f };
+    }
+}
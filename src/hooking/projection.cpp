@@ -0,0 +1,118 @@
+#include "projection.h"
+
+// https://github.com/KhronosGroup/OpenXR-SDK/blob/858912260ca616f4c23f7fb61c89228c353eb124/src/common/xr_linear.h#L564C1-L632C2
+// https://github.com/aboood40091/sead/blob/45b629fb032d88b828600a1b787729f2d398f19d/engine/library/modules/src/gfx/seadProjection.cpp#L166
+
+static data_VRProjectionMatrixOut calculateFOVAndOffset(XrFovf viewFOV) {
+    float totalHorizontalFov = viewFOV.angleRight - viewFOV.angleLeft;
+    float totalVerticalFov = viewFOV.angleUp - viewFOV.angleDown;
+
+    float aspectRatio = totalHorizontalFov / totalVerticalFov;
+    float fovY = totalVerticalFov;
+    float projectionCenter_offsetX = (viewFOV.angleRight + viewFOV.angleLeft) / 2.0f;
+    float projectionCenter_offsetY = (viewFOV.angleUp + viewFOV.angleDown) / 2.0f;
+
+    data_VRProjectionMatrixOut ret = {};
+    ret.aspectRatio = aspectRatio;
+    ret.fovY = fovY;
+    ret.offsetX = projectionCenter_offsetX;
+    ret.offsetY = projectionCenter_offsetY;
+
+    return ret;
+}
+
+glm::mat4 calculateProjectionMatrix(float nearZ, float farZ, const XrFovf& fov) {
+    float l = tanf(fov.angleLeft) * nearZ;
+    float r = tanf(fov.angleRight) * nearZ;
+    float b = tanf(fov.angleDown) * nearZ;
+    float t = tanf(fov.angleUp) * nearZ;
+
+    float invW = 1.0f / (r - l);
+    float invH = 1.0f / (t - b);
+    float invD = 1.0f / (farZ - nearZ);
+
+    glm::mat4 dst = {};
+    dst[0][0] = 2.0f * nearZ * invW;
+    dst[1][1] = 2.0f * nearZ * invH;
+    dst[0][2] = (r + l) * invW;
+    dst[1][2] = (t + b) * invH;
+    dst[2][2] = -(farZ + nearZ) * invD;
+    dst[2][3] = -(2.0f * farZ * nearZ) * invD;
+    dst[3][2] = -1.0f;
+    dst[3][3] = 0.0f;
+
+    return dst;
+}
+
+StereoProjection StereoProjection::Calculate(const XrFovf& fov, float zNear, float zFar, float deviceZScale, float deviceZOffset) {
+    auto newProjection = calculateFOVAndOffset(fov);
+
+    StereoProjection result = {};
+    result.aspect = newProjection.aspectRatio;
+    result.fovY = newProjection.fovY;
+    float halfAngle = newProjection.fovY.getLE() * 0.5f;
+    result.fovySin = sinf(halfAngle);
+    result.fovyCos = cosf(halfAngle);
+    result.fovyTan = tanf(halfAngle);
+    result.offset.x = newProjection.offsetX;
+    result.offset.y = newProjection.offsetY;
+
+    glm::fmat4 newMatrix = calculateProjectionMatrix(zNear, zFar, fov);
+    result.matrix = newMatrix;
+
+    // calculate device matrix
+    glm::fmat4 newDeviceMatrix = newMatrix;
+
+    newDeviceMatrix[2][0] *= deviceZScale;
+    newDeviceMatrix[2][1] *= deviceZScale;
+    newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * deviceZOffset) * deviceZScale;
+    newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * deviceZScale + newDeviceMatrix[3][3] * deviceZOffset;
+
+    result.deviceMatrix = newDeviceMatrix;
+    return result;
+}
+
+void StereoProjection::apply(BESeadPerspectiveProjection& projection) const {
+    projection.aspect = aspect;
+    projection.fovYRadiansOrAngle = fovY;
+    projection.fovySin = fovySin;
+    projection.fovyCos = fovyCos;
+    projection.fovyTan = fovyTan;
+    projection.offset = offset;
+    projection.matrix = matrix;
+    projection.deviceMatrix = deviceMatrix;
+
+    projection.dirty = false;
+    projection.deviceDirty = false;
+}
+
+std::optional<CombinedStereoView> CombinedStereoView::Calculate(const std::array<XrPosef, 2>& eyePoses, const std::array<XrFovf, 2>& eyeFOVs, float zNear, float zFar, float pullBack) {
+    CombinedStereoView view = {};
+    view.orientation = glm::slerp(ToGLM(eyePoses[0].orientation), ToGLM(eyePoses[1].orientation), 0.5f);
+    view.position = glm::mix(ToGLM(eyePoses[0].position), ToGLM(eyePoses[1].position), 0.5f) + view.orientation * glm::fvec3(0.0f, 0.0f, pullBack);
+    const glm::fquat toViewSpace = glm::inverse(view.orientation);
+
+    // the frustums are convex, so covering the corners of both eyes covers everything in between
+    glm::fvec2 minTan = glm::fvec2(std::numeric_limits<float>::max());
+    glm::fvec2 maxTan = glm::fvec2(std::numeric_limits<float>::lowest());
+    for (int eye = 0; eye < 2; ++eye) {
+        const XrFovf& fov = eyeFOVs[eye];
+        for (float depth : { zNear, zFar }) {
+            for (float tanX : { tanf(fov.angleLeft), tanf(fov.angleRight) }) {
+                for (float tanY : { tanf(fov.angleDown), tanf(fov.angleUp) }) {
+                    glm::fvec3 world = ToGLM(eyePoses[eye].position) + ToGLM(eyePoses[eye].orientation) * glm::fvec3(tanX * depth, tanY * depth, -depth);
+                    glm::fvec3 local = toViewSpace * (world - view.position);
+                    float localDepth = -local.z;
+                    if (localDepth <= 0.0f) {
+                        return std::nullopt;
+                    }
+                    minTan = glm::min(minTan, glm::fvec2(local) / localDepth);
+                    maxTan = glm::max(maxTan, glm::fvec2(local) / localDepth);
+                }
+            }
+        }
+    }
+
+    view.fov = { atanf(minTan.x), atanf(maxTan.x), atanf(maxTan.y), atanf(minTan.y) };
+    return view;
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include "rendering/openxr.h"
+
+glm::mat4 calculateProjectionMatrix(float nearZ, float farZ, const XrFovf& fov);
+
+// A single view whose frustum contains both eye frustums, used to render one set of shadow cascades that both eyes can share.
+// It sits between the eyes and is pulled back behind them, so that it only needs to be slightly wider than the eyes' combined FOV.
+// Only the pose and FOV are replaced, the cascades keep using the game's clip planes so that their splits stay where the game puts them.
+struct CombinedStereoView {
+    glm::fvec3 position;
+    glm::fquat orientation;
+    XrFovf fov;
+
+    // returns nothing if the eyes are too far apart for the pulled back view to see everything in front of them
+    // the FOV covers the eye frustums between zNear and zFar, except for the last pullBack meters which end up past the far plane
+    static std::optional<CombinedStereoView> Calculate(const std::array<XrPosef, 2>& eyePoses, const std::array<XrFovf, 2>& eyeFOVs, float zNear, float zFar, float pullBack = 1.0f);
+};
+
+// Everything the projection hooks write into a sead::PerspectiveProjection, already in the guest's byte order.
+struct StereoProjection {
+    BEType<float> aspect;
+    BEType<float> fovY;
+    BEType<float> fovySin;
+    BEType<float> fovyCos;
+    BEType<float> fovyTan;
+    BEVec2 offset;
+    BEMatrix44 matrix;
+    BEMatrix44 deviceMatrix;
+
+    static StereoProjection Calculate(const XrFovf& fov, float zNear, float zFar, float deviceZScale, float deviceZOffset);
+
+    // overwrites the FOV, matrices and dirty flags, the clip planes and device z scale/offset are left as they are
+    void apply(BESeadPerspectiveProjection& projection) const;
+};
+
+// The render, light pre-pass and camera projection hooks all turn the same eye FOV into the same matrices several times per frame.
+// Each thread that runs these hooks keeps the results for a few combinations of eye, FOV, clip planes and device z range around.
+// The aspect ratio is derived from the FOV, so it doesn't need to be part of the key.
+class ProjectionCache {
+public:
+    static const StereoProjection& Get(OpenXR::EyeSide side, const XrFovf& fov, float zNear, float zFar, float deviceZScale, float deviceZOffset) {
+        thread_local ProjectionCache s_cache;
+        return s_cache.GetOrCalculate(Key{ side, fov, zNear, zFar, deviceZScale, deviceZOffset });
+    }
+
+    // convenience for the hooks, uses the projection's own clip planes and device z range
+    static void Apply(OpenXR::EyeSide side, const XrFovf& fov, BESeadPerspectiveProjection& projection) {
+        Get(side, fov, projection.zNear.getLE(), projection.zFar.getLE(), projection.deviceZScale.getLE(), projection.deviceZOffset.getLE()).apply(projection);
+    }
+
+    static uint64_t GetCalculations() { return s_calculations.load(std::memory_order_relaxed); }
+
+private:
+    struct Key {
+        OpenXR::EyeSide side;
+        XrFovf fov;
+        float zNear;
+        float zFar;
+        float deviceZScale;
+        float deviceZOffset;
+
+        // compares the bits so that the cached output is exactly what a fresh calculation would produce
+        bool operator==(const Key& other) const {
+            return side == other.side && memcmp(&fov, &other.fov, sizeof(fov)) == 0 && memcmp(&zNear, &other.zNear, sizeof(float) * 4) == 0;
+        }
+    };
+
+    const StereoProjection& GetOrCalculate(const Key& key) {
+        for (Entry& entry : m_entries) {
+            if (entry.valid && entry.key == key) {
+                return entry.projection;
+            }
+        }
+
+        s_calculations.fetch_add(1, std::memory_order_relaxed);
+        Entry& entry = m_entries[m_nextEntry];
+        m_nextEntry = (m_nextEntry + 1) % m_entries.size();
+        entry.projection = StereoProjection::Calculate(key.fov, key.zNear, key.zFar, key.deviceZScale, key.deviceZOffset);
+        entry.key = key;
+        entry.valid = true;
+        return entry.projection;
+    }
+
+    struct Entry {
+        bool valid = false;
+        Key key = {};
+        StereoProjection projection = {};
+    };
+    std::array<Entry, 8> m_entries = {};
+    uint32_t m_nextEntry = 0;
+
+    static inline std::atomic_uint64_t s_calculations = 0;
+};
@@ -2,6 +2,7 @@
 #include "imgui_internal.h"
 #include "instance.h"
 #include "hooking/entity_debugger.h"
+#include "hooking/frame_context.h"
 
 ModSettings g_settings = {};
 
@@ -33,6 +34,8 @@ static void Settings_ReadLine(ImGuiContext*, ImGuiSettingsHandler*, void* entry,
     if (sscanf(line, "PerformanceOverlay=%d", &i_val) == 1) { s->performanceOverlay.store(i_val); return; }
     if (sscanf(line, "PerformanceOverlayFrequency=%d", &i_val) == 1) { s->performanceOverlayFrequency.store(i_val); return; }
     if (sscanf(line, "TutorialPromptShown=%d", &i_val) == 1) { s->tutorialPromptShown.store(i_val); return; }
+    if (sscanf(line, "ShareShadowCascades=%d", &i_val) == 1) { s->shareShadowCascades.store(i_val); return; }
+    if (sscanf(line, "ShadowUpdateInterval=%d", &i_val) == 1) { s->shadowUpdateInterval.store(i_val); return; }
     if (sscanf(line, "AxisThreshold=%f", &f_val) == 1) { s->axisThreshold.store(f_val); return; }
     if (sscanf(line, "StickDeadzone=%f", &f_val) == 1) { s->stickDeadzone.store(f_val); return; }
 }
@@ -55,6 +58,8 @@ static void Settings_WriteAll(ImGuiContext* ctx, ImGuiSettingsHandler* handler,
     buf->appendf("PerformanceOverlay=%d\n", (int)s.performanceOverlay.load());
     buf->appendf("PerformanceOverlayFrequency=%d\n", s.performanceOverlayFrequency.load());
     buf->appendf("TutorialPromptShown=%d\n", (int)s.tutorialPromptShown.load());
+    buf->appendf("ShareShadowCascades=%d\n", (int)s.shareShadowCascades.load());
+    buf->appendf("ShadowUpdateInterval=%d\n", s.shadowUpdateInterval.load());
     buf->appendf("AxisThreshold=%.3f\n", s.axisThreshold.load());
     buf->appendf("StickDeadzone=%.3f\n", s.stickDeadzone.load());
     buf->appendf("\n");
@@ -74,16 +79,28 @@ HWND CemuHooks::m_cemuTopWindow = NULL;
 HWND CemuHooks::m_cemuRenderWindow = NULL;
 uint64_t CemuHooks::s_memoryBaseAddress = 0;
 std::atomic_uint32_t CemuHooks::s_framesSinceLastCameraUpdate = 0;
+std::atomic_uint32_t CemuHooks::s_guestFrame = 1;
+std::array<std::atomic_uint64_t, std::to_underlying(ScreenId::ScreenId_END) + 1> CemuHooks::s_openScreens = {};
+std::atomic_uint64_t CemuHooks::s_screenLookups = 0;
 
 
 bool CemuHooks::IsScreenOpen(ScreenId screen) {
+    const uint32_t frame = s_guestFrame.load(std::memory_order_relaxed);
+    std::atomic_uint64_t& cachedScreen = s_openScreens[std::to_underlying(screen)];
+    if (uint64_t cached = cachedScreen.load(std::memory_order_relaxed); (cached >> 1) == frame) {
+        return (cached & 1) != 0;
+    }
+
+    s_screenLookups.fetch_add(1, std::memory_order_relaxed);
+    bool isOpen = false;
     uint32_t screenManagerInstance = getMemory<BEType<uint32_t>>(0x1047E650).getLE();
     if (screenManagerInstance != 0) {
         uint32_t screenBools = getMemory<BEType<uint32_t>>(screenManagerInstance + 0x18).getLE();
         uint32_t screenPtr = getMemory<BEType<uint32_t>>(screenBools + (std::to_underlying(screen) * 4)).getLE();
-        return screenPtr != 0;
+        isOpen = screenPtr != 0;
     }
-    return false;
+    cachedScreen.store(((uint64_t)frame << 1) | (isOpen ? 1 : 0), std::memory_order_relaxed);
+    return isOpen;
 }
 
 std::unordered_set<ScreenId> prevEnabledScreens = {};
@@ -130,6 +147,9 @@ void CemuHooks::hook_UpdateSettings(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
     uint32_t ppc_tableOfCutsceneEventSettings = hCPU->gpr[6];
+
+    BeginGuestFrame();
+    HookFrameContext::Capture();
     
     if (GetSettings().ShowDebugOverlay() && VRManager::instance().Hooks->m_entityDebugger) {
         VRManager::instance().Hooks->m_entityDebugger->UpdateEntityMemory();
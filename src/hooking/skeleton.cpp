@@ -1,79 +1,45 @@
 #include "instance.h"
 #include "cemu_hooks.h"
 #include "rendering/openxr.h"
+#include "frame_context.h"
+#include "skeleton.h"
+
+/*
+    Waist | 0 0 0 | 1.5708 0 -1.5708
+      Leg_1_L | 0.10854 0.0165 -0.11209 | 0 0 0
+        Knee_L | 0.39619 0.0308 0 | 0 0 0
+        Leg_2_L | 0.42 0 -0.08727 | 0 0 0
+      Leg_1_R | 0.10854 0.0165 0.11209 | 0 0 3.14159
+        Knee_R | -0.39619 -0.0308 0 | 0 0 0
+        Leg_2_R | -0.42 0 -0.08727 | 0 0 0
+ */
 
 struct Bone {
-    std::string name;
+    std::string_view name;
     glm::vec3 localPos;
     glm::vec3 localRotEuler; // in radians
     glm::mat4 localMatrix;
     glm::mat4 worldMatrix;
     int parentIndex = -1;
     std::vector<int> childrenIndices;
-    int indentLevel = 0;
 };
 
 class Skeleton {
 public:
-    void Parse(const std::string& data) {
+    void Build() {
         m_bones.clear();
-        m_boneNameMap.clear();
-
-        std::stringstream ss(data);
-        std::string line;
-
-        // this parses the bone hierarchy using the indentation levels to calculate parent-child relationships and model space transforms
-        std::vector<std::pair<int, int>> parentStack;
-        parentStack.push_back({ -1, -1 }); // Root parent is -1
-
-        while (std::getline(ss, line)) {
-            if (line.empty()) continue;
-
-            int indent = 0;
-            while (indent < line.length() && line[indent] == ' ') indent++;
-
-            size_t start = line.find_first_not_of(" \t");
-            if (start == std::string::npos) continue;
-
-            std::string content = line.substr(start);
-            size_t p1 = content.find('|');
-            if (p1 == std::string::npos) continue;
-
-            std::string currentName = content.substr(0, p1);
-            size_t lastChar = currentName.find_last_not_of(' ');
-            if (lastChar != std::string::npos) currentName = currentName.substr(0, lastChar + 1);
-
-            size_t p2 = content.find('|', p1 + 1);
-            if (p2 == std::string::npos) continue;
-
-            glm::vec3 pos, rotEuler;
-            std::stringstream ssPos(content.substr(p1 + 1, p2 - p1 - 1));
-            ssPos >> pos.x >> pos.y >> pos.z;
-            std::stringstream ssRot(content.substr(p2 + 1));
-            ssRot >> rotEuler.x >> rotEuler.y >> rotEuler.z;
-
-            Bone bone;
-            bone.name = currentName;
-            bone.localPos = pos;
-            bone.localRotEuler = rotEuler;
-            bone.indentLevel = indent;
-            bone.localMatrix = glm::translate(glm::identity<glm::mat4>(), pos) * glm::eulerAngleZYX(rotEuler.x, rotEuler.y, rotEuler.z);
-
-            while (parentStack.size() > 1 && parentStack.back().first >= indent) {
-                parentStack.pop_back();
-            }
-
-            bone.parentIndex = parentStack.back().second;
-
-            int newIndex = (int)m_bones.size();
+        m_bones.reserve(SKELETON_BONES.size());
+
+        for (const BoneDefinition& definition : SKELETON_BONES) {
+            Bone& bone = m_bones.emplace_back();
+            bone.name = definition.name;
+            bone.localPos = glm::vec3(definition.localPos[0], definition.localPos[1], definition.localPos[2]);
+            bone.localRotEuler = glm::vec3(definition.localRotEuler[0], definition.localRotEuler[1], definition.localRotEuler[2]);
+            bone.localMatrix = glm::translate(glm::identity<glm::mat4>(), bone.localPos) * glm::eulerAngleZYX(bone.localRotEuler.x, bone.localRotEuler.y, bone.localRotEuler.z);
+            bone.parentIndex = definition.parent == SkeletonBone::NONE ? -1 : std::to_underlying(definition.parent);
             if (bone.parentIndex != -1) {
-                m_bones[bone.parentIndex].childrenIndices.push_back(newIndex);
+                m_bones[bone.parentIndex].childrenIndices.push_back((int)m_bones.size() - 1);
             }
-
-            m_bones.push_back(bone);
-            m_boneNameMap[bone.name] = newIndex;
-
-            parentStack.push_back({ indent, newIndex });
         }
 
         UpdateWorldMatrices();
@@ -184,70 +150,20 @@ public:
         UpdateWorldMatrices();
     }
 
-    int GetBoneIndex(const std::string& name) const {
-        auto it = m_boneNameMap.find(name);
-        if (it != m_boneNameMap.end()) return it->second;
-        return -1;
-    }
-
     Bone* GetBone(int index) {
         if (index < 0 || index >= m_bones.size()) return nullptr;
         return &m_bones[index];
     }
 
-    Bone* GetBone(const std::string& name) {
-        int idx = GetBoneIndex(name);
-        if (idx == -1) return nullptr;
-        return &m_bones[idx];
+    Bone* GetBone(SkeletonBone bone) {
+        return GetBone(bone == SkeletonBone::NONE ? -1 : std::to_underlying(bone));
     }
 
 private:
     std::vector<Bone> m_bones;
-    std::map<std::string, int> m_boneNameMap;
 };
 
-const std::string SKELETON_DATA = R"(
-Root | 0 0 0 | 0 0 0
-  Skl_Root | 0 0.99426 0 | 0 0 0
-    Spine_1 | 0 0 0 | 1.5708 0 1.5708
-      Spine_2 | 0.136 0 0 | 0 0 0
-        Clavicle_L | 0.23961 -0.00002 0.03291 | 0 -1.5708 0
-          Arm_1_L | 0.15 0 0.01074 | 0 0 0
-            Arm_1_Assist_L | 0.06 0.00002 0 | 0 0 0
-            Arm_2_L | 0.24 0 0 | 0 0 0
-              Elbow_L | 0.04151 -0.02934 0.00021 | 0 0 0
-              Wrist_Assist_L | 0.25809 0.00002 -0.00012 | 0 0 0
-              Wrist_L | 0.27718 0 0 | 0 0 0
-                Weapon_L | 0.1069 0.00002 0.02769 | 1.5708 0 3.14159
-          Clavicle_Assist_L | 0.116 0 0.0107 | 0 0 0
-        Clavicle_R | 0.2396 -0.00002 -0.03291 | 3.14159 -1.5708 0
-          Arm_1_R | -0.15 0 -0.01074 | 0 0 0
-            Arm_1_Assist_R | -0.06 -0.00002 0 | 0 0 0
-            Arm_2_R | -0.24 0 0 | 0 0 0
-              Elbow_R | -0.04151 0.02934 -0.0002 | 0 0 0
-              Wrist_Assist_R | -0.25809 -0.00002 0.00012 | 0 0 0
-              Wrist_R | -0.27718 0 0 | 0 0 0
-                Weapon_R | -0.1069 -0.00002 -0.02769 | 1.5708 0 0
-          Clavicle_Assist_R | -0.116 0 -0.0107 | 0 0 0
-        Neck | 0.26326 0 0 | 0 0 0
-          Head | 0.12447 0 0 | 0 0 0
-            Face_Root | 0 0 0 | 0 0 0
-              Chin | 0.04787 0.05757 0 | 0 0 2.53073
-              Eyeball_L | 0.07017 0.12036 0.04815 | 0 0 0
-              Eyeball_R | 0.07017 0.12036 -0.04815 | 0 0 0
-)";
-
-/*
-    Waist | 0 0 0 | 1.5708 0 -1.5708
-      Leg_1_L | 0.10854 0.0165 -0.11209 | 0 0 0
-        Knee_L | 0.39619 0.0308 0 | 0 0 0
-        Leg_2_L | 0.42 0 -0.08727 | 0 0 0
-      Leg_1_R | 0.10854 0.0165 0.11209 | 0 0 3.14159
-        Knee_R | -0.39619 -0.0308 0 | 0 0 0
-        Leg_2_R | -0.42 0 -0.08727 | 0 0 0
- */
-
-static bool isFaceBone(const std::string_view& boneName) {
+bool isFaceBone(const std::string_view& boneName) {
     if (boneName.starts_with("Eye" /*lid*/) || boneName.starts_with("Cheek") || boneName.starts_with("Lip") || boneName.starts_with("Hair")) {
         return true;
     }
@@ -257,62 +173,122 @@ static bool isFaceBone(const std::string_view& boneName) {
     return false;
 }
 
+static ResolvedBone ResolveBone(std::string_view boneName) {
+    ResolvedBone bone;
+    bone.isLeft = boneName.ends_with("_L");
+    bone.flags |= isFaceBone(boneName) ? ResolvedBone::FACE : 0;
+    for (size_t i = 0; i < SKELETON_BONES.size(); ++i) {
+        if (SKELETON_BONES[i].name == boneName) {
+            bone.skeletonBone = (SkeletonBone)i;
+            break;
+        }
+    }
+
+    switch (bone.skeletonBone) {
+        case SkeletonBone::Arm_1_L:
+        case SkeletonBone::Arm_1_R:
+        case SkeletonBone::Elbow_L:
+        case SkeletonBone::Elbow_R:
+            bone.flags |= ResolvedBone::SOLVE_ARM_IK;
+            break;
+        case SkeletonBone::Wrist_Assist_L:
+        case SkeletonBone::Wrist_Assist_R:
+            bone.flags |= ResolvedBone::SOLVE_ARM_IK | ResolvedBone::ALIGN_WITH_CONTROLLER;
+            break;
+        case SkeletonBone::Wrist_L:
+        case SkeletonBone::Wrist_R:
+            bone.flags |= ResolvedBone::ALIGN_WITH_CONTROLLER;
+            break;
+        default:
+            break;
+    }
+    return bone;
+}
+
+// the bones of every model that the hook ran for, keyed by the guest address of its gsys::Model
+static std::unordered_map<uint32_t, ModelBones> s_modelBones;
+static uint32_t s_lastModelPruneFrame = 0;
+
+void ClearModelBones() {
+    s_modelBones.clear();
+    s_lastModelPruneFrame = 0;
+}
+
+ModelBones* GetPlayerModelBones(uint32_t gsysModelPtr, uint32_t guestFrame) {
+    // forget the models that were deleted every now and then
+    if (guestFrame - s_lastModelPruneFrame >= 600) {
+        std::erase_if(s_modelBones, [&](const auto& entry) { return guestFrame - entry.second.validatedFrame > 60; });
+        s_lastModelPruneFrame = guestFrame;
+    }
+
+    ModelBones& model = s_modelBones[gsysModelPtr];
+    // the game can create another model at the address of a deleted one, so its name is checked again once per guest frame
+    if (model.validatedFrame != guestFrame) {
+        const bool isPlayer = CemuHooks::getMemory<sead::FixedSafeString100>(gsysModelPtr + 0x128).getLE() == "GameROMPlayer";
+        if (!isPlayer) {
+            model.bones.clear();
+        }
+        model.isPlayer = isPlayer;
+        model.revalidateBoneNames = model.validatedFrame + 1 != guestFrame;
+        model.validatedFrame = guestFrame;
+    }
+    return model.isPlayer ? &model : nullptr;
+}
+
+const ResolvedBone& GetResolvedBone(ModelBones& model, uint32_t boneIdx, uint32_t boneNamePtr) {
+    if (boneIdx >= model.bones.size()) {
+        model.bones.resize(boneIdx + 1);
+    }
+    ResolvedBone& bone = model.bones[boneIdx];
+    if (bone.namePtr != boneNamePtr) {
+        bone = ResolveBone((const char*)(CemuHooks::s_memoryBaseAddress + boneNamePtr));
+        bone.namePtr = boneNamePtr;
+    }
+    return bone;
+}
+
 static Skeleton s_skeleton;
-static bool s_skeletonParsed = false;
+static bool s_skeletonBuilt = false;
 static glm::vec3 s_manualBodyOffset = glm::vec3(0.0f, 0.0f, -0.075f);
 static glm::mat4 s_handCorrectionRotationLeft = glm::mat4(1.0f);
 static glm::mat4 s_handCorrectionRotationRight = glm::mat4(1.0f);
 
-void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
-    hCPU->instructionPointer = hCPU->sprNew.LR;
-
-    const uint32_t gsysModelPtr = hCPU->gpr[3];
-    const uint32_t matrixPtr = hCPU->gpr[4];
-    const uint32_t scalePtr = hCPU->gpr[5];
-    const uint32_t boneNamePtr = hCPU->gpr[6];
-    if (!gsysModelPtr || !matrixPtr || !scalePtr || !boneNamePtr) return;
+// the state that every bone of the player needs, read once per hook call
+struct BonePoseFrame {
+    glm::fmat4 playerMtx;
+    glm::mat4 cameraMtx;
+};
 
-    const auto modelName = getMemory<sead::FixedSafeString100>(gsysModelPtr + 0x128);
-    if (modelName.getLE() != "GameROMPlayer") return;
+static BonePoseFrame GetBonePoseFrame() {
+    return {
+        .playerMtx = glm::fmat4(CemuHooks::getMemory<BEMatrix34>(CemuHooks::s_playerMtxAddress).getLEMatrix()),
+        .cameraMtx = CemuHooks::s_lastCameraMtx
+    };
+}
 
-    std::string boneName((char*)(s_memoryBaseAddress + boneNamePtr));
-    const bool isLeft = boneName.ends_with("_L");
+static BoneTransform CalculateBoneTransform(const ResolvedBone& bone, const BonePoseFrame& frame) {
+    const bool isLeft = bone.isLeft;
     const OpenXR::EyeSide side = isLeft ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
 
-    // helpers to write back matrix and scale
-    auto writeBoneMatrix = [&](const glm::mat4x3& mtx, const glm::fvec3& scale) {
-        BEMatrix34 m{ mtx };
-        setMemory(matrixPtr, m);
-        setMemory(scalePtr, scale);
-    };
-    auto writeBoneQuat = [&](const glm::vec3& pos, const glm::quat& rot, const glm::fvec3& scale) {
-        BEMatrix34 m{ pos, rot };
-        setMemory(matrixPtr, m);
-        setMemory(scalePtr, scale);
-    };
-
-    if (IsThirdPerson()) {
-        if (isFaceBone(boneName)) {
-            setMemory(scalePtr, glm::fvec3(1.0f));
+    if (CemuHooks::IsThirdPerson()) {
+        if (bone.flags & ResolvedBone::FACE) {
+            return { .scale = glm::fvec3(1.0f) };
         }
-        return;
+        return {};
     }
 
-
-    if (isFaceBone(boneName)) {
-        writeBoneQuat(glm::fvec3(), glm::identity<glm::fquat>(), glm::fvec3(0.05f));
-        return;
+    if (bone.flags & ResolvedBone::FACE) {
+        return { .matrix = glm::mat4x3(1.0f), .scale = glm::fvec3(0.05f) };
     }
 
-    glm::fvec3 boneScale = getMemory<BEVec3>(scalePtr).getLE();
-    const glm::fmat4 playerMtx4 = glm::fmat4(getMemory<BEMatrix34>(s_playerMtxAddress).getLEMatrix());
-    const glm::mat4 cameraMtx = s_lastCameraMtx;
+    const glm::fmat4& playerMtx4 = frame.playerMtx;
+    const glm::mat4& cameraMtx = frame.cameraMtx;
 
-    const OpenXR::InputState inputs = VRManager::instance().XR->m_input.load();
-    if (!inputs.shared.pose[side].isActive)
-        return;
+    const OpenXR::InputState::Shared& inputs = HookFrameContext::GetInput().shared;
+    if (!inputs.pose[side].isActive)
+        return {};
 
-    const auto& pose = inputs.shared.poseLocation[side];
+    const auto& pose = inputs.poseLocation[side];
     glm::fvec3 controllerPos = glm::fvec3();
     glm::fquat controllerRot = glm::identity<glm::fquat>();
     if (pose.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT)
@@ -321,9 +297,9 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
         controllerRot = ToGLM(pose.pose.orientation);
 
     // one-time skeleton and hand correction initialization
-    if (!s_skeletonParsed) {
-        s_skeleton.Parse(SKELETON_DATA);
-        s_skeletonParsed = true;
+    if (!s_skeletonBuilt) {
+        s_skeleton.Build();
+        s_skeletonBuilt = true;
 
         // left: 90 Y -> -90 Z -> 30 Z
         glm::fquat wristL = glm::identity<glm::fquat>();
@@ -342,9 +318,9 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
         s_handCorrectionRotationRight = glm::mat4_cast(wristR);
     }
 
-    int boneIndex = s_skeleton.GetBoneIndex(boneName);
-    if (boneIndex == -1)
-        return;
+    if (bone.skeletonBone == SkeletonBone::NONE)
+        return {};
+    const int boneIndex = std::to_underlying(bone.skeletonBone);
 
     // compute the controller target in model space
     auto calcControllerTargetModel = [&]() -> glm::mat4 {
@@ -352,8 +328,7 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
         glm::mat4 controllerMat = glm::translate(glm::identity<glm::mat4>(), controllerPos) * glm::mat4_cast(controllerRot) * handCorrectionMtx;
         glm::mat4 targetWorld = cameraMtx * controllerMat;
 
-        const char* weaponName = isLeft ? "Weapon_L" : "Weapon_R";
-        if (Bone* weapon = s_skeleton.GetBone(weaponName)) {
+        if (Bone* weapon = s_skeleton.GetBone(isLeft ? SkeletonBone::Weapon_L : SkeletonBone::Weapon_R)) {
             glm::vec3 weaponOffset = glm::vec3(weapon->localMatrix[3]);
             targetWorld = targetWorld * glm::translate(glm::identity<glm::mat4>(), -weaponOffset);
         }
@@ -364,7 +339,7 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
     glm::mat4 calculatedLocalMat = s_skeleton.GetBone(boneIndex)->localMatrix;
 
     // override the root transform so the body aligns with the headset yaw
-    if (boneName == "Skl_Root") {
+    if (bone.skeletonBone == SkeletonBone::Skl_Root) {
         auto headsetPose = VRManager::instance().XR->GetRenderer()->GetMiddlePose();
         glm::mat4 headsetMtx = headsetPose.value_or(ToMat4(glm::fvec3(0)));
 
@@ -372,9 +347,9 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
         static glm::vec3 eyeOffset = glm::vec3(0.0f);
         static bool offsetCalculated = false;
         if (!offsetCalculated) {
-            Bone* eyeL = s_skeleton.GetBone("Eyeball_L");
-            Bone* eyeR = s_skeleton.GetBone("Eyeball_R");
-            Bone* sklRoot = s_skeleton.GetBone("Skl_Root");
+            Bone* eyeL = s_skeleton.GetBone(SkeletonBone::Eyeball_L);
+            Bone* eyeR = s_skeleton.GetBone(SkeletonBone::Eyeball_R);
+            Bone* sklRoot = s_skeleton.GetBone(SkeletonBone::Skl_Root);
             if (eyeL && eyeR && sklRoot) {
                 glm::vec3 eyePos = (glm::vec3(eyeL->worldMatrix[3]) + glm::vec3(eyeR->worldMatrix[3])) * 0.5f;
                 eyeOffset = eyePos - glm::vec3(sklRoot->worldMatrix[3]);
@@ -399,42 +374,109 @@ void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
         glm::vec3 targetPos = glm::vec3(headsetModel[3]) - (yawRot * eyeOffset) + (yawRot * s_manualBodyOffset);
 
         // update skeleton for children (hands)
-        if (Bone* rootBone = s_skeleton.GetBone("Skl_Root")) {
+        if (Bone* rootBone = s_skeleton.GetBone(SkeletonBone::Skl_Root)) {
             rootBone->localMatrix = glm::translate(glm::identity<glm::mat4>(), targetPos) * glm::mat4_cast(yawRot);
             s_skeleton.UpdateWorldMatrices();
         }
 
-        writeBoneQuat(targetPos, yawRot, boneScale);
-        return;
+        glm::mat4x3 rootMtx = glm::mat4x3(glm::mat3_cast(yawRot));
+        rootMtx[3] = targetPos;
+        return { .matrix = rootMtx };
     }
 
     // solve upper arm IK so the arms reach the VR controllers
-    if (boneName == "Arm_1_L" || boneName == "Arm_1_R" ||
-        boneName == "Elbow_L" || boneName == "Elbow_R" ||
-        boneName == "Wrist_Assist_L" || boneName == "Wrist_Assist_R") {
-
-        int arm1Index = s_skeleton.GetBoneIndex(isLeft ? "Arm_1_L" : "Arm_1_R");
-        int arm2Index = s_skeleton.GetBoneIndex(isLeft ? "Arm_2_L" : "Arm_2_R");
-        int wristIndex = s_skeleton.GetBoneIndex(isLeft ? "Wrist_L" : "Wrist_R");
+    if (bone.flags & ResolvedBone::SOLVE_ARM_IK) {
+        int arm1Index = std::to_underlying(isLeft ? SkeletonBone::Arm_1_L : SkeletonBone::Arm_1_R);
+        int arm2Index = std::to_underlying(isLeft ? SkeletonBone::Arm_2_L : SkeletonBone::Arm_2_R);
+        int wristIndex = std::to_underlying(isLeft ? SkeletonBone::Wrist_L : SkeletonBone::Wrist_R);
 
-        if (arm1Index != -1 && arm2Index != -1 && wristIndex != -1) {
-            glm::vec3 targetPos = glm::vec3(calcControllerTargetModel()[3]);
+        glm::vec3 targetPos = glm::vec3(calcControllerTargetModel()[3]);
 
-            // pole vector (elbow hint): left-down-back / right-down-back, rotated by body yaw
-            glm::vec3 poleDir = isLeft ? glm::vec3(1.0f, -1.0f, -0.5f) : glm::vec3(-1.0f, -1.0f, -0.5f);
-            if (Bone* rootBone = s_skeleton.GetBone("Skl_Root"))
-                poleDir = glm::quat_cast(rootBone->localMatrix) * poleDir;
+        // pole vector (elbow hint): left-down-back / right-down-back, rotated by body yaw
+        glm::vec3 poleDir = isLeft ? glm::vec3(1.0f, -1.0f, -0.5f) : glm::vec3(-1.0f, -1.0f, -0.5f);
+        if (Bone* rootBone = s_skeleton.GetBone(SkeletonBone::Skl_Root))
+            poleDir = glm::quat_cast(rootBone->localMatrix) * poleDir;
 
-            s_skeleton.SolveTwoBoneIK(arm1Index, arm2Index, wristIndex, targetPos, poleDir, isLeft ? 1.0f : -1.0f);
-            calculatedLocalMat = s_skeleton.GetBone(boneIndex)->localMatrix;
-        }
+        s_skeleton.SolveTwoBoneIK(arm1Index, arm2Index, wristIndex, targetPos, poleDir, isLeft ? 1.0f : -1.0f);
+        calculatedLocalMat = s_skeleton.GetBone(boneIndex)->localMatrix;
     }
 
     // align the wrist and wrist assist directly with the controller pose
-    if (boneName == "Wrist_L" || boneName == "Wrist_R" ||
-        boneName == "Wrist_Assist_L" || boneName == "Wrist_Assist_R") {
+    if (bone.flags & ResolvedBone::ALIGN_WITH_CONTROLLER) {
         calculatedLocalMat = s_skeleton.CalculateLocalMatrixFromWorld(boneIndex, calcControllerTargetModel());
     }
 
-    writeBoneMatrix(glm::mat4x3(calculatedLocalMat), boneScale);
-}
\ No newline at end of file
+    return { .matrix = glm::mat4x3(calculatedLocalMat) };
+}
+
+void ModifyBoneMatrix(uint32_t gsysModelPtr, uint32_t matrixPtr, uint32_t scalePtr, uint32_t boneNamePtr, uint32_t boneIdx) {
+    if (!gsysModelPtr || !matrixPtr || !scalePtr || !boneNamePtr) return;
+
+    const uint32_t guestFrame = CemuHooks::GetGuestFrame();
+    ModelBones* playerModel = GetPlayerModelBones(gsysModelPtr, guestFrame);
+    if (playerModel == nullptr) return;
+
+    // bones that weren't resolved yet when the model got prepared (or got another name since) are calculated on their own
+    const ResolvedBone& bone = GetResolvedBone(*playerModel, boneIdx, boneNamePtr);
+    const BoneTransform transform = bone.preparedFrame == guestFrame ? bone.prepared : CalculateBoneTransform(bone, GetBonePoseFrame());
+    if (transform.matrix.has_value()) {
+        BEMatrix34 m{ transform.matrix.value() };
+        CemuHooks::setMemory(matrixPtr, m);
+    }
+    if (transform.scale.has_value()) {
+        CemuHooks::setMemory(scalePtr, transform.scale.value());
+    }
+}
+
+void CemuHooks::hook_ModifyBoneMatrix(PPCInterpreter_t* hCPU) {
+    hCPU->instructionPointer = hCPU->sprNew.LR;
+
+    ModifyBoneMatrix(hCPU->gpr[3], hCPU->gpr[4], hCPU->gpr[5], hCPU->gpr[6], hCPU->gpr[7]);
+}
+
+// called once per frame for each model before the guest copies its bones, and returns whether its bones can skip hook_ModifyBoneMatrix.
+// only the player's bones get modified, which happens while the guest copies each of them into the pose for havok so that the model's own
+// bone palette is left as the game animated it. their transforms are calculated here in one go though, in the same bone order that the guest
+// copies them in since the arm IK and the wrists use the state that the bones before them left in s_skeleton. the guest then only calls
+// hook_ModifyBoneMatrix for the bones that have something to write or that still need to be resolved, which boneHookMaskPtr tells it.
+bool PrepareModelBones(uint32_t gsysModelPtr, uint32_t boneHookMaskPtr) {
+    if (!gsysModelPtr || !boneHookMaskPtr) return false;
+
+    const uint32_t guestFrame = CemuHooks::GetGuestFrame();
+    ModelBones* playerModel = GetPlayerModelBones(gsysModelPtr, guestFrame);
+    if (playerModel == nullptr) return true;
+
+    // the bones past the ones that were resolved so far haven't been seen yet, and when the model's bone names need to be checked again
+    // every bone goes through the hook once
+    std::array<uint32_t, BONE_HOOK_MASK_WORDS> boneHookMask;
+    boneHookMask.fill(0xFFFFFFFF);
+    if (!playerModel->revalidateBoneNames) {
+        for (uint32_t boneIdx = 0; boneIdx < std::min<size_t>(playerModel->bones.size(), BONE_HOOK_MASK_BONES); ++boneIdx) {
+            if (playerModel->bones[boneIdx].namePtr != 0) {
+                boneHookMask[boneIdx / 32] &= ~(1u << (boneIdx % 32));
+            }
+        }
+    }
+
+    const BonePoseFrame frame = GetBonePoseFrame();
+    for (uint32_t boneIdx = 0; boneIdx < playerModel->bones.size(); ++boneIdx) {
+        ResolvedBone& bone = playerModel->bones[boneIdx];
+        if (bone.namePtr == 0) continue;
+        bone.prepared = CalculateBoneTransform(bone, frame);
+        bone.preparedFrame = guestFrame;
+        if (boneIdx < BONE_HOOK_MASK_BONES && (bone.prepared.matrix.has_value() || bone.prepared.scale.has_value())) {
+            boneHookMask[boneIdx / 32] |= 1u << (boneIdx % 32);
+        }
+    }
+
+    std::array<BEType<uint32_t>, BONE_HOOK_MASK_WORDS> guestMask;
+    std::ranges::copy(boneHookMask, guestMask.begin());
+    CemuHooks::writeMemory(boneHookMaskPtr, &guestMask);
+    return false;
+}
+
+void CemuHooks::hook_PrepareModelBones(PPCInterpreter_t* hCPU) {
+    hCPU->instructionPointer = hCPU->sprNew.LR;
+
+    hCPU->gpr[3] = PrepareModelBones(hCPU->gpr[3], hCPU->gpr[4]) ? 1 : 0;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+// the bones of the player's upper body, in the same order as SKELETON_BONES
+enum class SkeletonBone : uint8_t {
+    Root,
+    Skl_Root,
+    Spine_1,
+    Spine_2,
+    Clavicle_L,
+    Arm_1_L,
+    Arm_1_Assist_L,
+    Arm_2_L,
+    Elbow_L,
+    Wrist_Assist_L,
+    Wrist_L,
+    Weapon_L,
+    Clavicle_Assist_L,
+    Clavicle_R,
+    Arm_1_R,
+    Arm_1_Assist_R,
+    Arm_2_R,
+    Elbow_R,
+    Wrist_Assist_R,
+    Wrist_R,
+    Weapon_R,
+    Clavicle_Assist_R,
+    Neck,
+    Head,
+    Face_Root,
+    Chin,
+    Eyeball_L,
+    Eyeball_R,
+    COUNT,
+    NONE = 0xFF
+};
+
+struct BoneDefinition {
+    std::string_view name;
+    SkeletonBone parent;
+    std::array<float, 3> localPos;
+    std::array<float, 3> localRotEuler; // in radians
+};
+
+// every parent comes before its children, so the world matrices can be calculated in a single pass
+inline constexpr std::array<BoneDefinition, std::to_underlying(SkeletonBone::COUNT)> SKELETON_BONES = {{
+    { "Root", SkeletonBone::NONE, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Skl_Root", SkeletonBone::Root, { 0.0f, 0.99426f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Spine_1", SkeletonBone::Skl_Root, { 0.0f, 0.0f, 0.0f }, { 1.5708f, 0.0f, 1.5708f } },
+    { "Spine_2", SkeletonBone::Spine_1, { 0.136f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Clavicle_L", SkeletonBone::Spine_2, { 0.23961f, -0.00002f, 0.03291f }, { 0.0f, -1.5708f, 0.0f } },
+    { "Arm_1_L", SkeletonBone::Clavicle_L, { 0.15f, 0.0f, 0.01074f }, { 0.0f, 0.0f, 0.0f } },
+    { "Arm_1_Assist_L", SkeletonBone::Arm_1_L, { 0.06f, 0.00002f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Arm_2_L", SkeletonBone::Arm_1_L, { 0.24f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Elbow_L", SkeletonBone::Arm_2_L, { 0.04151f, -0.02934f, 0.00021f }, { 0.0f, 0.0f, 0.0f } },
+    { "Wrist_Assist_L", SkeletonBone::Arm_2_L, { 0.25809f, 0.00002f, -0.00012f }, { 0.0f, 0.0f, 0.0f } },
+    { "Wrist_L", SkeletonBone::Arm_2_L, { 0.27718f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Weapon_L", SkeletonBone::Wrist_L, { 0.1069f, 0.00002f, 0.02769f }, { 1.5708f, 0.0f, 3.14159f } },
+    { "Clavicle_Assist_L", SkeletonBone::Clavicle_L, { 0.116f, 0.0f, 0.0107f }, { 0.0f, 0.0f, 0.0f } },
+    { "Clavicle_R", SkeletonBone::Spine_2, { 0.2396f, -0.00002f, -0.03291f }, { 3.14159f, -1.5708f, 0.0f } },
+    { "Arm_1_R", SkeletonBone::Clavicle_R, { -0.15f, 0.0f, -0.01074f }, { 0.0f, 0.0f, 0.0f } },
+    { "Arm_1_Assist_R", SkeletonBone::Arm_1_R, { -0.06f, -0.00002f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Arm_2_R", SkeletonBone::Arm_1_R, { -0.24f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Elbow_R", SkeletonBone::Arm_2_R, { -0.04151f, 0.02934f, -0.0002f }, { 0.0f, 0.0f, 0.0f } },
+    { "Wrist_Assist_R", SkeletonBone::Arm_2_R, { -0.25809f, -0.00002f, 0.00012f }, { 0.0f, 0.0f, 0.0f } },
+    { "Wrist_R", SkeletonBone::Arm_2_R, { -0.27718f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Weapon_R", SkeletonBone::Wrist_R, { -0.1069f, -0.00002f, -0.02769f }, { 1.5708f, 0.0f, 0.0f } },
+    { "Clavicle_Assist_R", SkeletonBone::Clavicle_R, { -0.116f, 0.0f, -0.0107f }, { 0.0f, 0.0f, 0.0f } },
+    { "Neck", SkeletonBone::Spine_2, { 0.26326f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Head", SkeletonBone::Neck, { 0.12447f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Face_Root", SkeletonBone::Head, { 0.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, 0.0f } },
+    { "Chin", SkeletonBone::Face_Root, { 0.04787f, 0.05757f, 0.0f }, { 0.0f, 0.0f, 2.53073f } },
+    { "Eyeball_L", SkeletonBone::Face_Root, { 0.07017f, 0.12036f, 0.04815f }, { 0.0f, 0.0f, 0.0f } },
+    { "Eyeball_R", SkeletonBone::Face_Root, { 0.07017f, 0.12036f, -0.04815f }, { 0.0f, 0.0f, 0.0f } },
+}};
+
+static_assert([]() {
+    for (size_t i = 0; i < SKELETON_BONES.size(); ++i) {
+        if (SKELETON_BONES[i].parent != SkeletonBone::NONE && std::to_underlying(SKELETON_BONES[i].parent) >= i) {
+            return false;
+        }
+    }
+    return true;
+}(), "SKELETON_BONES needs every parent to come before its children");
+
+// the new local transform of a bone, whatever isn't set is kept as the game animated it
+struct BoneTransform {
+    std::optional<glm::mat4x3> matrix;
+    std::optional<glm::fvec3> scale;
+};
+
+// what hook_ModifyBoneMatrix needs to know about a bone of the player's model, resolved from its name the first time it shows up
+struct ResolvedBone {
+    enum Flags : uint8_t {
+        FACE = 1 << 0,
+        SOLVE_ARM_IK = 1 << 1,
+        ALIGN_WITH_CONTROLLER = 1 << 2,
+    };
+
+    uint32_t namePtr = 0; // 0 until it's resolved
+    SkeletonBone skeletonBone = SkeletonBone::NONE;
+    uint8_t flags = 0;
+    bool isLeft = false;
+
+    // calculated ahead of the guest copying the bone by PrepareModelBones, only valid for the guest frame it was prepared in
+    uint32_t preparedFrame = 0;
+    BoneTransform prepared;
+};
+
+// the bones of a model that the hook ran for
+struct ModelBones {
+    uint32_t validatedFrame = 0;
+    bool isPlayer = false;
+    // set when the model wasn't seen on the previous guest frame, since another model with other bones might've been created at its address
+    bool revalidateBoneNames = true;
+    std::vector<ResolvedBone> bones; // indexed by the model's bone index
+};
+
+// a bone of a gsys::ModelUnit's bone palette, which is what custom_gsys_ModelUnit_getBoneLocalMatrix copies from
+constexpr uint32_t BONE_PALETTE_STRIDE = 0x40;
+constexpr uint32_t BONE_PALETTE_SCALE_OFFSET = 0x04;
+constexpr uint32_t BONE_PALETTE_MATRIX_OFFSET = 0x10;
+
+// hook_PrepareModelBones fills a mask in patch_CTRL_Bones.asm with a bit for each bone that still needs hook_ModifyBoneMatrix,
+// as big-endian words with the first bone of each word in its lowest bit. bones past the end of the mask always call the hook.
+constexpr uint32_t BONE_HOOK_MASK_WORDS = 8;
+constexpr uint32_t BONE_HOOK_MASK_BONES = BONE_HOOK_MASK_WORDS * 32;
+
+// true for the bones of the player's face, which get hidden in first person
+bool isFaceBone(const std::string_view& boneName);
+
+// returns the bones of the model if it's the player's, or nullptr for every other model
+ModelBones* GetPlayerModelBones(uint32_t gsysModelPtr, uint32_t guestFrame);
+const ResolvedBone& GetResolvedBone(ModelBones& model, uint32_t boneIdx, uint32_t boneNamePtr);
+void ClearModelBones();
+
+// what hook_ModifyBoneMatrix and hook_PrepareModelBones do with their registers
+void ModifyBoneMatrix(uint32_t gsysModelPtr, uint32_t matrixPtr, uint32_t scalePtr, uint32_t boneNamePtr, uint32_t boneIdx);
+bool PrepareModelBones(uint32_t gsysModelPtr, uint32_t boneHookMaskPtr);
@@ -1,6 +1,9 @@
 #include "instance.h"
 #include "cemu_hooks.h"
 #include "weapon.h"
+#include "guest_fields.h"
+#include "motion_trace.h"
+#include "frame_context.h"
 
 
 std::array<WeaponMotionAnalyser, 2> CemuHooks::m_motionAnalyzers = {};
@@ -16,101 +19,102 @@ std::array s_cameraPositions = {
     glm::fvec3(0.0f)
 };
 
-static bool isDroppable(std::string actorName) {
-    static const std::string_view nonDroppableItems[] = {
-        "AncientArrow",
-        "Animal_Insect_A",
-        "Animal_Insect_B",
-        "Animal_Insect_F",
-        "Animal_Insect_H",
-        "Animal_Insect_M",
-        "Animal_Insect_S",
-        "Animal_Insect_X",
-        "Armor_Default_Extra_00",
-        "Armor_Default_Extra_01",
-        "bj_SupportApp_Wind",
-        "BombArrow_A",
-        "BrightArrow",
-        "BrightArrowTP",
-        "CarryBox",
-        "Dm_Npc_Gerudo_HeroSoul_Kago",
-        "Dm_Npc_Goron_HeroSoul_Kago",
-        "Dm_Npc_RevivalFairy",
-        "Dm_Npc_Rito_HeroSoul_Kago",
-        "Dm_Npc_Zora_HeroSoul_Kago",
-        "ElectricArrow",
-        "Explode",
-        "FireArrow",
-        "FireRodLv1Fire",
-        "FireRodLv2Fire",
-        "FireRodLv2FireChild",
-        "GameRomHorseReins_01",
-        "GameRomHorseReins_02",
-        "GameRomHorseReins_03",
-        "GameRomHorseReins_04",
-        "GameRomHorseReins_05",
-        "GameRomHorseReins_10",
-        "GameRomHorseSaddle_01",
-        "GameRomHorseSaddle_02",
-        "GameRomHorseSaddle_03",
-        "GameRomHorseSaddle_04",
-        "GameRomHorseSaddle_05",
-        "GameRomHorseSaddle_10",
-        "GameROMPlayer",
-        "Get_TwnObj_DLC_MemorialPicture_A_01",
-        "IceArrow",
-        "IceRodLv1Ice",
-        "IceRodLv2Ice",
-        "Item_Conductor",
-        "Item_CookSet",
-        "Item_Magnetglove",
-        "Item_Material_01",
-        "Item_Material_03",
-        "Item_Material_07",
-        "Item_Ore_F",
-        "KeySmall",
-        "NormalArrow",
-        "Obj_Armor_115_Head",
-        "Obj_DLC_HeroSeal_Gerudo",
-        "Obj_DLC_HeroSeal_Goron",
-        "Obj_DLC_HeroSeal_Rito",
-        "Obj_DLC_HeroSeal_Zora",
-        "Obj_DLC_HeroSoul_Gerudo",
-        "Obj_DLC_HeroSoul_Goron",
-        "Obj_DLC_HeroSoul_Rito",
-        "Obj_DLC_HeroSoul_Zora",
-        "Obj_DRStone_A_01",
-        "Obj_DRStone_Get",
-        "Obj_DungeonClearSeal",
-        "Obj_HeartUtuwa_A_01",
-        "Obj_HeroSoul_Gerudo",
-        "Obj_HeroSoul_Goron",
-        "Obj_HeroSoul_Rito",
-        "Obj_HeroSoul_Zora",
-        "Obj_IceMakerBlock",
-        "Obj_KorokNuts",
-        "Obj_Maracas",
-        "Obj_ProofBook",
-        "Obj_ProofGiantKiller",
-        "Obj_ProofGolemKiller",
-        "Obj_ProofKorok",
-        "Obj_ProofSandwormKiller",
-        "Obj_StaminaUtuwa_A_01",
-        "Obj_WarpDLC",
-        "PlayerStole2",
-        "PlayerStole2_Vagrant",
-        "Weapon_Bow_071",
-        "Weapon_Sword_056",
-        "Weapon_Sword_070",
-        "Weapon_Sword_080",
-        "Weapon_Sword_081",
-        "Weapon_Sword_502"
-    };
-
-    for (const auto& item : nonDroppableItems) {
-        if (actorName == item) {
-            return false;
-        }
+// sorted (by their bytes, so uppercase before lowercase) for binary searches
+static constexpr std::array<std::string_view, 87> s_nonDroppableItems = {
+    "AncientArrow",
+    "Animal_Insect_A",
+    "Animal_Insect_B",
+    "Animal_Insect_F",
+    "Animal_Insect_H",
+    "Animal_Insect_M",
+    "Animal_Insect_S",
+    "Animal_Insect_X",
+    "Armor_Default_Extra_00",
+    "Armor_Default_Extra_01",
+    "BombArrow_A",
+    "BrightArrow",
+    "BrightArrowTP",
+    "CarryBox",
+    "Dm_Npc_Gerudo_HeroSoul_Kago",
+    "Dm_Npc_Goron_HeroSoul_Kago",
+    "Dm_Npc_RevivalFairy",
+    "Dm_Npc_Rito_HeroSoul_Kago",
+    "Dm_Npc_Zora_HeroSoul_Kago",
+    "ElectricArrow",
+    "Explode",
+    "FireArrow",
+    "FireRodLv1Fire",
+    "FireRodLv2Fire",
+    "FireRodLv2FireChild",
+    "GameROMPlayer",
+    "GameRomHorseReins_01",
+    "GameRomHorseReins_02",
+    "GameRomHorseReins_03",
+    "GameRomHorseReins_04",
+    "GameRomHorseReins_05",
+    "GameRomHorseReins_10",
+    "GameRomHorseSaddle_01",
+    "GameRomHorseSaddle_02",
+    "GameRomHorseSaddle_03",
+    "GameRomHorseSaddle_04",
+    "GameRomHorseSaddle_05",
+    "GameRomHorseSaddle_10",
+    "Get_TwnObj_DLC_MemorialPicture_A_01",
+    "IceArrow",
+    "IceRodLv1Ice",
+    "IceRodLv2Ice",
+    "Item_Conductor",
+    "Item_CookSet",
+    "Item_Magnetglove",
+    "Item_Material_01",
+    "Item_Material_03",
+    "Item_Material_07",
+    "Item_Ore_F",
+    "KeySmall",
+    "NormalArrow",
+    "Obj_Armor_115_Head",
+    "Obj_DLC_HeroSeal_Gerudo",
+    "Obj_DLC_HeroSeal_Goron",
+    "Obj_DLC_HeroSeal_Rito",
+    "Obj_DLC_HeroSeal_Zora",
+    "Obj_DLC_HeroSoul_Gerudo",
+    "Obj_DLC_HeroSoul_Goron",
+    "Obj_DLC_HeroSoul_Rito",
+    "Obj_DLC_HeroSoul_Zora",
+    "Obj_DRStone_A_01",
+    "Obj_DRStone_Get",
+    "Obj_DungeonClearSeal",
+    "Obj_HeartUtuwa_A_01",
+    "Obj_HeroSoul_Gerudo",
+    "Obj_HeroSoul_Goron",
+    "Obj_HeroSoul_Rito",
+    "Obj_HeroSoul_Zora",
+    "Obj_IceMakerBlock",
+    "Obj_KorokNuts",
+    "Obj_Maracas",
+    "Obj_ProofBook",
+    "Obj_ProofGiantKiller",
+    "Obj_ProofGolemKiller",
+    "Obj_ProofKorok",
+    "Obj_ProofSandwormKiller",
+    "Obj_StaminaUtuwa_A_01",
+    "Obj_WarpDLC",
+    "PlayerStole2",
+    "PlayerStole2_Vagrant",
+    "Weapon_Bow_071",
+    "Weapon_Sword_056",
+    "Weapon_Sword_070",
+    "Weapon_Sword_080",
+    "Weapon_Sword_081",
+    "Weapon_Sword_502",
+    "bj_SupportApp_Wind"
+};
+static_assert(std::ranges::is_sorted(s_nonDroppableItems), "s_nonDroppableItems needs to stay sorted");
+static_assert(std::ranges::adjacent_find(s_nonDroppableItems) == s_nonDroppableItems.end(), "s_nonDroppableItems contains duplicates");
+
+bool isDroppable(std::string_view actorName) {
+    if (std::ranges::binary_search(s_nonDroppableItems, actorName)) {
+        return false;
     }
 
     // prevent dropping arrows
@@ -121,6 +125,9 @@ static bool isDroppable(std::string actorName) {
     return true;
 }
 
+// only looked up again when a different weapon gets equipped in that hand
+static std::array<bool, 2> s_isHeldWeaponDroppable = { false, false };
+
 constexpr uint32_t FLAG_THROWABLE = 0x00004000;
 bool ObjectCanBeThrown(uint32_t flags)
 {
@@ -180,6 +187,7 @@ void CemuHooks::hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU) {
     if (!actorName.getLE().empty() && boneName[0] != '\0' && isHeldByPlayer && (isLeftHandWeapon || isRightHandWeapon)) {
         OpenXR::EyeSide side = isLeftHandWeapon ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
 
+        bool isNewlyEquipped = m_heldWeapons[side] != targetActorPtr;
         m_heldWeapons[side] = targetActorPtr;
         m_heldWeaponsLastUpdate[side] = 0;
 
@@ -207,14 +215,17 @@ void CemuHooks::hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU) {
         //writeMemory(weaponMtxPtr, &weaponMtx);
         //writeMemory(modelBindInfoMtxPtr, &modelBindInfoMtx);
 
-        Weapon targetActor = {};
-        readMemory(targetActorPtr, &targetActor);
+        // only the few fields that are used below, instead of the whole Weapon struct
+        auto [targetName, targetFlags2, targetType] = readGuestFields<WeaponFields::Name, WeaponFields::Flags2, WeaponFields::Type>(targetActorPtr);
+        if (isNewlyEquipped) {
+            s_isHeldWeaponDroppable[side] = isDroppable(targetName.getLE());
+        }
 
         //Fetch data for inputs handling
-        auto gameState = VRManager::instance().XR->m_gameState.load();
-        gameState.is_throwable_object_held = ObjectCanBeThrown(targetActor.flags2.getLE());
+        OpenXR::GameState& gameState = HookFrameContext::GetGameState();
+        gameState.is_throwable_object_held = ObjectCanBeThrown(targetFlags2.getLE());
         auto equipType = EquipType::None;
-        switch (targetActor.type.getLE()) {
+        switch (targetType.getLE()) {
             case WeaponType::SmallSword:
             case WeaponType::LargeSword:
             case WeaponType::Spear:
@@ -232,12 +243,12 @@ void CemuHooks::hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU) {
         }
 
        
-        //Log::print<INFO>("Equipped weapon {} with type of {} on side {}", targetActor.name.getLE().c_str(), (uint32_t)targetActor.type.getLE(), (uint32_t)side);
+        //Log::print<INFO>("Equipped weapon {} with type of {} on side {}", targetName.getLE().c_str(), (uint32_t)targetType.getLE(), (uint32_t)side);
 
         if (isRightHandWeapon) {
             gameState.has_something_in_right_hand = true;
             
-            if (targetActor.name.getLE() == "Item_Magnetglove")
+            if (targetName.getLE() == "Item_Magnetglove")
                 equipType = EquipType::MagnetGlove;
 
             if (gameState.left_hand_current_equip_type == EquipType::Bow)
@@ -247,21 +258,21 @@ void CemuHooks::hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU) {
         }
         else {
             gameState.has_something_in_left_hand = true;
-            if (targetActor.name.getLE() == "Item_Conductor")
+            if (targetName.getLE() == "Item_Conductor")
                 equipType = EquipType::SheikahSlate;
 
             gameState.left_hand_current_equip_type = equipType;
         }
-        VRManager::instance().XR->m_gameState.store(gameState);
+        HookFrameContext::StoreGameState();
 
         
 
         // check if weapon is held and if a drop should be triggered
-        auto input = VRManager::instance().XR->m_input.load();
+        const OpenXR::InputState& input = HookFrameContext::GetInput();
         auto dropSide = input.inGame.drop_weapon[side];
 
-        if (input.shared.in_game && dropSide && isDroppable(targetActor.name.getLE())) {
-            Log::print<INFO>("Dropping weapon {} with type of {} due to long press on right waist body slot", targetActor.name.getLE().c_str(), (uint32_t)targetActor.type.getLE());
+        if (input.shared.in_game && dropSide && s_isHeldWeaponDroppable[side]) {
+            Log::print<INFO>("Dropping weapon {} with type of {} due to long press on right waist body slot", targetName.getLE().c_str(), (uint32_t)targetType.getLE());
             hCPU->gpr[11] = 1;
             hCPU->gpr[9] = 1;
             hCPU->gpr[13] = isLeftHandWeapon ? 1 : 0; // set the hand index to 0 for left hand, 1 for right hand
@@ -269,13 +280,13 @@ void CemuHooks::hook_ChangeWeaponMtx(PPCInterpreter_t* hCPU) {
         }
         // Support for long press (placeholder)
         //if (input.inGame.in_game && grabState.lastEvent == ButtonState::Event::LongPress) {
-        //    Log::print<CONTROLS>("Long press detected for {} (side {})", targetActor.name.getLE().c_str(), (int)side);
+        //    Log::print<CONTROLS>("Long press detected for {} (side {})", targetName.getLE().c_str(), (int)side);
         //    // TODO: Implement long press action (e.g., temporarily bind item)
         //    //grabState.longPress = false;
         //}
         //// Support for short press (placeholder)
         //if (input.inGame.in_game && grabState.lastEvent == ButtonState::Event::ShortPress) {
-        //    Log::print<CONTROLS>("Short press detected for {} (side {})", targetActor.name.getLE().c_str(), (int)side);
+        //    Log::print<CONTROLS>("Short press detected for {} (side {})", targetName.getLE().c_str(), (int)side);
         //    // TODO: Implement short press action (e.g., cycle weapon)
         //}
 
@@ -388,14 +399,17 @@ void CemuHooks::hook_EnableWeaponAttackSensor(PPCInterpreter_t* hCPU) {
 
     //Log::print("!! Running weapon analysis for {}", heldIndex);
 
-    auto inputs = VRManager::instance().XR->m_input.load();
+    const OpenXR::InputState::Shared& inputs = HookFrameContext::GetInput().shared;
     auto headset = VRManager::instance().XR->GetRenderer()->GetMiddlePose();
     if (!headset.has_value()) {
         return;
     }
 
     m_motionAnalyzers[heldIndex].ResetIfWeaponTypeChanged(weaponType);
-    m_motionAnalyzers[heldIndex].Update(inputs.shared.poseLocation[heldIndex], inputs.shared.poseVelocity[heldIndex], headset.value(), inputs.shared.inputTime);
+    m_motionAnalyzers[heldIndex].Update(inputs.poseLocation[heldIndex], inputs.poseVelocity[heldIndex], headset.value(), inputs.inputTime);
+    if (MotionTraceRecorder* recorder = MotionTraceRecorder::Get()) {
+        recorder->RecordSample((uint8_t)heldIndex, weaponType, inputs.poseLocation[heldIndex], inputs.poseVelocity[heldIndex], headset.value(), inputs.inputTime);
+    }
 
     // Use the analysed motion to determine whether the weapon is swinging or stabbing, and whether the attackSensor should be active this frame
     bool CHEAT_alwaysEnableWeaponCollision = false;
@@ -468,7 +482,7 @@ void CemuHooks::hook_SetPlayerWeaponScale(PPCInterpreter_t* hCPU) {
 void CemuHooks::hook_EquipWeapon(PPCInterpreter_t* hCPU) {
     hCPU->instructionPointer = hCPU->sprNew.LR;
 
-    auto input = VRManager::instance().XR->m_input.load();
+    const OpenXR::InputState& input = HookFrameContext::GetInput();
     // Check both hands for a short press to pick up weapon
     for (int side = 0; side < 2; ++side) {
         auto& grabState = input.inGame.grabState[side];
@@ -532,6 +546,7 @@ void CemuHooks::hook_ModifyHandModelAccessSearch(PPCInterpreter_t* hCPU) {
 
 void CemuHooks::DrawDebugOverlays() {
     if (ImGui::Begin("Weapon Motion Debugger")) {
+        ImGui::Text("Input and game state loads by hooks: %u last guest frame", HookFrameContext::GetLastFrameSnapshotLoads());
         for (auto it = m_motionAnalyzers.rbegin(); it != m_motionAnalyzers.rend(); ++it) {
             ImGui::PushID(&(*it));
             ImGui::BeginGroup();
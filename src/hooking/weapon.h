@@ -24,10 +24,13 @@ struct DebugSample {
     bool debug_expVelocityLengthEnabled;
 
     glm::fvec3 rotLinearAccel;
+    // stored when the sample is added, so the debug overlay doesn't need to rotate every sample again each time it's drawn
+    glm::fvec3 localLinearVelocity;
+    glm::fvec3 localAngularVelocity;
 
-    glm::fvec3 rotatedVelocity() const { return glm::inverse(rotation) * linearVelocity; }
-    glm::fvec3 rotatedAngularVelocity() const { return glm::inverse(rotation) * angularVelocity; }
-    glm::fvec3 rotatedLinearVelocity() const { return glm::inverse(rotation) * linearVelocity; }
+    glm::fvec3 rotatedVelocity() const { return localLinearVelocity; }
+    glm::fvec3 rotatedAngularVelocity() const { return localAngularVelocity; }
+    glm::fvec3 rotatedLinearVelocity() const { return localLinearVelocity; }
 };
 
 struct WeaponProfile {
@@ -70,6 +73,32 @@ struct SpearProfile : WeaponProfile {
     }
 };
 
+// the values that WeaponMotionAnalyser is currently tuned to, for every weapon type
+struct TunedAttackProfile : SpearProfile {
+    TunedAttackProfile() {
+        stab_SpeedThreshold = 0.05f;
+        stab_AccThreshold = 5.0f;
+        stab_LinearSteadinessThreshold = glm::cos(glm::pi<float>() / 4.5); // 15 deg accuracy cone
+        stab_AngularSteadinessThreshold = 4.5; // [rad/s]
+        stab_travelDistance = 0.15f;
+        slash_SpeedThreshold = 1.0f;
+        slash_AccThreshold = 20.0f;
+        slash_AccDriftThreshold = 10.0f; // use [rad/s^2]
+        slash_travelAngle = glm::pi<float>() / 6;
+    }
+};
+
+// everything the attack detection needs from a single sample, calculated once per update
+struct MotionFeatures {
+    glm::fvec3 localLinearVelocity;
+    glm::fvec3 localLinearDirection; // normalized localLinearVelocity
+    glm::fvec3 localLinearAcceleration;
+    glm::fvec3 localAngularVelocity;
+    float flatAngularAcceleration;
+    float angularDrift;
+    bool swingIsForwards;
+};
+
 class WeaponMotionAnalyser {
 public:
     WeaponMotionAnalyser() = default;
@@ -81,9 +110,10 @@ public:
     static constexpr float HAND_VELOCITY_LENGTH_THRESHOLD = 2.0f;
 
     static constexpr float dist_threshold = 0.6f; // max distance from head to consider attack
-    XrTime COOLDOWN_TIME = int(1e9*2.0f); // 0.5 s in nano seconds
+    static constexpr XrTime COOLDOWN_TIME = 0; // TODO: DIFFERENT COOLDOWN FOR STABS AND SWINGS
 
-    WeaponProfile profile = SpearProfile();
+    // shared by both hands, so it's not rebuilt for every update
+    static inline const WeaponProfile profile = TunedAttackProfile();
 
     // New member variables for angular velocity plot
     glm::fvec3 m_lastPlottedAngularVelocity = {0.0f, 0.0f, 0.0f};
@@ -116,6 +146,12 @@ public:
         handVelocityLength = glm::length(linearVelocity);
         handVelocityToggled = handVelocityLength >= HAND_VELOCITY_LENGTH_THRESHOLD;
 
+        // Determine max range from hand positions
+        float curr_distance = glm::distance(position, headsetPostion);
+        max_range = glm::max(max_range, dist_threshold*curr_distance); // maximum reached value currently (decreased using factor 'dist_threshold' to avoid outliers)
+
+        const MotionFeatures features = ExtractFeatures(rotation, linearVelocity, angularVelocity, headsetRotation, inputTime);
+
         m_rollingSamples[m_rollingSamplesIt] = {
             .time = inputTime,
             .position = position,
@@ -123,82 +159,27 @@ public:
             .linearVelocity = linearVelocity,
             .angularVelocity = angularVelocity, // angular velocity in world space
             .debug_attackType = AttackType::None,
-            .debug_expVelocityLengthEnabled = handVelocityToggled
+            .debug_expVelocityLengthEnabled = handVelocityToggled,
+            .rotLinearAccel = features.localLinearAcceleration,
+            .localLinearVelocity = features.localLinearVelocity,
+            .localAngularVelocity = features.localAngularVelocity
         };
         m_lastSampleIdx = m_rollingSamplesIt;
         m_rollingSamplesIt = (m_rollingSamplesIt + 1) % MAX_SAMPLES;
 
-        // Determine max range from hand positions
-        float curr_distance = glm::distance(position, headsetPostion);
-        max_range = glm::max(max_range, dist_threshold*curr_distance); // maximum reached value currently (decreased using factor 'dist_threshold' to avoid outliers)
-        //Log::print("!! range: {}/{}", curr_distance, max_range);
-
-        // ----- Find if rotation is towards center of view -----
-        const glm::fvec3 pos_rot_axis = glm::cross(headsetRotation * glm::fvec3(0, 0, -1), rotation * glm::fvec3(0, 0, 1)); // cross product from sword x to forward camera axis
-        const bool swing_is_forwards = glm::dot(pos_rot_axis, angularVelocity) > 0;
-        //Log::print("!! is forward: {}", swing_is_forwards ? "true" : "false");
-        //const float ang = glm::asin(glm::length(pos_rot_axis));
-
-        //Log::print("!! is_attacking: );
-        // ---- Find local velocities & accelerations -----
-        const glm::fvec3 localLinearVelocity = glm::inverse(rotation) * linearVelocity;
-        float dt = (float)(inputTime - prev_sample) / 1000000000.0f;
-        const glm::fvec3 localLinearAcceleration = (localLinearVelocity - prev_lin_vel) / glm::fvec3(dt); // TODO: add stab_acc threshold | Make stab continue as long as velocity follows acceleration (<0)
-
-        // ---- find angular velocity drift ----
-        // Log::print<CONTROLS>("angvel: {} \n prev_av: {}\ndt: {}\n dot: {}\nacos: {}", angularVelocity, prev_AngularVelocity, dt, glm::dot(angularVelocity, prev_AngularVelocity), acos(glm::dot(angularVelocity, prev_AngularVelocity)));
-
-        float angular_drift = acos(glm::dot(glm::normalize(angularVelocity), glm::normalize(prev_AngularVelocity)))/dt; // Angular velocity drift (defined as the angular velocity of the rotating angular velocity i.e. how much rad/s the orthogonal vector of rotation moves)
-
-        m_rollingSamples[m_lastSampleIdx].rotLinearAccel = localLinearAcceleration;
-
-
-
-        //Log::print("!! Acc: {} {} {}", localLinearAcceleration.x, localLinearAcceleration.y, localLinearAcceleration.z);
-
-        // For virtual desktop via steam vr -> use inv(rotation) * angular velocity
-        const glm::fvec3 localAngularVelocity = m_rollingSamples[m_lastSampleIdx].rotatedAngularVelocity(); //glm::inverse(rotation) * angularVelocity;
-
-        
-        // --- Get approximation of angular acceleration over xy plane ---
-        glm::fvec3 flat_ang_vel = localAngularVelocity - (glm::fvec3(.0, .0, localAngularVelocity.z)); // Get rotation vector over xy plane
-        float flat_ang_acc = (glm::length(flat_ang_vel) - glm::length(prev_ang_vel))/dt;
-
-        prev_ang_vel = flat_ang_vel;
-        
-        //Log::print("!! position_world: {}", position);
-        //Log::print("!! v_local: {}", localLinearVelocity);
-        profile.stab_SpeedThreshold = 0.05f;
-        profile.stab_AccThreshold = 5.0f;
-        profile.stab_LinearSteadinessThreshold = glm::cos(glm::pi<float>() / 4.5); // 15 deg accuracy cone
-        profile.stab_AngularSteadinessThreshold = 4.5; // [rad/s]
-        profile.stab_travelDistance = 0.15f;
-        profile.slash_SpeedThreshold = 1.0f;
-        profile.slash_AccThreshold = 20.0f;
-        profile.slash_AccDriftThreshold = 10.0f; // use [rad/s^2]
-        COOLDOWN_TIME = 0.0f*1e9; // TODO: DIFFERENT COOLDOWN FOR STABS AND SWINGS
-
-        //Log::print("!! steadiness: {} / {}", glm::normalize(localAngularVelocity).y, profile.slash_SteadinessThreshold);
-        profile.slash_travelAngle = glm::pi<float>() / 6;
         // Detect velocity threshold -> set attack type if not in attack & store original angle/position
         AttackType prev_attack = m_lockedAttackType;
 
-        detect_attack_type(localLinearVelocity, localLinearAcceleration, localAngularVelocity, flat_ang_acc, position, rotation, swing_is_forwards);
-
-        // Log::print("!! attack_state: {}", (int)m_lockedAttackType);
+        detect_attack_type(features, position, rotation);
 
         // Check if attack falls within weaponprofile velocity & angle margins -> if not cancel attack & go back to checking for attack
-        check_attack_steadiness(localLinearVelocity, localAngularVelocity, angular_drift);
-        //Log::print("!! m_badSampleCtr: {}", m_badSampleCtr);
+        check_attack_steadiness(features);
 
         // Check if delta_angle/delta_translation is enough to enable attack mode
         set_attack_activity(rotation, position);
 
-        // Log::print("!! AttackType: {} - IsAttacking = {} - bad_samples: {} - v_world: ({}): ", (int)m_lockedAttackType, IsAttacking() ? "true": "false", m_badSampleCtr, localLinearVelocity);
-
         m_rollingSamples[m_lastSampleIdx].debug_attackType = IsAttacking() ? m_lockedAttackType: AttackType::None;
 
-        // Log::print<CONTROLS>("{}", time_since_last_attack);
         // time since last attack update
         for (int i = 0; i < 2; i++) {
             time_since_last_attack[i] += inputTime - prev_sample;
@@ -206,28 +187,55 @@ public:
         }
 
         if (m_lockedAttackType != AttackType::None && prev_attack != m_lockedAttackType) { // if start of new attack
-            // Log::print<CONTROLS>("Switched attack to: {}", m_lockedAttackType == AttackType::Slash ? "slash" : "stab");
             time_since_last_attack[static_cast<int>(m_lockedAttackType) - 1] = 0; // reset timer for this attack type
         }
 
         prev_AngularVelocity = angularVelocity;
-        prev_lin_vel = localLinearVelocity;
+        prev_lin_vel = features.localLinearVelocity;
         prev_sample = inputTime;
     }
 
-    void detect_attack_type(const glm::fvec3 localLinearVelocity, const glm::fvec3 localLinearAcceleration, const glm::fvec3 localAngularVelocity, const float flag_ang_acc, const glm::fvec3 position, const glm::fquat rotation, const bool swing_is_forward) {
-        // Log::print<CONTROLS>("[WeaponMotionAnalyser] Detecting attack type with linear velocity: {}, attack type = {}, active: {}", localLinearVelocity, static_cast<int>(m_lockedAttackType), static_cast<int>(m_attackActivity));
+    // also advances prev_ang_vel, the other previous values are only advanced at the end of Update
+    MotionFeatures ExtractFeatures(const glm::fquat rotation, const glm::fvec3 linearVelocity, const glm::fvec3 angularVelocity, const glm::fquat headsetRotation, const XrTime inputTime) {
+        MotionFeatures features;
 
-        if (m_lockedAttackType == AttackType::None) {
-            glm::fvec3 dir_ang = glm::normalize(localAngularVelocity);
-            glm::fvec3 stab_ang = glm::normalize(localLinearVelocity);
+        // ----- Find if rotation is towards center of view -----
+        const glm::fvec3 pos_rot_axis = glm::cross(headsetRotation * glm::fvec3(0, 0, -1), rotation * glm::fvec3(0, 0, 1)); // cross product from sword x to forward camera axis
+        features.swingIsForwards = glm::dot(pos_rot_axis, angularVelocity) > 0;
+
+        // ---- Find local velocities & accelerations -----
+        const glm::fquat inverseRotation = glm::inverse(rotation);
+        features.localLinearVelocity = inverseRotation * linearVelocity;
+        features.localLinearDirection = glm::normalize(features.localLinearVelocity);
+        float dt = (float)(inputTime - prev_sample) / 1000000000.0f;
+        features.localLinearAcceleration = (features.localLinearVelocity - prev_lin_vel) / glm::fvec3(dt); // TODO: add stab_acc threshold | Make stab continue as long as velocity follows acceleration (<0)
+
+        // ---- find angular velocity drift ----
+        features.angularDrift = acos(glm::dot(glm::normalize(angularVelocity), glm::normalize(prev_AngularVelocity)))/dt; // Angular velocity drift (defined as the angular velocity of the rotating angular velocity i.e. how much rad/s the orthogonal vector of rotation moves)
+
+        // For virtual desktop via steam vr -> use inv(rotation) * angular velocity
+        features.localAngularVelocity = inverseRotation * angularVelocity;
+
+        // --- Get approximation of angular acceleration over xy plane ---
+        glm::fvec3 flat_ang_vel = features.localAngularVelocity - (glm::fvec3(.0, .0, features.localAngularVelocity.z)); // Get rotation vector over xy plane
+        features.flatAngularAcceleration = (glm::length(flat_ang_vel) - glm::length(prev_ang_vel))/dt;
+
+        prev_ang_vel = flat_ang_vel;
+        return features;
+    }
 
+    void detect_attack_type(const MotionFeatures& features, const glm::fvec3 position, const glm::fquat rotation) {
+        const glm::fvec3 localLinearAcceleration = features.localLinearAcceleration;
+        const glm::fvec3 localAngularVelocity = features.localAngularVelocity;
+        const glm::fvec3 stab_ang = features.localLinearDirection;
+        const float flag_ang_acc = features.flatAngularAcceleration;
+
+        if (m_lockedAttackType == AttackType::None) {
             //Log::print<CONTROLS>("controller angular velocity {}, {}, {}", abs(localAngularVelocity).x, abs(localAngularVelocity).y, abs(localAngularVelocity).z);
             //Log::print<CONTROLS>("linear acc reached {}", -localLinearAcceleration.z > profile.stab_AccThreshold);
 
             if (abs(localAngularVelocity).x < profile.stab_AngularSteadinessThreshold && abs(localAngularVelocity).y < profile.stab_AngularSteadinessThreshold && abs(-stab_ang.z) > profile.stab_LinearSteadinessThreshold && -localLinearAcceleration.z > profile.stab_AccThreshold) {
                 if (time_since_last_attack[int(AttackType::Stab)-1] >= COOLDOWN_TIME) {
-                    // Log::print<CONTROLS>("Failed due to: {}", );
                     m_lockedPosition = position;
                     m_goodStabSampleCtr++;
                     Log::print<CONTROLS>("Stab detect attack");
@@ -239,13 +247,11 @@ public:
             }else {
                 m_goodStabSampleCtr = 0;
             }
-            if (flag_ang_acc > profile.slash_AccThreshold && !swing_is_forward) {
+            if (flag_ang_acc > profile.slash_AccThreshold && !features.swingIsForwards) {
                 Log::print<CONTROLS>("Slash detected but not forward");
             }
             if (/*abs(dir_ang.x) > profile.slash_SteadinessThreshold &&*/ flag_ang_acc > profile.slash_AccThreshold /*&& swing_is_forward*/) {
                 if (time_since_last_attack[int(AttackType::Slash)-1] >= COOLDOWN_TIME) {
-                    // Log::print<CONTROLS>("cooldown currently: {}/{}", time_since_last_attack[int(AttackType::Slash) - 1], COOLDOWN_TIME);
-
                     m_goodSwingSampleCtr++;
                     m_lockedAngle = rotation * glm::fvec3(0.0f, 0.0f, 1.0f); // store z-axis
                     Log::print<CONTROLS>("slash attack detected");
@@ -261,7 +267,11 @@ public:
         }
     }
 
-    void check_attack_steadiness(const glm::fvec3 localLinearVelocity, const glm::fvec3 localAngularVelocity, const float angular_drift) {
+    void check_attack_steadiness(const MotionFeatures& features) {
+        const glm::fvec3 localLinearVelocity = features.localLinearVelocity;
+        const glm::fvec3 localAngularVelocity = features.localAngularVelocity;
+        const float angular_drift = features.angularDrift;
+
         // check steadiness condition for attack types
         switch (m_lockedAttackType) {
             case AttackType::None: { 
@@ -269,27 +279,17 @@ public:
                 return;
             }
             case AttackType::Stab: {
-                glm::fvec3 stab_ang = glm::normalize(localLinearVelocity);
+                const glm::fvec3 stab_ang = features.localLinearDirection;
 
                 if (abs(stab_ang.z) < profile.stab_LinearSteadinessThreshold || -localLinearVelocity.z < profile.stab_SpeedThreshold || glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0)) > profile.stab_AngularSteadinessThreshold || abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold) {
                     m_badSampleCtr++;
-                    bool speed_issue = abs(stab_ang.z) < profile.stab_LinearSteadinessThreshold && abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold && abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold;
-                    // Log::print<CONTROLS>("Failed due to {}", speed_issue ? "Speed is too low" : "Steadiness is too shit");
-                    //if (speed_issue) {
-                        //Log::print<CONTROLS>(" Speed is {}/{}", -localLinearVelocity.z, profile.stab_SpeedThreshold);
-                    //}
                 }
                 else {
                     m_badSampleCtr = 0;
-                    //Log::print<CONTROLS>("Speed is {}", -localLinearVelocity);
                 }
                 break;
             }
             case AttackType::Slash: {
-                glm::fvec3 dir_ang = glm::normalize(localAngularVelocity);
-                // Log::print<CONTROLS>("velocity ok: {}/{}: {}", glm::length(localAngularVelocity - glm::fvec3(.0, .0, localAngularVelocity.z)), profile.slash_SpeedThreshold, glm::length(localAngularVelocity - glm::fvec3(.0, .0, localAngularVelocity.z)) < profile.slash_SpeedThreshold);
-
-                // Log::print<CONTROLS>("angular drift: {}/{}: {}", angular_drift, profile.slash_AccDriftThreshold, angular_drift > profile.slash_AccDriftThreshold);
                 if (/*abs(dir_ang.x) < profile.slash_SteadinessThreshold ||*/ angular_drift > profile.slash_AccDriftThreshold || glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0f)) < profile.slash_SpeedThreshold) { // abs( - localAngularVelocity.x) < profile.slash_SpeedThreshold * 0.2f TODO: SLash speed should be directional (i.e. reversing slash direction should end it). During locking: store sign of swing direction, check if this is still valid here.
                     bool drift_fail = angular_drift > profile.slash_AccDriftThreshold;
                     
@@ -353,6 +353,10 @@ public:
         }
     }
 
+    AttackType GetLockedAttackType() const {
+        return m_lockedAttackType;
+    }
+
     bool IsAttacking() const {
         return m_attackActivity;
         // return m_lockedAttackType != AttackType::None;
@@ -601,4 +605,7 @@ private:
     mutable bool m_debugAngValid = false;
     mutable glm::vec3 m_debugLastLinDir = { 1, 0, 0 };
     mutable bool m_debugLinValid = false;
-};
\ No newline at end of file
+};
+
+// false for the items that shouldn't be dropped when the hand holding them lets go, like arrows, key items and the horse gear
+bool isDroppable(std::string_view actorName);
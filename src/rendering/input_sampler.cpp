@@ -0,0 +1,58 @@
+#include "input_sampler.h"
+#include "instance.h"
+
+std::mutex InputSampler::s_mutex;
+XrTime InputSampler::s_predictedDisplayTime = 0;
+std::chrono::steady_clock::time_point InputSampler::s_lastSampleTime = {};
+std::chrono::steady_clock::time_point InputSampler::s_lastFrameSampleTime = {};
+
+std::atomic<double> InputSampler::s_lastInputAgeMs = 0.0;
+std::atomic<double> InputSampler::s_averageInputAgeMs = 0.0;
+std::atomic<double> InputSampler::s_vpadSampleRatio = 0.0;
+
+void InputSampler::SampleOnFrameStart(XrTime predictedDisplayTime, bool inMenu) {
+    std::scoped_lock lock(s_mutex);
+    const auto now = std::chrono::steady_clock::now();
+    VRManager::instance().XR->UpdateActions(predictedDisplayTime, inMenu);
+    s_predictedDisplayTime = predictedDisplayTime;
+    s_lastSampleTime = now;
+    s_lastFrameSampleTime = now;
+}
+
+OpenXR::InputState InputSampler::SampleBeforeVPADRead(bool inMenu) {
+    std::scoped_lock lock(s_mutex);
+    const auto now = std::chrono::steady_clock::now();
+    OpenXR& xr = *VRManager::instance().XR;
+
+    // the hands and head get located at the display time of the current XR frame, the buttons and sticks are always the newest ones
+    const bool sample = s_predictedDisplayTime != 0 && ShouldSampleOnVPADRead(now - s_lastSampleTime, now - s_lastFrameSampleTime);
+    if (sample) {
+        xr.UpdateActions(s_predictedDisplayTime, inMenu);
+        s_lastSampleTime = now;
+    }
+
+    // the samples after this one start from the input without the short presses that the game is about to get
+    const OpenXR::InputState input = xr.m_input.load();
+    OpenXR::InputState consumed = input;
+    consumed.consumeShortPresses();
+    xr.m_input.store(consumed);
+
+    // averaged over roughly a second of VPAD reads, like the other timings in the overlay it's only meant to be glanced at
+    constexpr double SMOOTHING = 1.0 / 30.0;
+    const double ageMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - s_lastSampleTime).count();
+    s_lastInputAgeMs.store(ageMs, std::memory_order_relaxed);
+    s_averageInputAgeMs.store(s_averageInputAgeMs.load(std::memory_order_relaxed) * (1.0 - SMOOTHING) + ageMs * SMOOTHING, std::memory_order_relaxed);
+    s_vpadSampleRatio.store(s_vpadSampleRatio.load(std::memory_order_relaxed) * (1.0 - SMOOTHING) + (sample ? SMOOTHING : 0.0), std::memory_order_relaxed);
+    return input;
+}
+
+void InputSampler::StoreAfterVPADRead(const OpenXR::InputState& input) {
+    std::scoped_lock lock(s_mutex);
+    OpenXR& xr = *VRManager::instance().XR;
+
+    // the XR thread might've sampled the buttons and poses again during the read, so only the fields that the read itself changes are copied over
+    OpenXR::InputState latest = xr.m_input.load();
+    latest.inGame.drop_weapon = input.inGame.drop_weapon;
+    latest.shared.modMenuState.longFired_actedUpon = latest.shared.modMenuState.longFired_actedUpon && input.shared.modMenuState.longFired_actedUpon;
+    xr.m_input.store(latest);
+}
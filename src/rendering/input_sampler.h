@@ -0,0 +1,41 @@
+#pragma once
+#include "rendering/openxr.h"
+
+// Samples the XR actions on the guest thread right before hook_InjectXRInput fills the VPADStatus that the game reads.
+// RND_Renderer::StartFrame still samples them once per XR frame (for the hands, the mod menu etc.), but the game polls the gamepad on its own
+// thread at its own rate, so the buttons and sticks it got used to be up to a whole XR frame older than when the game asked for them.
+// The input age is the time between sampling the actions and handing them to the game, which is shown in the FPS overlay.
+// Short presses stay in the input across samples until a VPAD read consumes them, so one that both threads sampled between two reads isn't lost.
+class InputSampler {
+public:
+    // samples that are at least this close together are merged, e.g. when the game reads the VPAD right after an XR frame started
+    static constexpr std::chrono::nanoseconds MIN_SAMPLE_INTERVAL = std::chrono::milliseconds(1);
+    // the guest thread only samples while XR frames are still being started, since the poses are located at their predicted display time
+    static constexpr std::chrono::nanoseconds MAX_FRAME_SAMPLE_AGE = std::chrono::milliseconds(100);
+
+    // UpdateActions isn't safe to call from multiple threads at once, so both threads sample through these
+    static void SampleOnFrameStart(XrTime predictedDisplayTime, bool inMenu);
+    // returns the input that the VPAD read hands to the game, its short presses count as consumed from then on
+    static OpenXR::InputState SampleBeforeVPADRead(bool inMenu);
+    // publishes what the VPAD read changed in the input, without undoing what got sampled since SampleBeforeVPADRead
+    static void StoreAfterVPADRead(const OpenXR::InputState& input);
+
+    static bool ShouldSampleOnVPADRead(std::chrono::nanoseconds sinceLastSample, std::chrono::nanoseconds sinceFrameSample) {
+        return sinceLastSample >= MIN_SAMPLE_INTERVAL && sinceFrameSample <= MAX_FRAME_SAMPLE_AGE;
+    }
+
+    static double GetLastInputAgeMs() { return s_lastInputAgeMs.load(std::memory_order_relaxed); }
+    static double GetAverageInputAgeMs() { return s_averageInputAgeMs.load(std::memory_order_relaxed); }
+    // share of the VPAD reads that got freshly sampled input instead of the one from the XR frame
+    static double GetVPADSampleRatio() { return s_vpadSampleRatio.load(std::memory_order_relaxed); }
+
+private:
+    static std::mutex s_mutex;
+    static XrTime s_predictedDisplayTime;
+    static std::chrono::steady_clock::time_point s_lastSampleTime;
+    static std::chrono::steady_clock::time_point s_lastFrameSampleTime;
+
+    static std::atomic<double> s_lastInputAgeMs;
+    static std::atomic<double> s_averageInputAgeMs;
+    static std::atomic<double> s_vpadSampleRatio;
+};
@@ -82,6 +82,7 @@ OpenXR::OpenXR() {
     bool depthSupported = false;
     bool timeConvSupported = false;
     bool debugUtilsSupported = false;
+    bool locateSpacesSupported = false;
     for (XrExtensionProperties& extensionProperties : instanceExtensions) {
         Log::print<VERBOSE>("Found available OpenXR extension: {}", extensionProperties.extensionName);
         if (strcmp(extensionProperties.extensionName, XR_KHR_D3D12_ENABLE_EXTENSION_NAME) == 0) {
@@ -93,6 +94,9 @@ OpenXR::OpenXR() {
         else if (strcmp(extensionProperties.extensionName, XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME) == 0) {
             timeConvSupported = true;
         }
+        else if (strcmp(extensionProperties.extensionName, XR_KHR_LOCATE_SPACES_EXTENSION_NAME) == 0) {
+            locateSpacesSupported = true;
+        }
         else if (strcmp(extensionProperties.extensionName, XR_EXT_DEBUG_UTILS_EXTENSION_NAME) == 0) {
 #if defined(_DEBUG)
             debugUtilsSupported = Log::isLogTypeEnabled<XR_DEBUGUTILS>();
@@ -117,6 +121,7 @@ OpenXR::OpenXR() {
 
     std::vector<const char*> enabledExtensions = { XR_KHR_D3D12_ENABLE_EXTENSION_NAME, XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME, XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME };
     if (debugUtilsSupported) enabledExtensions.emplace_back(XR_EXT_DEBUG_UTILS_EXTENSION_NAME);
+    if (locateSpacesSupported) enabledExtensions.emplace_back(XR_KHR_LOCATE_SPACES_EXTENSION_NAME);
 
     XrInstanceCreateInfo xrInstanceCreateInfo = { XR_TYPE_INSTANCE_CREATE_INFO };
     xrInstanceCreateInfo.createFlags = 0;
@@ -124,7 +129,8 @@ OpenXR::OpenXR() {
     xrInstanceCreateInfo.enabledExtensionNames = enabledExtensions.data();
     xrInstanceCreateInfo.enabledApiLayerCount = 0;
     xrInstanceCreateInfo.enabledApiLayerNames = NULL;
-    xrInstanceCreateInfo.applicationInfo = { "BetterVR", 1, "Cemu", 1, XR_API_VERSION_1_0 };
+    // OpenXR 1.1 is requested first so that xrLocateSpaces is available without the extension, runtimes that only support 1.0 reject it
+    xrInstanceCreateInfo.applicationInfo = { "BetterVR", 1, "Cemu", 1, XR_API_VERSION_1_1 };
     {
         XrResult result = XR_ERROR_RUNTIME_FAILURE;
         for (int i = 0; i < 3; i++) {
@@ -132,6 +138,12 @@ OpenXR::OpenXR() {
              if (XR_SUCCEEDED(result)) {
                  break;
              }
+             if (result == XR_ERROR_API_VERSION_UNSUPPORTED && xrInstanceCreateInfo.applicationInfo.apiVersion != XR_API_VERSION_1_0) {
+                 Log::print<INFO>("OpenXR runtime doesn't support OpenXR 1.1, falling back to OpenXR 1.0");
+                 xrInstanceCreateInfo.applicationInfo.apiVersion = XR_API_VERSION_1_0;
+                 i--;
+                 continue;
+             }
              std::this_thread::sleep_for(std::chrono::seconds(2));
         }
 
@@ -139,6 +151,7 @@ OpenXR::OpenXR() {
             Log::print<ERROR>("Failed to create OpenXR instance! Is the OpenXR runtime installed and set to the correct runtime? Restarting might help, or going to SteamVR/Oculus Link's Settings and making sure OpenXR is enabled.");
         }
         checkXRResult(result, "Failed to initialize the OpenXR instance!");
+        m_apiVersion = xrInstanceCreateInfo.applicationInfo.apiVersion;
     }
 
     // Load extension pointers for this XrInstance
@@ -147,6 +160,18 @@ OpenXR::OpenXR() {
         xrGetInstanceProcAddr(m_instance, "xrConvertTimeToWin32PerformanceCounterKHR", (PFN_xrVoidFunction*)&func_xrConvertTimeToWin32PerformanceCounterKHR);
         xrGetInstanceProcAddr(m_instance, "xrConvertWin32PerformanceCounterToTimeKHR", (PFN_xrVoidFunction*)&func_xrConvertWin32PerformanceCounterToTimeKHR);
     }
+    if (m_apiVersion >= XR_MAKE_VERSION(1, 1, 0)) {
+        xrGetInstanceProcAddr(m_instance, "xrLocateSpaces", (PFN_xrVoidFunction*)&func_xrLocateSpaces);
+    }
+    if (func_xrLocateSpaces != nullptr) {
+        Log::print<INFO>("OpenXR runtime supports batched space locations (OpenXR 1.1)");
+    }
+    else {
+        if (locateSpacesSupported) {
+            xrGetInstanceProcAddr(m_instance, "xrLocateSpacesKHR", (PFN_xrVoidFunction*)&func_xrLocateSpaces);
+        }
+        Log::print<INFO>("OpenXR runtime {} batched space locations (XR_KHR_locate_spaces)", func_xrLocateSpaces ? "supports" : "doesn't support");
+    }
     if (debugUtilsSupported) {
         xrGetInstanceProcAddr(m_instance, "xrCreateDebugUtilsMessengerEXT", (PFN_xrVoidFunction*)&func_xrCreateDebugUtilsMessengerEXT);
         xrGetInstanceProcAddr(m_instance, "xrDestroyDebugUtilsMessengerEXT", (PFN_xrVoidFunction*)&func_xrDestroyDebugUtilsMessengerEXT);
@@ -526,7 +551,7 @@ void CheckButtonState(bool buttonPressed, ButtonState& buttonState) {
     buttonState.wasDownLastFrame = down;
 }
 
-std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTime, glm::fquat controllerRotation, bool inMenu) {
+std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTime, bool inMenu) {
     XrActiveActionSet activeActionSet = { (inMenu ? m_menuActionSet : m_gameplayActionSet), XR_NULL_PATH };
 
     XrActionsSyncInfo syncInfo = { XR_TYPE_ACTIONS_SYNC_INFO };
@@ -544,15 +569,25 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
         getPoseInfo.subactionPath = m_handPaths[side];
         newState.shared.pose[side] = { XR_TYPE_ACTION_STATE_POSE };
         checkXRResult(xrGetActionStatePose(m_session, &getPoseInfo, &newState.shared.pose[side]), "Failed to get pose of controller!");
+    }
 
+    // locate both hands together, which is a single runtime call when XR_KHR_locate_spaces is supported
+    // the head pose comes from the views that the renderer locates, so the head space isn't located here
+    const std::array<XrSpace, 2> trackedSpaces = {
+        newState.shared.in_game ? m_inGameHandSpaces[EyeSide::LEFT] : m_inMenuHandSpaces[EyeSide::LEFT],
+        newState.shared.in_game ? m_inGameHandSpaces[EyeSide::RIGHT] : m_inMenuHandSpaces[EyeSide::RIGHT]
+    };
+    const std::array<bool, 2> trackedSpacesActive = { newState.shared.pose[EyeSide::LEFT].isActive == XR_TRUE, newState.shared.pose[EyeSide::RIGHT].isActive == XR_TRUE };
+    std::array<XrSpaceLocation, 2> trackedLocations = {};
+    std::array<XrSpaceVelocity, 2> trackedVelocities = {};
+    LocateSpaces(m_stageSpace, predictedFrameTime, trackedSpaces, trackedSpacesActive, trackedLocations, trackedVelocities);
+
+    for (EyeSide side : { EyeSide::LEFT, EyeSide::RIGHT }) {
         if (newState.shared.pose[side].isActive) {
-            XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
-            XrSpaceVelocity spaceVelocity = { XR_TYPE_SPACE_VELOCITY };
-            spaceLocation.next = &spaceVelocity;
+            XrSpaceLocation& spaceLocation = trackedLocations[side];
+            XrSpaceVelocity& spaceVelocity = trackedVelocities[side];
             newState.shared.poseVelocity[side].linearVelocity = { 0.0f, 0.0f, 0.0f };
             newState.shared.poseVelocity[side].angularVelocity = { 0.0f, 0.0f, 0.0f };
-            XrSpace handSpace = newState.shared.in_game ? m_inGameHandSpaces[side] : m_inMenuHandSpaces[side];
-            checkXRResult(xrLocateSpace(handSpace, m_stageSpace, predictedFrameTime, &spaceLocation), "Failed to get location from controllers!");
             if ((spaceLocation.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) != 0 && (spaceLocation.locationFlags & XR_SPACE_LOCATION_ORIENTATION_VALID_BIT) != 0) {
                 newState.shared.poseLocation[side] = spaceLocation;
 
@@ -751,8 +786,58 @@ std::optional<OpenXR::InputState> OpenXR::UpdateActions(XrTime predictedFrameTim
 }
 
 
+void OpenXR::LocateSpaces(XrSpace baseSpace, XrTime time, std::span<const XrSpace> spaces, std::span<const bool> spacesActive, std::span<XrSpaceLocation> locations, std::span<XrSpaceVelocity> velocities) {
+    checkAssert(spaces.size() <= MAX_BATCHED_SPACES && spaces.size() == spacesActive.size() && spaces.size() == locations.size() && spaces.size() == velocities.size(), "Invalid amount of spaces to locate!");
+
+    for (size_t i = 0; i < spaces.size(); i++) {
+        locations[i] = { XR_TYPE_SPACE_LOCATION };
+        velocities[i] = { XR_TYPE_SPACE_VELOCITY };
+    }
+
+    if (func_xrLocateSpaces != nullptr) {
+        // inactive spaces are included as well, since the runtime just returns them without valid flags
+        std::array<XrSpaceLocationData, MAX_BATCHED_SPACES> locationData = {};
+        std::array<XrSpaceVelocityData, MAX_BATCHED_SPACES> velocityData = {};
+
+        XrSpacesLocateInfo locateInfo = { XR_TYPE_SPACES_LOCATE_INFO };
+        locateInfo.baseSpace = baseSpace;
+        locateInfo.time = time;
+        locateInfo.spaceCount = (uint32_t)spaces.size();
+        locateInfo.spaces = spaces.data();
+
+        XrSpaceVelocities spaceVelocities = { XR_TYPE_SPACE_VELOCITIES };
+        spaceVelocities.velocityCount = (uint32_t)spaces.size();
+        spaceVelocities.velocities = velocityData.data();
+        XrSpaceLocations spaceLocations = { XR_TYPE_SPACE_LOCATIONS };
+        spaceLocations.next = &spaceVelocities;
+        spaceLocations.locationCount = (uint32_t)spaces.size();
+        spaceLocations.locations = locationData.data();
+
+        ++m_frameLocateCalls;
+        checkXRResult(func_xrLocateSpaces(m_session, &locateInfo, &spaceLocations), "Failed to get locations of the tracked spaces!");
+        for (size_t i = 0; i < spaces.size(); i++) {
+            locations[i].locationFlags = locationData[i].locationFlags;
+            locations[i].pose = locationData[i].pose;
+            velocities[i].velocityFlags = velocityData[i].velocityFlags;
+            velocities[i].linearVelocity = velocityData[i].linearVelocity;
+            velocities[i].angularVelocity = velocityData[i].angularVelocity;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < spaces.size(); i++) {
+        if (!spacesActive[i])
+            continue;
+        locations[i].next = &velocities[i];
+        ++m_frameLocateCalls;
+        checkXRResult(xrLocateSpace(spaces[i], baseSpace, time, &locations[i]), "Failed to get location of a tracked space!");
+        locations[i].next = nullptr;
+    }
+}
+
 std::optional<XrSpaceLocation> OpenXR::UpdateSpaces(XrTime predictedDisplayTime) {
     XrSpaceLocation spaceLocation = { XR_TYPE_SPACE_LOCATION };
+    ++m_frameLocateCalls;
     if (XrResult result = xrLocateSpace(m_headSpace, m_stageSpace, predictedDisplayTime, &spaceLocation); XR_SUCCEEDED(result)) {
         if (result != XR_ERROR_TIME_INVALID) {
             checkXRResult(result, "Failed to get space location!");
@@ -765,6 +850,18 @@ std::optional<XrSpaceLocation> OpenXR::UpdateSpaces(XrTime predictedDisplayTime)
     return spaceLocation;
 }
 
+std::optional<XrTime> OpenXR::GetRuntimeTimeNow() const {
+    if (func_xrConvertWin32PerformanceCounterToTimeKHR == nullptr)
+        return std::nullopt;
+
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    XrTime time = 0;
+    if (XR_FAILED(func_xrConvertWin32PerformanceCounterToTimeKHR(m_instance, &counter, &time)))
+        return std::nullopt;
+    return time;
+}
+
 void OpenXR::ProcessEvents() {
     auto processSessionStateChangedEvent = [this](XrEventDataSessionStateChanged* stateChangedEvent) {
         switch (stateChangedEvent->state) {
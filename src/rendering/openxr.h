@@ -1,6 +1,7 @@
 #pragma once
 
 #include "hooking/rumble.h"
+#include "utils/seqlock.h"
 
 class OpenXR {
     friend class RND_Renderer;
@@ -43,7 +44,9 @@ public:
 
             Event lastEvent = Event::None;
 
-            void resetFrameFlags() { lastEvent = Event::None; }
+            // a long press is reported by every sample while the button is held, a short press stays until the VPAD read that hands it to the game
+            void resetFrameFlags() { if (lastEvent == Event::LongPress) lastEvent = Event::None; }
+            void consumeShortPress() { if (lastEvent == Event::ShortPress) lastEvent = Event::None; }
             void resetButtonState() {
                 wasDownLastFrame = false;
                 longFired = false;
@@ -104,8 +107,14 @@ public:
             XrActionStateBoolean leftTrigger;
             XrActionStateBoolean rightTrigger;
         } inMenu;
+
+        void consumeShortPresses() {
+            for (ButtonState* buttonState : { &shared.inventory_mapState, &shared.modMenuState, &inGame.crouch_scopeState, &inGame.runState, &inGame.useRune_runeMenuState, &inGame.grabState[0], &inGame.grabState[1], &inMenu.holdState }) {
+                buttonState->consumeShortPress();
+            }
+        }
     };
-    std::atomic<InputState> m_input = InputState{};
+    SeqLock<InputState> m_input{ InputState{} };
     std::atomic<glm::fquat> m_inputCameraRotation = glm::identity<glm::fquat>();
 
     struct GameState {
@@ -158,7 +167,7 @@ public:
         int magnesis_forward_frames_interval = 0;
         bool trigger_pressed_over_body_slot = false;
     };
-    std::atomic<GameState> m_gameState{};
+    SeqLock<GameState> m_gameState{ GameState{} };
     std::atomic_bool m_isMenuOpen;
     std::atomic_uint8_t m_currMenuTab;
     std::atomic_bool m_forceTabChange;
@@ -176,15 +185,28 @@ public:
     void CreateActions();
     std::array<XrViewConfigurationView, 2> GetViewConfigurations();
     std::optional<XrSpaceLocation> UpdateSpaces(XrTime predictedDisplayTime);
-    std::optional<InputState> UpdateActions(XrTime predictedFrameTime, glm::fquat controllerRotation, bool inMenu);
+    // returns nullopt when the runtime doesn't support XR_KHR_win32_convert_performance_counter_time
+    std::optional<XrTime> GetRuntimeTimeNow() const;
+    std::optional<InputState> UpdateActions(XrTime predictedFrameTime, bool inMenu);
    
     void ProcessEvents();
 
+    // amount of xrLocateSpace(s)/xrLocateViews calls made during the previous frame
+    void OnFrameStart() { m_lastFrameLocateCalls = m_frameLocateCalls.exchange(0); }
+    uint32_t GetLastFrameLocateCalls() const { return m_lastFrameLocateCalls; }
+    bool SupportsBatchedLocateSpaces() const { return func_xrLocateSpaces != nullptr; }
+    XrVersion GetApiVersion() const { return m_apiVersion; }
+
+    XrInstance GetInstance() const { return m_instance; }
     XrSession GetSession() const { return m_session; }
     RND_Renderer* GetRenderer() const { return m_renderer.get(); }
     RumbleManager* GetRumbleManager() const { return m_rumbleManager.get(); }
 
 private:
+    static constexpr size_t MAX_BATCHED_SPACES = 8;
+    // locates the spaces with one xrLocateSpaces(KHR) call when available, otherwise each active space is located separately
+    void LocateSpaces(XrSpace baseSpace, XrTime time, std::span<const XrSpace> spaces, std::span<const bool> spacesActive, std::span<XrSpaceLocation> locations, std::span<XrSpaceVelocity> velocities);
+
     XrPath GetXRPath(const char* str) const {
         XrPath path;
         checkXRResult(xrStringToPath(m_instance, str, &path), std::format("Failed to get path for {}", str).c_str());
@@ -192,6 +214,7 @@ private:
     };
 
     XrInstance m_instance = XR_NULL_HANDLE;
+    XrVersion m_apiVersion = XR_API_VERSION_1_0;
     XrSystemId m_systemId = XR_NULL_SYSTEM_ID;
     XrSession m_session = XR_NULL_HANDLE;
     XrSpace m_stageSpace = XR_NULL_HANDLE;
@@ -200,6 +223,9 @@ private:
     std::array<XrSpace, 2> m_inMenuHandSpaces = { XR_NULL_HANDLE, XR_NULL_HANDLE };
     std::array<XrPath, 2> m_handPaths = { XR_NULL_PATH, XR_NULL_PATH };
 
+    std::atomic_uint32_t m_frameLocateCalls = 0;
+    std::atomic_uint32_t m_lastFrameLocateCalls = 0;
+
     XrAction m_inGameGripPoseAction = XR_NULL_HANDLE;
     XrAction m_inGameAimPoseAction = XR_NULL_HANDLE;
     XrAction m_inMenuGripPoseAction = XR_NULL_HANDLE;
@@ -253,6 +279,8 @@ private:
     PFN_xrConvertWin32PerformanceCounterToTimeKHR func_xrConvertWin32PerformanceCounterToTimeKHR = nullptr;
     PFN_xrCreateDebugUtilsMessengerEXT func_xrCreateDebugUtilsMessengerEXT = nullptr;
     PFN_xrDestroyDebugUtilsMessengerEXT func_xrDestroyDebugUtilsMessengerEXT = nullptr;
+    // the core function for OpenXR 1.1 instances, or xrLocateSpacesKHR which has the same signature
+    PFN_xrLocateSpaces func_xrLocateSpaces = nullptr;
 };
 using ButtonState = OpenXR::InputState::ButtonState;
 using EyeSide = OpenXR::EyeSide;
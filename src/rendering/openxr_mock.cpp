@@ -0,0 +1,946 @@
+#include "openxr_mock.h"
+#include <openxr/openxr_loader_negotiation.h>
+#include <deque>
+
+namespace {
+    struct MockSpace {
+        enum class Kind { Reference, Action } kind;
+        XrReferenceSpaceType referenceType = XR_REFERENCE_SPACE_TYPE_STAGE;
+        XrAction action = XR_NULL_HANDLE;
+        XrPath subactionPath = XR_NULL_PATH;
+        XrPosef poseInSpace = { { 0, 0, 0, 1 }, { 0, 0, 0 } };
+    };
+
+    struct MockAction {
+        std::string name;
+        XrActionType type;
+    };
+
+    struct MockSwapchain {
+        uint32_t width;
+        uint32_t height;
+        int64_t format;
+#if defined(_WIN32)
+        std::vector<ComPtr<ID3D12Resource>> images;
+#else
+        // only D3D12 sessions have swapchains, this just keeps the image count for the other platforms
+        std::vector<uint64_t> images;
+#endif
+        uint32_t nextImageIdx = 0;
+    };
+
+    struct CallCounters {
+        std::atomic_uint64_t frames = 0;
+        std::atomic_uint64_t waitFrame = 0;
+        std::atomic_uint64_t beginFrame = 0;
+        std::atomic_uint64_t endFrame = 0;
+        std::atomic_uint64_t syncActions = 0;
+        std::atomic_uint64_t getActionState = 0;
+        std::atomic_uint64_t locateSpace = 0;
+        std::atomic_uint64_t locateSpaces = 0;
+        std::atomic_uint64_t locateSpacesKHR = 0;
+        std::atomic_uint64_t locateViews = 0;
+        std::atomic_uint64_t applyHapticFeedback = 0;
+        std::atomic_uint64_t acquireSwapchainImage = 0;
+        std::atomic_uint64_t pollEvent = 0;
+        std::atomic_uint64_t endFrameLayers = 0;
+
+        MockXRRuntime::CallCounts Snapshot() const {
+            return {
+                frames.load(), waitFrame.load(), beginFrame.load(), endFrame.load(), syncActions.load(), getActionState.load(),
+                locateSpace.load(), locateSpaces.load(), locateSpacesKHR.load(), locateViews.load(), applyHapticFeedback.load(), acquireSwapchainImage.load(), pollEvent.load(), endFrameLayers.load()
+            };
+        }
+    };
+
+    // all handles given out by the mock runtime are just increasing numbers
+    struct MockRuntimeState {
+        std::mutex mutex;
+        MockXRRuntime::Script script = MockXRRuntime::DefaultScript();
+
+        uint64_t nextHandle = 1;
+        bool instanceCreated = false;
+        XrVersion apiVersion = 0;
+        XrSession session = XR_NULL_HANDLE;
+        XrSessionState sessionState = XR_SESSION_STATE_UNKNOWN;
+#if defined(_WIN32)
+        ComPtr<ID3D12Device> d3d12Device;
+#endif
+
+        std::vector<std::string> paths = { "" };
+        std::unordered_map<uint64_t, MockSpace> spaces;
+        std::unordered_map<uint64_t, MockAction> actions;
+        std::unordered_map<uint64_t, MockSwapchain> swapchains;
+        std::deque<XrEventDataSessionStateChanged> events;
+
+        XrTime lastPredictedDisplayTime = 0;
+        // like a real runtime, the action values are the ones from when the actions were last synced
+        XrTime lastSyncTime = 0;
+
+        CallCounters counters;
+        MockXRRuntime::CallCounts frameStartCounts = {};
+        MockXRRuntime::CallCounts lastFrameCounts = {};
+
+        template <typename T>
+        T NewHandle() { return (T)nextHandle++; }
+
+        void ChangeSessionState(XrSessionState newState) {
+            sessionState = newState;
+            XrEventDataSessionStateChanged event = { XR_TYPE_EVENT_DATA_SESSION_STATE_CHANGED };
+            event.session = session;
+            event.state = newState;
+            event.time = MockXRRuntime::GetRuntimeTime();
+            events.emplace_back(event);
+        }
+    };
+
+    MockRuntimeState& GetState() {
+        static MockRuntimeState s_state;
+        return s_state;
+    }
+
+    std::atomic_bool s_isActive = false;
+
+    XrPosef MultiplyPoses(const XrPosef& parent, const XrPosef& child) {
+        glm::fquat parentRot = ToGLM(parent.orientation);
+        return { ToXR(parentRot * ToGLM(child.orientation)), ToXR(ToGLM(parent.position) + parentRot * ToGLM(child.position)) };
+    }
+
+    XrPosef InversePose(const XrPosef& pose) {
+        glm::fquat invRot = glm::conjugate(ToGLM(pose.orientation));
+        return { ToXR(invRot), ToXR(invRot * -ToGLM(pose.position)) };
+    }
+
+    // caller must hold the mutex
+    std::optional<XrPosef> GetSpacePoseInStage(MockRuntimeState& state, XrSpace space, XrTime time) {
+        auto it = state.spaces.find((uint64_t)space);
+        if (it == state.spaces.end()) {
+            return std::nullopt;
+        }
+
+        const MockSpace& mockSpace = it->second;
+        XrPosef originPose = { { 0, 0, 0, 1 }, { 0, 0, 0 } };
+        if (mockSpace.kind == MockSpace::Kind::Reference) {
+            if (mockSpace.referenceType == XR_REFERENCE_SPACE_TYPE_VIEW) {
+                originPose = state.script.headPose(time);
+            }
+        }
+        else {
+            const std::string& subactionPath = state.paths[mockSpace.subactionPath];
+            originPose = state.script.handPoses[subactionPath == "/user/hand/right" ? 1 : 0](time);
+        }
+        return MultiplyPoses(originPose, mockSpace.poseInSpace);
+    }
+
+    void FillSpaceLocation(MockRuntimeState& state, XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) {
+        auto spacePose = GetSpacePoseInStage(state, space, time);
+        auto basePose = GetSpacePoseInStage(state, baseSpace, time);
+        if (!spacePose || !basePose) {
+            location->locationFlags = 0;
+            return;
+        }
+
+        XrPosef invBasePose = InversePose(*basePose);
+        location->pose = MultiplyPoses(invBasePose, *spacePose);
+        location->locationFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT | XR_SPACE_LOCATION_POSITION_TRACKED_BIT | XR_SPACE_LOCATION_ORIENTATION_TRACKED_BIT;
+
+        // derive velocities from the scripted poses using a 1ms difference
+        for (auto* next = reinterpret_cast<XrBaseOutStructure*>(location->next); next != nullptr; next = next->next) {
+            if (next->type != XR_TYPE_SPACE_VELOCITY) {
+                continue;
+            }
+            constexpr XrDuration delta = 1'000'000;
+            XrPosef prevPose = MultiplyPoses(invBasePose, GetSpacePoseInStage(state, space, time - delta).value());
+
+            glm::fquat rotationDelta = ToGLM(location->pose.orientation) * glm::conjugate(ToGLM(prevPose.orientation));
+            if (rotationDelta.w < 0.0f) {
+                rotationDelta = -rotationDelta;
+            }
+            const float deltaSeconds = (float)delta / 1e9f;
+            auto* velocity = reinterpret_cast<XrSpaceVelocity*>(next);
+            velocity->linearVelocity = ToXR((ToGLM(location->pose.position) - ToGLM(prevPose.position)) / deltaSeconds);
+            velocity->angularVelocity = ToXR(glm::axis(rotationDelta) * (glm::angle(rotationDelta) / deltaSeconds));
+            velocity->velocityFlags = XR_SPACE_VELOCITY_LINEAR_VALID_BIT | XR_SPACE_VELOCITY_ANGULAR_VALID_BIT;
+        }
+    }
+
+    void CopyString(char* dst, size_t dstSize, std::string_view src) {
+        size_t count = std::min(dstSize - 1, src.size());
+        memcpy(dst, src.data(), count);
+        dst[count] = '\0';
+    }
+
+    template <typename T>
+    XrResult FillArray(uint32_t capacityInput, uint32_t* countOutput, T* output, const std::vector<T>& values) {
+        *countOutput = (uint32_t)values.size();
+        if (capacityInput == 0) {
+            return XR_SUCCESS;
+        }
+        if (capacityInput < values.size()) {
+            return XR_ERROR_SIZE_INSUFFICIENT;
+        }
+        std::copy(values.begin(), values.end(), output);
+        return XR_SUCCESS;
+    }
+
+    // without D3D12 the sessions are headless, which is enough for running the frame loop and the input without a GPU
+    const std::array s_supportedExtensions = {
+#if defined(_WIN32)
+        XR_KHR_D3D12_ENABLE_EXTENSION_NAME,
+        XR_KHR_WIN32_CONVERT_PERFORMANCE_COUNTER_TIME_EXTENSION_NAME,
+#else
+        XR_MND_HEADLESS_EXTENSION_NAME,
+#endif
+        XR_KHR_COMPOSITION_LAYER_DEPTH_EXTENSION_NAME,
+        XR_KHR_LOCATE_SPACES_EXTENSION_NAME,
+    };
+}
+
+// instance and system
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrEnumerateInstanceExtensionProperties(const char* layerName, uint32_t propertyCapacityInput, uint32_t* propertyCountOutput, XrExtensionProperties* properties) {
+    std::vector<XrExtensionProperties> extensions;
+    for (const char* name : s_supportedExtensions) {
+        XrExtensionProperties& extension = extensions.emplace_back(XrExtensionProperties{ XR_TYPE_EXTENSION_PROPERTIES });
+        CopyString(extension.extensionName, XR_MAX_EXTENSION_NAME_SIZE, name);
+        extension.extensionVersion = 1;
+    }
+    return FillArray(propertyCapacityInput, propertyCountOutput, properties, extensions);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrCreateInstance(const XrInstanceCreateInfo* createInfo, XrInstance* instance) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    for (uint32_t i = 0; i < createInfo->enabledExtensionCount; i++) {
+        if (std::ranges::none_of(s_supportedExtensions, [&](const char* name) { return strcmp(name, createInfo->enabledExtensionNames[i]) == 0; })) {
+            return XR_ERROR_EXTENSION_NOT_PRESENT;
+        }
+    }
+    // like runtimes that implement OpenXR 1.1, both 1.0 and 1.1 instances can be created
+    const XrVersion apiVersion = createInfo->applicationInfo.apiVersion;
+    if (XR_VERSION_MAJOR(apiVersion) != 1 || XR_VERSION_MINOR(apiVersion) > 1) {
+        return XR_ERROR_API_VERSION_UNSUPPORTED;
+    }
+    state.apiVersion = apiVersion;
+    state.instanceCreated = true;
+    *instance = state.NewHandle<XrInstance>();
+    s_isActive = true;
+    Log::print<INFO>("Using the BetterVR mock OpenXR runtime, no headset will be used!");
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrDestroyInstance(XrInstance instance) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.instanceCreated = false;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetInstanceProperties(XrInstance instance, XrInstanceProperties* instanceProperties) {
+    instanceProperties->runtimeVersion = XR_MAKE_VERSION(1, 0, 0);
+    CopyString(instanceProperties->runtimeName, XR_MAX_RUNTIME_NAME_SIZE, "BetterVR Mock Runtime");
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetSystem(XrInstance instance, const XrSystemGetInfo* getInfo, XrSystemId* systemId) {
+    if (getInfo->formFactor != XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY) {
+        return XR_ERROR_FORM_FACTOR_UNSUPPORTED;
+    }
+    *systemId = 1;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetSystemProperties(XrInstance instance, XrSystemId systemId, XrSystemProperties* properties) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    properties->systemId = systemId;
+    properties->vendorId = 0;
+    CopyString(properties->systemName, XR_MAX_SYSTEM_NAME_SIZE, "BetterVR Mock HMD");
+    properties->graphicsProperties.maxLayerCount = 16;
+    properties->graphicsProperties.maxSwapchainImageWidth = state.script.recommendedWidth * 2;
+    properties->graphicsProperties.maxSwapchainImageHeight = state.script.recommendedHeight * 2;
+    properties->trackingProperties.orientationTracking = XR_TRUE;
+    properties->trackingProperties.positionTracking = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetViewConfigurationProperties(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, XrViewConfigurationProperties* configurationProperties) {
+    if (viewConfigurationType != XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO) {
+        return XR_ERROR_VIEW_CONFIGURATION_TYPE_UNSUPPORTED;
+    }
+    configurationProperties->viewConfigurationType = viewConfigurationType;
+    configurationProperties->fovMutable = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrEnumerateViewConfigurationViews(XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrViewConfigurationView* views) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    XrViewConfigurationView view = { XR_TYPE_VIEW_CONFIGURATION_VIEW };
+    view.recommendedImageRectWidth = state.script.recommendedWidth;
+    view.recommendedImageRectHeight = state.script.recommendedHeight;
+    view.maxImageRectWidth = state.script.recommendedWidth * 2;
+    view.maxImageRectHeight = state.script.recommendedHeight * 2;
+    view.recommendedSwapchainSampleCount = 1;
+    view.maxSwapchainSampleCount = 1;
+    return FillArray(viewCapacityInput, viewCountOutput, views, std::vector{ view, view });
+}
+
+#if defined(_WIN32)
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetD3D12GraphicsRequirementsKHR(XrInstance instance, XrSystemId systemId, XrGraphicsRequirementsD3D12KHR* graphicsRequirements) {
+    // use the first hardware adapter, which is what Cemu will usually pick as well
+    ComPtr<IDXGIFactory4> dxgiFactory;
+    if (FAILED(CreateDXGIFactory1(IID_PPV_ARGS(&dxgiFactory)))) {
+        return XR_ERROR_RUNTIME_FAILURE;
+    }
+    ComPtr<IDXGIAdapter1> dxgiAdapter;
+    for (UINT i = 0; dxgiFactory->EnumAdapters1(i, &dxgiAdapter) != DXGI_ERROR_NOT_FOUND; i++) {
+        DXGI_ADAPTER_DESC1 adapterDesc;
+        dxgiAdapter->GetDesc1(&adapterDesc);
+        if ((adapterDesc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) == 0 || i == 0) {
+            graphicsRequirements->adapterLuid = adapterDesc.AdapterLuid;
+        }
+        if ((adapterDesc.Flags & DXGI_ADAPTER_FLAG_SOFTWARE) == 0) {
+            break;
+        }
+    }
+    graphicsRequirements->minFeatureLevel = D3D_FEATURE_LEVEL_11_0;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrConvertTimeToWin32PerformanceCounterKHR(XrInstance instance, XrTime time, LARGE_INTEGER* performanceCounter) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    performanceCounter->QuadPart = (LONGLONG)((double)time * (double)frequency.QuadPart / 1e9);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrConvertWin32PerformanceCounterToTimeKHR(XrInstance instance, const LARGE_INTEGER* performanceCounter, XrTime* time) {
+    LARGE_INTEGER frequency;
+    QueryPerformanceFrequency(&frequency);
+    *time = (XrTime)((double)performanceCounter->QuadPart * 1e9 / (double)frequency.QuadPart);
+    return XR_SUCCESS;
+}
+#endif
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrPollEvent(XrInstance instance, XrEventDataBuffer* eventData) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.counters.pollEvent++;
+    if (state.events.empty()) {
+        return XR_EVENT_UNAVAILABLE;
+    }
+    memcpy(eventData, &state.events.front(), sizeof(XrEventDataSessionStateChanged));
+    state.events.pop_front();
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrStringToPath(XrInstance instance, const char* pathString, XrPath* path) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    auto it = std::ranges::find(state.paths, std::string_view(pathString));
+    if (it == state.paths.end()) {
+        state.paths.emplace_back(pathString);
+        it = state.paths.end() - 1;
+    }
+    *path = (XrPath)std::distance(state.paths.begin(), it);
+    return XR_SUCCESS;
+}
+
+// session
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrCreateSession(XrInstance instance, const XrSessionCreateInfo* createInfo, XrSession* session) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+#if defined(_WIN32)
+    const XrBaseInStructure* next = reinterpret_cast<const XrBaseInStructure*>(createInfo->next);
+    while (next != nullptr && next->type != XR_TYPE_GRAPHICS_BINDING_D3D12_KHR) {
+        next = next->next;
+    }
+    if (next == nullptr) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+
+    state.d3d12Device = reinterpret_cast<const XrGraphicsBindingD3D12KHR*>(next)->device;
+#else
+    // a headless session (XR_MND_headless) doesn't get a graphics binding
+    if (createInfo->next != nullptr) {
+        return XR_ERROR_GRAPHICS_DEVICE_INVALID;
+    }
+#endif
+    state.session = state.NewHandle<XrSession>();
+    *session = state.session;
+    state.ChangeSessionState(XR_SESSION_STATE_IDLE);
+    state.ChangeSessionState(XR_SESSION_STATE_READY);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrDestroySession(XrSession session) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.swapchains.clear();
+#if defined(_WIN32)
+    state.d3d12Device.Reset();
+#endif
+    state.session = XR_NULL_HANDLE;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrBeginSession(XrSession session, const XrSessionBeginInfo* beginInfo) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.ChangeSessionState(XR_SESSION_STATE_SYNCHRONIZED);
+    state.ChangeSessionState(XR_SESSION_STATE_VISIBLE);
+    state.ChangeSessionState(XR_SESSION_STATE_FOCUSED);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrRequestExitSession(XrSession session) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.ChangeSessionState(XR_SESSION_STATE_VISIBLE);
+    state.ChangeSessionState(XR_SESSION_STATE_SYNCHRONIZED);
+    state.ChangeSessionState(XR_SESSION_STATE_STOPPING);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrEndSession(XrSession session) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.ChangeSessionState(XR_SESSION_STATE_IDLE);
+    state.ChangeSessionState(XR_SESSION_STATE_EXITING);
+    return XR_SUCCESS;
+}
+
+// spaces
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrCreateReferenceSpace(XrSession session, const XrReferenceSpaceCreateInfo* createInfo, XrSpace* space) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    *space = state.NewHandle<XrSpace>();
+    state.spaces[(uint64_t)*space] = MockSpace{ .kind = MockSpace::Kind::Reference, .referenceType = createInfo->referenceSpaceType, .poseInSpace = createInfo->poseInReferenceSpace };
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrCreateActionSpace(XrSession session, const XrActionSpaceCreateInfo* createInfo, XrSpace* space) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    *space = state.NewHandle<XrSpace>();
+    state.spaces[(uint64_t)*space] = MockSpace{ .kind = MockSpace::Kind::Action, .action = createInfo->action, .subactionPath = createInfo->subactionPath, .poseInSpace = createInfo->poseInActionSpace };
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrDestroySpace(XrSpace space) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.spaces.erase((uint64_t)space);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrLocateSpace(XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.counters.locateSpace++;
+    FillSpaceLocation(state, space, baseSpace, time, location);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrLocateSpaces(XrSession session, const XrSpacesLocateInfo* locateInfo, XrSpaceLocations* spaceLocations) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.counters.locateSpaces++;
+
+    if (spaceLocations->locationCount != locateInfo->spaceCount) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+    XrSpaceVelocities* spaceVelocities = nullptr;
+    for (auto* next = reinterpret_cast<XrBaseOutStructure*>(spaceLocations->next); next != nullptr; next = next->next) {
+        if (next->type == XR_TYPE_SPACE_VELOCITIES) {
+            spaceVelocities = reinterpret_cast<XrSpaceVelocities*>(next);
+        }
+    }
+    if (spaceVelocities != nullptr && spaceVelocities->velocityCount != locateInfo->spaceCount) {
+        return XR_ERROR_VALIDATION_FAILURE;
+    }
+
+    for (uint32_t i = 0; i < locateInfo->spaceCount; i++) {
+        XrSpaceLocation location = { XR_TYPE_SPACE_LOCATION };
+        XrSpaceVelocity velocity = { XR_TYPE_SPACE_VELOCITY };
+        if (spaceVelocities != nullptr) {
+            location.next = &velocity;
+        }
+        FillSpaceLocation(state, locateInfo->spaces[i], locateInfo->baseSpace, locateInfo->time, &location);
+
+        spaceLocations->locations[i].locationFlags = location.locationFlags;
+        spaceLocations->locations[i].pose = location.pose;
+        if (spaceVelocities != nullptr) {
+            spaceVelocities->velocities[i].velocityFlags = velocity.velocityFlags;
+            spaceVelocities->velocities[i].linearVelocity = velocity.linearVelocity;
+            spaceVelocities->velocities[i].angularVelocity = velocity.angularVelocity;
+        }
+    }
+    return XR_SUCCESS;
+}
+
+// XR_KHR_locate_spaces uses the same structs as the core function from OpenXR 1.1
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrLocateSpacesKHR(XrSession session, const XrSpacesLocateInfoKHR* locateInfo, XrSpaceLocationsKHR* spaceLocations) {
+    {
+        auto& state = GetState();
+        std::lock_guard lk(state.mutex);
+        state.counters.locateSpacesKHR++;
+    }
+    return Mock_xrLocateSpaces(session, locateInfo, spaceLocations);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrLocateViews(XrSession session, const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrView* views) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.counters.locateViews++;
+
+    *viewCountOutput = 2;
+    if (viewCapacityInput == 0) {
+        return XR_SUCCESS;
+    }
+    if (viewCapacityInput < 2) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+
+    auto basePose = GetSpacePoseInStage(state, viewLocateInfo->space, viewLocateInfo->displayTime);
+    if (!basePose) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    XrPosef headInBase = MultiplyPoses(InversePose(*basePose), state.script.headPose(viewLocateInfo->displayTime));
+    for (uint32_t i = 0; i < 2; i++) {
+        XrPosef eyeOffset = { { 0, 0, 0, 1 }, { (i == 0 ? -0.5f : 0.5f) * state.script.ipd, 0, 0 } };
+        views[i].pose = MultiplyPoses(headInBase, eyeOffset);
+        views[i].fov = state.script.fov[i];
+    }
+    viewState->viewStateFlags = XR_VIEW_STATE_POSITION_VALID_BIT | XR_VIEW_STATE_ORIENTATION_VALID_BIT | XR_VIEW_STATE_POSITION_TRACKED_BIT | XR_VIEW_STATE_ORIENTATION_TRACKED_BIT;
+    return XR_SUCCESS;
+}
+
+// actions
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrCreateActionSet(XrInstance instance, const XrActionSetCreateInfo* createInfo, XrActionSet* actionSet) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    *actionSet = state.NewHandle<XrActionSet>();
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrDestroyActionSet(XrActionSet actionSet) {
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrCreateAction(XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    *action = state.NewHandle<XrAction>();
+    state.actions[(uint64_t)*action] = MockAction{ createInfo->actionName, createInfo->actionType };
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrDestroyAction(XrAction action) {
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrSuggestInteractionProfileBindings(XrInstance instance, const XrInteractionProfileSuggestedBinding* suggestedBindings) {
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrAttachSessionActionSets(XrSession session, const XrSessionActionSetsAttachInfo* attachInfo) {
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrSyncActions(XrSession session, const XrActionsSyncInfo* syncInfo) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.counters.syncActions++;
+    state.lastSyncTime = MockXRRuntime::GetRuntimeTime();
+    return state.sessionState == XR_SESSION_STATE_FOCUSED ? XR_SUCCESS : XR_SESSION_NOT_FOCUSED;
+}
+
+static glm::fvec2 GetScriptedActionValue(MockRuntimeState& state, const XrActionStateGetInfo* getInfo) {
+    state.counters.getActionState++;
+    auto it = state.actions.find((uint64_t)getInfo->action);
+    if (it == state.actions.end() || !state.script.actionValue) {
+        return { 0.0f, 0.0f };
+    }
+    return state.script.actionValue(it->second.name, getInfo->subactionPath, state.lastSyncTime);
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetActionStateBoolean(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* actionState) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    actionState->currentState = GetScriptedActionValue(state, getInfo).x > 0.5f ? XR_TRUE : XR_FALSE;
+    actionState->isActive = XR_TRUE;
+    actionState->lastChangeTime = state.lastPredictedDisplayTime;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetActionStateFloat(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* actionState) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    actionState->currentState = GetScriptedActionValue(state, getInfo).x;
+    actionState->isActive = XR_TRUE;
+    actionState->lastChangeTime = state.lastPredictedDisplayTime;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetActionStateVector2f(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* actionState) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    actionState->currentState = ToXR(GetScriptedActionValue(state, getInfo));
+    actionState->isActive = XR_TRUE;
+    actionState->lastChangeTime = state.lastPredictedDisplayTime;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetActionStatePose(XrSession session, const XrActionStateGetInfo* getInfo, XrActionStatePose* actionState) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.counters.getActionState++;
+    actionState->isActive = XR_TRUE;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrApplyHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo, const XrHapticBaseHeader* hapticFeedback) {
+    GetState().counters.applyHapticFeedback++;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrStopHapticFeedback(XrSession session, const XrHapticActionInfo* hapticActionInfo) {
+    return XR_SUCCESS;
+}
+
+// swapchains
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrEnumerateSwapchainFormats(XrSession session, uint32_t formatCapacityInput, uint32_t* formatCountOutput, int64_t* formats) {
+#if defined(_WIN32)
+    return FillArray(formatCapacityInput, formatCountOutput, formats, std::vector<int64_t>{ DXGI_FORMAT_R8G8B8A8_UNORM_SRGB, DXGI_FORMAT_B8G8R8A8_UNORM_SRGB, DXGI_FORMAT_D32_FLOAT });
+#else
+    return FillArray(formatCapacityInput, formatCountOutput, formats, std::vector<int64_t>{});
+#endif
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrCreateSwapchain(XrSession session, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain) {
+#if defined(_WIN32)
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    if (!state.d3d12Device) {
+        return XR_ERROR_SESSION_LOST;
+    }
+
+    const bool isDepth = (createInfo->usageFlags & XR_SWAPCHAIN_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT) != 0;
+    MockSwapchain mockSwapchain = { createInfo->width, createInfo->height, createInfo->format };
+
+    D3D12_HEAP_PROPERTIES heapProperties = { D3D12_HEAP_TYPE_DEFAULT };
+    D3D12_RESOURCE_DESC textureDesc = {};
+    textureDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+    textureDesc.Width = createInfo->width;
+    textureDesc.Height = createInfo->height;
+    textureDesc.DepthOrArraySize = (UINT16)createInfo->arraySize;
+    textureDesc.MipLevels = (UINT16)createInfo->mipCount;
+    textureDesc.Format = (DXGI_FORMAT)createInfo->format;
+    textureDesc.SampleDesc.Count = createInfo->sampleCount;
+    textureDesc.Flags = isDepth ? D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL : D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET;
+
+    // OpenXR hands out swapchain images in the render target or depth write state
+    for (int i = 0; i < 3; i++) {
+        ComPtr<ID3D12Resource>& image = mockSwapchain.images.emplace_back();
+        if (FAILED(state.d3d12Device->CreateCommittedResource(&heapProperties, D3D12_HEAP_FLAG_NONE, &textureDesc, isDepth ? D3D12_RESOURCE_STATE_DEPTH_WRITE : D3D12_RESOURCE_STATE_RENDER_TARGET, nullptr, IID_PPV_ARGS(&image)))) {
+            return XR_ERROR_RUNTIME_FAILURE;
+        }
+    }
+
+    *swapchain = state.NewHandle<XrSwapchain>();
+    state.swapchains[(uint64_t)*swapchain] = std::move(mockSwapchain);
+    return XR_SUCCESS;
+#else
+    // headless sessions can't create swapchains
+    return XR_ERROR_FUNCTION_UNSUPPORTED;
+#endif
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrDestroySwapchain(XrSwapchain swapchain) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.swapchains.erase((uint64_t)swapchain);
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrEnumerateSwapchainImages(XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t* imageCountOutput, XrSwapchainImageBaseHeader* images) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    auto it = state.swapchains.find((uint64_t)swapchain);
+    if (it == state.swapchains.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+
+    *imageCountOutput = (uint32_t)it->second.images.size();
+    if (imageCapacityInput == 0) {
+        return XR_SUCCESS;
+    }
+    if (imageCapacityInput < it->second.images.size()) {
+        return XR_ERROR_SIZE_INSUFFICIENT;
+    }
+#if defined(_WIN32)
+    auto* d3d12Images = reinterpret_cast<XrSwapchainImageD3D12KHR*>(images);
+    for (size_t i = 0; i < it->second.images.size(); i++) {
+        d3d12Images[i].texture = it->second.images[i].Get();
+    }
+#endif
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrAcquireSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.counters.acquireSwapchainImage++;
+    auto it = state.swapchains.find((uint64_t)swapchain);
+    if (it == state.swapchains.end()) {
+        return XR_ERROR_HANDLE_INVALID;
+    }
+    *index = it->second.nextImageIdx;
+    it->second.nextImageIdx = (it->second.nextImageIdx + 1) % (uint32_t)it->second.images.size();
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrWaitSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo) {
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrReleaseSwapchainImage(XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo) {
+    return XR_SUCCESS;
+}
+
+// frame loop
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrWaitFrame(XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState) {
+    auto& state = GetState();
+    XrDuration displayPeriod;
+    XrDuration predictionOffset;
+    bool paceFrames;
+    {
+        std::lock_guard lk(state.mutex);
+        state.counters.waitFrame++;
+        displayPeriod = state.script.displayPeriod;
+        predictionOffset = state.script.predictionOffset;
+        paceFrames = state.script.paceFrames;
+    }
+
+    // block until the next simulated vsync, without holding the lock so that other threads can keep calling into the runtime
+    XrTime now = MockXRRuntime::GetRuntimeTime();
+    XrTime nextVsync = ((now / displayPeriod) + 1) * displayPeriod;
+    if (paceFrames) {
+        std::this_thread::sleep_for(std::chrono::nanoseconds(nextVsync - now));
+    }
+
+    std::lock_guard lk(state.mutex);
+    frameState->predictedDisplayTime = std::max(nextVsync + predictionOffset - displayPeriod, state.lastPredictedDisplayTime + displayPeriod);
+    frameState->predictedDisplayPeriod = displayPeriod;
+    frameState->shouldRender = state.sessionState == XR_SESSION_STATE_VISIBLE || state.sessionState == XR_SESSION_STATE_FOCUSED;
+    state.lastPredictedDisplayTime = frameState->predictedDisplayTime;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrBeginFrame(XrSession session, const XrFrameBeginInfo* frameBeginInfo) {
+    GetState().counters.beginFrame++;
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrEndFrame(XrSession session, const XrFrameEndInfo* frameEndInfo) {
+    auto& state = GetState();
+    std::lock_guard lk(state.mutex);
+    state.counters.endFrame++;
+    state.counters.endFrameLayers += frameEndInfo->layerCount;
+    state.counters.frames++;
+
+    MockXRRuntime::CallCounts currCounts = state.counters.Snapshot();
+    state.lastFrameCounts = {
+        1,
+        currCounts.waitFrame - state.frameStartCounts.waitFrame,
+        currCounts.beginFrame - state.frameStartCounts.beginFrame,
+        currCounts.endFrame - state.frameStartCounts.endFrame,
+        currCounts.syncActions - state.frameStartCounts.syncActions,
+        currCounts.getActionState - state.frameStartCounts.getActionState,
+        currCounts.locateSpace - state.frameStartCounts.locateSpace,
+        currCounts.locateSpaces - state.frameStartCounts.locateSpaces,
+        currCounts.locateSpacesKHR - state.frameStartCounts.locateSpacesKHR,
+        currCounts.locateViews - state.frameStartCounts.locateViews,
+        currCounts.applyHapticFeedback - state.frameStartCounts.applyHapticFeedback,
+        currCounts.acquireSwapchainImage - state.frameStartCounts.acquireSwapchainImage,
+        currCounts.pollEvent - state.frameStartCounts.pollEvent,
+        currCounts.endFrameLayers - state.frameStartCounts.endFrameLayers,
+    };
+    state.frameStartCounts = currCounts;
+
+    if (currCounts.frames % 500 == 0) {
+        const auto& last = state.lastFrameCounts;
+        Log::print<INTEROP>("[Mock Runtime] Frame #{}: syncActions={}, getActionState={}, locateSpace={}, locateSpaces={}, locateViews={}, acquireSwapchainImage={}, pollEvent={}, layers={}",
+            currCounts.frames, last.syncActions, last.getActionState, last.locateSpace, last.locateSpaces, last.locateViews, last.acquireSwapchainImage, last.pollEvent, last.endFrameLayers);
+    }
+    return XR_SUCCESS;
+}
+
+static XRAPI_ATTR XrResult XRAPI_CALL Mock_xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
+    static const std::unordered_map<std::string_view, PFN_xrVoidFunction> s_functions = {
+#define MOCK_XR_FUNCTION(name) { #name, reinterpret_cast<PFN_xrVoidFunction>(&Mock_##name) }
+        MOCK_XR_FUNCTION(xrGetInstanceProcAddr),
+        MOCK_XR_FUNCTION(xrEnumerateInstanceExtensionProperties),
+        MOCK_XR_FUNCTION(xrCreateInstance),
+        MOCK_XR_FUNCTION(xrDestroyInstance),
+        MOCK_XR_FUNCTION(xrGetInstanceProperties),
+        MOCK_XR_FUNCTION(xrGetSystem),
+        MOCK_XR_FUNCTION(xrGetSystemProperties),
+        MOCK_XR_FUNCTION(xrGetViewConfigurationProperties),
+        MOCK_XR_FUNCTION(xrEnumerateViewConfigurationViews),
+#if defined(_WIN32)
+        MOCK_XR_FUNCTION(xrGetD3D12GraphicsRequirementsKHR),
+        MOCK_XR_FUNCTION(xrConvertTimeToWin32PerformanceCounterKHR),
+        MOCK_XR_FUNCTION(xrConvertWin32PerformanceCounterToTimeKHR),
+#endif
+        MOCK_XR_FUNCTION(xrPollEvent),
+        MOCK_XR_FUNCTION(xrStringToPath),
+        MOCK_XR_FUNCTION(xrCreateSession),
+        MOCK_XR_FUNCTION(xrDestroySession),
+        MOCK_XR_FUNCTION(xrBeginSession),
+        MOCK_XR_FUNCTION(xrRequestExitSession),
+        MOCK_XR_FUNCTION(xrEndSession),
+        MOCK_XR_FUNCTION(xrCreateReferenceSpace),
+        MOCK_XR_FUNCTION(xrCreateActionSpace),
+        MOCK_XR_FUNCTION(xrDestroySpace),
+        MOCK_XR_FUNCTION(xrLocateSpace),
+        MOCK_XR_FUNCTION(xrLocateSpaces),
+        MOCK_XR_FUNCTION(xrLocateSpacesKHR),
+        MOCK_XR_FUNCTION(xrLocateViews),
+        MOCK_XR_FUNCTION(xrCreateActionSet),
+        MOCK_XR_FUNCTION(xrDestroyActionSet),
+        MOCK_XR_FUNCTION(xrCreateAction),
+        MOCK_XR_FUNCTION(xrDestroyAction),
+        MOCK_XR_FUNCTION(xrSuggestInteractionProfileBindings),
+        MOCK_XR_FUNCTION(xrAttachSessionActionSets),
+        MOCK_XR_FUNCTION(xrSyncActions),
+        MOCK_XR_FUNCTION(xrGetActionStateBoolean),
+        MOCK_XR_FUNCTION(xrGetActionStateFloat),
+        MOCK_XR_FUNCTION(xrGetActionStateVector2f),
+        MOCK_XR_FUNCTION(xrGetActionStatePose),
+        MOCK_XR_FUNCTION(xrApplyHapticFeedback),
+        MOCK_XR_FUNCTION(xrStopHapticFeedback),
+        MOCK_XR_FUNCTION(xrEnumerateSwapchainFormats),
+        MOCK_XR_FUNCTION(xrCreateSwapchain),
+        MOCK_XR_FUNCTION(xrDestroySwapchain),
+        MOCK_XR_FUNCTION(xrEnumerateSwapchainImages),
+        MOCK_XR_FUNCTION(xrAcquireSwapchainImage),
+        MOCK_XR_FUNCTION(xrWaitSwapchainImage),
+        MOCK_XR_FUNCTION(xrReleaseSwapchainImage),
+        MOCK_XR_FUNCTION(xrWaitFrame),
+        MOCK_XR_FUNCTION(xrBeginFrame),
+        MOCK_XR_FUNCTION(xrEndFrame),
+#undef MOCK_XR_FUNCTION
+    };
+
+    // xrLocateSpaces is only part of the core API of instances that were created for OpenXR 1.1
+    const bool isCoreFunction = strcmp(name, "xrLocateSpaces") == 0;
+    if (auto it = s_functions.find(name); it != s_functions.end() && (!isCoreFunction || XR_VERSION_MINOR(GetState().apiVersion) >= 1)) {
+        *function = it->second;
+        return XR_SUCCESS;
+    }
+    *function = nullptr;
+    return XR_ERROR_FUNCTION_UNSUPPORTED;
+}
+
+// called by the OpenXR loader when it loads BetterVR_MockRuntime.dll as the runtime from BetterVR_MockRuntime.json
+#if defined(_WIN32)
+#define MOCK_RUNTIME_EXPORT __declspec(dllexport)
+#else
+#define MOCK_RUNTIME_EXPORT __attribute__((visibility("default")))
+#endif
+
+extern "C" MOCK_RUNTIME_EXPORT XrResult XRAPI_CALL xrNegotiateLoaderRuntimeInterface(const XrNegotiateLoaderInfo* loaderInfo, XrNegotiateRuntimeRequest* runtimeRequest) {
+    if (loaderInfo == nullptr || runtimeRequest == nullptr || loaderInfo->structType != XR_LOADER_INTERFACE_STRUCT_LOADER_INFO || runtimeRequest->structType != XR_LOADER_INTERFACE_STRUCT_RUNTIME_REQUEST) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+    if (loaderInfo->minInterfaceVersion > XR_CURRENT_LOADER_RUNTIME_VERSION || loaderInfo->maxInterfaceVersion < XR_CURRENT_LOADER_RUNTIME_VERSION) {
+        return XR_ERROR_INITIALIZATION_FAILED;
+    }
+
+    runtimeRequest->runtimeInterfaceVersion = XR_CURRENT_LOADER_RUNTIME_VERSION;
+    runtimeRequest->runtimeApiVersion = XR_CURRENT_API_VERSION;
+    runtimeRequest->getInstanceProcAddr = &Mock_xrGetInstanceProcAddr;
+    return XR_SUCCESS;
+}
+
+
+namespace MockXRRuntime {
+    Script DefaultScript() {
+        // standing still with a slow head sway and both hands held in front of the body
+        Script script;
+        script.headPose = [](XrTime time) -> XrPosef {
+            const float seconds = (float)((double)time / 1e9);
+            glm::fquat rotation = glm::angleAxis(0.3f * glm::sin(seconds * 0.5f), glm::fvec3(0.0f, 1.0f, 0.0f));
+            return { ToXR(rotation), { 0.0f, 1.7f, 0.0f } };
+        };
+        script.handPoses[0] = [](XrTime time) -> XrPosef {
+            return { { 0, 0, 0, 1 }, { -0.2f, 1.2f, -0.3f } };
+        };
+        script.handPoses[1] = [](XrTime time) -> XrPosef {
+            return { { 0, 0, 0, 1 }, { 0.2f, 1.2f, -0.3f } };
+        };
+        script.actionValue = [](std::string_view actionName, XrPath subactionPath, XrTime time) -> glm::fvec2 {
+            return { 0.0f, 0.0f };
+        };
+        return script;
+    }
+
+    void SetScript(Script script) {
+        auto& state = GetState();
+        std::lock_guard lk(state.mutex);
+        state.script = std::move(script);
+    }
+
+    CallCounts GetCallCounts() {
+        return GetState().counters.Snapshot();
+    }
+
+    CallCounts GetLastFrameCallCounts() {
+        auto& state = GetState();
+        std::lock_guard lk(state.mutex);
+        return state.lastFrameCounts;
+    }
+
+    void ResetCallCounts() {
+        auto& state = GetState();
+        std::lock_guard lk(state.mutex);
+        state.counters.frames = 0;
+        state.counters.waitFrame = 0;
+        state.counters.beginFrame = 0;
+        state.counters.endFrame = 0;
+        state.counters.syncActions = 0;
+        state.counters.getActionState = 0;
+        state.counters.locateSpace = 0;
+        state.counters.locateSpaces = 0;
+        state.counters.locateSpacesKHR = 0;
+        state.counters.locateViews = 0;
+        state.counters.applyHapticFeedback = 0;
+        state.counters.acquireSwapchainImage = 0;
+        state.counters.pollEvent = 0;
+        state.counters.endFrameLayers = 0;
+        state.frameStartCounts = {};
+        state.lastFrameCounts = {};
+    }
+
+    XrTime GetRuntimeTime() {
+#if defined(_WIN32)
+        LARGE_INTEGER counter;
+        QueryPerformanceCounter(&counter);
+        XrTime time = 0;
+        Mock_xrConvertWin32PerformanceCounterToTimeKHR(XR_NULL_HANDLE, &counter, &time);
+        return time;
+#else
+        return (XrTime)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    bool IsActive() {
+        return s_isActive;
+    }
+
+    XrResult GetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
+        return Mock_xrGetInstanceProcAddr(instance, name, function);
+    }
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+// In-process OpenXR runtime that can stand in for SteamVR, Oculus or the Meta XR Simulator when benchmarking the frame loop.
+// It's built into BetterVR_MockRuntime.dll and BetterVR_Tests with BETTERVR_BUILD_TESTS, and isn't part of the layer DLL.
+// The OpenXR loader loads BetterVR_MockRuntime.dll when XR_RUNTIME_JSON points to BetterVR_MockRuntime.json.
+// Outside of Windows it only creates headless sessions (XR_MND_headless), which tests/mock_runtime_runner uses to run the frame loop.
+// Poses, action values and frame pacing are scripted, and every runtime call the mod makes is counted.
+namespace MockXRRuntime {
+    struct Script {
+        // poses are in stage space
+        std::function<XrPosef(XrTime time)> headPose;
+        std::array<std::function<XrPosef(XrTime time)>, 2> handPoses;
+        // booleans use x > 0.5, floats use x and vector2's use both
+        std::function<glm::fvec2(std::string_view actionName, XrPath subactionPath, XrTime time)> actionValue;
+
+        std::array<XrFovf, 2> fov = { XrFovf{ -0.9f, 0.8f, 0.8f, -0.9f }, XrFovf{ -0.8f, 0.9f, 0.8f, -0.9f } };
+        float ipd = 0.063f;
+        uint32_t recommendedWidth = 2064;
+        uint32_t recommendedHeight = 2208;
+
+        XrDuration displayPeriod = 11'111'111; // 90 Hz
+        // how far after xrWaitFrame returns the frame is predicted to be displayed, usually two display periods for a real runtime
+        XrDuration predictionOffset = 2 * 11'111'111;
+        // when disabled xrWaitFrame returns immediately, which makes the frame loop run as fast as the mod allows
+        bool paceFrames = true;
+    };
+
+    struct CallCounts {
+        uint64_t frames = 0;
+        uint64_t waitFrame = 0;
+        uint64_t beginFrame = 0;
+        uint64_t endFrame = 0;
+        uint64_t syncActions = 0;
+        uint64_t getActionState = 0;
+        uint64_t locateSpace = 0;
+        // batched calls through xrLocateSpaces or XR_KHR_locate_spaces, and the ones that went through the extension
+        uint64_t locateSpaces = 0;
+        uint64_t locateSpacesKHR = 0;
+        uint64_t locateViews = 0;
+        uint64_t applyHapticFeedback = 0;
+        uint64_t acquireSwapchainImage = 0;
+        uint64_t pollEvent = 0;
+        uint64_t endFrameLayers = 0;
+    };
+
+    Script DefaultScript();
+    void SetScript(Script script);
+
+    // returns the counts since the last reset, lastFrame only contains the calls made between the last two xrEndFrame calls
+    CallCounts GetCallCounts();
+    CallCounts GetLastFrameCallCounts();
+    void ResetCallCounts();
+
+    XrTime GetRuntimeTime();
+    bool IsActive();
+
+    // the runtime's functions, for when the mock gets called without going through the OpenXR loader
+    XrResult GetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function);
+}
@@ -1,6 +1,7 @@
 #include "renderer.h"
 #include "instance.h"
 #include "texture.h"
+#include "input_sampler.h"
 #include "utils/d3d12_utils.h"
 
 
@@ -53,16 +54,14 @@ void RND_Renderer::StartFrame() {
     checkXRResult(xrBeginFrame(m_session, &beginFrameInfo), "Couldn't begin OpenXR frame!");
 
     VRManager::instance().D3D12->StartFrame();
-    VRManager::instance().XR->UpdateSpaces(m_frameState.predictedDisplayTime);
-    this->UpdateViews(m_frameState.predictedDisplayTime);
-
-    // todo: update this as late as possible
+    VRManager::instance().XR->OnFrameStart();
+    this->LocateFrameViews(m_frameState.predictedDisplayTime);
 
     // todo: should we really not update actions if the camera is middle pose is not available?
     auto headsetRotation = VRManager::instance().XR->GetRenderer()->GetMiddlePose();
     if (headsetRotation.has_value()) {
-        // todo: update this as late as possible
-        VRManager::instance().XR->UpdateActions(m_frameState.predictedDisplayTime, headsetRotation.value(), VRManager::instance().Hooks->IsShowingMenu());
+        // the game's thread samples them again right before it reads the VPAD
+        InputSampler::SampleOnFrameStart(m_frameState.predictedDisplayTime, VRManager::instance().Hooks->IsShowingMenu());
     }
 }
 
@@ -144,10 +143,12 @@ void RND_Renderer::EndFrame() {
     frameEndInfo.layers = compositionLayers.data();
 
     if (s_endFrameCount % 500 == 0) {
-        Log::print<INTEROP>("EndFrame #{}: frameIdx={}, layers={}, 3D={}, 2D={}",
+        Log::print<INTEROP>("EndFrame #{}: frameIdx={}, layers={}, 3D={}, 2D={}, locateCalls={}{}",
             s_endFrameCount, frameIdx, compositionLayers.size(),
             (frameIdx != -1 && m_renderFrames[frameIdx].presented3D) ? "yes" : "no",
-            m_presented2DLastFrame ? "yes" : "no");
+            m_presented2DLastFrame ? "yes" : "no",
+            VRManager::instance().XR->GetLastFrameLocateCalls(),
+            VRManager::instance().XR->SupportsBatchedLocateSpaces() ? " (batched)" : "");
     }
 
     XrResult xrResult = xrEndFrame(m_session, &frameEndInfo);
@@ -236,14 +237,67 @@ std::optional<std::array<XrView, 2>> RND_Renderer::UpdateViews(XrTime predictedD
     viewLocateInfo.space = VRManager::instance().XR->m_stageSpace; // locate the rendering views relative to the room, not the headset center
     XrViewState viewState = { XR_TYPE_VIEW_STATE };
     uint32_t viewCount = (uint32_t)newViews.size();
+    ++VRManager::instance().XR->m_frameLocateCalls;
     checkXRResult(xrLocateViews(VRManager::instance().XR->m_session, &viewLocateInfo, &viewState, viewCount, &viewCount, newViews.data()), "Failed to get view information!");
     if ((viewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT) == 0)
         return std::nullopt; // what should occur when the orientation is invalid? keep rendering using old values?
 
+    const XrTime locatedAt = VRManager::instance().XR->GetRuntimeTimeNow().value_or(0);
+    std::scoped_lock lock(m_latchMutex);
     m_currViews = newViews;
+    m_viewsLocatedAt = locatedAt;
     return m_currViews;
 }
 
+void RND_Renderer::LocateFrameViews(XrTime predictedDisplayTime) {
+    this->UpdateViews(predictedDisplayTime);
+    {
+        std::scoped_lock lock(m_latchMutex);
+        ++m_framesSinceLatch;
+    }
+    m_latchDisplayTime = predictedDisplayTime;
+}
+
+std::optional<std::array<XrView, 2>> RND_Renderer::LateLatchViews() {
+    // the frame's predicted display time stays the target, but if the game is already running late we can only predict from now on
+    const XrTime predictedDisplayTime = m_latchDisplayTime;
+    if (!m_isInitialized || predictedDisplayTime == 0)
+        return std::nullopt;
+
+    std::optional<XrTime> latchTime = VRManager::instance().XR->GetRuntimeTimeNow();
+    const XrTime displayTime = latchTime.has_value() ? std::max(predictedDisplayTime, latchTime.value()) : predictedDisplayTime;
+
+    std::array newViews = { XrView{ XR_TYPE_VIEW }, XrView{ XR_TYPE_VIEW } };
+    XrViewLocateInfo viewLocateInfo = { XR_TYPE_VIEW_LOCATE_INFO };
+    viewLocateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    viewLocateInfo.displayTime = displayTime;
+    viewLocateInfo.space = VRManager::instance().XR->m_stageSpace;
+    XrViewState viewState = { XR_TYPE_VIEW_STATE };
+    uint32_t viewCount = (uint32_t)newViews.size();
+    ++VRManager::instance().XR->m_frameLocateCalls;
+    if (XR_FAILED(xrLocateViews(VRManager::instance().XR->m_session, &viewLocateInfo, &viewState, viewCount, &viewCount, newViews.data())))
+        return std::nullopt;
+    if ((viewState.viewStateFlags & XR_VIEW_STATE_ORIENTATION_VALID_BIT) == 0)
+        return std::nullopt;
+
+    std::scoped_lock lock(m_latchMutex);
+    m_currViews = newViews;
+    m_latchedViews = newViews;
+    // capped so that a latch after an event that skipped the camera hooks doesn't keep the next latch around for long
+    m_framesBetweenLatches = std::clamp(m_framesSinceLatch, 1u, 6u);
+    m_framesSinceLatch = 0;
+    ++m_latchCount;
+
+    if (latchTime.has_value() && m_viewsLocatedAt != 0) {
+        m_lastLatchGainMs = (double)(latchTime.value() - m_viewsLocatedAt) / 1e6;
+        m_lastLatchPredictionMs = (double)(displayTime - latchTime.value()) / 1e6;
+        if (m_latchCount % 500 == 0) {
+            Log::print<INTEROP>("LateLatchViews #{}: sampled {:.2f} ms after StartFrame, predicted {:.2f} ms ahead (display time {})", m_latchCount, m_lastLatchGainMs, m_lastLatchPredictionMs, displayTime);
+        }
+    }
+    return m_latchedViews;
+}
+
 void RND_Renderer::Layer3D::StartRendering() {
     // checkAssert((this->m_textures[OpenXR::EyeSide::LEFT] == nullptr && this->m_textures[OpenXR::EyeSide::RIGHT] == nullptr) || (this->m_textures[OpenXR::EyeSide::LEFT] != nullptr && this->m_textures[OpenXR::EyeSide::RIGHT] != nullptr), "Both textures must be either null or not null");
     // checkAssert((this->m_depthTextures[OpenXR::EyeSide::LEFT] == nullptr && this->m_depthTextures[OpenXR::EyeSide::RIGHT] == nullptr) || (this->m_depthTextures[OpenXR::EyeSide::LEFT] != nullptr && this->m_depthTextures[OpenXR::EyeSide::RIGHT] != nullptr), "Both depth textures must be either null or not null");
@@ -53,55 +53,67 @@ public:
     void StartFrame();
     void EndFrame();
     std::optional<std::array<XrView, 2>> UpdateViews(XrTime predictedDisplayTime);
+    // re-locates the views right before the game consumes them, the latched views are the ones submitted to the compositor
+    std::optional<std::array<XrView, 2>> LateLatchViews();
     
     std::optional<std::array<XrView, 2>> GetPoses(long frameIdx = -1) const { 
-        if (frameIdx != -1 && m_renderFrames[frameIdx].views.has_value()) return m_renderFrames[frameIdx].views;
-        return m_currViews; 
+        return GetViews(frameIdx);
     }
     
     std::optional<XrFovf> GetFOV(OpenXR::EyeSide side, long frameIdx = -1) const { 
-        const auto& views = (frameIdx != -1 && m_renderFrames[frameIdx].views.has_value()) ? m_renderFrames[frameIdx].views : m_currViews;
-        return views.transform([side](auto& views) { return views[side].fov; }); 
+        return GetViews(frameIdx).transform([side](auto& views) { return views[side].fov; }); 
     }
     
     std::optional<XrPosef> GetPose(OpenXR::EyeSide side, long frameIdx = -1) const { 
-        const auto& views = (frameIdx != -1 && m_renderFrames[frameIdx].views.has_value()) ? m_renderFrames[frameIdx].views : m_currViews;
-        return views.transform([side](auto& views) { return views[side].pose; }); 
+        return GetViews(frameIdx).transform([side](auto& views) { return views[side].pose; }); 
     }
     
     std::optional<glm::fmat4> GetPoseAsMatrix(OpenXR::EyeSide side, long frameIdx = -1) const {
-        const auto& views = (frameIdx != -1 && m_renderFrames[frameIdx].views.has_value()) ? m_renderFrames[frameIdx].views : m_currViews;
-        return views.transform([side](auto& views) {
+        return GetViews(frameIdx).transform([side](auto& views) {
             const XrPosef& pose = views[side].pose;
             return ToMat4(ToGLM(pose.position), ToGLM(pose.orientation));
         });
     };
     
     std::optional<glm::fmat4> GetMiddlePose(long frameIdx = -1) const {
-        const auto& views = (frameIdx != -1 && m_renderFrames[frameIdx].views.has_value()) ? m_renderFrames[frameIdx].views : m_currViews;
-        if (!views.has_value()) return std::nullopt;
-        const XrPosef& leftPose = views->at(OpenXR::EyeSide::LEFT).pose;
-        const XrPosef& rightPose = views->at(OpenXR::EyeSide::RIGHT).pose;
+        return GetViews(frameIdx).transform([](auto& views) { return GetMiddlePose(views); });
+    };
+
+    static glm::fmat4 GetMiddlePose(const std::array<XrView, 2>& views) {
+        const XrPosef& leftPose = views[OpenXR::EyeSide::LEFT].pose;
+        const XrPosef& rightPose = views[OpenXR::EyeSide::RIGHT].pose;
         glm::fvec3 middlePos = (ToGLM(leftPose.position) + ToGLM(rightPose.position)) * 0.5f;
         glm::quat middleOri = glm::slerp(ToGLM(leftPose.orientation), ToGLM(rightPose.orientation), 0.5f);
 
         return ToMat4(middlePos, middleOri);
-    };
+    }
+
+    // the views that the game renders the current frame with, the camera hooks of both eyes use the same snapshot
+    std::optional<std::array<XrView, 2>> GetViewsUsedByGame() const {
+        std::scoped_lock lock(m_latchMutex);
+        // a latch is trusted for as many XR frames as the game took between its last two latches, and one more
+        // the camera hooks don't run during some events, after which the views of the XR thread are used again
+        if (m_latchedViews.has_value() && m_framesSinceLatch <= m_framesBetweenLatches + 1) return m_latchedViews;
+        return m_currViews;
+    }
 
     double GetLastFrameWorkTimeMs() const { return m_lastFrameWorkTimeMs; }
     double GetLastWaitTimeMs() const { return m_lastWaitTimeMs; }
     double GetLastFrameTimeMs() const { return m_lastFrameTimeMs; }
     double GetPredictedDisplayPeriodMs() const { return m_predictedDisplayPeriodMs; }
     double GetLastOverheadMs() const { return m_lastOverheadMs; }
+    // how much later the latched pose was sampled compared to StartFrame, and how far ahead it still had to be predicted
+    double GetLastLatchGainMs() const { return m_lastLatchGainMs; }
+    double GetLastLatchPredictionMs() const { return m_lastLatchPredictionMs; }
 
     void On3DColorCopied(OpenXR::EyeSide side, long frameIdx) {
         m_renderFrames[frameIdx].copiedColor[side] = true;
-        if (!m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = m_currViews;
+        if (!m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = GetViewsUsedByGame();
     }
 
     void On3DDepthCopied(OpenXR::EyeSide side, long frameIdx) {
         m_renderFrames[frameIdx].copiedDepth[side] = true;
-        if (!m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = m_currViews;
+        if (!m_renderFrames[frameIdx].views.has_value()) m_renderFrames[frameIdx].views = GetViewsUsedByGame();
     }
 
     void On2DCopied(long frameIdx) {
@@ -220,6 +232,15 @@ public:
     }
 
 protected:
+    // the game's thread reads the views of the eyes from several hooks, which have to agree with each other and with the submitted frame
+    std::optional<std::array<XrView, 2>> GetViews(long frameIdx) const {
+        if (frameIdx != -1 && m_renderFrames[frameIdx].views.has_value()) return m_renderFrames[frameIdx].views;
+        return GetViewsUsedByGame();
+    }
+
+    // locates the views of the frame that xrWaitFrame just returned, on the XR thread
+    void LocateFrameViews(XrTime predictedDisplayTime);
+
     XrSession m_session;
     XrFrameState m_frameState = { XR_TYPE_FRAME_STATE };
     std::optional<std::array<XrView, 2>> m_currViews;
@@ -241,4 +262,16 @@ protected:
     double m_lastFrameTimeMs = 0.0;
     double m_predictedDisplayPeriodMs = 0.0;
     double m_lastOverheadMs = 0.0;
+
+    // late latching of the views, m_currViews is also guarded by the mutex since the game's thread latches it
+    mutable std::mutex m_latchMutex;
+    // m_frameState belongs to the XR thread, this is the predicted display time of its frame for the game's thread
+    std::atomic<XrTime> m_latchDisplayTime = 0;
+    std::optional<std::array<XrView, 2>> m_latchedViews;
+    uint32_t m_framesSinceLatch = 0;
+    uint32_t m_framesBetweenLatches = 1;
+    uint64_t m_latchCount = 0;
+    XrTime m_viewsLocatedAt = 0;
+    double m_lastLatchGainMs = 0.0;
+    double m_lastLatchPredictionMs = 0.0;
 };
@@ -29,6 +29,9 @@ RND_Vulkan::RND_Vulkan(VkInstance vkInstance, VkPhysicalDevice vkPhysDevice, VkD
     }
 }
 
+RND_Vulkan::RND_Vulkan(VkDevice vkDevice, const vkroots::VkDeviceDispatch* deviceDispatch): m_instance(VK_NULL_HANDLE), m_physicalDevice(VK_NULL_HANDLE), m_device(vkDevice), m_instanceDispatch(nullptr), m_physicalDeviceDispatch(nullptr), m_deviceDispatch(deviceDispatch) {
+}
+
 RND_Vulkan::~RND_Vulkan() {
 }
 
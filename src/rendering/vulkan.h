@@ -6,6 +6,8 @@
 class RND_Vulkan {
 public:
     RND_Vulkan(VkInstance vkInstance, VkPhysicalDevice vkPhysDevice, VkDevice vkDevice);
+    // only has a device, for replaying the layer's calls against a stub device that has no instance or physical device behind it
+    RND_Vulkan(VkDevice vkDevice, const vkroots::VkDeviceDispatch* deviceDispatch);
     ~RND_Vulkan();
 
     uint32_t FindMemoryType(uint32_t memoryTypeBitsRequirement, VkMemoryPropertyFlags requirementsMask);
@@ -1,5 +1,6 @@
 #include "hooking/cemu_hooks.h"
 #include "hooking/entity_debugger.h"
+#include "hooking/input_bindings.h"
 #include "instance.h"
 #include "utils/vulkan_utils.h"
 #include "vulkan.h"
@@ -852,6 +853,11 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
                     ImGui::PushStyleColor(ImGuiCol_Text, ImGui::GetStyleColorVec4(ImGuiCol_HeaderActive));
                     ImGui::Text("Input");
                     ImGui::PopStyleColor();
+                    DrawSettingRow("Input Bindings (BetterVR_bindings.txt)", [&]() {
+                        if (ImGui::Button("Reload##InputBindings")) {
+                            InputBindings::RequestReload();
+                        }
+                    });
                     if (cameraMode == 1) {
                         float deadzone = settings.stickDeadzone;
                         DrawSettingRow("Thumbstick Deadzone", [&]() {
@@ -912,6 +918,26 @@ void RND_Renderer::ImGuiOverlay::DrawHelpMenu() {
                             }
                         });
 
+                        bool shareShadows = settings.ShareShadowCascadesBetweenEyes();
+                        DrawSettingRow("Render Shadows Once For Both Eyes", [&]() {
+                            if (ImGui::Checkbox("##ShareShadowCascades", &shareShadows)) {
+                                settings.shareShadowCascades = shareShadows ? 1 : 0;
+                                changed = true;
+                            }
+                        });
+
+                        int shadowInterval = (int)settings.GetShadowUpdateInterval() - 1;
+                        const char* shadowIntervalOptions[] = { "Every Frame", "Every 2nd Frame", "Every 3rd Frame", "Every 4th Frame" };
+                        DrawSettingRow("Shadow Update Rate", [&]() {
+                            if (ImGui::Combo("##ShadowUpdateInterval", &shadowInterval, shadowIntervalOptions, 4)) {
+                                settings.shadowUpdateInterval = shadowInterval + 1;
+                                changed = true;
+                            }
+                            if (ImGui::IsItemHovered()) {
+                                ImGui::SetTooltip("Frames that skip the update show the shadow map from the last update, which assumes that it keeps its contents between frames.\nIf shadows flicker or disappear, set this back to Every Frame.");
+                            }
+                        });
+
                         if (VRManager::instance().XR->m_capabilities.isOculusLinkRuntime) {
                             int angularFix = (int)settings.buggyAngularVelocity.load();
                             const char* angularOptions[] = { "Auto (Oculus Link)", "Forced On", "Forced Off" };
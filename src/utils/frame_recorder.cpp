@@ -0,0 +1,148 @@
+#include "frame_recorder.h"
+
+FrameRecorder* FrameRecorder::Get() {
+    // the recorder lives until the process exits, every present flushes the file so nothing gets lost when Cemu is closed
+    static FrameRecorder* s_recorder = []() -> FrameRecorder* {
+        const char* path = std::getenv("BETTERVR_RECORD_FRAMES");
+        if (path == nullptr || path[0] == '\0') {
+            return nullptr;
+        }
+
+        uint32_t frameInterval = 1;
+        if (const char* interval = std::getenv("BETTERVR_RECORD_FRAMES_INTERVAL")) {
+            frameInterval = std::max(1ul, std::strtoul(interval, nullptr, 10));
+        }
+
+        Log::print<INFO>("Recording intercepted Vulkan calls to {} (every {} frame(s))", path, frameInterval);
+        return new FrameRecorder(path, frameInterval);
+    }();
+    return s_recorder;
+}
+
+FrameRecorder::FrameRecorder(const std::filesystem::path& path, uint32_t frameInterval): m_frameInterval(frameInterval), m_startTime(std::chrono::steady_clock::now()) {
+    m_file.open(path, std::ios::out | std::ios::binary | std::ios::trunc);
+    if (!m_file.is_open()) {
+        Log::print<ERROR>("Failed to open {} for recording frames!", path.string());
+        return;
+    }
+
+    FileHeader header = {};
+    header.frameInterval = m_frameInterval;
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+}
+
+FrameRecorder::~FrameRecorder() {
+    if (m_file.is_open()) {
+        m_file.close();
+    }
+}
+
+template <typename T>
+void FrameRecorder::WriteEvent(EventType type, const T& payload) {
+    static_assert(std::is_trivially_copyable_v<T>, "Recorded events need to be trivially copyable");
+    if (!m_file.is_open()) {
+        return;
+    }
+
+    EventHeader header = {};
+    header.type = type;
+    header.frameIdx = m_frameIdx;
+    header.timestampNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_startTime).count();
+    m_file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    m_file.write(reinterpret_cast<const char*>(&payload), sizeof(payload));
+}
+
+// image creation and destruction is always recorded since replaying any later frame depends on which images exist
+void FrameRecorder::RecordCreateImage(const VkImageCreateInfo* pCreateInfo, VkImage image, VkResult result) {
+    CreateImageEvent event = {};
+    event.image = (uint64_t)image;
+    event.format = pCreateInfo->format;
+    event.extent = pCreateInfo->extent;
+    event.usage = pCreateInfo->usage;
+    event.mipLevels = pCreateInfo->mipLevels;
+    event.arrayLayers = pCreateInfo->arrayLayers;
+    event.result = result;
+
+    std::lock_guard lk(m_mutex);
+    WriteEvent(EventType::CreateImage, event);
+}
+
+void FrameRecorder::RecordDestroyImage(VkImage image) {
+    DestroyImageEvent event = {};
+    event.image = (uint64_t)image;
+
+    std::lock_guard lk(m_mutex);
+    WriteEvent(EventType::DestroyImage, event);
+}
+
+void FrameRecorder::RecordClearColorImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, const VkClearColorValue* pColor, uint32_t rangeCount, const VkImageSubresourceRange* pRanges) {
+    std::lock_guard lk(m_mutex);
+    if (!IsSampledFrame()) {
+        return;
+    }
+
+    ClearColorImageEvent event = {};
+    event.commandBuffer = (uint64_t)commandBuffer;
+    event.image = (uint64_t)image;
+    event.imageLayout = imageLayout;
+    event.color = *pColor;
+    event.rangeCount = rangeCount;
+    if (rangeCount > 0) {
+        event.firstRange = pRanges[0];
+    }
+    WriteEvent(EventType::ClearColorImage, event);
+}
+
+void FrameRecorder::RecordClearDepthStencilImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, const VkClearDepthStencilValue* pDepthStencil, uint32_t rangeCount, const VkImageSubresourceRange* pRanges) {
+    std::lock_guard lk(m_mutex);
+    if (!IsSampledFrame()) {
+        return;
+    }
+
+    ClearDepthStencilImageEvent event = {};
+    event.commandBuffer = (uint64_t)commandBuffer;
+    event.image = (uint64_t)image;
+    event.imageLayout = imageLayout;
+    event.depthStencil = *pDepthStencil;
+    event.rangeCount = rangeCount;
+    if (rangeCount > 0) {
+        event.firstRange = pRanges[0];
+    }
+    WriteEvent(EventType::ClearDepthStencilImage, event);
+}
+
+void FrameRecorder::RecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkResult result) {
+    std::lock_guard lk(m_mutex);
+    if (!IsSampledFrame()) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < submitCount; i++) {
+        QueueSubmitEvent event = {};
+        event.queue = (uint64_t)queue;
+        event.submitIdx = i;
+        event.submitCount = submitCount;
+        event.waitSemaphoreCount = pSubmits[i].waitSemaphoreCount;
+        event.signalSemaphoreCount = pSubmits[i].signalSemaphoreCount;
+        event.commandBufferCount = std::min(pSubmits[i].commandBufferCount, MAX_RECORDED_COMMAND_BUFFERS);
+        for (uint32_t j = 0; j < event.commandBufferCount; j++) {
+            event.commandBuffers[j] = (uint64_t)pSubmits[i].pCommandBuffers[j];
+        }
+        event.result = result;
+        WriteEvent(EventType::QueueSubmit, event);
+    }
+}
+
+void FrameRecorder::RecordQueuePresent(VkQueue queue, const VkPresentInfoKHR* pPresentInfo, VkResult result) {
+    std::lock_guard lk(m_mutex);
+    if (IsSampledFrame()) {
+        QueuePresentEvent event = {};
+        event.queue = (uint64_t)queue;
+        event.swapchainCount = pPresentInfo->swapchainCount;
+        event.firstImageIndex = pPresentInfo->swapchainCount > 0 ? pPresentInfo->pImageIndices[0] : 0;
+        event.result = result;
+        WriteEvent(EventType::QueuePresent, event);
+        m_file.flush();
+    }
+    m_frameIdx++;
+}
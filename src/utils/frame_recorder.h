@@ -0,0 +1,107 @@
+#pragma once
+#include <filesystem>
+
+// Records the Vulkan calls intercepted by VRLayer so that they can be replayed later without Cemu, the game or a headset.
+// Recording is opt-in using BETTERVR_RECORD_FRAMES=<path>, and BETTERVR_RECORD_FRAMES_INTERVAL=<n> only keeps every n-th frame.
+class FrameRecorder {
+public:
+    enum class EventType : uint8_t {
+        CreateImage = 0,
+        DestroyImage = 1,
+        ClearColorImage = 2,
+        ClearDepthStencilImage = 3,
+        QueueSubmit = 4,
+        QueuePresent = 5,
+    };
+
+    struct FileHeader {
+        char magic[4] = { 'B', 'V', 'R', 'F' };
+        uint32_t version = 1;
+        uint32_t frameInterval = 1;
+        uint32_t reserved = 0;
+    };
+
+    // each event is stored as an EventHeader followed by exactly one of the payloads below
+    struct EventHeader {
+        EventType type;
+        uint8_t padding[3];
+        uint32_t frameIdx;
+        uint64_t timestampNs;
+    };
+
+    struct CreateImageEvent {
+        uint64_t image;
+        VkFormat format;
+        VkExtent3D extent;
+        VkImageUsageFlags usage;
+        uint32_t mipLevels;
+        uint32_t arrayLayers;
+        VkResult result;
+    };
+
+    struct DestroyImageEvent {
+        uint64_t image;
+    };
+
+    struct ClearColorImageEvent {
+        uint64_t commandBuffer;
+        uint64_t image;
+        VkImageLayout imageLayout;
+        VkClearColorValue color;
+        uint32_t rangeCount;
+        VkImageSubresourceRange firstRange;
+    };
+
+    struct ClearDepthStencilImageEvent {
+        uint64_t commandBuffer;
+        uint64_t image;
+        VkImageLayout imageLayout;
+        VkClearDepthStencilValue depthStencil;
+        uint32_t rangeCount;
+        VkImageSubresourceRange firstRange;
+    };
+
+    // only the first command buffers of each submit are stored, which is enough to match them against the copy operations
+    static constexpr uint32_t MAX_RECORDED_COMMAND_BUFFERS = 8;
+    struct QueueSubmitEvent {
+        uint64_t queue;
+        uint32_t submitIdx;
+        uint32_t submitCount;
+        uint32_t waitSemaphoreCount;
+        uint32_t signalSemaphoreCount;
+        uint32_t commandBufferCount;
+        std::array<uint64_t, MAX_RECORDED_COMMAND_BUFFERS> commandBuffers;
+        VkResult result;
+    };
+
+    struct QueuePresentEvent {
+        uint64_t queue;
+        uint32_t swapchainCount;
+        uint32_t firstImageIndex;
+        VkResult result;
+    };
+
+    static FrameRecorder* Get();
+
+    void RecordCreateImage(const VkImageCreateInfo* pCreateInfo, VkImage image, VkResult result);
+    void RecordDestroyImage(VkImage image);
+    void RecordClearColorImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, const VkClearColorValue* pColor, uint32_t rangeCount, const VkImageSubresourceRange* pRanges);
+    void RecordClearDepthStencilImage(VkCommandBuffer commandBuffer, VkImage image, VkImageLayout imageLayout, const VkClearDepthStencilValue* pDepthStencil, uint32_t rangeCount, const VkImageSubresourceRange* pRanges);
+    void RecordQueueSubmit(VkQueue queue, uint32_t submitCount, const VkSubmitInfo* pSubmits, VkResult result);
+    void RecordQueuePresent(VkQueue queue, const VkPresentInfoKHR* pPresentInfo, VkResult result);
+
+private:
+    FrameRecorder(const std::filesystem::path& path, uint32_t frameInterval);
+    ~FrameRecorder();
+
+    template <typename T>
+    void WriteEvent(EventType type, const T& payload);
+
+    bool IsSampledFrame() const { return m_frameIdx % m_frameInterval == 0; }
+
+    std::mutex m_mutex;
+    std::ofstream m_file;
+    uint32_t m_frameInterval = 1;
+    uint32_t m_frameIdx = 0;
+    std::chrono::steady_clock::time_point m_startTime;
+};
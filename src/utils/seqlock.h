@@ -0,0 +1,65 @@
+#pragma once
+
+// Publishes a struct that's shared between the XR thread and the game's hooks without the hidden lock of a large std::atomic<T>.
+// Writers are serialized and bump the sequence before and after copying the new value in. Readers never take a lock, they copy
+// the value (or just the field they need) and retry in the rare case that a writer was busy at the same time.
+template <typename T>
+class SeqLock {
+    static_assert(std::is_trivially_copyable_v<T>, "SeqLock can only publish trivially copyable types");
+
+public:
+    SeqLock() = default;
+    SeqLock(const T& value): m_value(value) {}
+    SeqLock(const SeqLock&) = delete;
+    SeqLock& operator=(const SeqLock&) = delete;
+
+    T load() const {
+        T result;
+        Read(&result, reinterpret_cast<const std::byte*>(&m_value), sizeof(T));
+        return result;
+    }
+
+    // only copies a single member, e.g. m_input.load(&OpenXR::InputState::shared) in hooks that run for every bone
+    template <typename M>
+    M load(M T::* member) const {
+        M result;
+        Read(&result, reinterpret_cast<const std::byte*>(&(m_value.*member)), sizeof(M));
+        return result;
+    }
+
+    void store(const T& value) {
+        while (m_writerLock.test_and_set(std::memory_order_acquire)) {
+            YieldProcessor();
+        }
+        const uint32_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(&m_value, &value, sizeof(T));
+        m_sequence.store(sequence + 2, std::memory_order_release);
+        m_writerLock.clear(std::memory_order_release);
+    }
+
+    // amount of times a reader had to retry because it raced a writer
+    uint64_t GetReadRetries() const { return m_readRetries.load(std::memory_order_relaxed); }
+
+private:
+    void Read(void* dst, const std::byte* src, size_t size) const {
+        while (true) {
+            const uint32_t before = m_sequence.load(std::memory_order_acquire);
+            if ((before & 1) == 0) {
+                std::memcpy(dst, src, size);
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_sequence.load(std::memory_order_relaxed) == before) {
+                    return;
+                }
+            }
+            m_readRetries.fetch_add(1, std::memory_order_relaxed);
+            YieldProcessor();
+        }
+    }
+
+    alignas(64) std::atomic_uint32_t m_sequence = 0;
+    std::atomic_flag m_writerLock;
+    mutable std::atomic_uint64_t m_readRetries = 0;
+    alignas(64) T m_value = {};
+};
@@ -0,0 +1,103 @@
+#include "tests.h"
+#include "hooking/actor_table.h"
+#include "hooking/cemu_hooks.h"
+
+namespace {
+    // the same read that ActorTable does when it adds an actor
+    const char* ReadActorName(uint32_t actorPtr) {
+        uint32_t actorNamePtr = CemuHooks::getMemory<BEType<uint32_t>>(actorPtr + offsetof(ActorWiiU, name) + offsetof(sead::FixedSafeString40, c_str)).getLE();
+        if (actorNamePtr == 0)
+            return nullptr;
+        return (const char*)CemuHooks::s_memoryBaseAddress + actorNamePtr;
+    }
+}
+
+// builds a fake actor list, renames churnPerWalk actors between each walk (like the game deleting and creating actors at the same address)
+// and walks it with the old clear-and-rebuild map and with ActorTable, returns the amount of walks where both disagree (which should always be zero)
+static uint64_t BenchmarkActorChurn(uint32_t actorCount, uint32_t walks, uint32_t churnPerWalk) {
+    if (actorCount < 3) {
+        Log::print<WARNING>("Actor churn benchmark needs at least 3 actors");
+        return 0;
+    }
+
+    std::vector<std::string> names = { "GameROMPlayer", "GameRomCamera" };
+    for (uint32_t i = 0; i < 62; ++i) {
+        names.emplace_back(std::format("{}_{:03}", (i % 3 == 0) ? "Enemy_Bokoblin" : (i % 3 == 1) ? "Weapon_Sword" : "Obj_Tree", i));
+    }
+
+    constexpr uint32_t firstActor = 0x1000;
+    constexpr uint32_t nameStride = 0x40;
+    const uint32_t firstName = firstActor + actorCount * (uint32_t)sizeof(ActorWiiU);
+    std::vector<std::byte> fakeMemory(firstName + names.size() * nameStride);
+    for (size_t i = 0; i < names.size(); ++i) {
+        memcpy(fakeMemory.data() + firstName + i * nameStride, names[i].c_str(), names[i].size() + 1);
+    }
+    CemuHooks::s_memoryBaseAddress = (uint64_t)fakeMemory.data();
+
+    auto actorAddress = [&](uint32_t i) { return firstActor + i * (uint32_t)sizeof(ActorWiiU); };
+    auto setActorName = [&](uint32_t i, size_t nameIdx) {
+        CemuHooks::setMemory<uint32_t>(actorAddress(i) + offsetof(ActorWiiU, name) + offsetof(sead::FixedSafeString40, c_str), firstName + (uint32_t)nameIdx * nameStride);
+    };
+    for (uint32_t i = 0; i < actorCount; ++i) {
+        setActorName(i, i < 2 ? i : 2 + i % (names.size() - 2));
+    }
+
+    std::unordered_map<uint32_t, std::pair<std::string, uint32_t>> legacyActors;
+    uint32_t legacyPlayer = 0;
+    ActorTable table;
+    uint32_t tablePlayer = 0;
+
+    double legacyNs = 0.0;
+    double tableNs = 0.0;
+    uint64_t mismatches = 0;
+    uint32_t churned = 0;
+    for (uint32_t walk = 0; walk < walks; ++walk) {
+        for (uint32_t i = 0; walk > 0 && i < churnPerWalk; ++i) {
+            uint32_t actorIdx = 2 + (churned++ * 7919) % (actorCount - 2);
+            setActorName(actorIdx, 2 + (actorIdx + walk) % (names.size() - 2));
+            table.OnActorCreated(actorAddress(actorIdx));
+        }
+
+        // how hook_UpdateActorList used to rebuild the list
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < actorCount; ++i) {
+            if (i == 0) {
+                legacyActors.clear();
+            }
+            const char* actorName = ReadActorName(actorAddress(i));
+            if (actorName == nullptr)
+                continue;
+            if (actorName[0] != '\0') {
+                legacyActors.emplace(actorAddress(i) + stringToHash(actorName), std::make_pair(actorName, actorAddress(i)));
+            }
+            if (strcmp(actorName, "GameROMPlayer") == 0) {
+                legacyPlayer = actorAddress(i);
+            }
+        }
+        legacyNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < actorCount; ++i) {
+            const ActorTable::Actor* actor = table.OnActorVisited(i, actorCount, actorAddress(i));
+            if (actor != nullptr && actor->role == ActorTable::Role::PLAYER) {
+                tablePlayer = actor->address;
+            }
+        }
+        tableNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        bool matches = legacyActors.size() == table.GetActorCount() && legacyPlayer == tablePlayer;
+        table.ForEach([&](ActorTable::Handle, const ActorTable::Actor& actor) {
+            auto it = legacyActors.find(actor.id);
+            matches = matches && it != legacyActors.end() && it->second.first == *actor.name && it->second.second == actor.address;
+        });
+        mismatches += matches ? 0 : 1;
+    }
+
+    CemuHooks::s_memoryBaseAddress = 0;
+
+    double visits = (double)walks * (double)actorCount;
+    Log::print<INFO>("Actor churn benchmark ({} actors x {} walks, {} churned per walk): rebuild = {:.1f} ns/actor, table = {:.1f} ns/actor, {} interned names, {} mismatches", actorCount, walks, churnPerWalk, legacyNs / visits, tableNs / visits, table.GetInternedNameCount(), mismatches);
+    return mismatches;
+}
+
+BETTERVR_TEST(ActorChurn, []() { return BenchmarkActorChurn(2000, 200, 20); });
@@ -0,0 +1,236 @@
+#include "tests.h"
+#include "hooking/culling.h"
+#include <random>
+
+namespace {
+    struct SyntheticEye {
+        glm::fvec3 pos;
+        glm::fquat rot;
+        XrFovf fov;
+    };
+
+    glm::mat4 BuildViewProjection(const SyntheticEye& eye, float nearClip, float farClip) {
+        glm::mat4 view = glm::inverse(glm::translate(glm::mat4(1.0f), eye.pos) * glm::mat4_cast(eye.rot));
+        // same -1 to 1 depth range as the projection the camera hooks use
+        glm::mat4 proj = glm::frustumRH_NO(tanf(eye.fov.angleLeft) * nearClip, tanf(eye.fov.angleRight) * nearClip, tanf(eye.fov.angleDown) * nearClip, tanf(eye.fov.angleUp) * nearClip, nearClip, farClip);
+        return proj * view;
+    }
+
+    StereoFrustum BuildStereoFrustum(const std::array<SyntheticEye, 2>& eyes, float nearClip, float farClip) {
+        StereoFrustum frustum;
+        for (const SyntheticEye& eye : eyes) {
+            frustum.addEye(BuildViewProjection(eye, nearClip, farClip));
+        }
+        frustum.finalize();
+        return frustum;
+    }
+}
+
+// compares the combined stereo volume against the per-eye tests for random eye setups, including canted displays and different FOVs per eye,
+// and returns the amount of spheres that the per-eye tests accept but StereoFrustum::checkSphere rejected (which should always be zero)
+static uint64_t ValidateStereoCulling(uint32_t setups, uint32_t spheresPerSetup) {
+    std::mt19937 rng(5678);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    auto range = [&](float min, float max) { return min + (max - min) * unit(rng); };
+
+    uint64_t falseNegatives = 0;
+    uint64_t refinedSpheres = 0;
+    uint64_t extraVisible = 0;
+    for (uint32_t setup = 0; setup < setups; ++setup) {
+        glm::fquat headRot = glm::angleAxis(range(-3.14f, 3.14f), glm::fvec3(0, 1, 0)) * glm::angleAxis(range(-1.0f, 1.0f), glm::fvec3(1, 0, 0));
+        glm::fvec3 headPos = glm::fvec3(range(-100.0f, 100.0f), range(0.0f, 50.0f), range(-100.0f, 100.0f));
+        float ipd = range(0.05f, 0.075f);
+        float cant = range(0.0f, 0.2f);
+        std::array<SyntheticEye, 2> eyes = {
+            SyntheticEye{ headPos + headRot * glm::fvec3(-ipd * 0.5f, 0, 0), headRot * glm::angleAxis(cant, glm::fvec3(0, 1, 0)), XrFovf{ -range(0.7f, 1.0f), range(0.6f, 0.9f), range(0.6f, 0.9f), -range(0.7f, 1.0f) } },
+            SyntheticEye{ headPos + headRot * glm::fvec3(ipd * 0.5f, 0, 0), headRot * glm::angleAxis(-cant, glm::fvec3(0, 1, 0)), XrFovf{ -range(0.6f, 0.9f), range(0.7f, 1.0f), range(0.6f, 0.9f), -range(0.7f, 1.0f) } }
+        };
+        float nearClip = range(0.05f, 2.0f);
+        float farClip = range(50.0f, 25000.0f);
+        StereoFrustum frustum = BuildStereoFrustum(eyes, nearClip, farClip);
+
+        for (uint32_t i = 0; i < spheresPerSetup; ++i) {
+            // spread the spheres around the view volume, most of them close to the camera where the eyes differ the most
+            float distance = std::pow(unit(rng), 3.0f) * farClip * 1.2f;
+            glm::fvec3 direction = glm::normalize(glm::fvec3(range(-1.0f, 1.0f), range(-1.0f, 1.0f), range(-1.0f, 1.0f)));
+            glm::fvec3 center = headPos + direction * distance;
+            float radius = std::pow(unit(rng), 2.0f) * std::max(0.1f, distance * 0.5f);
+
+            bool reference = frustum.checkSphereForEachEye(center, radius);
+            bool combined = frustum.checkSphere(center, radius);
+            bool combinedWithoutRefinement = frustum.checkSphere(center, radius, false);
+            if (reference && (!combined || !combinedWithoutRefinement)) {
+                ++falseNegatives;
+            }
+            if (combined && !reference) {
+                ++extraVisible;
+            }
+            if (combinedWithoutRefinement && !combined) {
+                ++refinedSpheres;
+            }
+        }
+    }
+
+    Log::print<INFO>("Stereo culling validation ({} setups x {} spheres): {} false negatives, {} conservative extra visible, {} rejected by the per-eye refinement", setups, spheresPerSetup, falseNegatives, extraVisible, refinedSpheres);
+    return falseNegatives;
+}
+
+// measures how many of the spheres that pass the combined volume still fall through to the per-eye tests, with an edge band per plane
+// and with the single band (the largest one over all planes) that StereoFrustum used to have, along with the time per sphere for both.
+// returns the amount of spheres that the per-eye tests accept but the per-plane bands rejected (which should always be zero)
+static uint64_t BenchmarkEdgeBands(uint32_t setups, uint32_t spheresPerSetup) {
+    std::mt19937 rng(2468);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    auto range = [&](float min, float max) { return min + (max - min) * unit(rng); };
+
+    // same plane tests as StereoFrustum::checkSphere, 0 = rejected, 1 = accepted by the combined volume alone, 2 = falls through to the eyes
+    auto classify = [](const StereoFrustum& frustum, const glm::vec3& center, float radius) {
+        bool nearEdge = false;
+        for (int i = 0; i < 6; ++i) {
+            float dist = glm::dot(glm::vec3(frustum.combined.planes[i]), center) + frustum.combined.planes[i].w;
+            float expandedRadius = radius * frustum.combinedRadiusScale[i];
+            if (dist < -expandedRadius) {
+                return 0;
+            }
+            nearEdge |= dist < expandedRadius + frustum.edgeBands[i];
+        }
+        return nearEdge ? 2 : 1;
+    };
+
+    uint64_t falseNegatives = 0;
+    uint64_t passedCombined = 0;
+    std::array<uint64_t, 2> fallThroughs = {};
+    std::array<uint64_t, 2> visibleCounts = {};
+    std::array<double, 2> seconds = {};
+    std::vector<glm::vec4> spheres(spheresPerSetup);
+    for (uint32_t setup = 0; setup < setups; ++setup) {
+        glm::fquat headRot = glm::angleAxis(range(-3.14f, 3.14f), glm::fvec3(0, 1, 0)) * glm::angleAxis(range(-1.0f, 1.0f), glm::fvec3(1, 0, 0));
+        glm::fvec3 headPos = glm::fvec3(range(-100.0f, 100.0f), range(0.0f, 50.0f), range(-100.0f, 100.0f));
+        float ipd = range(0.05f, 0.075f);
+        float cant = setup % 2 == 0 ? 0.0f : range(0.0f, 0.2f);
+        std::array<SyntheticEye, 2> eyes = {
+            SyntheticEye{ headPos + headRot * glm::fvec3(-ipd * 0.5f, 0, 0), headRot * glm::angleAxis(cant, glm::fvec3(0, 1, 0)), XrFovf{ -range(0.7f, 1.0f), range(0.6f, 0.9f), range(0.6f, 0.9f), -range(0.7f, 1.0f) } },
+            SyntheticEye{ headPos + headRot * glm::fvec3(ipd * 0.5f, 0, 0), headRot * glm::angleAxis(-cant, glm::fvec3(0, 1, 0)), XrFovf{ -range(0.6f, 0.9f), range(0.7f, 1.0f), range(0.6f, 0.9f), -range(0.7f, 1.0f) } }
+        };
+        float farClip = range(50.0f, 25000.0f);
+        std::array<StereoFrustum, 2> frustums = { BuildStereoFrustum(eyes, range(0.05f, 2.0f), farClip) };
+        frustums[1] = frustums[0];
+        frustums[1].edgeBands.fill(*std::ranges::max_element(frustums[0].edgeBands));
+
+        for (glm::vec4& sphere : spheres) {
+            float distance = std::pow(unit(rng), 3.0f) * farClip * 1.2f;
+            glm::fvec3 direction = glm::normalize(glm::fvec3(range(-1.0f, 1.0f), range(-1.0f, 1.0f), range(-1.0f, 1.0f)));
+            sphere = glm::vec4(headPos + direction * distance, std::pow(unit(rng), 2.0f) * std::max(0.1f, distance * 0.5f));
+        }
+
+        for (size_t band = 0; band < frustums.size(); ++band) {
+            uint64_t visible = 0;
+            auto start = std::chrono::high_resolution_clock::now();
+            for (const glm::vec4& sphere : spheres) {
+                visible += frustums[band].checkSphere(glm::vec3(sphere), sphere.w) ? 1 : 0;
+            }
+            seconds[band] += std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+            visibleCounts[band] += visible;
+        }
+
+        for (const glm::vec4& sphere : spheres) {
+            const int perPlane = classify(frustums[0], glm::vec3(sphere), sphere.w);
+            passedCombined += perPlane != 0 ? 1 : 0;
+            fallThroughs[0] += perPlane == 2 ? 1 : 0;
+            fallThroughs[1] += classify(frustums[1], glm::vec3(sphere), sphere.w) == 2 ? 1 : 0;
+            if (frustums[0].checkSphereForEachEye(glm::vec3(sphere), sphere.w) && !frustums[0].checkSphere(glm::vec3(sphere), sphere.w)) {
+                ++falseNegatives;
+            }
+        }
+    }
+
+    const double spheresTested = (double)setups * (double)spheresPerSetup;
+    auto rate = [&](uint64_t count) { return passedCombined == 0 ? 0.0 : 100.0 * (double)count / (double)passedCombined; };
+    Log::print<INFO>("Edge band benchmark ({} setups x {} spheres, {} passed the combined volume): per-plane bands = {:.1f}% fall through, {:.1f} ns/sphere, {} visible; single band = {:.1f}% fall through, {:.1f} ns/sphere, {} visible; {} false negatives",
+        setups, spheresPerSetup, passedCombined, rate(fallThroughs[0]), seconds[0] * 1e9 / spheresTested, visibleCounts[0], rate(fallThroughs[1]), seconds[1] * 1e9 / spheresTested, visibleCounts[1], falseNegatives);
+    return falseNegatives;
+}
+
+// replays a frame's worth of visibility queries, once rebuilding the frustums for every query like the hook used to and once through StereoCullingCache
+static void BenchmarkCulling(uint32_t queriesPerFrame, uint32_t frames) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> radius(0.1f, 8.0f);
+
+    std::vector<glm::vec4> spheres(queriesPerFrame);
+    for (glm::vec4& sphere : spheres) {
+        sphere = glm::vec4(position(rng), position(rng) * 0.2f, position(rng), radius(rng));
+    }
+
+    // the game mostly alternates between a handful of clip plane pairs
+    constexpr std::array<std::pair<float, float>, 3> clipPlanes = { std::pair{ 0.1f, 25000.0f }, std::pair{ 0.1f, 600.0f }, std::pair{ 1.0f, 3000.0f } };
+
+    auto runFrames = [&](auto&& checkSphere) -> std::pair<double, uint64_t> {
+        uint64_t visible = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t frame = 0; frame < frames; ++frame) {
+            float yaw = glm::radians((float)frame);
+            std::array<SyntheticEye, 2> eyes = {
+                SyntheticEye{ glm::fvec3(-0.032f, 1.7f, 0.0f), glm::angleAxis(yaw, glm::fvec3(0, 1, 0)), XrFovf{ -0.9f, 0.8f, 0.8f, -0.9f } },
+                SyntheticEye{ glm::fvec3(0.032f, 1.7f, 0.0f), glm::angleAxis(yaw, glm::fvec3(0, 1, 0)), XrFovf{ -0.8f, 0.9f, 0.8f, -0.9f } }
+            };
+            StereoCullingCache::Invalidate();
+            for (uint32_t i = 0; i < queriesPerFrame; ++i) {
+                auto [nearClip, farClip] = clipPlanes[i % clipPlanes.size()];
+                visible += checkSphere(eyes, nearClip, farClip, spheres[i]) ? 1 : 0;
+            }
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count();
+        return { seconds * 1e9 / ((double)frames * (double)queriesPerFrame), visible };
+    };
+
+    auto [uncachedNs, uncachedVisible] = runFrames([](const std::array<SyntheticEye, 2>& eyes, float nearClip, float farClip, const glm::vec4& sphere) {
+        return BuildStereoFrustum(eyes, nearClip, farClip).checkSphere(glm::vec3(sphere), sphere.w);
+    });
+    auto [cachedNs, cachedVisible] = runFrames([](const std::array<SyntheticEye, 2>& eyes, float nearClip, float farClip, const glm::vec4& sphere) {
+        const StereoFrustum& frustum = StereoCullingCache::Get(0x1000, nearClip, farClip, [&eyes](float nearClip, float farClip) { return BuildStereoFrustum(eyes, nearClip, farClip); });
+        return frustum.checkSphere(glm::vec3(sphere), sphere.w);
+    });
+
+    Log::print<INFO>("Culling benchmark ({} queries x {} frames): rebuilding every query = {:.1f} ns/query, cached = {:.1f} ns/query ({} vs {} visible)", queriesPerFrame, frames, uncachedNs, cachedNs, uncachedVisible, cachedVisible);
+}
+
+// alternates the visibility queries between two cameras that use the same clip planes, like the main and the shadow camera can,
+// and checks each query through StereoCullingCache against the frustum of the camera it was made for.
+// returns the amount of spheres where the cached frustum disagreed (which should always be zero)
+static uint64_t ValidateCullingCacheCameras(uint32_t frames, uint32_t queriesPerFrame) {
+    std::mt19937 rng(4321);
+    std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> radius(0.1f, 8.0f);
+
+    constexpr std::array<uint32_t, 2> cameras = { 0x1000, 0x2000 };
+    uint64_t mismatches = 0;
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        // the second camera looks the other way, so most spheres are only visible to one of them
+        std::array<std::array<SyntheticEye, 2>, 2> cameraEyes;
+        for (size_t camera = 0; camera < cameras.size(); ++camera) {
+            const glm::fquat rotation = glm::angleAxis(glm::radians((float)frame + 180.0f * (float)camera), glm::fvec3(0, 1, 0));
+            cameraEyes[camera] = {
+                SyntheticEye{ glm::fvec3(-0.032f, 1.7f, 0.0f), rotation, XrFovf{ -0.9f, 0.8f, 0.8f, -0.9f } },
+                SyntheticEye{ glm::fvec3(0.032f, 1.7f, 0.0f), rotation, XrFovf{ -0.8f, 0.9f, 0.8f, -0.9f } }
+            };
+        }
+        const std::array<StereoFrustum, 2> expected = { BuildStereoFrustum(cameraEyes[0], 0.1f, 600.0f), BuildStereoFrustum(cameraEyes[1], 0.1f, 600.0f) };
+
+        StereoCullingCache::Invalidate();
+        for (uint32_t i = 0; i < queriesPerFrame; ++i) {
+            const size_t camera = i % cameras.size();
+            const glm::vec4 sphere = glm::vec4(position(rng), position(rng) * 0.2f, position(rng), radius(rng));
+            const StereoFrustum& frustum = StereoCullingCache::Get(cameras[camera], 0.1f, 600.0f, [&](float nearClip, float farClip) { return BuildStereoFrustum(cameraEyes[camera], nearClip, farClip); });
+            mismatches += frustum.checkSphere(glm::vec3(sphere), sphere.w) != expected[camera].checkSphere(glm::vec3(sphere), sphere.w) ? 1 : 0;
+        }
+    }
+
+    Log::print<INFO>("Culling cache camera check ({} frames x {} queries over {} cameras): {} mismatches", frames, queriesPerFrame, cameras.size(), mismatches);
+    return mismatches;
+}
+
+BETTERVR_TEST(StereoCulling, []() { return ValidateStereoCulling(64, 4096); });
+BETTERVR_TEST(EdgeBands, []() { return BenchmarkEdgeBands(64, 4096); });
+BETTERVR_TEST(Culling, []() { BenchmarkCulling(2000, 300); return 0; });
+BETTERVR_TEST(CullingCacheCameras, []() { return ValidateCullingCacheCameras(100, 1000); });
@@ -0,0 +1,66 @@
+#include "tests.h"
+#include "hooking/entity_debugger.h"
+#include "hooking/actor_table.h"
+#include "instance.h"
+
+// measures what the entity debugger costs for an increasing amount of fake actors, both the full refresh (which used to run on the guest thread
+// every frame and now runs on the refresh thread) and UpdateEntityMemory (which still runs every guest frame), returns the amount of actor counts
+// where the debugger didn't end up with exactly one entity per actor (which should always be zero)
+static uint64_t BenchmarkEntityDebugger(uint32_t maxActorCount, uint32_t iterations) {
+    constexpr std::array names = { "GameROMPlayer", "Enemy_Bokoblin_Junior", "Weapon_Sword_001", "Obj_Tree_01", "Animal_Fox_A" };
+    constexpr uint32_t firstActor = 0x1000;
+    constexpr uint32_t nameStride = 0x40;
+
+    uint64_t mismatches = 0;
+    for (uint32_t actorCount = 64; actorCount <= maxActorCount; actorCount *= 4) {
+        // weapons point at memory past their ActorWiiU part, so give each actor the size of a Weapon
+        const uint32_t firstName = firstActor + actorCount * (uint32_t)sizeof(Weapon);
+        std::vector<std::byte> fakeMemory(firstName + names.size() * nameStride);
+        for (size_t i = 0; i < names.size(); ++i) {
+            memcpy(fakeMemory.data() + firstName + i * nameStride, names[i], strlen(names[i]) + 1);
+        }
+        CemuHooks::s_memoryBaseAddress = (uint64_t)fakeMemory.data();
+
+        ActorTable table;
+        for (uint32_t i = 0; i < actorCount; ++i) {
+            uint32_t actorPtr = firstActor + i * (uint32_t)sizeof(Weapon);
+            CemuHooks::setMemory<uint32_t>(actorPtr + offsetof(ActorWiiU, name) + offsetof(sead::FixedSafeString40, c_str), firstName + (i % (uint32_t)names.size()) * nameStride);
+            CemuHooks::setMemory<float>(actorPtr + offsetof(ActorWiiU, mtx) + offsetof(BEMatrix34, pos_x), (float)(i + 1));
+        }
+        for (uint32_t i = 0; i < actorCount; ++i) {
+            table.OnActorVisited(i, actorCount, firstActor + i * (uint32_t)sizeof(Weapon));
+        }
+
+        std::vector<EntityDebugger::WatchedActor> actors;
+        EntityDebugger::CollectActors(table, actors);
+
+        EntityDebugger debugger(false);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+            debugger.RefreshEntities(actors);
+        }
+        double refreshUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / (double)iterations;
+
+        // freeze the matrix of every 16th actor
+        {
+            std::scoped_lock lock(debugger.m_entitiesMutex);
+            for (uint32_t i = 0; i < (uint32_t)actors.size(); i += 16) {
+                debugger.m_entities.at(actors[i].id).values[0].frozen = true;
+            }
+            debugger.RebuildFrozenValues();
+        }
+        start = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+            debugger.UpdateEntityMemory();
+        }
+        double guestFrameUs = std::chrono::duration<double, std::micro>(std::chrono::high_resolution_clock::now() - start).count() / (double)iterations;
+
+        mismatches += (debugger.m_entities.size() != actorCount || debugger.m_sortedEntityIds.size() != actorCount) ? 1 : 0;
+        CemuHooks::s_memoryBaseAddress = 0;
+
+        Log::print<INFO>("Entity debugger benchmark ({} actors x {} iterations): refresh = {:.1f} us, per guest frame = {:.2f} us", actorCount, iterations, refreshUs, guestFrameUs);
+    }
+    return mismatches;
+}
+
+BETTERVR_TEST(EntityDebugger, []() { return BenchmarkEntityDebugger(1000, 200); });
@@ -0,0 +1,133 @@
+#include "tests.h"
+#include "hooking/frame_context.h"
+#include "instance.h"
+
+// runs a synthetic skeleton of boneCount bones for a number of frames while a simulated XR thread keeps publishing new controller poses,
+// once by loading the input for every bone like hook_ModifyBoneMatrix used to and once through HookFrameContext.
+// returns the amount of frames where the context needed more than one load of the input or its bones saw different poses (which should always be zero)
+static uint64_t BenchmarkHookFrameContext(uint32_t boneCount, uint32_t frames) {
+    std::vector<std::string> boneNames;
+    for (uint32_t i = 0; i < boneCount; ++i) {
+        boneNames.emplace_back(std::format("Bone_{:03}_{}", i / 2, (i % 2 == 0) ? "L" : "R"));
+    }
+
+    auto input = std::make_unique<SeqLock<OpenXR::InputState>>(OpenXR::InputState{});
+    auto gameState = std::make_unique<SeqLock<OpenXR::GameState>>(OpenXR::GameState{});
+
+    // publishes as fast as it can, which is far more often than UpdateActions does
+    std::atomic_bool stop = false;
+    std::thread xrThread([&]() {
+        OpenXR::InputState state = {};
+        for (uint64_t count = 1; !stop.load(std::memory_order_relaxed); ++count) {
+            state.shared.inputTime = (XrTime)count;
+            state.shared.poseLocation[0].pose.position.x = (float)(count & 0xFFFFFF);
+            state.shared.poseLocation[1].pose.position.x = -(float)(count & 0xFFFFFF);
+            input->store(state);
+        }
+    });
+
+    // what every bone does with the input, the frame's result is whether all bones used the input from the same XR frame
+    auto runBones = [&](auto&& loadShared) {
+        XrTime firstInputTime = -1;
+        bool samePose = true;
+        for (const std::string& boneName : boneNames) {
+            decltype(auto) inputs = loadShared();
+            const OpenXR::EyeSide side = boneName.ends_with("_L") ? OpenXR::EyeSide::LEFT : OpenXR::EyeSide::RIGHT;
+            const glm::fvec3 controllerPos = ToGLM(inputs.poseLocation[side].pose.position);
+            firstInputTime = firstInputTime == -1 ? inputs.inputTime : firstInputTime;
+            samePose = samePose && inputs.inputTime == firstInputTime && glm::abs(controllerPos.x) == (float)(firstInputTime & 0xFFFFFF);
+        }
+        return samePose;
+    };
+
+    uint32_t legacyMixedFrames = 0;
+    auto start = std::chrono::high_resolution_clock::now();
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        legacyMixedFrames += runBones([&]() { return input->load(&OpenXR::InputState::shared); }) ? 0 : 1;
+    }
+    double legacyNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+    uint64_t errors = 0;
+    uint64_t loadsBefore = HookFrameContext::GetSnapshotLoads();
+    start = std::chrono::high_resolution_clock::now();
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        HookFrameContext::Capture(*input, *gameState);
+        errors += runBones([&]() -> const OpenXR::InputState::Shared& { return HookFrameContext::GetInput().shared; }) ? 0 : 1;
+        errors += (frame > 0 && HookFrameContext::GetLastFrameSnapshotLoads() != 1) ? 1 : 0;
+    }
+    double contextNs = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+    uint64_t contextLoads = HookFrameContext::GetSnapshotLoads() - loadsBefore;
+
+    stop = true;
+    xrThread.join();
+
+    double bones = (double)frames * (double)boneCount;
+    Log::print<INFO>("Hook frame context benchmark ({} bones x {} frames): per-bone loads = {:.1f} ns/bone with {} frames mixing poses, frame context = {:.1f} ns/bone with {:.1f} loads/frame, {} errors",
+        boneCount, frames, legacyNs / bones, legacyMixedFrames, contextNs / bones, frames > 0 ? (double)contextLoads / frames : 0.0, errors);
+    return errors;
+}
+
+// changes the game state from a few threads at once like the camera, weapon and VPAD hooks do, each thread its own fields.
+// every thread only loads the captured frame once per frame, and has to see the input from that frame and the changes of the other threads from the frame before.
+// returns the amount of checks that failed (which should always be zero)
+static uint64_t ValidateHookFrameContextThreads(uint32_t frames) {
+    auto input = std::make_unique<SeqLock<OpenXR::InputState>>(OpenXR::InputState{});
+    auto gameState = std::make_unique<SeqLock<OpenXR::GameState>>(OpenXR::GameState{});
+
+    // each thread flips its own bool and counts frames in its own equip type, so changes to neighbouring fields have to survive each other
+    auto changeOwnFields = [](OpenXR::GameState& state, uint32_t thread, uint32_t frame) {
+        const bool flag = (frame % 2) == 0;
+        switch (thread) {
+            case 0: state.is_climbing = flag; state.right_hand_current_equip_type = (EquipType)(frame % 4); break;
+            case 1: state.is_riding_mount = flag; state.left_hand_current_equip_type = (EquipType)(frame % 4); break;
+            case 2: state.is_paragliding = flag; state.last_equip_type_held = (EquipType)(frame % 4); break;
+        }
+    };
+    auto hasOwnFields = [](const OpenXR::GameState& state, uint32_t thread, uint32_t frame) {
+        const bool flag = (frame % 2) == 0;
+        switch (thread) {
+            case 0: return state.is_climbing == flag && state.right_hand_current_equip_type == (EquipType)(frame % 4);
+            case 1: return state.is_riding_mount == flag && state.left_hand_current_equip_type == (EquipType)(frame % 4);
+            default: return state.is_paragliding == flag && state.last_equip_type_held == (EquipType)(frame % 4);
+        }
+    };
+
+    constexpr uint32_t THREADS = 3;
+    std::atomic_uint64_t errors = 0;
+    for (uint32_t frame = 1; frame <= frames; ++frame) {
+        OpenXR::InputState state = {};
+        state.shared.inputTime = (XrTime)frame;
+        input->store(state);
+        HookFrameContext::Capture(*input, *gameState);
+
+        std::vector<std::thread> threads;
+        for (uint32_t thread = 0; thread < THREADS; ++thread) {
+            threads.emplace_back([&, thread]() {
+                for (uint32_t otherThread = 0; otherThread < THREADS && frame > 1; ++otherThread) {
+                    errors += hasOwnFields(HookFrameContext::GetGameState(), otherThread, frame - 1) ? 0 : 1;
+                }
+                changeOwnFields(HookFrameContext::GetGameState(), thread, frame);
+                HookFrameContext::StoreGameState();
+                errors += HookFrameContext::GetInput().shared.inputTime == (XrTime)frame ? 0 : 1;
+            });
+        }
+        for (std::thread& thread : threads) {
+            thread.join();
+        }
+    }
+
+    // the threads are new every frame, so the frame was loaded once for the capture, once per thread and once per store
+    HookFrameContext::Capture(*input, *gameState);
+    errors += HookFrameContext::GetLastFrameSnapshotLoads() != 1 + THREADS * 2 ? 1 : 0;
+
+    const OpenXR::GameState finalState = gameState->load();
+    for (uint32_t thread = 0; thread < THREADS; ++thread) {
+        errors += hasOwnFields(finalState, thread, frames) ? 0 : 1;
+    }
+
+    Log::print<INFO>("Hook frame context threads ({} threads x {} frames): {} errors", THREADS, frames, errors.load());
+    return errors;
+}
+
+BETTERVR_TEST(HookFrameContext, []() { return BenchmarkHookFrameContext(120, 1000); });
+BETTERVR_TEST(HookFrameContextThreads, []() { return ValidateHookFrameContextThreads(200); });
@@ -0,0 +1,265 @@
+#include "tests.h"
+#include "instance.h"
+#include "read_frame_recording.h"
+#include "hooking/layer.h"
+#include "rendering/openxr_mock.h"
+#include <cstring>
+
+// Replays a recording made by FrameRecorder through the VRLayer overrides against a stub Vulkan dispatch that doesn't touch a GPU.
+// CreateImage, DestroyImage and QueueSubmit always go through VRLayer. The clears and presents initialize and drive the VR session,
+// so they're only sent through VRLayer when includeSessionCalls is set and otherwise go straight to the stub dispatch.
+// With includeSessionCalls the session runs on the mock runtime and VRManager gets a Vulkan object for the stub device, since
+// VRManager::Init needs Cemu's instance, D3D12 and the Cemu hooks. The renderer's layers need D3D12 too, so the session is kept
+// from becoming ready, which leaves the clears at the point where they'd copy to the layers and passes them through.
+namespace FrameReplayer {
+    struct Stats {
+        uint32_t frames = 0;
+        uint64_t events = 0;
+        // xrPollEvent calls from the presents, so zero when the presents didn't go through VRLayer
+        uint64_t polledEvents = 0;
+        double totalLayerMs = 0.0;
+        double minFrameMs = std::numeric_limits<double>::max();
+        double maxFrameMs = 0.0;
+    };
+
+    // stub dispatch that the VRLayer overrides call into, none of these touch an actual device
+    VkImage s_nextReplayImage = VK_NULL_HANDLE;
+
+    VKAPI_ATTR VkResult VKAPI_CALL Stub_CreateImage(VkDevice, const VkImageCreateInfo*, const VkAllocationCallbacks*, VkImage* pImage) {
+        *pImage = s_nextReplayImage;
+        return VK_SUCCESS;
+    }
+    VKAPI_ATTR void VKAPI_CALL Stub_DestroyImage(VkDevice, VkImage, const VkAllocationCallbacks*) {
+    }
+    VKAPI_ATTR void VKAPI_CALL Stub_CmdClearColorImage(VkCommandBuffer, VkImage, VkImageLayout, const VkClearColorValue*, uint32_t, const VkImageSubresourceRange*) {
+    }
+    VKAPI_ATTR void VKAPI_CALL Stub_CmdClearDepthStencilImage(VkCommandBuffer, VkImage, VkImageLayout, const VkClearDepthStencilValue*, uint32_t, const VkImageSubresourceRange*) {
+    }
+    VKAPI_ATTR VkResult VKAPI_CALL Stub_QueueSubmit(VkQueue, uint32_t, const VkSubmitInfo*, VkFence) {
+        return VK_SUCCESS;
+    }
+    VKAPI_ATTR VkResult VKAPI_CALL Stub_QueuePresentKHR(VkQueue, const VkPresentInfoKHR*) {
+        return VK_SUCCESS;
+    }
+
+    VKAPI_ATTR PFN_vkVoidFunction VKAPI_CALL Stub_GetDeviceProcAddr(VkDevice, const char* pName) {
+        if (strcmp(pName, "vkCreateImage") == 0) return (PFN_vkVoidFunction)&Stub_CreateImage;
+        if (strcmp(pName, "vkDestroyImage") == 0) return (PFN_vkVoidFunction)&Stub_DestroyImage;
+        if (strcmp(pName, "vkCmdClearColorImage") == 0) return (PFN_vkVoidFunction)&Stub_CmdClearColorImage;
+        if (strcmp(pName, "vkCmdClearDepthStencilImage") == 0) return (PFN_vkVoidFunction)&Stub_CmdClearDepthStencilImage;
+        if (strcmp(pName, "vkQueueSubmit") == 0) return (PFN_vkVoidFunction)&Stub_QueueSubmit;
+        if (strcmp(pName, "vkQueuePresentKHR") == 0) return (PFN_vkVoidFunction)&Stub_QueuePresentKHR;
+        return nullptr;
+    }
+
+    std::optional<Stats> Replay(const std::filesystem::path& path, bool includeSessionCalls) {
+        using namespace VRLayer;
+
+        FrameRecordingReader reader(path);
+        if (!reader.IsValid()) {
+            return std::nullopt;
+        }
+
+        const VkDevice stubDevice = (VkDevice)0xBE77E4D0;
+        VkDeviceCreateInfo stubCreateInfo = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO };
+        const vkroots::VkDeviceDispatch deviceDispatch(&Stub_GetDeviceProcAddr, stubDevice, VK_NULL_HANDLE, nullptr, &stubCreateInfo);
+
+        uint64_t pollEventsBefore = 0;
+        if (includeSessionCalls) {
+            OpenXR& xr = Tests::GetMockSession();
+            if (xr.GetRenderer() != nullptr) {
+                Log::print<ERROR>("A renderer already exists, its layers can't be created without D3D12");
+                return std::nullopt;
+            }
+
+            // takes the session's state changes so that the presents don't create a renderer when they process the events
+            XrEventDataBuffer eventData = { XR_TYPE_EVENT_DATA_BUFFER };
+            while (xrPollEvent(xr.GetInstance(), &eventData) == XR_SUCCESS) {
+                eventData = { XR_TYPE_EVENT_DATA_BUFFER };
+            }
+            VRManager::instance().VK = std::make_unique<RND_Vulkan>(stubDevice, &deviceDispatch);
+            pollEventsBefore = MockXRRuntime::GetCallCounts().pollEvent;
+        }
+
+        Stats stats = {};
+        double currFrameMs = 0.0;
+        auto timeLayerCall = [&](auto&& call) {
+            auto start = std::chrono::high_resolution_clock::now();
+            call();
+            currFrameMs += std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+            stats.events++;
+        };
+
+        // submits are recorded one VkSubmitInfo at a time and get rebuilt into a single vkQueueSubmit call
+        struct PendingSubmit {
+            std::vector<VkCommandBuffer> commandBuffers;
+            std::vector<VkSemaphore> waitSemaphores;
+            std::vector<VkPipelineStageFlags> waitDstStageMasks;
+            std::vector<VkSemaphore> signalSemaphores;
+        };
+        std::vector<PendingSubmit> pendingSubmits;
+
+        FrameRecorder::EventHeader eventHeader = {};
+        bool stopReplay = false;
+        while (!stopReplay && reader.ReadEvent(eventHeader)) {
+            switch (eventHeader.type) {
+                case FrameRecorder::EventType::CreateImage: {
+                    FrameRecorder::CreateImageEvent event = {};
+                    if (!reader.ReadPayload(event)) break;
+
+                    VkImageCreateInfo createInfo = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO };
+                    createInfo.imageType = VK_IMAGE_TYPE_2D;
+                    createInfo.format = event.format;
+                    createInfo.extent = event.extent;
+                    createInfo.usage = event.usage;
+                    createInfo.mipLevels = event.mipLevels;
+                    createInfo.arrayLayers = event.arrayLayers;
+
+                    VkImage image = VK_NULL_HANDLE;
+                    s_nextReplayImage = (VkImage)event.image;
+                    timeLayerCall([&]() { VkDeviceOverrides::CreateImage(deviceDispatch, stubDevice, &createInfo, nullptr, &image); });
+                    break;
+                }
+                case FrameRecorder::EventType::DestroyImage: {
+                    FrameRecorder::DestroyImageEvent event = {};
+                    if (!reader.ReadPayload(event)) break;
+
+                    timeLayerCall([&]() { VkDeviceOverrides::DestroyImage(deviceDispatch, stubDevice, (VkImage)event.image, nullptr); });
+                    break;
+                }
+                case FrameRecorder::EventType::ClearColorImage: {
+                    FrameRecorder::ClearColorImageEvent event = {};
+                    if (!reader.ReadPayload(event)) break;
+
+                    const vkroots::VkCommandBufferDispatch commandBufferDispatch((VkCommandBuffer)event.commandBuffer, &deviceDispatch);
+                    std::vector<VkImageSubresourceRange> ranges(event.rangeCount, event.firstRange);
+                    timeLayerCall([&]() {
+                        if (includeSessionCalls) {
+                            VkDeviceOverrides::CmdClearColorImage(commandBufferDispatch, (VkCommandBuffer)event.commandBuffer, (VkImage)event.image, event.imageLayout, &event.color, event.rangeCount, ranges.data());
+                        }
+                        else {
+                            commandBufferDispatch.CmdClearColorImage((VkCommandBuffer)event.commandBuffer, (VkImage)event.image, event.imageLayout, &event.color, event.rangeCount, ranges.data());
+                        }
+                    });
+                    break;
+                }
+                case FrameRecorder::EventType::ClearDepthStencilImage: {
+                    FrameRecorder::ClearDepthStencilImageEvent event = {};
+                    if (!reader.ReadPayload(event)) break;
+
+                    const vkroots::VkCommandBufferDispatch commandBufferDispatch((VkCommandBuffer)event.commandBuffer, &deviceDispatch);
+                    std::vector<VkImageSubresourceRange> ranges(event.rangeCount, event.firstRange);
+                    timeLayerCall([&]() {
+                        if (includeSessionCalls) {
+                            VkDeviceOverrides::CmdClearDepthStencilImage(commandBufferDispatch, (VkCommandBuffer)event.commandBuffer, (VkImage)event.image, event.imageLayout, &event.depthStencil, event.rangeCount, ranges.data());
+                        }
+                        else {
+                            commandBufferDispatch.CmdClearDepthStencilImage((VkCommandBuffer)event.commandBuffer, (VkImage)event.image, event.imageLayout, &event.depthStencil, event.rangeCount, ranges.data());
+                        }
+                    });
+                    break;
+                }
+                case FrameRecorder::EventType::QueueSubmit: {
+                    FrameRecorder::QueueSubmitEvent event = {};
+                    if (!reader.ReadPayload(event)) break;
+
+                    PendingSubmit& pending = pendingSubmits.emplace_back();
+                    for (uint32_t i = 0; i < event.commandBufferCount; i++) {
+                        pending.commandBuffers.emplace_back((VkCommandBuffer)event.commandBuffers[i]);
+                    }
+                    pending.waitSemaphores.resize(event.waitSemaphoreCount, VK_NULL_HANDLE);
+                    pending.waitDstStageMasks.resize(event.waitSemaphoreCount, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT);
+                    pending.signalSemaphores.resize(event.signalSemaphoreCount, VK_NULL_HANDLE);
+
+                    if (event.submitIdx + 1 < event.submitCount) {
+                        break;
+                    }
+
+                    std::vector<VkSubmitInfo> submitInfos;
+                    for (PendingSubmit& submit : pendingSubmits) {
+                        VkSubmitInfo& submitInfo = submitInfos.emplace_back(VkSubmitInfo{ VK_STRUCTURE_TYPE_SUBMIT_INFO });
+                        submitInfo.waitSemaphoreCount = (uint32_t)submit.waitSemaphores.size();
+                        submitInfo.pWaitSemaphores = submit.waitSemaphores.data();
+                        submitInfo.pWaitDstStageMask = submit.waitDstStageMasks.data();
+                        submitInfo.commandBufferCount = (uint32_t)submit.commandBuffers.size();
+                        submitInfo.pCommandBuffers = submit.commandBuffers.data();
+                        submitInfo.signalSemaphoreCount = (uint32_t)submit.signalSemaphores.size();
+                        submitInfo.pSignalSemaphores = submit.signalSemaphores.data();
+                    }
+
+                    const vkroots::VkQueueDispatch queueDispatch((VkQueue)event.queue, &deviceDispatch);
+                    timeLayerCall([&]() { VkDeviceOverrides::QueueSubmit(queueDispatch, (VkQueue)event.queue, (uint32_t)submitInfos.size(), submitInfos.data(), VK_NULL_HANDLE); });
+                    pendingSubmits.clear();
+                    break;
+                }
+                case FrameRecorder::EventType::QueuePresent: {
+                    FrameRecorder::QueuePresentEvent event = {};
+                    if (!reader.ReadPayload(event)) break;
+
+                    std::vector<VkSwapchainKHR> swapchains(event.swapchainCount, VK_NULL_HANDLE);
+                    std::vector<uint32_t> imageIndices(event.swapchainCount, event.firstImageIndex);
+                    VkPresentInfoKHR presentInfo = { VK_STRUCTURE_TYPE_PRESENT_INFO_KHR };
+                    presentInfo.swapchainCount = event.swapchainCount;
+                    presentInfo.pSwapchains = swapchains.data();
+                    presentInfo.pImageIndices = imageIndices.data();
+
+                    const vkroots::VkQueueDispatch queueDispatch((VkQueue)event.queue, &deviceDispatch);
+                    timeLayerCall([&]() {
+                        if (includeSessionCalls) {
+                            VkDeviceOverrides::QueuePresentKHR(queueDispatch, (VkQueue)event.queue, &presentInfo);
+                        }
+                        else {
+                            queueDispatch.QueuePresentKHR((VkQueue)event.queue, &presentInfo);
+                        }
+                    });
+
+                    stats.frames++;
+                    stats.totalLayerMs += currFrameMs;
+                    stats.minFrameMs = std::min(stats.minFrameMs, currFrameMs);
+                    stats.maxFrameMs = std::max(stats.maxFrameMs, currFrameMs);
+                    currFrameMs = 0.0;
+                    break;
+                }
+                default: {
+                    Log::print<ERROR>("Unknown event type {} in frame recording, stopping replay", (uint32_t)eventHeader.type);
+                    stopReplay = true;
+                    break;
+                }
+            }
+        }
+
+        if (includeSessionCalls) {
+            stats.polledEvents = MockXRRuntime::GetCallCounts().pollEvent - pollEventsBefore;
+            VRManager::instance().VK.reset();
+        }
+
+        if (stats.frames > 0) {
+            Log::print<INFO>("Replayed {} frames ({} events) from {}{}: avg {:.4f} ms, min {:.4f} ms, max {:.4f} ms of layer time per frame", stats.frames, stats.events, path.string(), includeSessionCalls ? " with the session calls" : "", stats.totalLayerMs / stats.frames, stats.minFrameMs, stats.maxFrameMs);
+        }
+        return stats;
+    }
+}
+
+// replays the recording that BETTERVR_REPLAY_FRAMES points to, recordings aren't part of the repository since they depend on the GPU and settings
+static uint64_t ReplayFrameRecording(bool includeSessionCalls) {
+    const char* path = std::getenv("BETTERVR_REPLAY_FRAMES");
+    if (path == nullptr || path[0] == '\0') {
+        Log::print<INFO>("Skipping the frame replay since BETTERVR_REPLAY_FRAMES isn't set");
+        return 0;
+    }
+    std::optional<FrameReplayer::Stats> stats = FrameReplayer::Replay(path, includeSessionCalls);
+    if (!stats) {
+        return 1;
+    }
+
+    // every present should have processed the session's events, and none of them should have made a renderer
+    uint64_t errors = 0;
+    if (includeSessionCalls) {
+        errors += stats->polledEvents < stats->frames ? 1 : 0;
+        errors += VRManager::instance().XR->GetRenderer() != nullptr ? 1 : 0;
+    }
+    return errors;
+}
+
+BETTERVR_TEST(FrameReplay, []() { return ReplayFrameRecording(false); });
+BETTERVR_TEST(FrameReplaySession, []() { return ReplayFrameRecording(true); });
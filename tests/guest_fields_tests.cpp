@@ -0,0 +1,61 @@
+#include "tests.h"
+#include "hooking/guest_fields.h"
+
+// reads the fields hook_ChangeWeaponMtx needs from fake weapons, once by copying each Weapon like the hook used to and once with readGuestFields,
+// returns the amount of weapons where both paths disagree (which should always be zero)
+static uint64_t BenchmarkGuestFields(uint32_t weaponCount, uint32_t iterations) {
+    constexpr uint32_t firstWeapon = 0x1000;
+    std::vector<std::byte> fakeMemory(firstWeapon + (size_t)weaponCount * sizeof(Weapon));
+    CemuHooks::s_memoryBaseAddress = (uint64_t)fakeMemory.data();
+    for (uint32_t i = 0; i < weaponCount; ++i) {
+        uint32_t weaponPtr = firstWeapon + i * (uint32_t)sizeof(Weapon);
+        writeGuestField<WeaponFields::Flags2>(weaponPtr, (ActorFlags2)(i * 0x01010101u));
+        writeGuestField<WeaponFields::Type>(weaponPtr, (WeaponType)(i % 6));
+        writeGuestField<WeaponFields::OriginalScale>(weaponPtr, BEVec3((float)i, 1.0f, 2.0f));
+    }
+
+    struct Result {
+        ActorFlags2 flags2;
+        WeaponType type;
+        glm::fvec3 scale;
+    };
+    std::vector<Result> structResults(weaponCount);
+    std::vector<Result> fieldResults(weaponCount);
+
+    auto timeIterations = [&](auto&& readAllWeapons) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+            readAllWeapons();
+        }
+        return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() * 1e9 / ((double)iterations * (double)weaponCount);
+    };
+
+    double structNs = timeIterations([&]() {
+        for (uint32_t i = 0; i < weaponCount; ++i) {
+            Weapon weapon = {};
+            CemuHooks::readMemory(firstWeapon + i * (uint32_t)sizeof(Weapon), &weapon);
+            structResults[i] = { weapon.flags2.getLE(), weapon.type.getLE(), weapon.originalScale.getLE() };
+        }
+    });
+
+    double fieldNs = timeIterations([&]() {
+        for (uint32_t i = 0; i < weaponCount; ++i) {
+            auto [flags2, type, scale] = readGuestFields<WeaponFields::Flags2, WeaponFields::Type, WeaponFields::OriginalScale>(firstWeapon + i * (uint32_t)sizeof(Weapon));
+            fieldResults[i] = { flags2.getLE(), type.getLE(), scale.getLE() };
+        }
+    });
+
+    CemuHooks::s_memoryBaseAddress = 0;
+
+    uint64_t mismatches = 0;
+    for (uint32_t i = 0; i < weaponCount; ++i) {
+        const Result& a = structResults[i];
+        const Result& b = fieldResults[i];
+        mismatches += (a.flags2 != b.flags2 || a.type != b.type || a.scale != b.scale) ? 1 : 0;
+    }
+
+    Log::print<INFO>("Guest field benchmark ({} weapons x {} iterations): full Weapon copy = {:.1f} ns/weapon, selected fields = {:.1f} ns/weapon, {} mismatches", weaponCount, iterations, structNs, fieldNs, mismatches);
+    return mismatches;
+}
+
+BETTERVR_TEST(GuestFields, []() { return BenchmarkGuestFields(20, 100'000); });
@@ -0,0 +1,79 @@
+#include "tests.h"
+#include "hooking/guest_snapshot.h"
+#include "hooking/cemu_hooks.h"
+#include <random>
+
+// fills a fake guest memory image with actors and compares reading their matrices and a few other fields through CemuHooks::readMemory
+// with capturing all of them at once through GuestSnapshot, returns the amount of values that differ between both paths (which should always be zero)
+static uint64_t BenchmarkGuestSnapshot(uint32_t actorCount, uint32_t iterations) {
+    // the actors are laid out back to back, starting at a made-up guest address
+    constexpr uint32_t firstActor = 0x1000;
+    std::vector<std::byte> fakeMemory(firstActor + (size_t)actorCount * sizeof(ActorWiiU));
+    std::mt19937 rng(9876);
+    std::uniform_real_distribution<float> value(-1000.0f, 1000.0f);
+    for (size_t offset = firstActor; offset + 4 <= fakeMemory.size(); offset += 4) {
+        BEType<float> word = value(rng);
+        memcpy(fakeMemory.data() + offset, &word, sizeof(word));
+    }
+    CemuHooks::s_memoryBaseAddress = (uint64_t)fakeMemory.data();
+
+    constexpr size_t FIELDS_PER_ACTOR = 12 + 3 + 6;
+    std::vector<float> readResults((size_t)actorCount * FIELDS_PER_ACTOR);
+    std::vector<float> snapshotResults((size_t)actorCount * FIELDS_PER_ACTOR);
+
+    auto timeIterations = [&](auto&& readAllActors) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+            readAllActors();
+        }
+        return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - start).count() * 1e9 / ((double)iterations * (double)actorCount);
+    };
+
+    // how hooks read actors today, one readMemory per actor and a swap per field
+    double readMemoryNs = timeIterations([&]() {
+        ActorWiiU actor;
+        for (uint32_t i = 0; i < actorCount; ++i) {
+            CemuHooks::readMemory(firstActor + i * (uint32_t)sizeof(ActorWiiU), &actor);
+            float* out = &readResults[i * FIELDS_PER_ACTOR];
+            const BEType<float>* mtx = &actor.mtx.x_x;
+            for (int j = 0; j < 12; ++j) {
+                *out++ = mtx[j].getLE();
+            }
+            glm::fvec3 velocity = actor.velocity.getLE();
+            *out++ = velocity.x;
+            *out++ = velocity.y;
+            *out++ = velocity.z;
+            *out++ = actor.aabb.minX.getLE();
+            *out++ = actor.aabb.minY.getLE();
+            *out++ = actor.aabb.minZ.getLE();
+            *out++ = actor.aabb.maxX.getLE();
+            *out++ = actor.aabb.maxY.getLE();
+            *out++ = actor.aabb.maxZ.getLE();
+        }
+    });
+
+    // one copy for all actors, then batched swaps for the contiguous fields
+    GuestSnapshot snapshot;
+    double snapshotNs = timeIterations([&]() {
+        snapshot.capture(firstActor, actorCount * (uint32_t)sizeof(ActorWiiU));
+        for (uint32_t i = 0; i < actorCount; ++i) {
+            uint32_t actorPtr = firstActor + i * (uint32_t)sizeof(ActorWiiU);
+            float* out = &snapshotResults[i * FIELDS_PER_ACTOR];
+            snapshot.readArrayLE(actorPtr + offsetof(ActorWiiU, mtx), std::span(out, 12));
+            snapshot.readArrayLE(actorPtr + offsetof(ActorWiiU, velocity), std::span(out + 12, 3));
+            snapshot.readArrayLE(actorPtr + offsetof(ActorWiiU, aabb), std::span(out + 15, 6));
+        }
+    });
+
+    CemuHooks::s_memoryBaseAddress = 0;
+
+    uint64_t mismatches = 0;
+    for (size_t i = 0; i < readResults.size(); ++i) {
+        mismatches += memcmp(&readResults[i], &snapshotResults[i], sizeof(float)) != 0 ? 1 : 0;
+    }
+
+    Log::print<INFO>("Guest snapshot benchmark ({} actors x {} iterations): readMemory = {:.1f} ns/actor, snapshot = {:.1f} ns/actor, {} mismatches", actorCount, iterations, readMemoryNs, snapshotNs, mismatches);
+    return mismatches;
+}
+
+BETTERVR_TEST(GuestSnapshot, []() { return BenchmarkGuestSnapshot(1000, 200); });
@@ -0,0 +1,341 @@
+#include "tests.h"
+#include "hooking/hand_gestures.h"
+#include "hooking/motion_trace.h"
+#include <numeric>
+#include <random>
+
+namespace {
+    // how calculateHandGesture found the gesture before the recognizer, from scratch for every sample
+    HandGestureState GetStatelessGesture(const glm::fvec3& handPos, const glm::fmat4& headsetMatrix) {
+        glm::fvec3 headsetForward = -glm::normalize(glm::fvec3(headsetMatrix[2]));
+        headsetForward.y = 0.0f;
+        headsetForward = glm::normalize(headsetForward);
+        const glm::fvec3 headsetRight = glm::normalize(glm::fvec3(headsetMatrix[0]));
+        const glm::fvec3 headsetPos(headsetMatrix[3]);
+        const glm::fvec3 headToHand = handPos - headsetPos;
+
+        HandGestureState gesture = {};
+        gesture.isBehindHead = glm::dot(headsetForward, headToHand) < 0.0f;
+        gesture.isBehindHeadWithWaistOffset = glm::dot(headsetForward, glm::fvec3(headToHand.x, 0.0f, headToHand.z)) - 0.05f < 0.0f;
+        gesture.isOnLeftSide = glm::dot(headsetRight, headToHand) < 0.0f;
+        gesture.isCloseToHead = glm::length2(headToHand) < 0.35f * 0.35f;
+        gesture.isCloseToMouth = glm::length2(headToHand) < 0.2f * 0.2f;
+        gesture.isCloseToWaist = handPos.y < headsetPos.y - 0.45f;
+        gesture.isNearChestHeight = handPos.y > headsetPos.y - 0.3f;
+        return gesture;
+    }
+
+    // the flags that the recognizer keeps with hysteresis
+    constexpr std::array<bool HandGestureState::*, 7> GESTURE_FLAGS = {
+        &HandGestureState::isBehindHead, &HandGestureState::isBehindHeadWithWaistOffset, &HandGestureState::isCloseToHead, &HandGestureState::isCloseToMouth,
+        &HandGestureState::isCloseToWaist, &HandGestureState::isNearChestHeight, &HandGestureState::isOnLeftSide
+    };
+
+    // what the shield and the slots react to, a change of either is a change that the player would notice
+    struct RecognizedPose {
+        BodySlot slot;
+        bool isNearChestHeight;
+
+        bool operator==(const RecognizedPose&) const = default;
+    };
+
+    RecognizedPose GetPose(const HandGestureState& gesture) {
+        return { HandGestureRecognizer::GetSlot(gesture), gesture.isNearChestHeight };
+    }
+
+    // one hand moving relative to the body while the head looks around a bit, generated here rather than recorded from a player
+    struct PoseTrace {
+        std::string name;
+        OpenXR::EyeSide hand;
+        std::vector<glm::fmat4> headsetMatrices;
+        std::vector<glm::fvec3> handPositions; // with tracking noise and tremor
+        std::vector<glm::fvec3> smoothHandPositions;
+        // the slot that the hand was placed in, while it's held in a slot or resting away from them (not while it's moving in between)
+        std::vector<std::optional<BodySlot>> labels;
+        bool isResting; // the hand rests on the edge of a slot, so there's no right answer but it shouldn't flicker
+    };
+
+    constexpr double SAMPLE_RATE = 90.0;
+    constexpr size_t MIN_SLOT_SAMPLES = 9; // 100 ms
+
+    glm::fmat4 GetHeadsetMatrix(double time) {
+        const float yaw = 0.4f * (float)std::sin(0.9 * time);
+        const float pitch = 0.15f * (float)std::sin(1.3 * time + 0.5);
+        return glm::translate(glm::fmat4(1.0f), glm::fvec3(0.0f, 1.6f, 0.0f)) * glm::rotate(glm::fmat4(1.0f), yaw, glm::fvec3(0.0f, 1.0f, 0.0f)) * glm::rotate(glm::fmat4(1.0f), pitch, glm::fvec3(1.0f, 0.0f, 0.0f));
+    }
+
+    // offsets are x to the right, y up and z forward, where the hand is placed relative to the yaw of the head
+    glm::fvec3 GetHandPosition(const glm::fmat4& headsetMatrix, const glm::fvec3& bodyOffset) {
+        glm::fvec3 forward = -glm::fvec3(headsetMatrix[2]);
+        forward.y = 0.0f;
+        forward = glm::normalize(forward);
+        const glm::fvec3 right = glm::cross(forward, glm::fvec3(0.0f, 1.0f, 0.0f));
+        return glm::fvec3(headsetMatrix[3]) + right * bodyOffset.x + glm::fvec3(0.0f, bodyOffset.y, 0.0f) + forward * bodyOffset.z;
+    }
+
+    PoseTrace MakeTrace(std::string name, OpenXR::EyeSide hand, bool isResting, double seconds, std::mt19937& rng, const std::function<glm::fvec3(double)>& getBodyOffset, const std::function<std::optional<BodySlot>(double)>& getLabel) {
+        // tracking jitter plus a physiological tremor of a couple of millimeters
+        std::normal_distribution<float> jitter(0.0f, 0.0015f);
+        std::uniform_real_distribution<float> phase(0.0f, glm::two_pi<float>());
+        const glm::fvec3 tremorPhase = { phase(rng), phase(rng), phase(rng) };
+
+        PoseTrace trace = { std::move(name), hand, {}, {}, {}, {}, isResting };
+        const size_t samples = (size_t)(seconds * SAMPLE_RATE);
+        for (size_t i = 0; i < samples; ++i) {
+            const double time = (double)i / SAMPLE_RATE;
+            const glm::fmat4 headsetMatrix = GetHeadsetMatrix(time);
+            const glm::fvec3 smoothPos = GetHandPosition(headsetMatrix, getBodyOffset(time));
+            const glm::fvec3 tremor = 0.002f * glm::sin(glm::fvec3((float)(glm::two_pi<double>() * 9.0 * time)) + tremorPhase);
+            trace.headsetMatrices.emplace_back(headsetMatrix);
+            trace.smoothHandPositions.emplace_back(smoothPos);
+            trace.handPositions.emplace_back(smoothPos + tremor + glm::fvec3(jitter(rng), jitter(rng), jitter(rng)));
+            trace.labels.emplace_back(getLabel(time));
+        }
+        return trace;
+    }
+
+    // resting in front of the body, reaching to the slot and holding it there for a moment before going back, 0 is resting and 1 is in the slot
+    double GetReachAmount(double time) {
+        constexpr double REACH = 0.4;
+        constexpr double HOLD = 0.6;
+        constexpr double REST = 0.6;
+        const double t = std::fmod(time, REST + REACH + HOLD + REACH);
+        if (t < REST)
+            return 0.0;
+        if (t < REST + REACH)
+            return glm::smoothstep(0.0, 1.0, (t - REST) / REACH);
+        if (t < REST + REACH + HOLD)
+            return 1.0;
+        return 1.0 - glm::smoothstep(0.0, 1.0, (t - REST - REACH - HOLD) / REACH);
+    }
+
+    struct TraceResult {
+        uint32_t changes = 0;
+        uint32_t missed = 0;
+        std::vector<double> latenciesMs;
+    };
+
+    // how fast the slots that the smooth hand path goes through were recognized from the noisy one, and how often the recognized pose changed
+    TraceResult CompareWithSmoothPath(const std::vector<RecognizedPose>& recognized, const std::vector<RecognizedPose>& expected) {
+        TraceResult result;
+        for (size_t i = 1; i < recognized.size(); ++i) {
+            result.changes += recognized[i] != recognized[i - 1] ? 1 : 0;
+        }
+
+        for (size_t i = 1; i < expected.size(); ++i) {
+            if (expected[i].slot == expected[i - 1].slot)
+                continue;
+
+            size_t end = i + 1;
+            while (end < expected.size() && expected[end].slot == expected[i].slot)
+                ++end;
+            // slots that the hand only brushes past on its way to another one (e.g. the mouth when reaching over the shoulder) don't need to be recognized
+            if (end - i < MIN_SLOT_SAMPLES)
+                continue;
+            auto found = std::find_if(recognized.begin() + (ptrdiff_t)i, recognized.begin() + (ptrdiff_t)end, [&](const RecognizedPose& pose) { return pose.slot == expected[i].slot; });
+            if (found == recognized.begin() + (ptrdiff_t)end)
+                result.missed++;
+            else
+                result.latenciesMs.emplace_back((double)std::distance(recognized.begin() + (ptrdiff_t)i, found) * 1000.0 / SAMPLE_RATE);
+        }
+        return result;
+    }
+}
+
+// plays synthetic hand traces (reaching to each body slot, and resting right on the edge of a slot) with tracking noise and tremor
+// through the stateless gesture checks that used to run on each VPAD read and through the recognizer, and logs how often the recognized slot
+// changed and how long it took to recognize the slots that the smooth hand path went through.
+// the reaching traces are labelled with the slot that the hand was generated to hold, which the recognizer has to agree with.
+// the motion traces in traceDirectory (e.g. resources/motion_traces, can be null) have no labels for the body slots. body_slots_both_hands has
+// the hands reaching for the slots and the other traces are attacks, which shouldn't be mistaken for the slots that they swing past.
+// for those, each flag of the recognizer can only flip after the stateless flag flipped: the value has to cross the whole hysteresis band,
+// which takes it past the stateless threshold as well. so a flag of the recognizer never changes more often, but the slot they add up to can.
+// returns the amount of traces where the recognizer missed a slot, disagreed with a label, was more than 50 ms late, flickered or a flag
+// changed more often than without the hysteresis (which should always be zero)
+static uint64_t ValidateHandGestures(uint32_t seed, const char* traceDirectory) {
+    constexpr double MAX_LATENCY_MS = 50.0;
+    constexpr double REACH_SECONDS = 8.0;
+    constexpr double REST_SECONDS = 6.0;
+
+    std::mt19937 rng(seed);
+    const glm::fvec3 leftRest = { -0.2f, -0.4f, 0.35f };
+    const glm::fvec3 rightRest = { 0.2f, -0.4f, 0.35f };
+
+    std::vector<PoseTrace> traces;
+    auto addReach = [&](std::string name, OpenXR::EyeSide hand, glm::fvec3 slotOffset, BodySlot slot) {
+        const glm::fvec3 rest = hand == OpenXR::EyeSide::LEFT ? leftRest : rightRest;
+        auto getOffset = [=](double time) { return glm::mix(rest, slotOffset, (float)GetReachAmount(time)); };
+        auto getLabel = [=](double time) -> std::optional<BodySlot> {
+            const double amount = GetReachAmount(time);
+            return amount == 1.0 ? std::optional(slot) : amount == 0.0 ? std::optional(BodySlot::None) : std::nullopt;
+        };
+        traces.emplace_back(MakeTrace(std::move(name), hand, false, REACH_SECONDS, rng, getOffset, getLabel));
+    };
+    addReach("left hand to left shoulder", OpenXR::EyeSide::LEFT, { -0.15f, -0.05f, -0.1f }, BodySlot::LeftShoulder);
+    addReach("right hand to left shoulder", OpenXR::EyeSide::RIGHT, { -0.12f, -0.05f, -0.1f }, BodySlot::LeftShoulder);
+    addReach("left hand to right shoulder", OpenXR::EyeSide::LEFT, { 0.12f, -0.05f, -0.1f }, BodySlot::RightShoulder);
+    addReach("right hand to right shoulder", OpenXR::EyeSide::RIGHT, { 0.15f, -0.05f, -0.1f }, BodySlot::RightShoulder);
+    addReach("left hand to left waist", OpenXR::EyeSide::LEFT, { -0.2f, -0.6f, -0.05f }, BodySlot::LeftWaist);
+    addReach("right hand to left waist", OpenXR::EyeSide::RIGHT, { -0.15f, -0.6f, -0.05f }, BodySlot::LeftWaist);
+    addReach("right hand to right waist", OpenXR::EyeSide::RIGHT, { 0.2f, -0.6f, -0.05f }, BodySlot::RightWaist);
+    addReach("left hand to mouth", OpenXR::EyeSide::LEFT, { -0.03f, -0.08f, 0.08f }, BodySlot::Mouth);
+    addReach("right hand to mouth", OpenXR::EyeSide::RIGHT, { 0.03f, -0.08f, 0.08f }, BodySlot::Mouth);
+
+    // resting on the edge of a slot has no right answer, so these aren't labelled
+    auto addRest = [&](std::string name, OpenXR::EyeSide hand, glm::fvec3 offset) {
+        traces.emplace_back(MakeTrace(std::move(name), hand, true, REST_SECONDS, rng, [=](double) { return offset; }, [](double) { return std::optional<BodySlot>(); }));
+    };
+    addRest("right hand resting between the shoulders", OpenXR::EyeSide::RIGHT, { 0.0f, -0.05f, -0.12f });
+    addRest("right hand resting on the edge of the left shoulder", OpenXR::EyeSide::RIGHT, glm::normalize(glm::fvec3(-0.5f, -0.2f, -0.5f)) * 0.35f);
+    addRest("left hand resting at the back of the left waist", OpenXR::EyeSide::LEFT, { -0.2f, -0.6f, 0.05f });
+    addRest("left hand resting at the height of the waist", OpenXR::EyeSide::LEFT, { -0.2f, -0.45f, -0.05f });
+    addRest("left hand resting at the edge of the mouth", OpenXR::EyeSide::LEFT, { 0.0f, -0.2f, 0.0f });
+    addRest("left hand holding the shield at chest height", OpenXR::EyeSide::LEFT, { -0.2f, -0.3f, 0.35f });
+
+    uint64_t errors = 0;
+    for (const PoseTrace& trace : traces) {
+        HandGestureRecognizer recognizer;
+        std::vector<RecognizedPose> expected, stateless, recognized;
+        uint32_t mislabelled = 0;
+        for (size_t i = 0; i < trace.handPositions.size(); ++i) {
+            const glm::fmat4& headsetMatrix = trace.headsetMatrices[i];
+            const XrTime time = (XrTime)std::llround((double)i * 1e9 / SAMPLE_RATE);
+
+            expected.emplace_back(GetPose(GetStatelessGesture(trace.smoothHandPositions[i], headsetMatrix)));
+            stateless.emplace_back(GetPose(GetStatelessGesture(trace.handPositions[i], headsetMatrix)));
+
+            const glm::fvec3 otherHand = GetHandPosition(headsetMatrix, trace.hand == OpenXR::EyeSide::LEFT ? rightRest : leftRest);
+            recognizer.Update(time, headsetMatrix, trace.hand == OpenXR::EyeSide::LEFT ? trace.handPositions[i] : otherHand, trace.hand == OpenXR::EyeSide::RIGHT ? trace.handPositions[i] : otherHand);
+            recognized.emplace_back(GetPose(recognizer.GetGesture(trace.hand)));
+            mislabelled += trace.labels[i].has_value() && trace.labels[i] != recognizer.GetSlot(trace.hand) ? 1 : 0;
+        }
+
+        uint32_t expectedChanges = 0;
+        for (size_t i = 1; i < expected.size(); ++i) {
+            expectedChanges += expected[i] != expected[i - 1] ? 1 : 0;
+        }
+
+        const TraceResult statelessResult = CompareWithSmoothPath(stateless, expected);
+        const TraceResult recognizedResult = CompareWithSmoothPath(recognized, expected);
+        auto getAverage = [](const std::vector<double>& values) { return values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / (double)values.size(); };
+        auto getMax = [](const std::vector<double>& values) { return values.empty() ? 0.0 : std::ranges::max(values); };
+
+        // resting on an edge may settle on either side of it once, but shouldn't go back and forth
+        const bool failed = trace.isResting
+            ? recognizedResult.changes > 2
+            : recognizedResult.missed > 0 || mislabelled > 0 || recognizedResult.changes > expectedChanges || getMax(recognizedResult.latenciesMs) > MAX_LATENCY_MS;
+        errors += failed ? 1 : 0;
+
+        if (trace.isResting) {
+            Log::print<INFO>("Hand gestures, {}: stateless changed {} times, recognizer changed {} times{}",
+                trace.name, statelessResult.changes, recognizedResult.changes, failed ? " (FAILED)" : "");
+        }
+        else {
+            Log::print<INFO>("Hand gestures, {}: {} changes expected, stateless changed {} times with latency avg = {:.1f} max = {:.1f} ms, recognizer changed {} times with latency avg = {:.1f} max = {:.1f} ms, missed {} slots and disagreed with {} labelled samples{}",
+                trace.name, expectedChanges, statelessResult.changes, getAverage(statelessResult.latenciesMs), getMax(statelessResult.latenciesMs),
+                recognizedResult.changes, getAverage(recognizedResult.latenciesMs), getMax(recognizedResult.latenciesMs), recognizedResult.missed, mislabelled, failed ? " (FAILED)" : "");
+        }
+    }
+
+    std::error_code ec;
+    std::vector<std::filesystem::path> paths;
+    if (traceDirectory != nullptr) {
+        for (const auto& entry : std::filesystem::directory_iterator(traceDirectory, ec)) {
+            if (entry.is_regular_file() && entry.path().extension() == MotionTrace::FILE_EXTENSION) {
+                paths.emplace_back(entry.path());
+            }
+        }
+        std::ranges::sort(paths);
+    }
+
+    for (const std::filesystem::path& path : paths) {
+        std::optional<MotionTrace> trace = MotionTrace::Load(path);
+        if (!trace.has_value()) {
+            continue;
+        }
+
+        // the samples of both hands share their input time, so each hand gets its own recognizer
+        std::array<HandGestureRecognizer, 2> recognizers;
+        std::array<std::optional<HandGestureState>, 2> lastStateless, lastRecognized;
+        std::array<uint32_t, GESTURE_FLAGS.size()> statelessFlips = {}, recognizedFlips = {};
+        uint32_t statelessChanges = 0;
+        uint32_t recognizedChanges = 0;
+        for (const MotionTrace::Sample& sample : trace->samples) {
+            const uint8_t side = sample.side & 1;
+
+            // like processHandGesture, which starts over once the hand can be tracked again
+            if ((sample.location.locationFlags & XR_SPACE_LOCATION_POSITION_VALID_BIT) == 0) {
+                recognizers[side].Reset(sample.inputTime);
+                lastStateless[side].reset();
+                lastRecognized[side].reset();
+                continue;
+            }
+
+            const glm::fmat4 headsetMatrix = ToMat4(sample.headsetPosition, sample.headsetRotation);
+            const glm::fvec3 handPos = ToGLM(sample.location.pose.position);
+            if (!recognizers[side].Update(sample.inputTime, headsetMatrix, handPos, handPos)) {
+                continue;
+            }
+
+            const HandGestureState stateless = GetStatelessGesture(handPos, headsetMatrix);
+            const HandGestureState recognized = recognizers[side].GetGesture((OpenXR::EyeSide)side);
+            if (lastStateless[side].has_value()) {
+                for (size_t flag = 0; flag < GESTURE_FLAGS.size(); ++flag) {
+                    statelessFlips[flag] += (*lastStateless[side]).*GESTURE_FLAGS[flag] != stateless.*GESTURE_FLAGS[flag] ? 1 : 0;
+                    recognizedFlips[flag] += (*lastRecognized[side]).*GESTURE_FLAGS[flag] != recognized.*GESTURE_FLAGS[flag] ? 1 : 0;
+                }
+                statelessChanges += GetPose(*lastStateless[side]) != GetPose(stateless) ? 1 : 0;
+                recognizedChanges += GetPose(*lastRecognized[side]) != GetPose(recognized) ? 1 : 0;
+            }
+            lastStateless[side] = stateless;
+            lastRecognized[side] = recognized;
+        }
+
+        uint32_t flagsFlippedMoreOften = 0;
+        for (size_t flag = 0; flag < GESTURE_FLAGS.size(); ++flag) {
+            flagsFlippedMoreOften += recognizedFlips[flag] > statelessFlips[flag] ? 1 : 0;
+        }
+        const bool failed = flagsFlippedMoreOften > 0;
+        errors += failed ? 1 : 0;
+        Log::print<INFO>("Hand gestures, motion trace {} ({} samples): stateless changed {} times, recognizer changed {} times, {} flags flipped more often with the hysteresis{}",
+            trace->name, trace->samples.size(), statelessChanges, recognizedChanges, flagsFlippedMoreOften, failed ? " (FAILED)" : "");
+    }
+    return errors;
+}
+
+// a hand that was in a slot leaves it when the recognizer is reset (like when tracking got lost or the game opened a menu),
+// and the next sample gets recognized without the hysteresis, even if it has the same input time as the last one.
+// returns the amount of failed checks
+static uint64_t CheckHandGestureReset() {
+    HandGestureRecognizer recognizer;
+    const glm::fmat4 headsetMatrix = GetHeadsetMatrix(0.0);
+    const glm::fvec3 rest = GetHandPosition(headsetMatrix, { 0.2f, -0.4f, 0.35f });
+    const glm::fvec3 shoulder = GetHandPosition(headsetMatrix, { -0.15f, -0.05f, -0.1f });
+    // inside the hysteresis band around the edge of the shoulder slot, so it's only in the slot when it was in it already
+    const glm::fvec3 shoulderEdge = GetHandPosition(headsetMatrix, glm::normalize(glm::fvec3(-0.5f, -0.2f, -0.5f)) * 0.355f);
+
+    uint64_t errors = 0;
+    recognizer.Update(1, headsetMatrix, shoulder, rest);
+    recognizer.Update(2, headsetMatrix, shoulderEdge, rest);
+    errors += recognizer.GetSlot(OpenXR::EyeSide::LEFT) != BodySlot::LeftShoulder ? 1 : 0;
+
+    const uint64_t eventsBefore = recognizer.GetEventCount();
+    uint64_t cursor = eventsBefore;
+    recognizer.Reset(2);
+    bool leftShoulder = false;
+    recognizer.ConsumeEvents(cursor, [&](const HandGestureRecognizer::Event& event) {
+        leftShoulder = event.hand == OpenXR::EyeSide::LEFT && event.slot == BodySlot::LeftShoulder && !event.entered;
+    });
+    errors += recognizer.GetEventCount() != eventsBefore + 1 || !leftShoulder ? 1 : 0;
+    errors += recognizer.GetSlot(OpenXR::EyeSide::LEFT) != BodySlot::None ? 1 : 0;
+
+    errors += recognizer.Update(2, headsetMatrix, shoulderEdge, rest) ? 0 : 1;
+    errors += recognizer.GetSlot(OpenXR::EyeSide::LEFT) != BodySlot::None ? 1 : 0;
+
+    Log::print<INFO>("Hand gestures, reset: {} failed checks", errors);
+    return errors;
+}
+
+BETTERVR_TEST(HandGestures, []() {
+    return ValidateHandGestures(1, (Tests::GetSourceDirectory() / "resources/motion_traces").string().c_str()) + CheckHandGestureReset();
+});
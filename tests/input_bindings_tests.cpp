@@ -0,0 +1,148 @@
+#include "tests.h"
+#include "hooking/input_bindings.h"
+#include <random>
+
+// plays back pseudo-random input sequences (the same ones for every seed) through the branches that hook_InjectXRInput used to have
+// and through the default profile, returns the amount of polls where the VPAD buttons or the game state they changed differ
+static uint64_t ValidateInputBindings(uint32_t seed, uint32_t polls) {
+    std::optional<InputBindings> bindings = InputBindings::Compile(InputBindings::GetDefaultProfile(), "default input bindings");
+    if (!bindings.has_value()) {
+        return 1;
+    }
+
+    // what hook_InjectXRInput used to do for these bindings
+    auto legacyBindings = [](const OpenXR::InputState& inputs, OpenXR::GameState& gameState, bool dpadMenuOpen, bool leftHandOverSlot, bool rightHandOverSlot) {
+        auto mapXRButtonToVpad = [](const XrActionStateBoolean& state, VPADButtons mapping) -> uint32_t {
+            return state.currentState ? mapping : 0;
+        };
+
+        uint32_t buttonHold = 0;
+        if (gameState.in_game) {
+            if (!gameState.prevent_inputs) {
+                buttonHold |= mapXRButtonToVpad(inputs.inGame.jump_cancel, VPAD_BUTTON_X);
+                if (inputs.inGame.crouch_scopeState.lastEvent == ButtonState::Event::LongPress) {
+                    buttonHold |= VPAD_BUTTON_STICK_R;
+                }
+                if (inputs.shared.inventory_mapState.lastEvent == ButtonState::Event::ShortPress) {
+                    buttonHold |= VPAD_BUTTON_PLUS;
+                    gameState.map_open = false;
+                }
+                if (inputs.shared.inventory_mapState.lastEvent == ButtonState::Event::LongPress) {
+                    buttonHold |= VPAD_BUTTON_MINUS;
+                    gameState.map_open = true;
+                }
+            }
+            if (inputs.inGame.crouch_scopeState.lastEvent == ButtonState::Event::ShortPress) {
+                buttonHold |= VPAD_BUTTON_STICK_L;
+            }
+            if (inputs.inGame.useRune_runeMenuState.lastEvent == ButtonState::Event::ShortPress) {
+                buttonHold |= VPAD_BUTTON_L;
+                gameState.last_equip_type_held = EquipType::SheikahSlate;
+            }
+            if (gameState.is_climbing || gameState.is_paragliding) {
+                buttonHold |= mapXRButtonToVpad(inputs.inGame.run_interact, VPAD_BUTTON_B);
+            }
+            else if (gameState.is_riding_mount) {
+                buttonHold |= mapXRButtonToVpad(inputs.inGame.run_interact, VPAD_BUTTON_A);
+                if (inputs.inGame.grab[1].currentState && !rightHandOverSlot)
+                    buttonHold |= VPAD_BUTTON_A;
+                if (inputs.inGame.grab[0].currentState && !leftHandOverSlot)
+                    buttonHold |= VPAD_BUTTON_B;
+            }
+            else {
+                if (inputs.inGame.runState.lastEvent == ButtonState::Event::LongPress)
+                    buttonHold |= VPAD_BUTTON_B;
+                else
+                    buttonHold |= mapXRButtonToVpad(inputs.inGame.run_interact, VPAD_BUTTON_A);
+            }
+        }
+        else {
+            if (!dpadMenuOpen)
+                buttonHold |= mapXRButtonToVpad(inputs.inMenu.sort, VPAD_BUTTON_Y);
+            if (!gameState.prevent_inputs) {
+                buttonHold |= mapXRButtonToVpad(inputs.inMenu.back, VPAD_BUTTON_B);
+                if (gameState.map_open)
+                    buttonHold |= mapXRButtonToVpad(inputs.shared.inventory_map, VPAD_BUTTON_MINUS);
+                else
+                    buttonHold |= mapXRButtonToVpad(inputs.shared.inventory_map, VPAD_BUTTON_PLUS);
+            }
+            buttonHold |= mapXRButtonToVpad(inputs.inMenu.select, VPAD_BUTTON_A);
+            buttonHold |= mapXRButtonToVpad(inputs.inMenu.leftTrigger, VPAD_BUTTON_L);
+            buttonHold |= mapXRButtonToVpad(inputs.inMenu.rightTrigger, VPAD_BUTTON_R);
+            if (inputs.inMenu.holdState.lastEvent == ButtonState::Event::ShortPress)
+                buttonHold |= VPAD_BUTTON_X;
+        }
+        return buttonHold;
+    };
+
+    // the inputs and state change a little with each poll, like they would while playing
+    std::mt19937 rng(seed);
+    std::bernoulli_distribution flip(0.15);
+    std::discrete_distribution<int> event({ 0.8, 0.1, 0.1 });
+    auto toggle = [&](auto& value) { if (flip(rng)) value = !value; };
+
+    OpenXR::InputState inputs = {};
+    OpenXR::GameState gameState = {};
+    gameState.in_game = true;
+    bool dpadMenuOpen = false;
+    bool leftHandOverSlot = false;
+    bool rightHandOverSlot = false;
+
+    uint64_t mismatches = 0;
+    double legacyNs = 0.0;
+    double bindingsNs = 0.0;
+    for (uint32_t poll = 0; poll < polls; ++poll) {
+        if (std::bernoulli_distribution(0.02)(rng)) {
+            gameState.in_game = !gameState.in_game;
+        }
+        for (XrActionStateBoolean* action : { &inputs.inGame.crouch_scope, &inputs.inGame.jump_cancel, &inputs.inGame.run_interact, &inputs.inGame.useRune_dpadMenu, &inputs.shared.inventory_map,
+                                              &inputs.inMenu.select, &inputs.inMenu.back, &inputs.inMenu.sort, &inputs.inMenu.hold, &inputs.inMenu.leftTrigger, &inputs.inMenu.rightTrigger }) {
+            if (flip(rng)) action->currentState = !action->currentState;
+        }
+        for (XrActionStateFloat& grab : inputs.inGame.grab) {
+            if (flip(rng)) grab.currentState = grab.currentState == 0.0f ? 1.0f : 0.0f;
+        }
+        for (ButtonState* state : { &inputs.inGame.crouch_scopeState, &inputs.inGame.runState, &inputs.inGame.useRune_runeMenuState, &inputs.shared.inventory_mapState, &inputs.inMenu.holdState }) {
+            state->lastEvent = (ButtonState::Event)event(rng);
+        }
+        toggle(gameState.prevent_inputs);
+        toggle(gameState.is_climbing);
+        toggle(gameState.is_paragliding);
+        toggle(gameState.is_riding_mount);
+        toggle(gameState.map_open);
+        toggle(dpadMenuOpen);
+        toggle(leftHandOverSlot);
+        toggle(rightHandOverSlot);
+
+        uint32_t conditions = gameState.in_game ? InputBindings::IN_GAME : InputBindings::IN_MENU;
+        conditions |= gameState.prevent_inputs ? InputBindings::PREVENTING_INPUTS : 0;
+        conditions |= (gameState.is_climbing || gameState.is_paragliding) ? InputBindings::CLIMBING : 0;
+        conditions |= gameState.is_riding_mount ? InputBindings::RIDING : 0;
+        conditions |= gameState.map_open ? InputBindings::MAP_OPEN : 0;
+        conditions |= dpadMenuOpen ? InputBindings::DPAD_MENU_OPEN : 0;
+        conditions |= leftHandOverSlot ? InputBindings::LEFT_HAND_OVER_SLOT : 0;
+        conditions |= rightHandOverSlot ? InputBindings::RIGHT_HAND_OVER_SLOT : 0;
+
+        OpenXR::GameState legacyGameState = gameState;
+        auto start = std::chrono::high_resolution_clock::now();
+        uint32_t legacyButtons = legacyBindings(inputs, legacyGameState, dpadMenuOpen, leftHandOverSlot, rightHandOverSlot);
+        legacyNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        OpenXR::GameState bindingsGameState = gameState;
+        start = std::chrono::high_resolution_clock::now();
+        uint32_t buttons = bindings->Evaluate(inputs, bindingsGameState, conditions);
+        bindingsNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        const bool matches = buttons == legacyButtons && bindingsGameState.map_open == legacyGameState.map_open && bindingsGameState.last_equip_type_held == legacyGameState.last_equip_type_held;
+        if (!matches && mismatches++ < 10) {
+            Log::print<WARNING>("Input bindings differ on poll {}: buttons {:#x} instead of {:#x}", poll, buttons, legacyButtons);
+        }
+        gameState = legacyGameState;
+    }
+
+    Log::print<INFO>("Input bindings validation ({} polls, {} instructions): branches = {:.1f} ns/poll, bindings = {:.1f} ns/poll, {} mismatches",
+        polls, bindings->GetInstructionCount(), polls > 0 ? legacyNs / polls : 0.0, polls > 0 ? bindingsNs / polls : 0.0, mismatches);
+    return mismatches;
+}
+
+BETTERVR_TEST(InputBindings, []() { return ValidateInputBindings(1, 100'000); });
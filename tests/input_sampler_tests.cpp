@@ -0,0 +1,89 @@
+#include "tests.h"
+#include "instance.h"
+#include "rendering/input_sampler.h"
+#include "rendering/openxr_mock.h"
+
+// presses crouch_scope through the mock runtime's script while a simulated XR thread samples the actions through the real InputSampler at
+// the mock's display rate, like RND_Renderer::StartFrame does, and this thread reads them at gameFps like hook_InjectXRInput does.
+// the XR thread usually samples a release a few times before the game reads it, which used to replace its ShortPress before the game saw it.
+// returns the amount of presses that the game saw as the wrong event, more than once or not at all (which should always be zero)
+static uint64_t CheckInputSamplerPresses(uint32_t gameFps, uint32_t shortPresses) {
+    using namespace std::chrono_literals;
+    constexpr auto SHORT_PRESS_DURATION = 80ms;
+    constexpr auto LONG_PRESS_DURATION = 400ms;
+    constexpr auto RELEASE_DURATION = 150ms;
+
+    OpenXR& xr = Tests::GetMockSession();
+    xr.m_input.store(OpenXR::InputState{});
+
+    std::atomic_bool pressed = false;
+    MockXRRuntime::Script script = MockXRRuntime::DefaultScript();
+    script.actionValue = [&pressed](std::string_view actionName, XrPath subactionPath, XrTime time) -> glm::fvec2 {
+        return { actionName == "crouch_scope" && pressed.load() ? 1.0f : 0.0f, 0.0f };
+    };
+    const auto displayPeriod = std::chrono::nanoseconds(script.displayPeriod);
+    MockXRRuntime::SetScript(std::move(script));
+
+    std::atomic_bool stop = false;
+    std::thread xrThread([&]() {
+        while (!stop.load()) {
+            InputSampler::SampleOnFrameStart(MockXRRuntime::GetRuntimeTime() + 2 * displayPeriod.count(), false);
+            std::this_thread::sleep_for(displayPeriod);
+        }
+    });
+
+    struct Reads {
+        uint32_t shortPresses = 0;
+        uint32_t longPresses = 0;
+        uint32_t total = 0;
+    };
+    const auto gamePeriod = std::chrono::nanoseconds(1'000'000'000 / std::max(gameFps, 1u));
+    auto readVPAD = [&](std::chrono::nanoseconds duration) {
+        Reads reads;
+        const auto end = std::chrono::steady_clock::now() + duration;
+        while (std::chrono::steady_clock::now() < end) {
+            OpenXR::InputState input = InputSampler::SampleBeforeVPADRead(false);
+            reads.shortPresses += input.inGame.crouch_scopeState.lastEvent == ButtonState::Event::ShortPress ? 1 : 0;
+            reads.longPresses += input.inGame.crouch_scopeState.lastEvent == ButtonState::Event::LongPress ? 1 : 0;
+            reads.total++;
+            InputSampler::StoreAfterVPADRead(input);
+            std::this_thread::sleep_for(gamePeriod);
+        }
+        return reads;
+    };
+
+    // lets the XR thread start the first frame, the VPAD reads before that don't sample
+    readVPAD(RELEASE_DURATION);
+
+    uint64_t errors = 0;
+    uint32_t seenShortPresses = 0;
+    for (uint32_t i = 0; i < shortPresses; ++i) {
+        pressed = true;
+        Reads whilePressed = readVPAD(SHORT_PRESS_DURATION);
+        pressed = false;
+        Reads afterRelease = readVPAD(RELEASE_DURATION);
+
+        const uint32_t seen = whilePressed.shortPresses + afterRelease.shortPresses;
+        seenShortPresses += seen;
+        errors += (seen != 1 || whilePressed.longPresses + afterRelease.longPresses != 0) ? 1 : 0;
+    }
+
+    // held past the threshold it's reported as a long press by every read, and no short press follows when it's released
+    pressed = true;
+    Reads whileHeld = readVPAD(LONG_PRESS_DURATION);
+    pressed = false;
+    Reads afterLongRelease = readVPAD(RELEASE_DURATION);
+    errors += (whileHeld.longPresses == 0 || whileHeld.shortPresses != 0) ? 1 : 0;
+    errors += afterLongRelease.shortPresses != 0 ? 1 : 0;
+
+    stop = true;
+    xrThread.join();
+    MockXRRuntime::SetScript(MockXRRuntime::DefaultScript());
+
+    Log::print<INFO>("Input sampler ({} FPS game, {:.0f} Hz XR): {} short presses seen for {} presses, long press seen by {}/{} reads while held, input age avg = {:.1f} ms, {:.0f}% of VPAD reads sampled, {} errors",
+        gameFps, 1e9 / (double)displayPeriod.count(), seenShortPresses, shortPresses, whileHeld.longPresses, whileHeld.total,
+        InputSampler::GetAverageInputAgeMs(), InputSampler::GetVPADSampleRatio() * 100.0, errors);
+    return errors;
+}
+
+BETTERVR_TEST(InputSampler, []() { return CheckInputSamplerPresses(30, 10); });
@@ -0,0 +1,136 @@
+#include "tests.h"
+#include "instance.h"
+#include "rendering/openxr_mock.h"
+#include "rendering/renderer.h"
+
+namespace {
+    // StartFrame needs D3D12 and swapchains, this only runs the part of it that locates the views on the mock session
+    class LatchTestRenderer : public RND_Renderer {
+    public:
+        using RND_Renderer::RND_Renderer;
+
+        void StartMockFrame() {
+            XrFrameWaitInfo waitFrameInfo = { XR_TYPE_FRAME_WAIT_INFO };
+            checkXRResult(xrWaitFrame(m_session, &waitFrameInfo, &m_frameState), "Failed to wait for the mock frame!");
+            m_isInitialized = true;
+            this->LocateFrameViews(m_frameState.predictedDisplayTime);
+        }
+
+        // the views from the last StartFrame, which the camera hooks used before the views got latched
+        std::optional<std::array<XrView, 2>> GetStartFrameViews() const {
+            std::scoped_lock lock(m_latchMutex);
+            return m_currViews;
+        }
+    };
+
+    // the head turns at a constant rate, and the mock's head pose is the one at the moment it's located instead of a predicted one
+    // so the yaw of a view tells when it was sampled, and how old the pose was when the game read it
+    constexpr float YAW_RATE = 0.25f; // radians per second
+
+    bool IsSamePose(const XrPosef& a, const XrPosef& b) {
+        return ToGLM(a.position) == ToGLM(b.position) && ToGLM(a.orientation) == ToGLM(b.orientation);
+    }
+
+    XrTime GetSampleTime(const XrView& view, XrTime start) {
+        const XrQuaternionf& q = view.pose.orientation;
+        const float yaw = 2.0f * std::atan2(q.y, q.w);
+        return start + (XrTime)((double)yaw / YAW_RATE * 1e9);
+    }
+}
+
+// a simulated XR thread starts frames at the mock's display rate like RND_Renderer::StartFrame, while this thread plays the game at gameFps
+// each game frame latches the views from the left eye's camera hook, renders the left eye and then reads the views again for the right eye.
+// returns the amount of frames where the eyes didn't use the same views, and one more if latching didn't make the poses that the game used newer
+static uint64_t CheckLateLatching(uint32_t gameFps, uint32_t gameFrames) {
+    using namespace std::chrono_literals;
+
+    OpenXR& xr = Tests::GetMockSession();
+    const XrTime start = MockXRRuntime::GetRuntimeTime();
+    MockXRRuntime::Script script = MockXRRuntime::DefaultScript();
+    script.headPose = [start](XrTime displayTime) -> XrPosef {
+        const float seconds = (float)((double)(MockXRRuntime::GetRuntimeTime() - start) / 1e9);
+        return { ToXR(glm::angleAxis(YAW_RATE * seconds, glm::fvec3(0.0f, 1.0f, 0.0f))), { 0.0f, 1.7f, 0.0f } };
+    };
+    MockXRRuntime::SetScript(std::move(script));
+    const MockXRRuntime::CallCounts countsBefore = MockXRRuntime::GetCallCounts();
+
+    uint64_t mismatchedEyes = 0;
+    double startFrameAgeMs = 0.0;
+    double latchedAgeMs = 0.0;
+    double rightEyeAgeMs = 0.0;
+    uint32_t latches = 0;
+    {
+        // the renderer begins the session again, and ends it when it's destroyed
+        LatchTestRenderer renderer(xr.GetSession());
+
+        std::atomic_bool stop = false;
+        std::thread xrThread([&]() {
+            while (!stop.load()) {
+                renderer.StartMockFrame();
+            }
+        });
+
+        // lets the XR thread locate the views of its first frame
+        std::this_thread::sleep_for(50ms);
+
+        const auto gamePeriod = std::chrono::nanoseconds(1'000'000'000 / std::max(gameFps, 1u));
+        for (uint32_t i = 0; i < gameFrames; ++i) {
+            const auto frameStart = std::chrono::steady_clock::now();
+
+            // the game logic before the camera update takes a different amount of time each frame
+            std::this_thread::sleep_for(gamePeriod * (1 + i % 4) / 10);
+
+            auto startFrameViews = renderer.GetStartFrameViews();
+            renderer.LateLatchViews();
+            auto leftViews = renderer.GetViewsUsedByGame();
+            const XrTime leftReadTime = MockXRRuntime::GetRuntimeTime();
+            if (!startFrameViews || !leftViews) {
+                mismatchedEyes++;
+                continue;
+            }
+            startFrameAgeMs += (double)(leftReadTime - GetSampleTime((*startFrameViews)[OpenXR::EyeSide::LEFT], start)) / 1e6;
+            latchedAgeMs += (double)(leftReadTime - GetSampleTime((*leftViews)[OpenXR::EyeSide::LEFT], start)) / 1e6;
+            latches++;
+
+            // rendering the left eye takes long enough for the XR thread to start its next frame before the right eye's camera hook
+            std::this_thread::sleep_for(gamePeriod * 4 / 10);
+
+            auto rightViews = renderer.GetViewsUsedByGame();
+            auto rightPose = renderer.GetPose(OpenXR::EyeSide::RIGHT);
+            const XrTime rightReadTime = MockXRRuntime::GetRuntimeTime();
+            const bool sameViews = rightViews && rightPose
+                && IsSamePose((*rightViews)[OpenXR::EyeSide::RIGHT].pose, (*leftViews)[OpenXR::EyeSide::RIGHT].pose)
+                && IsSamePose(rightPose.value(), (*leftViews)[OpenXR::EyeSide::RIGHT].pose);
+            mismatchedEyes += sameViews ? 0 : 1;
+            if (rightViews) {
+                rightEyeAgeMs += (double)(rightReadTime - GetSampleTime((*rightViews)[OpenXR::EyeSide::RIGHT], start)) / 1e6;
+            }
+
+            std::this_thread::sleep_until(frameStart + gamePeriod);
+        }
+
+        stop = true;
+        xrThread.join();
+    }
+
+    // the renderer ended the shared mock session, the tests after this one still need it to be running
+    XrSessionBeginInfo beginInfo = { XR_TYPE_SESSION_BEGIN_INFO };
+    beginInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    checkXRResult(xrBeginSession(xr.GetSession(), &beginInfo), "Failed to begin the mock session again!");
+    MockXRRuntime::SetScript(MockXRRuntime::DefaultScript());
+
+    const MockXRRuntime::CallCounts countsAfter = MockXRRuntime::GetCallCounts();
+    const double frames = (double)std::max(latches, 1u);
+    startFrameAgeMs /= frames;
+    latchedAgeMs /= frames;
+    rightEyeAgeMs /= frames;
+    const uint64_t errors = mismatchedEyes + (latches == 0 || latchedAgeMs >= startFrameAgeMs ? 1 : 0);
+
+    Log::print<INFO>("Late latching ({} FPS game, {} XR frames): head pose age when the camera is written = {:.2f} ms from StartFrame vs {:.2f} ms latched, {:.2f} ms for the right eye, {} xrLocateViews calls, {} frames with mismatched eyes, {} errors",
+        gameFps, countsAfter.waitFrame - countsBefore.waitFrame, startFrameAgeMs, latchedAgeMs, rightEyeAgeMs, countsAfter.locateViews - countsBefore.locateViews, mismatchedEyes, errors);
+    return errors;
+}
+
+BETTERVR_TEST(LateLatching, []() {
+    return CheckLateLatching(20, 30) + CheckLateLatching(30, 45) + CheckLateLatching(60, 90);
+});
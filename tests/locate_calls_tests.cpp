@@ -0,0 +1,44 @@
+#include "tests.h"
+#include "instance.h"
+#include "rendering/openxr_mock.h"
+
+// samples the actions for a number of frames on the mock session, like RND_Renderer::StartFrame does through InputSampler.
+// before the hands were batched, each frame located both hands and the head space with three xrLocateSpace calls, even though the head
+// pose that the mod uses comes from xrLocateViews. it should be a single batched call for the hands, and since the mock runtime supports
+// OpenXR 1.1 that should be the core xrLocateSpaces instead of xrLocateSpacesKHR.
+// returns the amount of frames that made any other locate calls, plus one if the extension was used instead of the core function
+static uint64_t CheckLocateCallsPerFrame(uint32_t frames) {
+    constexpr uint64_t LOCATE_CALLS_BEFORE_BATCHING = 3;
+
+    OpenXR& xr = Tests::GetMockSession();
+    if (!xr.SupportsBatchedLocateSpaces()) {
+        Log::print<ERROR>("The mock runtime didn't provide xrLocateSpaces or XR_KHR_locate_spaces");
+        return 1;
+    }
+
+    uint64_t errors = 0;
+    uint64_t locateCalls = 0;
+    const MockXRRuntime::CallCounts countsBefore = MockXRRuntime::GetCallCounts();
+    for (uint32_t i = 0; i < frames; ++i) {
+        const MockXRRuntime::CallCounts frameBefore = MockXRRuntime::GetCallCounts();
+        xr.OnFrameStart();
+        xr.UpdateActions(MockXRRuntime::GetRuntimeTime() + 2 * MockXRRuntime::DefaultScript().displayPeriod, false);
+        const MockXRRuntime::CallCounts frameAfter = MockXRRuntime::GetCallCounts();
+
+        const uint64_t locateSpace = frameAfter.locateSpace - frameBefore.locateSpace;
+        const uint64_t locateSpaces = frameAfter.locateSpaces - frameBefore.locateSpaces;
+        locateCalls += locateSpace + locateSpaces;
+        errors += (locateSpace != 0 || locateSpaces != 1) ? 1 : 0;
+    }
+    xr.OnFrameStart();
+    errors += xr.GetLastFrameLocateCalls() != 1 ? 1 : 0;
+    const MockXRRuntime::CallCounts countsAfter = MockXRRuntime::GetCallCounts();
+    errors += (xr.GetApiVersion() < XR_MAKE_VERSION(1, 1, 0) || countsAfter.locateSpacesKHR != countsBefore.locateSpacesKHR) ? 1 : 0;
+
+    Log::print<INFO>("Locate calls: {:.2f} per frame (was {}) over {} frames, xrLocateSpace = {}, xrLocateSpaces = {} ({} through the extension), {} errors",
+        (double)locateCalls / (double)std::max(frames, 1u), LOCATE_CALLS_BEFORE_BATCHING, frames,
+        countsAfter.locateSpace - countsBefore.locateSpace, countsAfter.locateSpaces - countsBefore.locateSpaces, countsAfter.locateSpacesKHR - countsBefore.locateSpacesKHR, errors);
+    return errors;
+}
+
+BETTERVR_TEST(LocateCalls, []() { return CheckLocateCallsPerFrame(100); });
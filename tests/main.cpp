@@ -0,0 +1,45 @@
+#include "tests.h"
+
+namespace Tests {
+    std::vector<Test>& GetTests() {
+        static std::vector<Test> s_tests;
+        return s_tests;
+    }
+}
+
+// runs every test, or only the ones named on the command line, and returns how many of them failed
+int main(int argc, char** argv) {
+    std::vector<Tests::Test>& tests = Tests::GetTests();
+    std::ranges::sort(tests, {}, &Tests::Test::name);
+
+    std::vector<std::string_view> selected(argv + 1, argv + argc);
+    for (std::string_view name : selected) {
+        if (std::ranges::find(tests, name, &Tests::Test::name) == tests.end()) {
+            Log::print<ERROR>("Unknown test {}", name);
+            return 1;
+        }
+    }
+
+    int failedTests = 0;
+    for (const Tests::Test& test : tests) {
+        if (!selected.empty() && std::ranges::find(selected, test.name) == selected.end()) {
+            continue;
+        }
+
+        Log::print<INFO>("Running {}...", test.name);
+        uint64_t failures = 0;
+        try {
+            failures = test.run();
+        }
+        catch (const std::exception& e) {
+            Log::print<ERROR>("{} threw an exception: {}", test.name, e.what());
+            failures = 1;
+        }
+
+        if (failures != 0) {
+            Log::print<ERROR>("{} failed with {} mismatches", test.name, failures);
+            failedTests++;
+        }
+    }
+    return failedTests;
+}
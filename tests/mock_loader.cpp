@@ -0,0 +1,92 @@
+#include "tests.h"
+#include "instance.h"
+#include "rendering/openxr_mock.h"
+
+// BetterVR_Tests doesn't link the OpenXR loader, these take its place and send every OpenXR call the mod makes straight to the mock runtime.
+// That way the tests can script the mock and read its call counts in the same process, without going through XR_RUNTIME_JSON.
+namespace {
+    template <typename PFN>
+    PFN GetMockFunction(const char* name) {
+        PFN_xrVoidFunction function = nullptr;
+        MockXRRuntime::GetInstanceProcAddr(XR_NULL_HANDLE, name, &function);
+        if (function == nullptr) {
+            Log::print<ERROR>("The mock runtime doesn't implement {}", name);
+            std::abort();
+        }
+        return reinterpret_cast<PFN>(function);
+    }
+}
+
+#define MOCK_LOADER_FUNCTION(name, params, args) \
+    extern "C" XRAPI_ATTR XrResult XRAPI_CALL name params { \
+        static const PFN_##name s_function = GetMockFunction<PFN_##name>(#name); \
+        return s_function args; \
+    }
+
+MOCK_LOADER_FUNCTION(xrEnumerateInstanceExtensionProperties, (const char* layerName, uint32_t propertyCapacityInput, uint32_t* propertyCountOutput, XrExtensionProperties* properties), (layerName, propertyCapacityInput, propertyCountOutput, properties))
+MOCK_LOADER_FUNCTION(xrCreateInstance, (const XrInstanceCreateInfo* createInfo, XrInstance* instance), (createInfo, instance))
+MOCK_LOADER_FUNCTION(xrDestroyInstance, (XrInstance instance), (instance))
+MOCK_LOADER_FUNCTION(xrGetInstanceProperties, (XrInstance instance, XrInstanceProperties* instanceProperties), (instance, instanceProperties))
+MOCK_LOADER_FUNCTION(xrGetSystem, (XrInstance instance, const XrSystemGetInfo* getInfo, XrSystemId* systemId), (instance, getInfo, systemId))
+MOCK_LOADER_FUNCTION(xrGetSystemProperties, (XrInstance instance, XrSystemId systemId, XrSystemProperties* properties), (instance, systemId, properties))
+MOCK_LOADER_FUNCTION(xrGetViewConfigurationProperties, (XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, XrViewConfigurationProperties* configurationProperties), (instance, systemId, viewConfigurationType, configurationProperties))
+MOCK_LOADER_FUNCTION(xrEnumerateViewConfigurationViews, (XrInstance instance, XrSystemId systemId, XrViewConfigurationType viewConfigurationType, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrViewConfigurationView* views), (instance, systemId, viewConfigurationType, viewCapacityInput, viewCountOutput, views))
+MOCK_LOADER_FUNCTION(xrPollEvent, (XrInstance instance, XrEventDataBuffer* eventData), (instance, eventData))
+MOCK_LOADER_FUNCTION(xrStringToPath, (XrInstance instance, const char* pathString, XrPath* path), (instance, pathString, path))
+MOCK_LOADER_FUNCTION(xrCreateSession, (XrInstance instance, const XrSessionCreateInfo* createInfo, XrSession* session), (instance, createInfo, session))
+MOCK_LOADER_FUNCTION(xrDestroySession, (XrSession session), (session))
+MOCK_LOADER_FUNCTION(xrBeginSession, (XrSession session, const XrSessionBeginInfo* beginInfo), (session, beginInfo))
+MOCK_LOADER_FUNCTION(xrRequestExitSession, (XrSession session), (session))
+MOCK_LOADER_FUNCTION(xrEndSession, (XrSession session), (session))
+MOCK_LOADER_FUNCTION(xrCreateReferenceSpace, (XrSession session, const XrReferenceSpaceCreateInfo* createInfo, XrSpace* space), (session, createInfo, space))
+MOCK_LOADER_FUNCTION(xrCreateActionSpace, (XrSession session, const XrActionSpaceCreateInfo* createInfo, XrSpace* space), (session, createInfo, space))
+MOCK_LOADER_FUNCTION(xrDestroySpace, (XrSpace space), (space))
+MOCK_LOADER_FUNCTION(xrLocateSpace, (XrSpace space, XrSpace baseSpace, XrTime time, XrSpaceLocation* location), (space, baseSpace, time, location))
+MOCK_LOADER_FUNCTION(xrLocateViews, (XrSession session, const XrViewLocateInfo* viewLocateInfo, XrViewState* viewState, uint32_t viewCapacityInput, uint32_t* viewCountOutput, XrView* views), (session, viewLocateInfo, viewState, viewCapacityInput, viewCountOutput, views))
+MOCK_LOADER_FUNCTION(xrCreateActionSet, (XrInstance instance, const XrActionSetCreateInfo* createInfo, XrActionSet* actionSet), (instance, createInfo, actionSet))
+MOCK_LOADER_FUNCTION(xrCreateAction, (XrActionSet actionSet, const XrActionCreateInfo* createInfo, XrAction* action), (actionSet, createInfo, action))
+MOCK_LOADER_FUNCTION(xrSuggestInteractionProfileBindings, (XrInstance instance, const XrInteractionProfileSuggestedBinding* suggestedBindings), (instance, suggestedBindings))
+MOCK_LOADER_FUNCTION(xrAttachSessionActionSets, (XrSession session, const XrSessionActionSetsAttachInfo* attachInfo), (session, attachInfo))
+MOCK_LOADER_FUNCTION(xrSyncActions, (XrSession session, const XrActionsSyncInfo* syncInfo), (session, syncInfo))
+MOCK_LOADER_FUNCTION(xrGetActionStateBoolean, (XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateBoolean* actionState), (session, getInfo, actionState))
+MOCK_LOADER_FUNCTION(xrGetActionStateFloat, (XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateFloat* actionState), (session, getInfo, actionState))
+MOCK_LOADER_FUNCTION(xrGetActionStateVector2f, (XrSession session, const XrActionStateGetInfo* getInfo, XrActionStateVector2f* actionState), (session, getInfo, actionState))
+MOCK_LOADER_FUNCTION(xrGetActionStatePose, (XrSession session, const XrActionStateGetInfo* getInfo, XrActionStatePose* actionState), (session, getInfo, actionState))
+MOCK_LOADER_FUNCTION(xrApplyHapticFeedback, (XrSession session, const XrHapticActionInfo* hapticActionInfo, const XrHapticBaseHeader* hapticFeedback), (session, hapticActionInfo, hapticFeedback))
+MOCK_LOADER_FUNCTION(xrStopHapticFeedback, (XrSession session, const XrHapticActionInfo* hapticActionInfo), (session, hapticActionInfo))
+MOCK_LOADER_FUNCTION(xrEnumerateSwapchainFormats, (XrSession session, uint32_t formatCapacityInput, uint32_t* formatCountOutput, int64_t* formats), (session, formatCapacityInput, formatCountOutput, formats))
+MOCK_LOADER_FUNCTION(xrCreateSwapchain, (XrSession session, const XrSwapchainCreateInfo* createInfo, XrSwapchain* swapchain), (session, createInfo, swapchain))
+MOCK_LOADER_FUNCTION(xrDestroySwapchain, (XrSwapchain swapchain), (swapchain))
+MOCK_LOADER_FUNCTION(xrEnumerateSwapchainImages, (XrSwapchain swapchain, uint32_t imageCapacityInput, uint32_t* imageCountOutput, XrSwapchainImageBaseHeader* images), (swapchain, imageCapacityInput, imageCountOutput, images))
+MOCK_LOADER_FUNCTION(xrAcquireSwapchainImage, (XrSwapchain swapchain, const XrSwapchainImageAcquireInfo* acquireInfo, uint32_t* index), (swapchain, acquireInfo, index))
+MOCK_LOADER_FUNCTION(xrWaitSwapchainImage, (XrSwapchain swapchain, const XrSwapchainImageWaitInfo* waitInfo), (swapchain, waitInfo))
+MOCK_LOADER_FUNCTION(xrReleaseSwapchainImage, (XrSwapchain swapchain, const XrSwapchainImageReleaseInfo* releaseInfo), (swapchain, releaseInfo))
+MOCK_LOADER_FUNCTION(xrWaitFrame, (XrSession session, const XrFrameWaitInfo* frameWaitInfo, XrFrameState* frameState), (session, frameWaitInfo, frameState))
+MOCK_LOADER_FUNCTION(xrBeginFrame, (XrSession session, const XrFrameBeginInfo* frameBeginInfo), (session, frameBeginInfo))
+MOCK_LOADER_FUNCTION(xrEndFrame, (XrSession session, const XrFrameEndInfo* frameEndInfo), (session, frameEndInfo))
+#undef MOCK_LOADER_FUNCTION
+
+extern "C" XRAPI_ATTR XrResult XRAPI_CALL xrGetInstanceProcAddr(XrInstance instance, const char* name, PFN_xrVoidFunction* function) {
+    return MockXRRuntime::GetInstanceProcAddr(instance, name, function);
+}
+
+namespace Tests {
+    OpenXR& GetMockSession() {
+        static OpenXR& s_xr = []() -> OpenXR& {
+            // VRManager creates its OpenXR instance on first use, with the runtime overridden it doesn't look for an installed one
+            SetEnvironmentVariableA("XR_RUNTIME_JSON", "BetterVR_MockRuntime.json");
+            OpenXR& xr = *VRManager::instance().XR;
+
+            // the session never gets a swapchain, so it doesn't need a D3D12 device
+            XrGraphicsBindingD3D12KHR d3d12Binding = { XR_TYPE_GRAPHICS_BINDING_D3D12_KHR };
+            xr.CreateSession(d3d12Binding);
+            xr.CreateActions();
+
+            XrSessionBeginInfo beginInfo = { XR_TYPE_SESSION_BEGIN_INFO };
+            beginInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+            checkXRResult(xrBeginSession(xr.GetSession(), &beginInfo), "Failed to begin the mock session!");
+            return xr;
+        }();
+        return s_xr;
+    }
+}
@@ -0,0 +1,282 @@
+#include "rendering/openxr_mock.h"
+#include "../read_frame_recording.h"
+
+// Runs a headless frame loop against the mock runtime, making the same per-frame calls as the layer's input and rendering threads:
+//   BetterVR_MockRuntimeRunner [frames | recording]
+// Frames aren't paced so that the loop measures the runtime calls themselves. When given a recording made with BETTERVR_RECORD_FRAMES,
+// it runs one frame per recorded present at the recorded times instead, with the mock pacing xrWaitFrame like a headset would.
+// returns the amount of failed calls and mismatched call counts
+namespace {
+    template <typename PFN>
+    PFN GetMockFunction(XrInstance instance, const char* name) {
+        PFN_xrVoidFunction function = nullptr;
+        MockXRRuntime::GetInstanceProcAddr(instance, name, &function);
+        if (function == nullptr) {
+            Log::print<ERROR>("The mock runtime doesn't implement {}", name);
+            std::abort();
+        }
+        return reinterpret_cast<PFN>(function);
+    }
+
+    uint64_t s_failedCalls = 0;
+
+    void Check(XrResult result, const char* call) {
+        if (XR_FAILED(result)) {
+            Log::print<ERROR>("{} failed with {}", call, (int32_t)result);
+            s_failedCalls++;
+        }
+    }
+}
+
+#define MOCK_FUNCTION(instance, name) const PFN_##name name = GetMockFunction<PFN_##name>(instance, #name)
+
+// returns the time of each present in the recording, relative to the start of the recording
+static std::optional<std::vector<uint64_t>> ReadPresentTimes(const std::filesystem::path& path) {
+    FrameRecordingReader reader(path);
+    if (!reader.IsValid()) {
+        return std::nullopt;
+    }
+
+    std::vector<uint64_t> presentTimesNs;
+    FrameRecorder::EventHeader eventHeader = {};
+    while (reader.ReadEvent(eventHeader)) {
+        if (eventHeader.type == FrameRecorder::EventType::QueuePresent) {
+            presentTimesNs.emplace_back(eventHeader.timestampNs);
+        }
+        if (!reader.SkipPayload(eventHeader.type)) {
+            break;
+        }
+    }
+    Log::print<INFO>("Read {} presents from {}, recorded every {} frame(s)", presentTimesNs.size(), path.string(), reader.GetHeader().frameInterval);
+    return presentTimesNs;
+}
+
+static uint64_t RunFrameLoop(uint32_t frameCount, std::span<const uint64_t> presentTimesNs) {
+    const bool replay = !presentTimesNs.empty();
+    if (replay) {
+        frameCount = (uint32_t)presentTimesNs.size();
+    }
+
+    MockXRRuntime::Script script = MockXRRuntime::DefaultScript();
+    script.paceFrames = replay;
+    MockXRRuntime::SetScript(std::move(script));
+
+    MOCK_FUNCTION(XR_NULL_HANDLE, xrCreateInstance);
+    XrInstanceCreateInfo instanceCreateInfo = { XR_TYPE_INSTANCE_CREATE_INFO };
+    const char* extensions[] = { XR_MND_HEADLESS_EXTENSION_NAME };
+    instanceCreateInfo.enabledExtensionCount = 1;
+    instanceCreateInfo.enabledExtensionNames = extensions;
+    instanceCreateInfo.applicationInfo = { "BetterVR Mock Runtime Runner", 1, "Cemu", 1, XR_API_VERSION_1_1 };
+    XrInstance instance = XR_NULL_HANDLE;
+    Check(xrCreateInstance(&instanceCreateInfo, &instance), "xrCreateInstance");
+
+    MOCK_FUNCTION(instance, xrGetSystem);
+    MOCK_FUNCTION(instance, xrCreateSession);
+    MOCK_FUNCTION(instance, xrPollEvent);
+    MOCK_FUNCTION(instance, xrBeginSession);
+    MOCK_FUNCTION(instance, xrStringToPath);
+    MOCK_FUNCTION(instance, xrCreateReferenceSpace);
+    MOCK_FUNCTION(instance, xrCreateActionSet);
+    MOCK_FUNCTION(instance, xrCreateAction);
+    MOCK_FUNCTION(instance, xrCreateActionSpace);
+    MOCK_FUNCTION(instance, xrAttachSessionActionSets);
+    MOCK_FUNCTION(instance, xrWaitFrame);
+    MOCK_FUNCTION(instance, xrBeginFrame);
+    MOCK_FUNCTION(instance, xrEndFrame);
+    MOCK_FUNCTION(instance, xrLocateViews);
+    MOCK_FUNCTION(instance, xrSyncActions);
+    MOCK_FUNCTION(instance, xrGetActionStatePose);
+    MOCK_FUNCTION(instance, xrGetActionStateBoolean);
+    MOCK_FUNCTION(instance, xrLocateSpaces);
+    MOCK_FUNCTION(instance, xrEndSession);
+    MOCK_FUNCTION(instance, xrDestroySession);
+    MOCK_FUNCTION(instance, xrDestroyInstance);
+
+    XrSystemGetInfo systemGetInfo = { XR_TYPE_SYSTEM_GET_INFO };
+    systemGetInfo.formFactor = XR_FORM_FACTOR_HEAD_MOUNTED_DISPLAY;
+    XrSystemId systemId = XR_NULL_SYSTEM_ID;
+    Check(xrGetSystem(instance, &systemGetInfo, &systemId), "xrGetSystem");
+
+    // headless sessions don't have a graphics binding
+    XrSessionCreateInfo sessionCreateInfo = { XR_TYPE_SESSION_CREATE_INFO };
+    sessionCreateInfo.systemId = systemId;
+    XrSession session = XR_NULL_HANDLE;
+    Check(xrCreateSession(instance, &sessionCreateInfo, &session), "xrCreateSession");
+
+    XrEventDataBuffer eventData = { XR_TYPE_EVENT_DATA_BUFFER };
+    while (xrPollEvent(instance, &eventData) == XR_SUCCESS) {
+        eventData = { XR_TYPE_EVENT_DATA_BUFFER };
+    }
+    XrSessionBeginInfo sessionBeginInfo = { XR_TYPE_SESSION_BEGIN_INFO };
+    sessionBeginInfo.primaryViewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+    Check(xrBeginSession(session, &sessionBeginInfo), "xrBeginSession");
+
+    XrReferenceSpaceCreateInfo referenceSpaceCreateInfo = { XR_TYPE_REFERENCE_SPACE_CREATE_INFO };
+    referenceSpaceCreateInfo.poseInReferenceSpace = { { 0, 0, 0, 1 }, { 0, 0, 0 } };
+    referenceSpaceCreateInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_STAGE;
+    XrSpace stageSpace = XR_NULL_HANDLE;
+    Check(xrCreateReferenceSpace(session, &referenceSpaceCreateInfo, &stageSpace), "xrCreateReferenceSpace");
+    referenceSpaceCreateInfo.referenceSpaceType = XR_REFERENCE_SPACE_TYPE_VIEW;
+    XrSpace viewSpace = XR_NULL_HANDLE;
+    Check(xrCreateReferenceSpace(session, &referenceSpaceCreateInfo, &viewSpace), "xrCreateReferenceSpace");
+
+    // a grip pose and a button per hand, like the layer's gameplay action set
+    std::array<XrPath, 2> handPaths = {};
+    Check(xrStringToPath(instance, "/user/hand/left", &handPaths[0]), "xrStringToPath");
+    Check(xrStringToPath(instance, "/user/hand/right", &handPaths[1]), "xrStringToPath");
+
+    XrActionSetCreateInfo actionSetCreateInfo = { XR_TYPE_ACTION_SET_CREATE_INFO };
+    std::strcpy(actionSetCreateInfo.actionSetName, "gameplay");
+    std::strcpy(actionSetCreateInfo.localizedActionSetName, "Gameplay");
+    XrActionSet actionSet = XR_NULL_HANDLE;
+    Check(xrCreateActionSet(instance, &actionSetCreateInfo, &actionSet), "xrCreateActionSet");
+
+    XrActionCreateInfo actionCreateInfo = { XR_TYPE_ACTION_CREATE_INFO };
+    actionCreateInfo.countSubactionPaths = (uint32_t)handPaths.size();
+    actionCreateInfo.subactionPaths = handPaths.data();
+    actionCreateInfo.actionType = XR_ACTION_TYPE_POSE_INPUT;
+    std::strcpy(actionCreateInfo.actionName, "grip_pose");
+    std::strcpy(actionCreateInfo.localizedActionName, "Grip Pose");
+    XrAction gripAction = XR_NULL_HANDLE;
+    Check(xrCreateAction(actionSet, &actionCreateInfo, &gripAction), "xrCreateAction");
+    actionCreateInfo.actionType = XR_ACTION_TYPE_BOOLEAN_INPUT;
+    std::strcpy(actionCreateInfo.actionName, "grab");
+    std::strcpy(actionCreateInfo.localizedActionName, "Grab");
+    XrAction grabAction = XR_NULL_HANDLE;
+    Check(xrCreateAction(actionSet, &actionCreateInfo, &grabAction), "xrCreateAction");
+
+    std::array<XrSpace, 2> handSpaces = {};
+    for (size_t i = 0; i < handSpaces.size(); i++) {
+        XrActionSpaceCreateInfo actionSpaceCreateInfo = { XR_TYPE_ACTION_SPACE_CREATE_INFO };
+        actionSpaceCreateInfo.action = gripAction;
+        actionSpaceCreateInfo.subactionPath = handPaths[i];
+        actionSpaceCreateInfo.poseInActionSpace = { { 0, 0, 0, 1 }, { 0, 0, 0 } };
+        Check(xrCreateActionSpace(session, &actionSpaceCreateInfo, &handSpaces[i]), "xrCreateActionSpace");
+    }
+
+    XrSessionActionSetsAttachInfo attachInfo = { XR_TYPE_SESSION_ACTION_SETS_ATTACH_INFO };
+    attachInfo.countActionSets = 1;
+    attachInfo.actionSets = &actionSet;
+    Check(xrAttachSessionActionSets(session, &attachInfo), "xrAttachSessionActionSets");
+
+    MockXRRuntime::ResetCallCounts();
+    double minFrameMs = std::numeric_limits<double>::max();
+    double maxFrameMs = 0.0;
+    double totalFrameMs = 0.0;
+    // display periods that passed without a frame, when the recorded game couldn't keep up with the headset
+    uint64_t missedDisplayPeriods = 0;
+    XrTime prevDisplayTime = 0;
+    const auto loopStart = std::chrono::steady_clock::now();
+    for (uint32_t frame = 0; frame < frameCount; frame++) {
+        if (replay) {
+            std::this_thread::sleep_until(loopStart + std::chrono::nanoseconds(presentTimesNs[frame] - presentTimesNs[0]));
+        }
+
+        XrFrameWaitInfo frameWaitInfo = { XR_TYPE_FRAME_WAIT_INFO };
+        XrFrameState frameState = { XR_TYPE_FRAME_STATE };
+        Check(xrWaitFrame(session, &frameWaitInfo, &frameState), "xrWaitFrame");
+        if (frame > 0 && frameState.predictedDisplayTime - prevDisplayTime > frameState.predictedDisplayPeriod) {
+            missedDisplayPeriods += (uint64_t)((frameState.predictedDisplayTime - prevDisplayTime) / frameState.predictedDisplayPeriod - 1);
+        }
+        prevDisplayTime = frameState.predictedDisplayTime;
+
+        // xrWaitFrame isn't timed since it blocks until the next display period when frames are paced
+        auto start = std::chrono::high_resolution_clock::now();
+        XrFrameBeginInfo frameBeginInfo = { XR_TYPE_FRAME_BEGIN_INFO };
+        Check(xrBeginFrame(session, &frameBeginInfo), "xrBeginFrame");
+
+        XrViewLocateInfo viewLocateInfo = { XR_TYPE_VIEW_LOCATE_INFO };
+        viewLocateInfo.viewConfigurationType = XR_VIEW_CONFIGURATION_TYPE_PRIMARY_STEREO;
+        viewLocateInfo.displayTime = frameState.predictedDisplayTime;
+        viewLocateInfo.space = stageSpace;
+        XrViewState viewState = { XR_TYPE_VIEW_STATE };
+        std::array<XrView, 2> views = { XrView{ XR_TYPE_VIEW }, XrView{ XR_TYPE_VIEW } };
+        uint32_t viewCount = 0;
+        Check(xrLocateViews(session, &viewLocateInfo, &viewState, (uint32_t)views.size(), &viewCount, views.data()), "xrLocateViews");
+
+        XrActiveActionSet activeActionSet = { actionSet, XR_NULL_PATH };
+        XrActionsSyncInfo syncInfo = { XR_TYPE_ACTIONS_SYNC_INFO };
+        syncInfo.countActiveActionSets = 1;
+        syncInfo.activeActionSets = &activeActionSet;
+        Check(xrSyncActions(session, &syncInfo), "xrSyncActions");
+
+        for (XrPath handPath : handPaths) {
+            XrActionStateGetInfo getInfo = { XR_TYPE_ACTION_STATE_GET_INFO };
+            getInfo.subactionPath = handPath;
+            getInfo.action = gripAction;
+            XrActionStatePose poseState = { XR_TYPE_ACTION_STATE_POSE };
+            Check(xrGetActionStatePose(session, &getInfo, &poseState), "xrGetActionStatePose");
+            getInfo.action = grabAction;
+            XrActionStateBoolean grabState = { XR_TYPE_ACTION_STATE_BOOLEAN };
+            Check(xrGetActionStateBoolean(session, &getInfo, &grabState), "xrGetActionStateBoolean");
+        }
+
+        // the head and both hands in one batched call, like OpenXR::UpdateActions
+        const std::array<XrSpace, 3> spaces = { viewSpace, handSpaces[0], handSpaces[1] };
+        std::array<XrSpaceLocationData, 3> locationData = {};
+        std::array<XrSpaceVelocityData, 3> velocityData = {};
+        XrSpaceVelocities velocities = { XR_TYPE_SPACE_VELOCITIES };
+        velocities.velocityCount = (uint32_t)velocityData.size();
+        velocities.velocities = velocityData.data();
+        XrSpaceLocations locations = { XR_TYPE_SPACE_LOCATIONS, &velocities };
+        locations.locationCount = (uint32_t)locationData.size();
+        locations.locations = locationData.data();
+        XrSpacesLocateInfo locateInfo = { XR_TYPE_SPACES_LOCATE_INFO };
+        locateInfo.baseSpace = stageSpace;
+        locateInfo.time = frameState.predictedDisplayTime;
+        locateInfo.spaceCount = (uint32_t)spaces.size();
+        locateInfo.spaces = spaces.data();
+        Check(xrLocateSpaces(session, &locateInfo, &locations), "xrLocateSpaces");
+
+        // no layers since there aren't any swapchains without a graphics binding
+        XrFrameEndInfo frameEndInfo = { XR_TYPE_FRAME_END_INFO };
+        frameEndInfo.displayTime = frameState.predictedDisplayTime;
+        frameEndInfo.environmentBlendMode = XR_ENVIRONMENT_BLEND_MODE_OPAQUE;
+        Check(xrEndFrame(session, &frameEndInfo), "xrEndFrame");
+
+        const double frameMs = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+        totalFrameMs += frameMs;
+        minFrameMs = std::min(minFrameMs, frameMs);
+        maxFrameMs = std::max(maxFrameMs, frameMs);
+    }
+
+    // every frame should have made exactly the calls above
+    const MockXRRuntime::CallCounts counts = MockXRRuntime::GetCallCounts();
+    uint64_t mismatches = 0;
+    mismatches += counts.frames != frameCount ? 1 : 0;
+    mismatches += counts.waitFrame != frameCount ? 1 : 0;
+    mismatches += counts.syncActions != frameCount ? 1 : 0;
+    mismatches += counts.locateViews != frameCount ? 1 : 0;
+    mismatches += counts.locateSpaces != frameCount ? 1 : 0;
+    mismatches += counts.locateSpacesKHR != 0 ? 1 : 0;
+    mismatches += counts.getActionState != frameCount * 4ull ? 1 : 0;
+    if (frameCount > 0) {
+        Log::print<INFO>("Ran {} frames on the mock runtime: avg {:.4f} ms, min {:.4f} ms, max {:.4f} ms per frame", frameCount, totalFrameMs / frameCount, minFrameMs, maxFrameMs);
+    }
+    if (replay) {
+        Log::print<INFO>("The recorded presents missed {} display periods", missedDisplayPeriods);
+    }
+    Log::print<INFO>("Calls: waitFrame={}, syncActions={}, getActionState={}, locateSpace={}, locateSpaces={}, locateViews={}", counts.waitFrame, counts.syncActions, counts.getActionState, counts.locateSpace, counts.locateSpaces, counts.locateViews);
+
+    Check(xrEndSession(session), "xrEndSession");
+    Check(xrDestroySession(session), "xrDestroySession");
+    Check(xrDestroyInstance(instance), "xrDestroyInstance");
+    return s_failedCalls + mismatches;
+}
+
+int main(int argc, char** argv) {
+    std::vector<uint64_t> presentTimesNs;
+    uint32_t frameCount = 1000;
+    if (argc > 1 && std::filesystem::is_regular_file(argv[1])) {
+        std::optional<std::vector<uint64_t>> recordedTimesNs = ReadPresentTimes(argv[1]);
+        if (!recordedTimesNs || recordedTimesNs->empty()) {
+            Log::print<ERROR>("{} doesn't contain any presents", argv[1]);
+            return 1;
+        }
+        presentTimesNs = std::move(*recordedTimesNs);
+    }
+    else if (argc > 1) {
+        frameCount = (uint32_t)std::max(std::atoi(argv[1]), 1);
+    }
+    return (int)std::min<uint64_t>(RunFrameLoop(frameCount, presentTimesNs), 255);
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+// Stands in for include/pch.h, which pulls in Windows, D3D12 and Vulkan. It only provides what openxr_mock.cpp and utils/frame_recorder.h use from it.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Vulkan includes, only the types for the events in frame recordings
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan_core.h>
+
+// OpenXR includes, without a platform or graphics API since the mock only creates headless sessions here
+#include <openxr/openxr.h>
+
+// glm includes, with the same defines as the layer
+#define GLM_FORCE_XYZW_ONLY
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+inline glm::fvec2 ToGLM(const XrVector2f& vec) {
+    return glm::make_vec2(&vec.x);
+}
+
+inline glm::fvec3 ToGLM(const XrVector3f& vec) {
+    return glm::make_vec3(&vec.x);
+}
+
+inline glm::fquat ToGLM(const XrQuaternionf& quat) {
+    return glm::fquat(quat.w, quat.x, quat.y, quat.z);
+}
+
+inline XrVector2f ToXR(const glm::fvec2& vec) {
+    return { vec.x, vec.y };
+}
+
+inline XrVector3f ToXR(const glm::fvec3& vec) {
+    return { vec.x, vec.y, vec.z };
+}
+
+inline XrQuaternionf ToXR(const glm::fquat& quat) {
+    return { quat.x, quat.y, quat.z, quat.w };
+}
+
+// same interface as utils/logger.h, but it prints to stdout/stderr instead of Cemu's console and log file
+enum class LogType {
+    INTEROP,
+    INFO,
+    WARNING,
+    ERROR
+};
+
+using enum LogType;
+
+class Log {
+public:
+    template <LogType L, class... Args>
+    static inline void print(const char* format, Args&&... args) {
+        std::string message = std::vformat(format, std::make_format_args(args...));
+        std::fprintf(L == INFO || L == INTEROP ? stdout : stderr, "%s\n", message.c_str());
+    }
+};
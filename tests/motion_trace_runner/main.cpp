@@ -0,0 +1,10 @@
+#include "../run_motion_traces.h"
+
+// runs the motion traces through the attack detection, without the rest of the layer:
+//   BetterVR_MotionTraceRunner [directory] [iterations]
+// the directory defaults to resources/motion_traces, returns the amount of missed, misclassified and falsely detected attacks
+int main(int argc, char** argv) {
+    const std::filesystem::path directory = argc > 1 ? std::filesystem::path(argv[1]) : std::filesystem::path(BETTERVR_SOURCE_DIR) / "resources/motion_traces";
+    const uint32_t iterations = argc > 2 ? (uint32_t)std::max(std::atoi(argv[2]), 1) : 10;
+    return (int)std::min<uint64_t>(RunMotionTraces(directory, iterations), 255);
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+// Stands in for include/pch.h, which pulls in Windows, D3D12 and Vulkan. It only provides what motion_trace.cpp and weapon.h use from it.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cfloat>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+// OpenXR includes, only the types since the runner doesn't talk to a runtime
+#include <openxr/openxr.h>
+
+// ImGui includes, weapon.h draws its debug overlay with these but the runner never calls it
+#define IMGUI_DEFINE_MATH_OPERATORS
+#include <imgui.h>
+#include <implot3d.h>
+#include <implot.h>
+
+// glm includes, with the same defines as the layer so that the analysers compute the same values
+#define GLM_FORCE_XYZW_ONLY
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_access.hpp>
+#include <glm/gtc/quaternion.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/norm.hpp>
+#undef GLM_ENABLE_EXPERIMENTAL
+
+inline glm::fvec3 ToGLM(const XrVector3f& vec) {
+    return glm::make_vec3(&vec.x);
+}
+
+inline glm::fquat ToGLM(const XrQuaternionf& quat) {
+    return glm::fquat(quat.w, quat.x, quat.y, quat.z);
+}
+
+#include "weapon_type.h"
+
+// same interface as utils/logger.h, but it prints to stdout/stderr instead of Cemu's console and log file
+enum class LogType {
+    CONTROLS,
+    INFO,
+    WARNING,
+    ERROR
+};
+
+using enum LogType;
+
+class Log {
+public:
+    template <LogType L, class... Args>
+    static inline void print(const char* format, Args&&... args) {
+        if constexpr (L == CONTROLS) {
+            return;
+        }
+        else {
+            std::string message = std::vformat(format, std::make_format_args(args...));
+            std::fprintf(L == INFO ? stdout : stderr, "%s\n", message.c_str());
+        }
+    }
+};
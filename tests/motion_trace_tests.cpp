@@ -0,0 +1,4 @@
+#include "tests.h"
+#include "run_motion_traces.h"
+
+BETTERVR_TEST(MotionTraces, []() { return RunMotionTraces(Tests::GetSourceDirectory() / "resources/motion_traces", 10); });
@@ -0,0 +1,125 @@
+#include "tests.h"
+#include "hooking/cemu_hooks.h"
+#include "hooking/openxr_motion_bridge.h"
+#include <random>
+
+namespace {
+    // a controller that keeps aiming around (a yaw sweep with a tilted wobble on top) while the hand moves slightly, in double precision
+    glm::dquat GetAimOrientation(double time) {
+        const glm::dvec3 wobbleAxis = glm::normalize(glm::dvec3(0.3, 0.3, 0.9));
+        return glm::normalize(glm::angleAxis(1.2 * std::sin(3.1 * time), glm::dvec3(0.0, 1.0, 0.0)) * glm::angleAxis(0.8 * std::sin(2.3 * time), wobbleAxis));
+    }
+
+    SampledMotionIntegrator::Sample GetAimSample(double time) {
+        // the runtime reports the angular velocity in world space, which is taken from the rotation over a very short time here
+        constexpr double EPSILON = 1e-5;
+        glm::dquat delta = GetAimOrientation(time + EPSILON) * glm::inverse(GetAimOrientation(time - EPSILON));
+        if (delta.w < 0.0) delta = -delta;
+        const glm::dvec3 axis = { delta.x, delta.y, delta.z };
+        const double sinHalfAngle = glm::length(axis);
+        const glm::dvec3 angularVelocity = sinHalfAngle > 1e-12 ? axis * (2.0 * std::atan2(sinHalfAngle, delta.w) / sinHalfAngle / (2.0 * EPSILON)) : glm::dvec3(0.0);
+
+        return {
+            .time = (XrTime)std::llround(time * 1e9),
+            .orientation = glm::quat(GetAimOrientation(time)),
+            .angularVelocity = glm::vec3(angularVelocity),
+            .linearVelocity = glm::vec3(0.26 * std::cos(1.3 * time), 0.21 * std::cos(2.1 * time), 0.0)
+        };
+    }
+
+    // what the game does with the gyro, turning its own orientation by the local angular velocity over its frame time
+    glm::dquat IntegrateGyro(const glm::dquat& orientation, const glm::vec3& gyro, double frameTime) {
+        const glm::dvec3 rotation = glm::dvec3(gyro.x, -gyro.y, -gyro.z) * frameTime; // undo the bridge's Cemu axes
+        const double angle = glm::length(rotation);
+        return angle > 1e-12 ? glm::normalize(orientation * glm::angleAxis(angle, rotation / angle)) : orientation;
+    }
+
+    double GetAngleBetween(const glm::dquat& a, const glm::dquat& b) {
+        const glm::dquat delta = glm::inverse(a) * b;
+        return glm::degrees(2.0 * std::acos(std::min(1.0, std::abs(delta.w))));
+    }
+
+    // times of the poses that the runtime samples for each XR frame, which start a bit early or late depending on the runtime's frame pacing
+    std::vector<double> GetXRFrameTimes(double refreshRate, double seconds, std::mt19937& rng) {
+        constexpr double JITTER = 0.15; // of a frame
+        std::uniform_real_distribution<double> jitter(-JITTER, JITTER);
+
+        const double period = 1.0 / refreshRate;
+        std::vector<double> times;
+        for (uint32_t frame = 0; (double)frame * period < seconds; ++frame) {
+            times.emplace_back(((double)frame + jitter(rng)) * period);
+        }
+        return times;
+    }
+}
+
+// the runtime samples the controller once per XR frame at the headset's refresh rate, while the game reads the VPAD at its own frame rate
+// and gets the pose of the latest XR frame. plays the same controller motion at 20, 30 and 60 FPS on a 72 and 90 Hz headset through the bridge
+// with the runtime's angular velocity (like before) and through SampledMotionIntegrator, integrates the gyro of both over the game's frame time
+// like the game does and logs how far that ends up from the pose that the game was given.
+// returns the amount of frames where SampledMotionIntegrator's gyro ends up more than 5 degrees off, plus one for each frame rate where it isn't
+// more accurate on average than before
+static uint64_t ValidateMotionIntegration(uint32_t seconds) {
+    constexpr double MAX_ERROR_DEGREES = 5.0;
+    // the game doesn't read the VPAD at exactly the same point of each frame either
+    constexpr double GAME_JITTER = 0.01; // of a frame
+
+    uint64_t errors = 0;
+    for (double refreshRate : { 72.0, 90.0 }) {
+        for (uint32_t fps : { 20u, 30u, 60u }) {
+            std::mt19937 rng(1234);
+            std::uniform_real_distribution<double> gameJitter(-GAME_JITTER, GAME_JITTER);
+            const std::vector<double> xrFrameTimes = GetXRFrameTimes(refreshRate, (double)seconds + 1.0, rng);
+
+            const double frameTime = 1.0 / (double)fps;
+            const uint32_t frames = seconds * fps;
+
+            OpenXRMotionBridge legacyBridge;
+            SampledMotionIntegrator integrator;
+            glm::dquat legacyOrientation = {};
+            glm::dquat integratedOrientation = {};
+
+            double legacyTotalError = 0.0;
+            double legacyMaxError = 0.0;
+            double integratedTotalError = 0.0;
+            double integratedMaxError = 0.0;
+            size_t xrFrame = 0;
+            for (uint32_t frame = 0; frame < frames; ++frame) {
+                // starts a bit later so that the first read already has an XR frame
+                const double readTime = 0.05 + ((double)frame + gameJitter(rng)) * frameTime;
+                while (xrFrame + 1 < xrFrameTimes.size() && xrFrameTimes[xrFrame + 1] <= readTime) {
+                    xrFrame++;
+                }
+
+                const SampledMotionIntegrator::Sample sample = GetAimSample(xrFrameTimes[xrFrame]);
+                const glm::quat invRot = glm::inverse(sample.orientation);
+                const WiiUMotionData legacyMotion = legacyBridge.Process(sample.orientation, invRot * sample.angularVelocity, invRot * glm::vec3(0.0f, 9.81f, 0.0f));
+                const WiiUMotionData integratedMotion = integrator.Update(sample);
+                if (frame == 0) {
+                    legacyOrientation = glm::dquat(sample.orientation);
+                    integratedOrientation = glm::dquat(sample.orientation);
+                }
+                else {
+                    legacyOrientation = IntegrateGyro(legacyOrientation, legacyMotion.gyro, frameTime);
+                    integratedOrientation = IntegrateGyro(integratedOrientation, integratedMotion.gyro, frameTime);
+                }
+
+                const glm::dquat orientation = glm::dquat(sample.orientation);
+                const double legacyError = GetAngleBetween(orientation, legacyOrientation);
+                const double integratedError = GetAngleBetween(orientation, integratedOrientation);
+                legacyTotalError += legacyError;
+                legacyMaxError = std::max(legacyMaxError, legacyError);
+                integratedTotalError += integratedError;
+                integratedMaxError = std::max(integratedMaxError, integratedError);
+                errors += integratedError > MAX_ERROR_DEGREES ? 1 : 0;
+            }
+            errors += integratedTotalError >= legacyTotalError ? 1 : 0;
+
+            Log::print<INFO>("Motion integration at {} FPS on a {} Hz headset ({} frames): gyro orientation error avg = {:.2f} max = {:.2f} degrees, from the sampled rotation avg = {:.2f} max = {:.2f} degrees",
+                fps, refreshRate, frames, frames > 0 ? legacyTotalError / frames : 0.0, legacyMaxError, frames > 0 ? integratedTotalError / frames : 0.0, integratedMaxError);
+        }
+    }
+    return errors;
+}
+
+BETTERVR_TEST(MotionIntegration, []() { return ValidateMotionIntegration(10); });
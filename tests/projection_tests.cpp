@@ -0,0 +1,173 @@
+#include "tests.h"
+#include "hooking/cemu_hooks.h"
+#include "hooking/culling.h"
+#include "hooking/projection.h"
+#include <random>
+
+namespace {
+    // the FOV split that projection.cpp does for StereoProjection::Calculate, copied so that the reference below stays independent of it
+    data_VRProjectionMatrixOut calculateFOVAndOffset(XrFovf viewFOV) {
+        float totalHorizontalFov = viewFOV.angleRight - viewFOV.angleLeft;
+        float totalVerticalFov = viewFOV.angleUp - viewFOV.angleDown;
+
+        data_VRProjectionMatrixOut ret = {};
+        ret.aspectRatio = totalHorizontalFov / totalVerticalFov;
+        ret.fovY = totalVerticalFov;
+        ret.offsetX = (viewFOV.angleRight + viewFOV.angleLeft) / 2.0f;
+        ret.offsetY = (viewFOV.angleUp + viewFOV.angleDown) / 2.0f;
+        return ret;
+    }
+
+    // what each projection hook used to calculate by itself, kept as the reference for the golden test below
+    void ApplyProjectionUncached(const XrFovf& currFOV, BESeadPerspectiveProjection& perspectiveProjection) {
+        auto newProjection = calculateFOVAndOffset(currFOV);
+
+        perspectiveProjection.aspect = newProjection.aspectRatio;
+        perspectiveProjection.fovYRadiansOrAngle = newProjection.fovY;
+        float halfAngle = newProjection.fovY.getLE() * 0.5f;
+        perspectiveProjection.fovySin = sinf(halfAngle);
+        perspectiveProjection.fovyCos = cosf(halfAngle);
+        perspectiveProjection.fovyTan = tanf(halfAngle);
+        perspectiveProjection.offset.x = newProjection.offsetX;
+        perspectiveProjection.offset.y = newProjection.offsetY;
+
+        glm::fmat4 newMatrix = calculateProjectionMatrix(perspectiveProjection.zNear.getLE(), perspectiveProjection.zFar.getLE(), currFOV);
+        perspectiveProjection.matrix = newMatrix;
+
+        glm::fmat4 newDeviceMatrix = newMatrix;
+
+        float zScale = perspectiveProjection.deviceZScale.getLE();
+        float zOffset = perspectiveProjection.deviceZOffset.getLE();
+
+        newDeviceMatrix[2][0] *= zScale;
+        newDeviceMatrix[2][1] *= zScale;
+        newDeviceMatrix[2][2] = (newDeviceMatrix[2][2] + newDeviceMatrix[3][2] * zOffset) * zScale;
+        newDeviceMatrix[2][3] = newDeviceMatrix[2][3] * zScale + newDeviceMatrix[3][3] * zOffset;
+
+        perspectiveProjection.deviceMatrix = newDeviceMatrix;
+
+        perspectiveProjection.dirty = false;
+        perspectiveProjection.deviceDirty = false;
+    }
+}
+
+// feeds random eye FOVs, clip planes and device z ranges through ProjectionCache and the old per-hook calculation,
+// and returns the amount of projections where the guest memory would differ by even a single byte (which should always be zero)
+static uint64_t ValidateProjectionCache(uint32_t iterations) {
+    std::mt19937 rng(2468);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    auto range = [&](float min, float max) { return min + (max - min) * unit(rng); };
+
+    constexpr std::array<std::pair<float, float>, 3> clipPlanes = { std::pair{ 0.1f, 25000.0f }, std::pair{ 0.1f, 600.0f }, std::pair{ 1.0f, 3000.0f } };
+    constexpr std::array<std::pair<float, float>, 2> deviceZRanges = { std::pair{ 0.5f, 0.5f }, std::pair{ 1.0f, 0.0f } };
+
+    const uint64_t calculationsBefore = ProjectionCache::GetCalculations();
+    uint64_t mismatches = 0;
+    for (uint32_t i = 0; i < iterations; ++i) {
+        OpenXR::EyeSide side = (i & 1) ? OpenXR::EyeSide::RIGHT : OpenXR::EyeSide::LEFT;
+        XrFovf fov = { -range(0.6f, 1.0f), range(0.6f, 1.0f), range(0.6f, 1.0f), -range(0.6f, 1.0f) };
+        for (uint32_t repeat = 0; repeat < 4; ++repeat) {
+            auto [zNear, zFar] = clipPlanes[(i + repeat) % clipPlanes.size()];
+            auto [zScale, zOffset] = deviceZRanges[repeat % deviceZRanges.size()];
+
+            BESeadPerspectiveProjection reference = {};
+            reference.zNear = zNear;
+            reference.zFar = zFar;
+            reference.deviceZScale = zScale;
+            reference.deviceZOffset = zOffset;
+            reference.dirty = true;
+            reference.deviceDirty = true;
+            BESeadPerspectiveProjection calculated = reference;
+            BESeadPerspectiveProjection cached = reference;
+
+            ApplyProjectionUncached(fov, reference);
+            // the first Apply calculates the projection, the second one is served from the cache
+            ProjectionCache::Apply(side, fov, calculated);
+            ProjectionCache::Apply(side, fov, cached);
+            for (const BESeadPerspectiveProjection* projection : { &calculated, &cached }) {
+                if (memcmp(&reference, projection, sizeof(BESeadPerspectiveProjection)) != 0) {
+                    ++mismatches;
+                }
+            }
+        }
+    }
+
+    Log::print<INFO>("Projection cache validation ({} FOVs x 4 projections x 2 lookups): {} mismatches, {} calculations", iterations, mismatches, ProjectionCache::GetCalculations() - calculationsBefore);
+    return mismatches;
+}
+
+// splits the combined stereo view into shadow cascades like the game does for its own camera, then checks that random points
+// inside both eye frustums always land inside one of the cascades, returns the amount of points that didn't (which should always be zero)
+static uint64_t ValidateShadowCascadeCoverage(uint32_t setups, uint32_t pointsPerEye) {
+    std::mt19937 rng(1357);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+    auto range = [&](float min, float max) { return min + (max - min) * unit(rng); };
+
+    constexpr int CASCADE_COUNT = 4;
+    uint64_t uncovered = 0;
+    uint64_t skippedSetups = 0;
+    double horizontalFOV = 0.0;
+    for (uint32_t setup = 0; setup < setups; ++setup) {
+        glm::fquat headRot = glm::angleAxis(range(-3.14f, 3.14f), glm::fvec3(0, 1, 0)) * glm::angleAxis(range(-1.0f, 1.0f), glm::fvec3(1, 0, 0));
+        glm::fvec3 headPos = glm::fvec3(range(-100.0f, 100.0f), range(0.0f, 50.0f), range(-100.0f, 100.0f));
+        float ipd = range(0.05f, 0.075f);
+        float cant = range(0.0f, 0.2f);
+        auto toPose = [](glm::fvec3 pos, glm::fquat rot) {
+            return XrPosef{ XrQuaternionf{ rot.x, rot.y, rot.z, rot.w }, XrVector3f{ pos.x, pos.y, pos.z } };
+        };
+        std::array<XrPosef, 2> poses = {
+            toPose(headPos + headRot * glm::fvec3(-ipd * 0.5f, 0, 0), headRot * glm::angleAxis(cant, glm::fvec3(0, 1, 0))),
+            toPose(headPos + headRot * glm::fvec3(ipd * 0.5f, 0, 0), headRot * glm::angleAxis(-cant, glm::fvec3(0, 1, 0)))
+        };
+        std::array<XrFovf, 2> fovs = {
+            XrFovf{ -range(0.7f, 1.0f), range(0.6f, 0.9f), range(0.6f, 0.9f), -range(0.7f, 1.0f) },
+            XrFovf{ -range(0.6f, 0.9f), range(0.7f, 1.0f), range(0.6f, 0.9f), -range(0.7f, 1.0f) }
+        };
+        float zNear = range(0.05f, 1.0f);
+        float shadowDistance = range(50.0f, 300.0f);
+
+        constexpr float PULL_BACK = 1.0f;
+        auto viewOpt = CombinedStereoView::Calculate(poses, fovs, zNear, shadowDistance, PULL_BACK);
+        if (!viewOpt) {
+            ++skippedSetups;
+            continue;
+        }
+        const CombinedStereoView& view = viewOpt.value();
+        horizontalFOV += view.fov.angleRight - view.fov.angleLeft;
+
+        // practical split scheme, halfway between uniform and logarithmic splits, over the game's clip planes
+        std::array<Frustum, CASCADE_COUNT> cascades = {};
+        glm::mat4 combinedView = glm::inverse(glm::translate(glm::mat4(1.0f), view.position) * glm::mat4_cast(view.orientation));
+        float splitNear = zNear;
+        for (int i = 0; i < CASCADE_COUNT; ++i) {
+            float fraction = (float)(i + 1) / (float)CASCADE_COUNT;
+            float splitFar = i == CASCADE_COUNT - 1 ? shadowDistance : glm::mix(zNear + (shadowDistance - zNear) * fraction, zNear * std::pow(shadowDistance / zNear, fraction), 0.5f);
+            cascades[i].update(glm::transpose(calculateProjectionMatrix(splitNear, splitFar, view.fov)) * combinedView);
+            splitNear = splitFar;
+        }
+
+        for (int eye = 0; eye < 2; ++eye) {
+            for (uint32_t i = 0; i < pointsPerEye; ++i) {
+                // most points close to the eye, where the eyes and the combined view differ the most
+                // the view is pulled back behind the eyes, so the last PULL_BACK meters in front of them are past the game's far plane
+                float depth = zNear + std::pow(unit(rng), 3.0f) * (shadowDistance - PULL_BACK - zNear);
+                float tanX = glm::mix(tanf(fovs[eye].angleLeft), tanf(fovs[eye].angleRight), unit(rng));
+                float tanY = glm::mix(tanf(fovs[eye].angleDown), tanf(fovs[eye].angleUp), unit(rng));
+                glm::fvec3 point = ToGLM(poses[eye].position) + ToGLM(poses[eye].orientation) * glm::fvec3(tanX * depth, tanY * depth, -depth);
+
+                // allow for float rounding on the cascade borders
+                float tolerance = depth * 1e-4f;
+                if (std::none_of(cascades.begin(), cascades.end(), [&](const Frustum& cascade) { return cascade.checkSphere(point, tolerance); })) {
+                    ++uncovered;
+                }
+            }
+        }
+    }
+
+    const uint32_t testedSetups = setups - (uint32_t)skippedSetups;
+    Log::print<INFO>("Shadow cascade coverage validation ({} setups x {} points per eye): {} uncovered points, {} setups without a combined view, {:.1f} degrees average horizontal FOV", setups, pointsPerEye, uncovered, skippedSetups, testedSetups == 0 ? 0.0 : glm::degrees(horizontalFOV / testedSetups));
+    return uncovered;
+}
+
+BETTERVR_TEST(ProjectionCache, []() { return ValidateProjectionCache(100'000); });
+BETTERVR_TEST(ShadowCascadeCoverage, []() { return ValidateShadowCascadeCoverage(64, 1000); });
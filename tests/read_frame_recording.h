@@ -0,0 +1,55 @@
+#pragma once
+#include "utils/frame_recorder.h"
+
+// Reads a recording made by FrameRecorder one event at a time, the caller reads the payload that belongs to each event's type.
+// used by the FrameReplay tests and by tests/mock_runtime_runner, which also builds on Linux
+class FrameRecordingReader {
+public:
+    explicit FrameRecordingReader(const std::filesystem::path& path): m_file(path, std::ios::in | std::ios::binary) {
+        if (!m_file.is_open()) {
+            Log::print<ERROR>("Failed to open frame recording {}", path.string());
+            return;
+        }
+        if (!ReadPayload(m_header) || memcmp(m_header.magic, FrameRecorder::FileHeader{}.magic, sizeof(m_header.magic)) != 0 || m_header.version != FrameRecorder::FileHeader{}.version) {
+            Log::print<ERROR>("{} isn't a supported frame recording", path.string());
+            return;
+        }
+        m_valid = true;
+    }
+
+    bool IsValid() const { return m_valid; }
+    const FrameRecorder::FileHeader& GetHeader() const { return m_header; }
+
+    bool ReadEvent(FrameRecorder::EventHeader& eventHeader) {
+        return m_valid && ReadPayload(eventHeader);
+    }
+
+    template <typename T>
+    bool ReadPayload(T& payload) {
+        m_file.read(reinterpret_cast<char*>(&payload), sizeof(payload));
+        return m_file.gcount() == sizeof(payload);
+    }
+
+    // for callers that only need some of the events, returns false for unknown event types since their size isn't known
+    bool SkipPayload(FrameRecorder::EventType type) {
+        switch (type) {
+            case FrameRecorder::EventType::CreateImage: return SkipBytes(sizeof(FrameRecorder::CreateImageEvent));
+            case FrameRecorder::EventType::DestroyImage: return SkipBytes(sizeof(FrameRecorder::DestroyImageEvent));
+            case FrameRecorder::EventType::ClearColorImage: return SkipBytes(sizeof(FrameRecorder::ClearColorImageEvent));
+            case FrameRecorder::EventType::ClearDepthStencilImage: return SkipBytes(sizeof(FrameRecorder::ClearDepthStencilImageEvent));
+            case FrameRecorder::EventType::QueueSubmit: return SkipBytes(sizeof(FrameRecorder::QueueSubmitEvent));
+            case FrameRecorder::EventType::QueuePresent: return SkipBytes(sizeof(FrameRecorder::QueuePresentEvent));
+            default: return false;
+        }
+    }
+
+private:
+    bool SkipBytes(std::streamoff count) {
+        m_file.seekg(count, std::ios::cur);
+        return m_file.good();
+    }
+
+    std::ifstream m_file;
+    FrameRecorder::FileHeader m_header = {};
+    bool m_valid = false;
+};
@@ -0,0 +1,47 @@
+#pragma once
+#include "hooking/motion_trace.h"
+
+// runs every motion trace in the directory (e.g. resources/motion_traces) through the attack detection and logs the results per trace,
+// returns the amount of missed, misclassified and falsely detected attacks over all traces.
+// used by the MotionTraces test and by tests/motion_trace_runner, which also builds on Linux
+inline uint64_t RunMotionTraces(const std::filesystem::path& directory, uint32_t iterations) {
+    std::error_code ec;
+    std::vector<std::filesystem::path> paths;
+    for (const auto& entry : std::filesystem::directory_iterator(directory, ec)) {
+        if (entry.is_regular_file() && entry.path().extension() == MotionTrace::FILE_EXTENSION) {
+            paths.emplace_back(entry.path());
+        }
+    }
+    if (ec || paths.empty()) {
+        Log::print<WARNING>("No motion traces found in {}", directory.string());
+        return 0;
+    }
+    std::ranges::sort(paths);
+
+    MotionTraceRunner::Stats total = {};
+    double totalNs = 0.0;
+    for (const std::filesystem::path& path : paths) {
+        std::optional<MotionTrace> trace = MotionTrace::Load(path);
+        if (!trace.has_value()) {
+            continue;
+        }
+
+        MotionTraceRunner::Stats stats = MotionTraceRunner::Run(trace.value(), iterations);
+        Log::print<INFO>("Motion trace {} ({} samples, {} labelled): {}/{} attacks detected, {} misclassified, {} missed, {} false positives, latency avg = {:.1f} max = {} frames, {:.1f} ns/sample",
+            trace->name, stats.samples, stats.labelledSamples, stats.detectedAttacks, stats.labelledAttacks, stats.misclassifiedAttacks, stats.missedAttacks, stats.falsePositives, stats.GetAverageLatencyFrames(), stats.maxLatencyFrames, stats.nsPerSample);
+
+        total.samples += stats.samples;
+        total.labelledAttacks += stats.labelledAttacks;
+        total.detectedAttacks += stats.detectedAttacks;
+        total.misclassifiedAttacks += stats.misclassifiedAttacks;
+        total.missedAttacks += stats.missedAttacks;
+        total.falsePositives += stats.falsePositives;
+        total.totalLatencyFrames += stats.totalLatencyFrames;
+        total.maxLatencyFrames = std::max(total.maxLatencyFrames, stats.maxLatencyFrames);
+        totalNs += stats.nsPerSample * stats.samples;
+    }
+
+    Log::print<INFO>("Motion traces ({} traces, {} samples x {} iterations): {}/{} attacks detected, {} misclassified, {} missed, {} false positives, latency avg = {:.1f} max = {} frames, {:.1f} ns/sample",
+        paths.size(), total.samples, iterations, total.detectedAttacks, total.labelledAttacks, total.misclassifiedAttacks, total.missedAttacks, total.falsePositives, total.GetAverageLatencyFrames(), total.maxLatencyFrames, total.samples > 0 ? totalNs / total.samples : 0.0);
+    return (uint64_t)total.missedAttacks + total.misclassifiedAttacks + total.falsePositives;
+}
@@ -0,0 +1,91 @@
+#include "tests.h"
+#include "instance.h"
+#include "utils/seqlock.h"
+
+// Compares SeqLock against the std::atomic<InputState> it replaced, using a simulated XR thread that keeps publishing new
+// input states and a couple of simulated hook threads that load them. Writes happen as fast as possible, which is far more
+// contention than the 90-120 stores per second from UpdateActions.
+namespace {
+    struct BenchmarkResult {
+        uint64_t reads = 0;
+        uint64_t writes = 0;
+        uint64_t tornReads = 0;
+        double seconds = 0.0;
+    };
+
+    template <typename Load, typename Store>
+    BenchmarkResult RunContention(uint32_t readerThreads, std::chrono::milliseconds duration, Load load, Store store) {
+        std::atomic_bool stop = false;
+        std::atomic_uint64_t reads = 0;
+        std::atomic_uint64_t writes = 0;
+        std::atomic_uint64_t torn = 0;
+
+        std::vector<std::thread> threads;
+        threads.emplace_back([&]() {
+            OpenXR::InputState state = {};
+            uint64_t count = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                // two fields that are far apart in the struct, a torn snapshot would see them disagree
+                state.shared.inputTime = (XrTime)count;
+                state.shared.hmdRelativePoseLocation[1].pose.position.x = (float)(count & 0xFFFFFF);
+                store(state);
+                ++count;
+            }
+            writes = count;
+        });
+        for (uint32_t i = 0; i < readerThreads; i++) {
+            threads.emplace_back([&]() {
+                uint64_t count = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    OpenXR::InputState::Shared shared = load();
+                    if ((float)(shared.inputTime & 0xFFFFFF) != shared.hmdRelativePoseLocation[1].pose.position.x) {
+                        torn++;
+                    }
+                    ++count;
+                }
+                reads += count;
+            });
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::this_thread::sleep_for(duration);
+        stop = true;
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        return { reads.load(), writes.load(), torn.load(), std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() };
+    }
+
+    void LogResult(std::string_view name, const BenchmarkResult& result) {
+        Log::print<INFO>("{:<28} {:>10.2f}M reads/s, {:>8.2f}M writes/s, {} torn reads", name, (double)result.reads / result.seconds / 1e6, (double)result.writes / result.seconds / 1e6, result.tornReads);
+    }
+}
+
+// returns the amount of torn snapshots that the SeqLock readers saw (which should always be zero)
+static uint64_t BenchmarkStatePublication(uint32_t readerThreads, uint32_t durationMs) {
+    const std::chrono::milliseconds duration(durationMs);
+    Log::print<INFO>("Benchmarking InputState publication ({} bytes) with 1 writer and {} reader(s) for {} ms", sizeof(OpenXR::InputState), readerThreads, durationMs);
+
+    uint64_t seqLockTornReads = 0;
+    {
+        auto atomicState = std::make_unique<std::atomic<OpenXR::InputState>>(OpenXR::InputState{});
+        LogResult("std::atomic (full load):", RunContention(readerThreads, duration, [&]() { return atomicState->load().shared; }, [&](const OpenXR::InputState& state) { atomicState->store(state); }));
+    }
+    {
+        auto seqLockState = std::make_unique<SeqLock<OpenXR::InputState>>(OpenXR::InputState{});
+        BenchmarkResult result = RunContention(readerThreads, duration, [&]() { return seqLockState->load().shared; }, [&](const OpenXR::InputState& state) { seqLockState->store(state); });
+        LogResult("SeqLock (full load):", result);
+        seqLockTornReads += result.tornReads;
+        Log::print<INFO>("SeqLock reader retries: {}", seqLockState->GetReadRetries());
+    }
+    {
+        auto seqLockState = std::make_unique<SeqLock<OpenXR::InputState>>(OpenXR::InputState{});
+        BenchmarkResult result = RunContention(readerThreads, duration, [&]() { return seqLockState->load(&OpenXR::InputState::shared); }, [&](const OpenXR::InputState& state) { seqLockState->store(state); });
+        LogResult("SeqLock (shared field load):", result);
+        seqLockTornReads += result.tornReads;
+        Log::print<INFO>("SeqLock reader retries: {}", seqLockState->GetReadRetries());
+    }
+    return seqLockTornReads;
+}
+
+BETTERVR_TEST(StatePublication, []() { return BenchmarkStatePublication(2, 500); });
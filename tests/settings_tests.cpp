@@ -0,0 +1,52 @@
+#include "tests.h"
+#include "hooking/cemu_hooks.h"
+
+// scripts a fake screen manager in guest memory that opens and closes a few screens every frame and queries them many times per frame,
+// returns the amount of wrong answers plus the amount of frames where the screen table was chased more than once per screen (which should always be zero)
+static uint64_t ValidateGuestFrameCache(uint32_t frames, uint32_t queriesPerFrame) {
+    // only the range around the screen manager is backed by memory
+    constexpr uint32_t fakeMemoryStart = 0x10400000;
+    constexpr uint32_t screenManagerPtr = 0x1047E650;
+    constexpr uint32_t screenManager = 0x10480000;
+    constexpr uint32_t screenTable = 0x10481000;
+    std::vector<std::byte> fakeMemory(0x100000);
+    CemuHooks::s_memoryBaseAddress = (uint64_t)fakeMemory.data() - fakeMemoryStart;
+    CemuHooks::setMemory<uint32_t>(screenManagerPtr, screenManager);
+    CemuHooks::setMemory<uint32_t>(screenManager + 0x18, screenTable);
+
+    struct ScriptedScreen {
+        ScreenId id;
+        uint32_t openEvery;
+    };
+    constexpr std::array scriptedScreens = {
+        ScriptedScreen{ ScreenId::PauseMenuInfo_00, 5 },
+        ScriptedScreen{ ScreenId::ShopBG_00, 3 },
+        ScriptedScreen{ ScreenId::MessageDialog, 7 },
+    };
+
+    uint64_t errors = 0;
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        for (const ScriptedScreen& screen : scriptedScreens) {
+            uint32_t screenPtr = (frame % screen.openEvery == 0) ? 0x10482000 + std::to_underlying(screen.id) * 0x100 : 0;
+            CemuHooks::setMemory<uint32_t>(screenTable + std::to_underlying(screen.id) * 4, screenPtr);
+        }
+
+        CemuHooks::BeginGuestFrame();
+        uint64_t lookupsBefore = CemuHooks::GetScreenLookups();
+        for (uint32_t query = 0; query < queriesPerFrame; ++query) {
+            for (const ScriptedScreen& screen : scriptedScreens) {
+                errors += CemuHooks::IsScreenOpen(screen.id) != (frame % screen.openEvery == 0) ? 1 : 0;
+            }
+        }
+        errors += (CemuHooks::GetScreenLookups() - lookupsBefore) > scriptedScreens.size() ? 1 : 0;
+    }
+
+    CemuHooks::s_memoryBaseAddress = 0;
+    // don't let the scripted results leak into the next real frame
+    CemuHooks::BeginGuestFrame();
+
+    Log::print<INFO>("Guest frame cache test ({} frames x {} queries): {} errors", frames, queriesPerFrame, errors);
+    return errors;
+}
+
+BETTERVR_TEST(GuestFrameCache, []() { return ValidateGuestFrameCache(1000, 100); });
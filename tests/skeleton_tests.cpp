@@ -0,0 +1,225 @@
+#include "tests.h"
+#include "hooking/skeleton.h"
+#include "hooking/cemu_hooks.h"
+#include "hooking/frame_context.h"
+#include "rendering/openxr.h"
+
+// builds a fake player model and a fake NPC model with boneCount bones each and resolves every bone for a number of frames,
+// once with the string work hook_ModifyBoneMatrix used to do for every bone and once through the resolved bone tables,
+// returns the amount of bones where both disagree (which should always be zero)
+static uint64_t BenchmarkBoneResolution(uint32_t boneCount, uint32_t frames) {
+    // the upper body from the skeleton, some face bones and made-up bones for the rest
+    std::vector<std::string> boneNames;
+    for (const BoneDefinition& definition : SKELETON_BONES) {
+        boneNames.emplace_back(definition.name);
+    }
+    for (const char* faceBone : { "Eyelid_L", "Eyelid_R", "Cheek_L", "Cheek_R", "Lip_Upper", "Lip_Lower", "Hair_A_1", "Teeth_Upper", "Nose", "Ponytail_A_1" }) {
+        boneNames.emplace_back(faceBone);
+    }
+    for (uint32_t i = 0; boneNames.size() < boneCount; ++i) {
+        boneNames.emplace_back(std::format("Finger_{}_{}_{}", i / 6, i % 3, (i % 2 == 0) ? "L" : "R"));
+    }
+    boneNames.resize(boneCount);
+
+    constexpr uint32_t playerModel = 0x1000;
+    constexpr uint32_t npcModel = 0x2000;
+    constexpr uint32_t firstBoneName = 0x3000;
+    constexpr uint32_t boneNameStride = 0x20;
+    std::vector<std::byte> fakeMemory(firstBoneName + (size_t)boneCount * boneNameStride);
+    CemuHooks::s_memoryBaseAddress = (uint64_t)fakeMemory.data();
+
+    auto setModelName = [&](uint32_t modelPtr, std::string_view name) {
+        const uint32_t namePtr = modelPtr + 0x128;
+        CemuHooks::setMemory<uint32_t>(namePtr + offsetof(sead::FixedSafeString100, c_str), namePtr + offsetof(sead::FixedSafeString100, data));
+        memcpy(fakeMemory.data() + namePtr + offsetof(sead::FixedSafeString100, data), name.data(), name.size());
+    };
+    setModelName(playerModel, "GameROMPlayer");
+    setModelName(npcModel, "Npc_Hylia_Man");
+    for (uint32_t i = 0; i < boneCount; ++i) {
+        memcpy(fakeMemory.data() + firstBoneName + i * boneNameStride, boneNames[i].c_str(), std::min<size_t>(boneNames[i].size(), boneNameStride - 1));
+    }
+
+    // how hook_ModifyBoneMatrix used to find out what to do with each bone
+    std::map<std::string, int> boneNameMap;
+    for (size_t i = 0; i < SKELETON_BONES.size(); ++i) {
+        boneNameMap[std::string(SKELETON_BONES[i].name)] = (int)i;
+    }
+    auto resolveLegacy = [&](uint32_t gsysModelPtr, uint32_t boneNamePtr) -> std::optional<ResolvedBone> {
+        const auto modelName = CemuHooks::getMemory<sead::FixedSafeString100>(gsysModelPtr + 0x128);
+        if (modelName.getLE() != "GameROMPlayer") return std::nullopt;
+
+        std::string boneName((char*)(CemuHooks::s_memoryBaseAddress + boneNamePtr));
+        ResolvedBone bone;
+        bone.isLeft = boneName.ends_with("_L");
+        bone.flags |= isFaceBone(boneName) ? ResolvedBone::FACE : 0;
+        auto it = boneNameMap.find(boneName);
+        bone.skeletonBone = it != boneNameMap.end() ? (SkeletonBone)it->second : SkeletonBone::NONE;
+        if (boneName == "Arm_1_L" || boneName == "Arm_1_R" || boneName == "Elbow_L" || boneName == "Elbow_R" || boneName == "Wrist_Assist_L" || boneName == "Wrist_Assist_R") {
+            bone.flags |= ResolvedBone::SOLVE_ARM_IK;
+        }
+        if (boneName == "Wrist_L" || boneName == "Wrist_R" || boneName == "Wrist_Assist_L" || boneName == "Wrist_Assist_R") {
+            bone.flags |= ResolvedBone::ALIGN_WITH_CONTROLLER;
+        }
+        return bone;
+    };
+
+    auto sameBone = [](const std::optional<ResolvedBone>& a, const ResolvedBone* b) {
+        if (!a.has_value() || b == nullptr) {
+            return !a.has_value() && b == nullptr;
+        }
+        return a->skeletonBone == b->skeletonBone && a->flags == b->flags && a->isLeft == b->isLeft;
+    };
+
+    std::vector<std::optional<ResolvedBone>> legacyResults((size_t)boneCount * 2);
+    std::vector<const ResolvedBone*> tableResults((size_t)boneCount * 2);
+    uint64_t mismatches = 0;
+    double legacyNs = 0.0;
+    double tableNs = 0.0;
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        CemuHooks::BeginGuestFrame();
+
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t model = 0; model < 2; ++model) {
+            for (uint32_t i = 0; i < boneCount; ++i) {
+                legacyResults[model * boneCount + i] = resolveLegacy(model == 0 ? playerModel : npcModel, firstBoneName + i * boneNameStride);
+            }
+        }
+        legacyNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        start = std::chrono::high_resolution_clock::now();
+        for (uint32_t model = 0; model < 2; ++model) {
+            for (uint32_t i = 0; i < boneCount; ++i) {
+                ModelBones* modelBones = GetPlayerModelBones(model == 0 ? playerModel : npcModel, CemuHooks::GetGuestFrame());
+                tableResults[model * boneCount + i] = modelBones != nullptr ? &GetResolvedBone(*modelBones, i, firstBoneName + i * boneNameStride) : nullptr;
+            }
+        }
+        tableNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        for (size_t i = 0; i < legacyResults.size(); ++i) {
+            mismatches += sameBone(legacyResults[i], tableResults[i]) ? 0 : 1;
+        }
+    }
+
+    ClearModelBones();
+    CemuHooks::s_memoryBaseAddress = 0;
+    CemuHooks::BeginGuestFrame();
+
+    double bones = (double)frames * (double)boneCount * 2.0;
+    Log::print<INFO>("Bone resolution benchmark ({} bones x 2 models x {} frames): string compares = {:.1f} ns/bone, resolved tables = {:.1f} ns/bone, {} mismatches", boneCount, frames, legacyNs / bones, tableNs / bones, mismatches);
+    return mismatches;
+}
+
+// builds a fake player model with a synthetic bone palette of boneCount bones, with the skeleton bones stored children first, and copies its bones
+// for a number of frames like custom_gsys_ModelUnit_getBoneLocalMatrix does: once bone by bone through hook_ModifyBoneMatrix alone like it used to,
+// and once after hook_PrepareModelBones where only the bones in the mask that it filled go through hook_ModifyBoneMatrix. the bones have to come
+// out the same even though the arm IK depends on the bones that come before, so the prepared path has to keep the guest's bone order.
+// the cost of the PPC to host transition itself can only be seen in Cemu, this measures the host side of the paths and counts how many transitions the prepared path still needs.
+// returns the amount of bones where the prepared path doesn't match the per-bone path, plus the frames where the bone palette itself got modified (which should always be zero)
+static uint64_t BenchmarkBonePalette(uint32_t boneCount, uint32_t frames) {
+    // the arms and face of the player and made-up bones for the rest, Skl_Root is left out since it needs the headset pose from a running renderer
+    std::vector<std::string> boneNames;
+    for (const BoneDefinition& definition : SKELETON_BONES | std::views::reverse) {
+        if (definition.name != "Skl_Root") {
+            boneNames.emplace_back(definition.name);
+        }
+    }
+    for (const char* faceBone : { "Eyelid_L", "Eyelid_R", "Cheek_L", "Cheek_R", "Lip_Upper", "Lip_Lower", "Hair_A_1", "Teeth_Upper", "Nose", "Ponytail_A_1" }) {
+        boneNames.emplace_back(faceBone);
+    }
+    for (uint32_t i = 0; boneNames.size() < boneCount; ++i) {
+        boneNames.emplace_back(std::format("Finger_{}_{}_{}", i / 6, i % 3, (i % 2 == 0) ? "L" : "R"));
+    }
+    boneNames.resize(boneCount);
+
+    constexpr uint32_t playerModel = 0x1000;
+    constexpr uint32_t playerMtx = 0x1200;
+    constexpr uint32_t firstBoneName = 0x2000;
+    constexpr uint32_t boneNameStride = 0x20;
+    const uint32_t palette = firstBoneName + boneCount * boneNameStride;
+    const uint32_t paletteSize = boneCount * BONE_PALETTE_STRIDE;
+    const uint32_t perBoneCopies = palette + paletteSize;
+    const uint32_t preparedCopies = perBoneCopies + paletteSize;
+    const uint32_t boneHookMask = preparedCopies + paletteSize;
+    std::vector<std::byte> fakeMemory(boneHookMask + BONE_HOOK_MASK_WORDS * sizeof(uint32_t));
+    CemuHooks::s_memoryBaseAddress = (uint64_t)fakeMemory.data();
+    const uint32_t previousPlayerMtxAddress = CemuHooks::s_playerMtxAddress;
+    CemuHooks::s_playerMtxAddress = playerMtx;
+
+    const uint32_t modelNamePtr = playerModel + 0x128;
+    CemuHooks::setMemory<uint32_t>(modelNamePtr + offsetof(sead::FixedSafeString100, c_str), modelNamePtr + offsetof(sead::FixedSafeString100, data));
+    memcpy(fakeMemory.data() + modelNamePtr + offsetof(sead::FixedSafeString100, data), "GameROMPlayer", 13);
+    CemuHooks::setMemory(playerMtx, BEMatrix34{ glm::mat4x3(1.0f) });
+    for (uint32_t i = 0; i < boneCount; ++i) {
+        memcpy(fakeMemory.data() + firstBoneName + i * boneNameStride, boneNames[i].c_str(), std::min<size_t>(boneNames[i].size(), boneNameStride - 1));
+
+        glm::mat4x3 local = glm::mat4x3(glm::mat3_cast(glm::angleAxis(0.1f * (float)i, glm::normalize(glm::fvec3(1.0f, 2.0f, 3.0f)))));
+        local[3] = glm::fvec3(0.01f * (float)i, 0.02f, -0.01f * (float)(i % 7));
+        CemuHooks::setMemory(palette + i * BONE_PALETTE_STRIDE + BONE_PALETTE_SCALE_OFFSET, glm::fvec3(1.0f));
+        CemuHooks::setMemory(palette + i * BONE_PALETTE_STRIDE + BONE_PALETTE_MATRIX_OFFSET, BEMatrix34{ local });
+    }
+    const std::vector<std::byte> animatedPalette(fakeMemory.begin() + palette, fakeMemory.begin() + perBoneCopies);
+
+    // both controllers are tracked in front of the player
+    OpenXR::InputState inputState = {};
+    for (uint32_t side = 0; side < 2; ++side) {
+        inputState.shared.pose[side].isActive = XR_TRUE;
+        inputState.shared.poseLocation[side].locationFlags = XR_SPACE_LOCATION_POSITION_VALID_BIT | XR_SPACE_LOCATION_ORIENTATION_VALID_BIT;
+        inputState.shared.poseLocation[side].pose = { { 0.0f, 0.0f, 0.0f, 1.0f }, { side == 0 ? -0.2f : 0.2f, 1.2f, -0.4f } };
+    }
+    auto input = std::make_unique<SeqLock<OpenXR::InputState>>(inputState);
+    auto gameState = std::make_unique<SeqLock<OpenXR::GameState>>(OpenXR::GameState{});
+    HookFrameContext::Capture(*input, *gameState);
+
+    // what the guest does for every bone, copy the matrix and scale out of the palette and let hook_ModifyBoneMatrix change the copy
+    auto copyBone = [&](uint32_t boneIdx, uint32_t copies, bool callHook = true) {
+        const uint32_t entry = copies + boneIdx * BONE_PALETTE_STRIDE;
+        memcpy(fakeMemory.data() + entry, fakeMemory.data() + palette + boneIdx * BONE_PALETTE_STRIDE, BONE_PALETTE_STRIDE);
+        if (!callHook) return;
+        ModifyBoneMatrix(playerModel, entry + BONE_PALETTE_MATRIX_OFFSET, entry + BONE_PALETTE_SCALE_OFFSET, firstBoneName + boneIdx * boneNameStride, boneIdx);
+    };
+
+    double perBoneNs = 0.0;
+    double preparedNs = 0.0;
+    uint64_t mismatches = 0;
+    uint64_t preparedHookCalls = 0;
+    for (uint32_t frame = 0; frame < frames; ++frame) {
+        CemuHooks::BeginGuestFrame();
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t i = 0; i < boneCount; ++i) {
+            copyBone(i, perBoneCopies);
+        }
+        perBoneNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        CemuHooks::BeginGuestFrame();
+        start = std::chrono::high_resolution_clock::now();
+        mismatches += PrepareModelBones(playerModel, boneHookMask) ? 1 : 0;
+        for (uint32_t i = 0; i < boneCount; ++i) {
+            const bool callHook = i >= BONE_HOOK_MASK_BONES || ((CemuHooks::getMemory<uint32_t>(boneHookMask + (i / 32) * sizeof(uint32_t)).getLE() >> (i % 32)) & 1) != 0;
+            copyBone(i, preparedCopies, callHook);
+            preparedHookCalls += callHook ? 1 : 0;
+        }
+        preparedNs += std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count();
+
+        mismatches += memcmp(fakeMemory.data() + palette, animatedPalette.data(), animatedPalette.size()) != 0 ? 1 : 0;
+        // the bones only get resolved once the guest copied them, so the first frame can't be prepared yet
+        if (frame == 0) continue;
+        for (uint32_t i = 0; i < boneCount; ++i) {
+            const uint32_t entry = i * BONE_PALETTE_STRIDE;
+            mismatches += memcmp(fakeMemory.data() + perBoneCopies + entry, fakeMemory.data() + preparedCopies + entry, BONE_PALETTE_STRIDE) != 0 ? 1 : 0;
+        }
+    }
+
+    ClearModelBones();
+    input->store(OpenXR::InputState{});
+    HookFrameContext::Capture(*input, *gameState);
+    CemuHooks::s_playerMtxAddress = previousPlayerMtxAddress;
+    CemuHooks::s_memoryBaseAddress = 0;
+    CemuHooks::BeginGuestFrame();
+
+    double bones = (double)frames * (double)boneCount;
+    Log::print<INFO>("Bone palette benchmark ({} bones x {} frames): per-bone = {:.1f} ns/bone, prepared = {:.1f} ns/bone ({:.1f} hook calls per frame), {} mismatches", boneCount, frames, perBoneNs / bones, preparedNs / bones, (double)preparedHookCalls / (double)frames, mismatches);
+    return mismatches;
+}
+
+BETTERVR_TEST(BoneResolution, []() { return BenchmarkBoneResolution(120, 1000); });
+BETTERVR_TEST(BonePalette, []() { return BenchmarkBonePalette(120, 1000); });
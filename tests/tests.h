@@ -0,0 +1,31 @@
+#pragma once
+
+class OpenXR;
+
+// The tests and benchmarks that check the mod's optimizations against the code they replaced, without Cemu, the game or a headset.
+// Each one returns the amount of mismatches or failed checks (so zero when it passed) and logs its timings.
+// They're registered with BETTERVR_TEST at static initialization and run by BetterVR_Tests, which is only built with BETTERVR_BUILD_TESTS.
+namespace Tests {
+    struct Test {
+        std::string_view name;
+        std::function<uint64_t()> run;
+    };
+
+    std::vector<Test>& GetTests();
+
+    struct Registration {
+        Registration(std::string_view name, std::function<uint64_t()> run) {
+            GetTests().emplace_back(name, std::move(run));
+        }
+    };
+
+    // VRManager's OpenXR instance with a running session on the mock runtime, which mock_loader.cpp sends the OpenXR calls to
+    OpenXR& GetMockSession();
+
+    // directory of the source tree, for tests that read files from resources/
+    inline std::filesystem::path GetSourceDirectory() {
+        return BETTERVR_SOURCE_DIR;
+    }
+}
+
+#define BETTERVR_TEST(name, ...) static const Tests::Registration s_##name##Test(#name, __VA_ARGS__)
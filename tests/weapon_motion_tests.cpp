@@ -0,0 +1,441 @@
+#include "tests.h"
+#include "hooking/cemu_hooks.h"
+#include "hooking/weapon.h"
+#include <random>
+
+namespace {
+    // WeaponMotionAnalyser's attack detection as it was before the features were extracted once per update and the profile became static,
+    // kept to check that the current one still comes to exactly the same results
+    class LegacyWeaponMotionAnalyser {
+    public:
+        static constexpr int MAX_SAMPLES = WeaponMotionAnalyser::MAX_SAMPLES;
+        static constexpr int BAD_SAMPLES_BUFFER = WeaponMotionAnalyser::BAD_SAMPLES_BUFFER;
+        static constexpr float HAND_VELOCITY_LENGTH_THRESHOLD = WeaponMotionAnalyser::HAND_VELOCITY_LENGTH_THRESHOLD;
+
+        static constexpr float dist_threshold = 0.6f; // max distance from head to consider attack
+        XrTime COOLDOWN_TIME = int(1e9*2.0f); // 0.5 s in nano seconds
+
+        WeaponProfile profile = SpearProfile();
+
+        // New member variables for angular velocity plot
+        glm::fvec3 m_lastPlottedAngularVelocity = {0.0f, 0.0f, 0.0f};
+        bool m_hasValidLastPlottedAngularVelocity = false;
+        static constexpr float ANGULAR_VELOCITY_THRESHOLD = 0.1f;
+        float max_range = 0.0f;
+        glm::fvec3 prev_lin_vel = glm::fvec3(0.0f);
+        glm::fvec3 prev_ang_vel = glm::fvec3(.0f);
+        XrTime prev_sample = 0;
+
+        XrTime time_since_last_attack[2] = { 0, 0 }; // Time elapsed since last attack
+
+        glm::fvec3 prev_AngularVelocity = glm::fvec3();
+
+        bool handVelocityToggled = false;
+        float handVelocityLength = 0.0f;
+
+        void Update(const XrSpaceLocation& handLocation, const XrSpaceVelocity& handVelocity, const glm::fmat4& headsetMtx, const XrTime inputTime) {
+            // Get velocity expressed in controller space
+            const glm::fvec3 linearVelocity = ToGLM(handVelocity.linearVelocity);
+            const glm::fvec3 angularVelocity = ToGLM(handVelocity.angularVelocity);
+
+            const glm::fquat rotation = ToGLM(handLocation.pose.orientation); // rotation of controller w.r.t. world
+            const glm::fvec3 position = ToGLM(handLocation.pose.position);
+
+            const glm::fvec3 headsetPostion = glm::fvec3(headsetMtx[3]);
+            const glm::fquat headsetRotation = glm::quat_cast(headsetMtx); // Angular rotation vector
+
+            // new variant of attack detection based on velocity threshold
+            handVelocityLength = glm::length(linearVelocity);
+            handVelocityToggled = handVelocityLength >= HAND_VELOCITY_LENGTH_THRESHOLD;
+
+            m_rollingSamples[m_rollingSamplesIt] = {
+                .time = inputTime,
+                .position = position,
+                .rotation = rotation,
+                .linearVelocity = linearVelocity,
+                .angularVelocity = angularVelocity, // angular velocity in world space
+                .debug_attackType = AttackType::None,
+                .debug_expVelocityLengthEnabled = handVelocityToggled
+            };
+            m_lastSampleIdx = m_rollingSamplesIt;
+            m_rollingSamplesIt = (m_rollingSamplesIt + 1) % MAX_SAMPLES;
+
+            // Determine max range from hand positions
+            float curr_distance = glm::distance(position, headsetPostion);
+            max_range = glm::max(max_range, dist_threshold*curr_distance); // maximum reached value currently (decreased using factor 'dist_threshold' to avoid outliers)
+            //Log::print("!! range: {}/{}", curr_distance, max_range);
+
+            // ----- Find if rotation is towards center of view -----
+            const glm::fvec3 pos_rot_axis = glm::cross(headsetRotation * glm::fvec3(0, 0, -1), rotation * glm::fvec3(0, 0, 1)); // cross product from sword x to forward camera axis
+            const bool swing_is_forwards = glm::dot(pos_rot_axis, angularVelocity) > 0;
+            //Log::print("!! is forward: {}", swing_is_forwards ? "true" : "false");
+            //const float ang = glm::asin(glm::length(pos_rot_axis));
+
+            //Log::print("!! is_attacking: );
+            // ---- Find local velocities & accelerations -----
+            const glm::fvec3 localLinearVelocity = glm::inverse(rotation) * linearVelocity;
+            float dt = (float)(inputTime - prev_sample) / 1000000000.0f;
+            const glm::fvec3 localLinearAcceleration = (localLinearVelocity - prev_lin_vel) / glm::fvec3(dt); // TODO: add stab_acc threshold | Make stab continue as long as velocity follows acceleration (<0)
+
+            // ---- find angular velocity drift ----
+            // Log::print<CONTROLS>("angvel: {} \n prev_av: {}\ndt: {}\n dot: {}\nacos: {}", angularVelocity, prev_AngularVelocity, dt, glm::dot(angularVelocity, prev_AngularVelocity), acos(glm::dot(angularVelocity, prev_AngularVelocity)));
+
+            float angular_drift = acos(glm::dot(glm::normalize(angularVelocity), glm::normalize(prev_AngularVelocity)))/dt; // Angular velocity drift (defined as the angular velocity of the rotating angular velocity i.e. how much rad/s the orthogonal vector of rotation moves)
+
+            m_rollingSamples[m_lastSampleIdx].rotLinearAccel = localLinearAcceleration;
+
+
+
+            //Log::print("!! Acc: {} {} {}", localLinearAcceleration.x, localLinearAcceleration.y, localLinearAcceleration.z);
+
+            // For virtual desktop via steam vr -> use inv(rotation) * angular velocity
+            const glm::fvec3 localAngularVelocity = glm::inverse(rotation) * angularVelocity; // what DebugSample::rotatedAngularVelocity() used to calculate
+
+        
+            // --- Get approximation of angular acceleration over xy plane ---
+            glm::fvec3 flat_ang_vel = localAngularVelocity - (glm::fvec3(.0, .0, localAngularVelocity.z)); // Get rotation vector over xy plane
+            float flat_ang_acc = (glm::length(flat_ang_vel) - glm::length(prev_ang_vel))/dt;
+
+            prev_ang_vel = flat_ang_vel;
+        
+            //Log::print("!! position_world: {}", position);
+            //Log::print("!! v_local: {}", localLinearVelocity);
+            profile.stab_SpeedThreshold = 0.05f;
+            profile.stab_AccThreshold = 5.0f;
+            profile.stab_LinearSteadinessThreshold = glm::cos(glm::pi<float>() / 4.5); // 15 deg accuracy cone
+            profile.stab_AngularSteadinessThreshold = 4.5; // [rad/s]
+            profile.stab_travelDistance = 0.15f;
+            profile.slash_SpeedThreshold = 1.0f;
+            profile.slash_AccThreshold = 20.0f;
+            profile.slash_AccDriftThreshold = 10.0f; // use [rad/s^2]
+            COOLDOWN_TIME = 0.0f*1e9; // TODO: DIFFERENT COOLDOWN FOR STABS AND SWINGS
+
+            //Log::print("!! steadiness: {} / {}", glm::normalize(localAngularVelocity).y, profile.slash_SteadinessThreshold);
+            profile.slash_travelAngle = glm::pi<float>() / 6;
+            // Detect velocity threshold -> set attack type if not in attack & store original angle/position
+            AttackType prev_attack = m_lockedAttackType;
+
+            detect_attack_type(localLinearVelocity, localLinearAcceleration, localAngularVelocity, flat_ang_acc, position, rotation, swing_is_forwards);
+
+            // Log::print("!! attack_state: {}", (int)m_lockedAttackType);
+
+            // Check if attack falls within weaponprofile velocity & angle margins -> if not cancel attack & go back to checking for attack
+            check_attack_steadiness(localLinearVelocity, localAngularVelocity, angular_drift);
+            //Log::print("!! m_badSampleCtr: {}", m_badSampleCtr);
+
+            // Check if delta_angle/delta_translation is enough to enable attack mode
+            set_attack_activity(rotation, position);
+
+            // Log::print("!! AttackType: {} - IsAttacking = {} - bad_samples: {} - v_world: ({}): ", (int)m_lockedAttackType, IsAttacking() ? "true": "false", m_badSampleCtr, localLinearVelocity);
+
+            m_rollingSamples[m_lastSampleIdx].debug_attackType = IsAttacking() ? m_lockedAttackType: AttackType::None;
+
+            // Log::print<CONTROLS>("{}", time_since_last_attack);
+            // time since last attack update
+            for (int i = 0; i < 2; i++) {
+                time_since_last_attack[i] += inputTime - prev_sample;
+                time_since_last_attack[i]  = std::min(time_since_last_attack[i], COOLDOWN_TIME);
+            }
+
+            if (m_lockedAttackType != AttackType::None && prev_attack != m_lockedAttackType) { // if start of new attack
+                // Log::print<CONTROLS>("Switched attack to: {}", m_lockedAttackType == AttackType::Slash ? "slash" : "stab");
+                time_since_last_attack[static_cast<int>(m_lockedAttackType) - 1] = 0; // reset timer for this attack type
+            }
+
+            prev_AngularVelocity = angularVelocity;
+            prev_lin_vel = localLinearVelocity;
+            prev_sample = inputTime;
+        }
+
+        void detect_attack_type(const glm::fvec3 localLinearVelocity, const glm::fvec3 localLinearAcceleration, const glm::fvec3 localAngularVelocity, const float flag_ang_acc, const glm::fvec3 position, const glm::fquat rotation, const bool swing_is_forward) {
+            // Log::print<CONTROLS>("[WeaponMotionAnalyser] Detecting attack type with linear velocity: {}, attack type = {}, active: {}", localLinearVelocity, static_cast<int>(m_lockedAttackType), static_cast<int>(m_attackActivity));
+
+            if (m_lockedAttackType == AttackType::None) {
+                glm::fvec3 dir_ang = glm::normalize(localAngularVelocity);
+                glm::fvec3 stab_ang = glm::normalize(localLinearVelocity);
+
+                //Log::print<CONTROLS>("controller angular velocity {}, {}, {}", abs(localAngularVelocity).x, abs(localAngularVelocity).y, abs(localAngularVelocity).z);
+                //Log::print<CONTROLS>("linear acc reached {}", -localLinearAcceleration.z > profile.stab_AccThreshold);
+
+                if (abs(localAngularVelocity).x < profile.stab_AngularSteadinessThreshold && abs(localAngularVelocity).y < profile.stab_AngularSteadinessThreshold && abs(-stab_ang.z) > profile.stab_LinearSteadinessThreshold && -localLinearAcceleration.z > profile.stab_AccThreshold) {
+                    if (time_since_last_attack[int(AttackType::Stab)-1] >= COOLDOWN_TIME) {
+                        // Log::print<CONTROLS>("Failed due to: {}", );
+                        m_lockedPosition = position;
+                        m_goodStabSampleCtr++;
+                        Log::print<CONTROLS>("Stab detect attack");
+                        if (m_goodStabSampleCtr > 1) {
+                            m_lockedAttackType = AttackType::Stab;
+                        }
+                    };
+                
+                }else {
+                    m_goodStabSampleCtr = 0;
+                }
+                if (flag_ang_acc > profile.slash_AccThreshold && !swing_is_forward) {
+                    Log::print<CONTROLS>("Slash detected but not forward");
+                }
+                if (/*abs(dir_ang.x) > profile.slash_SteadinessThreshold &&*/ flag_ang_acc > profile.slash_AccThreshold /*&& swing_is_forward*/) {
+                    if (time_since_last_attack[int(AttackType::Slash)-1] >= COOLDOWN_TIME) {
+                        // Log::print<CONTROLS>("cooldown currently: {}/{}", time_since_last_attack[int(AttackType::Slash) - 1], COOLDOWN_TIME);
+
+                        m_goodSwingSampleCtr++;
+                        m_lockedAngle = rotation * glm::fvec3(0.0f, 0.0f, 1.0f); // store z-axis
+                        Log::print<CONTROLS>("slash attack detected");
+                        if (m_goodSwingSampleCtr > 1) {
+                            m_lockedAttackType = AttackType::Slash;
+                            //Log::print<CONTROLS>("Initiate swing");
+                        }
+                    }
+                }
+                else {
+                    m_goodSwingSampleCtr = 0;
+                }
+            }
+        }
+
+        void check_attack_steadiness(const glm::fvec3 localLinearVelocity, const glm::fvec3 localAngularVelocity, const float angular_drift) {
+            // check steadiness condition for attack types
+            switch (m_lockedAttackType) {
+                case AttackType::None: { 
+                    //m_badSampleCtr = 0;
+                    return;
+                }
+                case AttackType::Stab: {
+                    glm::fvec3 stab_ang = glm::normalize(localLinearVelocity);
+
+                    if (abs(stab_ang.z) < profile.stab_LinearSteadinessThreshold || -localLinearVelocity.z < profile.stab_SpeedThreshold || glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0)) > profile.stab_AngularSteadinessThreshold || abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold) {
+                        m_badSampleCtr++;
+                        bool speed_issue = abs(stab_ang.z) < profile.stab_LinearSteadinessThreshold && abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold && abs(localAngularVelocity).x > profile.stab_AngularSteadinessThreshold;
+                        // Log::print<CONTROLS>("Failed due to {}", speed_issue ? "Speed is too low" : "Steadiness is too shit");
+                        //if (speed_issue) {
+                            //Log::print<CONTROLS>(" Speed is {}/{}", -localLinearVelocity.z, profile.stab_SpeedThreshold);
+                        //}
+                    }
+                    else {
+                        m_badSampleCtr = 0;
+                        //Log::print<CONTROLS>("Speed is {}", -localLinearVelocity);
+                    }
+                    break;
+                }
+                case AttackType::Slash: {
+                    glm::fvec3 dir_ang = glm::normalize(localAngularVelocity);
+                    // Log::print<CONTROLS>("velocity ok: {}/{}: {}", glm::length(localAngularVelocity - glm::fvec3(.0, .0, localAngularVelocity.z)), profile.slash_SpeedThreshold, glm::length(localAngularVelocity - glm::fvec3(.0, .0, localAngularVelocity.z)) < profile.slash_SpeedThreshold);
+
+                    // Log::print<CONTROLS>("angular drift: {}/{}: {}", angular_drift, profile.slash_AccDriftThreshold, angular_drift > profile.slash_AccDriftThreshold);
+                    if (/*abs(dir_ang.x) < profile.slash_SteadinessThreshold ||*/ angular_drift > profile.slash_AccDriftThreshold || glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0f)) < profile.slash_SpeedThreshold) { // abs( - localAngularVelocity.x) < profile.slash_SpeedThreshold * 0.2f TODO: SLash speed should be directional (i.e. reversing slash direction should end it). During locking: store sign of swing direction, check if this is still valid here.
+                        bool drift_fail = angular_drift > profile.slash_AccDriftThreshold;
+                    
+                        if (drift_fail) {
+                            Log::print<CONTROLS>("[FAIL]: Drift: {}/{}",  angular_drift, profile.slash_AccDriftThreshold);
+                        }
+                        else {
+                            Log::print<CONTROLS>("[FAIL]: Angular velocity: {}/{}", glm::length(glm::fvec3(localAngularVelocity.x, localAngularVelocity.y, 0.0f)), profile.slash_SpeedThreshold);
+                        }
+                    
+                        m_badSampleCtr++;
+                    }
+                    else {
+                        m_badSampleCtr  = 0;
+                    }
+                    break;
+                }
+            }
+        
+            // Remove attack type if too many bad samples
+            if (m_badSampleCtr >= BAD_SAMPLES_BUFFER) {
+                m_badSampleCtr = 0;
+                //Log::print<CONTROLS>("removed attack due to bad samples");
+                m_lockedAttackType = AttackType::None;
+            }
+        }
+
+        void set_attack_activity(const glm::fquat rotation, const glm::fvec3 position) {
+            if (m_lockedAttackType ==  AttackType::None) {
+                m_attackActivity = false;
+            }
+            else if (!m_attackActivity) {
+                switch (m_lockedAttackType) {
+                    case AttackType::Stab: {
+                        const float travel_dist = glm::length(position - m_lockedPosition);
+                        Log::print<CONTROLS>("travel distance: {}", travel_dist);
+                        if (travel_dist > profile.stab_travelDistance) {
+                            m_attackActivity = true;
+                        }
+                        break;
+                    }
+                    case AttackType::Slash: {
+                        // Assumptions:
+                        // - Rotation (wind-up) only occures along x axis
+                        // - detection angle is smaller than 180 deg (calculated angle decreases after 180 degrees)
+                        const glm::fvec3 z_start = m_lockedAngle;
+                        const glm::fvec3 z_now = rotation * glm::fvec3(0.0f, 0.0f, 1.0f);
+                        const float dot_product = glm::dot(z_now, z_start);
+                        const float ang_difference = glm::acos(dot_product); // would be more performant to dot_product as comparison value and change profile.slash_travelAngle to cos(angle) instead of angle
+                        //Log::print<CONTROLS>("angle_dif: {}", ang_difference);
+
+                        if (ang_difference > profile.slash_travelAngle) {
+                            m_attackActivity = true;
+                        }
+                        break;
+                    }
+                    default: {
+                        break;
+                    };
+                }
+            }
+        }
+
+        bool IsAttacking() const {
+            return m_attackActivity;
+        }
+
+        float GetAttackImpulse() const {
+            if (m_lockedAttackType == AttackType::Slash) {
+                return std::clamp((float)m_goodSwingSampleCtr / 5.0f, 0.0f, 1.0f);
+            }
+            else if (m_lockedAttackType == AttackType::Stab) {
+                return std::clamp((float)m_goodStabSampleCtr / 5.0f, 0.0f, 1.0f);
+            }
+            return 0.0f;
+        }
+
+        std::array<DebugSample, MAX_SAMPLES> m_rollingSamples = {};
+        uint32_t m_lastSampleIdx = 0;
+        uint32_t m_rollingSamplesIt = 0;
+
+        uint32_t m_goodSwingSampleCtr = 0;
+        bool m_attackActivity = false;
+        uint32_t m_badSampleCtr = 0;
+        AttackType m_lockedAttackType = AttackType::None;
+        glm::fvec3 m_lockedPosition = {};
+        glm::fvec3 m_lockedAngle = {};
+        uint32_t m_goodStabSampleCtr = 0;
+    };
+
+    struct MotionFrame {
+        XrSpaceLocation location;
+        XrSpaceVelocity velocity;
+        glm::fmat4 headset;
+        XrTime time;
+    };
+
+    // made-up hand motion at around 90 Hz, with slashes around the controller's x axis, stabs along its -z axis, flailing and idle hands in between
+    std::vector<MotionFrame> GenerateMotionCorpus(uint32_t rounds, uint32_t seed) {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> unit(-1.0f, 1.0f);
+        std::vector<MotionFrame> frames;
+
+        const glm::fmat4 headset = glm::translate(glm::fmat4(1.0f), glm::fvec3(0.0f, 1.6f, 0.0f));
+        XrTime time = 1'000'000'000;
+        glm::fquat rotation = glm::identity<glm::fquat>();
+        glm::fvec3 position = glm::fvec3(0.0f);
+
+        auto addFrame = [&](glm::fvec3 localLinearVelocity, glm::fvec3 localAngularVelocity) {
+            // the occasional repeated timestamp, like when the runtime doesn't have a newer pose yet
+            XrTime dt = (rng() % 40 == 0) ? 0 : 11'111'111 + (XrTime)(unit(rng) * 500'000.0f);
+            time += dt;
+            const float dtSeconds = (float)dt / 1e9f;
+
+            const glm::fvec3 linearVelocity = rotation * localLinearVelocity;
+            const glm::fvec3 angularVelocity = rotation * localAngularVelocity;
+            position += linearVelocity * dtSeconds;
+            if (float speed = glm::length(localAngularVelocity); speed > 0.0f) {
+                rotation = glm::normalize(rotation * glm::angleAxis(speed * dtSeconds, localAngularVelocity / speed));
+            }
+
+            MotionFrame& frame = frames.emplace_back();
+            frame.location = { XR_TYPE_SPACE_LOCATION };
+            frame.location.pose.orientation = { rotation.x, rotation.y, rotation.z, rotation.w };
+            frame.location.pose.position = { position.x, position.y, position.z };
+            frame.velocity = { XR_TYPE_SPACE_VELOCITY };
+            frame.velocity.linearVelocity = { linearVelocity.x, linearVelocity.y, linearVelocity.z };
+            frame.velocity.angularVelocity = { angularVelocity.x, angularVelocity.y, angularVelocity.z };
+            frame.headset = headset;
+            frame.time = time;
+        };
+        auto jitter = [&](float amount) { return glm::fvec3(unit(rng), unit(rng), unit(rng)) * amount; };
+        auto idle = [&](uint32_t count) {
+            for (uint32_t i = 0; i < count; ++i) {
+                addFrame(jitter(0.05f), jitter(0.2f));
+            }
+        };
+
+        for (uint32_t round = 0; round < rounds; ++round) {
+            rotation = glm::angleAxis(glm::radians(-30.0f + unit(rng) * 20.0f), glm::fvec3(1.0f, 0.0f, 0.0f));
+            position = glm::fvec3(0.25f, 1.2f, -0.3f) + jitter(0.1f);
+            idle(20);
+
+            const float slashSpeed = 10.0f + unit(rng) * 5.0f;
+            for (uint32_t i = 0; i < 14; ++i) {
+                float speed = slashSpeed * glm::sin(glm::pi<float>() * (float)i / 13.0f);
+                addFrame(jitter(0.3f), glm::fvec3(speed, 0.0f, 0.0f) + jitter(0.5f));
+            }
+            idle(10);
+
+            const float stabSpeed = 3.0f + unit(rng);
+            for (uint32_t i = 0; i < 12; ++i) {
+                float speed = stabSpeed * glm::sin(glm::pi<float>() * (float)i / 11.0f);
+                addFrame(glm::fvec3(0.0f, 0.0f, -speed) + jitter(0.1f), jitter(0.5f));
+            }
+            idle(10);
+
+            for (uint32_t i = 0; i < 8; ++i) {
+                addFrame(jitter(3.0f), jitter(10.0f));
+            }
+        }
+        return frames;
+    }
+}
+
+// runs a generated motion corpus through WeaponMotionAnalyser and the version from before its features were extracted once per update,
+// returns the amount of frames where their state differs in any bit (which should always be zero) and logs the cost per update of both
+static uint64_t ValidateWeaponMotionAnalyser(uint32_t rounds, uint32_t iterations) {
+    const std::vector<MotionFrame> corpus = GenerateMotionCorpus(rounds, 4321);
+
+    auto sameBits = [](const auto& a, const auto& b) {
+        static_assert(sizeof(a) == sizeof(b));
+        return memcmp(&a, &b, sizeof(a)) == 0;
+    };
+
+    LegacyWeaponMotionAnalyser legacy;
+    WeaponMotionAnalyser analyser;
+    uint64_t mismatches = 0;
+    std::array<uint32_t, 3> attackingFrames = {};
+    for (const MotionFrame& frame : corpus) {
+        legacy.Update(frame.location, frame.velocity, frame.headset, frame.time);
+        analyser.Update(frame.location, frame.velocity, frame.headset, frame.time);
+
+        bool matches = legacy.IsAttacking() == analyser.IsAttacking()
+            && legacy.m_lockedAttackType == analyser.GetLockedAttackType()
+            && sameBits(legacy.GetAttackImpulse(), analyser.GetAttackImpulse())
+            && sameBits(legacy.handVelocityLength, analyser.handVelocityLength)
+            && legacy.handVelocityToggled == analyser.handVelocityToggled
+            && sameBits(legacy.max_range, analyser.max_range)
+            && sameBits(legacy.time_since_last_attack, analyser.time_since_last_attack)
+            && sameBits(legacy.prev_lin_vel, analyser.prev_lin_vel)
+            && sameBits(legacy.prev_ang_vel, analyser.prev_ang_vel)
+            && sameBits(legacy.prev_AngularVelocity, analyser.prev_AngularVelocity);
+        mismatches += matches ? 0 : 1;
+
+        if (analyser.IsAttacking()) {
+            attackingFrames[std::to_underlying(analyser.GetLockedAttackType())]++;
+        }
+    }
+
+    auto timeUpdates = [&](auto& motionAnalyser) {
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+            for (const MotionFrame& frame : corpus) {
+                motionAnalyser.Update(frame.location, frame.velocity, frame.headset, frame.time);
+            }
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / ((double)iterations * (double)corpus.size());
+    };
+    double legacyNs = timeUpdates(legacy);
+    double analyserNs = timeUpdates(analyser);
+
+    Log::print<INFO>("Weapon motion analyser test ({} frames, {} slash and {} stab frames attacking): {} mismatches, legacy = {:.1f} ns/update, current = {:.1f} ns/update", corpus.size(), attackingFrames[std::to_underlying(AttackType::Slash)], attackingFrames[std::to_underlying(AttackType::Stab)], mismatches, legacyNs, analyserNs);
+    return mismatches;
+}
+
+BETTERVR_TEST(WeaponMotionAnalyser, []() { return ValidateWeaponMotionAnalyser(20, 100); });
@@ -0,0 +1,152 @@
+#include "tests.h"
+#include "hooking/cemu_hooks.h"
+#include "hooking/weapon.h"
+
+// checks every listed item (and some near misses around each of them) against the linear search isDroppable used to do and times both lookups,
+// returns the amount of names where both disagree (which should always be zero)
+static uint64_t BenchmarkDroppableWeapons(uint32_t iterations) {
+    // the list exactly as isDroppable had it before it got sorted, so that the linear search doesn't depend on s_nonDroppableItems in weapon.cpp
+    static constexpr std::array<std::string_view, 87> baselineNonDroppableItems = {
+        "AncientArrow",
+        "Animal_Insect_A",
+        "Animal_Insect_B",
+        "Animal_Insect_F",
+        "Animal_Insect_H",
+        "Animal_Insect_M",
+        "Animal_Insect_S",
+        "Animal_Insect_X",
+        "Armor_Default_Extra_00",
+        "Armor_Default_Extra_01",
+        "bj_SupportApp_Wind",
+        "BombArrow_A",
+        "BrightArrow",
+        "BrightArrowTP",
+        "CarryBox",
+        "Dm_Npc_Gerudo_HeroSoul_Kago",
+        "Dm_Npc_Goron_HeroSoul_Kago",
+        "Dm_Npc_RevivalFairy",
+        "Dm_Npc_Rito_HeroSoul_Kago",
+        "Dm_Npc_Zora_HeroSoul_Kago",
+        "ElectricArrow",
+        "Explode",
+        "FireArrow",
+        "FireRodLv1Fire",
+        "FireRodLv2Fire",
+        "FireRodLv2FireChild",
+        "GameRomHorseReins_01",
+        "GameRomHorseReins_02",
+        "GameRomHorseReins_03",
+        "GameRomHorseReins_04",
+        "GameRomHorseReins_05",
+        "GameRomHorseReins_10",
+        "GameRomHorseSaddle_01",
+        "GameRomHorseSaddle_02",
+        "GameRomHorseSaddle_03",
+        "GameRomHorseSaddle_04",
+        "GameRomHorseSaddle_05",
+        "GameRomHorseSaddle_10",
+        "GameROMPlayer",
+        "Get_TwnObj_DLC_MemorialPicture_A_01",
+        "IceArrow",
+        "IceRodLv1Ice",
+        "IceRodLv2Ice",
+        "Item_Conductor",
+        "Item_CookSet",
+        "Item_Magnetglove",
+        "Item_Material_01",
+        "Item_Material_03",
+        "Item_Material_07",
+        "Item_Ore_F",
+        "KeySmall",
+        "NormalArrow",
+        "Obj_Armor_115_Head",
+        "Obj_DLC_HeroSeal_Gerudo",
+        "Obj_DLC_HeroSeal_Goron",
+        "Obj_DLC_HeroSeal_Rito",
+        "Obj_DLC_HeroSeal_Zora",
+        "Obj_DLC_HeroSoul_Gerudo",
+        "Obj_DLC_HeroSoul_Goron",
+        "Obj_DLC_HeroSoul_Rito",
+        "Obj_DLC_HeroSoul_Zora",
+        "Obj_DRStone_A_01",
+        "Obj_DRStone_Get",
+        "Obj_DungeonClearSeal",
+        "Obj_HeartUtuwa_A_01",
+        "Obj_HeroSoul_Gerudo",
+        "Obj_HeroSoul_Goron",
+        "Obj_HeroSoul_Rito",
+        "Obj_HeroSoul_Zora",
+        "Obj_IceMakerBlock",
+        "Obj_KorokNuts",
+        "Obj_Maracas",
+        "Obj_ProofBook",
+        "Obj_ProofGiantKiller",
+        "Obj_ProofGolemKiller",
+        "Obj_ProofKorok",
+        "Obj_ProofSandwormKiller",
+        "Obj_StaminaUtuwa_A_01",
+        "Obj_WarpDLC",
+        "PlayerStole2",
+        "PlayerStole2_Vagrant",
+        "Weapon_Bow_071",
+        "Weapon_Sword_056",
+        "Weapon_Sword_070",
+        "Weapon_Sword_080",
+        "Weapon_Sword_081",
+        "Weapon_Sword_502"
+    };
+
+    auto isDroppableLinear = [](const std::string& actorName) {
+        for (const auto& item : baselineNonDroppableItems) {
+            if (actorName == item) {
+                return false;
+            }
+        }
+        return !actorName.contains("Arrow");
+    };
+
+    // every baseline name has to stay non-droppable, the ones containing Arrow are also caught by the fallback
+    uint64_t mismatches = 0;
+    for (std::string_view item : baselineNonDroppableItems) {
+        if (isDroppable(item)) {
+            Log::print<ERROR>("{} is missing from s_nonDroppableItems", item);
+            ++mismatches;
+        }
+    }
+
+    std::vector<std::string> names = { "Weapon_Sword_001", "Weapon_Lsword_032", "Weapon_Shield_021", "Weapon_Bow_001", "Item_Fruit_A", "Obj_FireWoodBundle", "" };
+    for (std::string_view item : baselineNonDroppableItems) {
+        names.emplace_back(item);
+        names.emplace_back(std::string(item) + "_");
+        names.emplace_back(item.substr(0, item.size() - 1));
+        names.emplace_back(toLower(std::string(item)));
+    }
+
+    for (const std::string& name : names) {
+        bool expected = isDroppableLinear(name);
+        if (isDroppable(name) != expected) {
+            Log::print<ERROR>("isDroppable(\"{}\") should be {}", name, expected);
+            ++mismatches;
+        }
+    }
+
+    auto timeLookups = [&](auto&& lookup) {
+        uint32_t droppable = 0;
+        auto start = std::chrono::high_resolution_clock::now();
+        for (uint32_t iteration = 0; iteration < iterations; ++iteration) {
+            for (const std::string& name : names) {
+                droppable += lookup(name) ? 1 : 0;
+            }
+        }
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::high_resolution_clock::now() - start).count() / ((double)iterations * (double)names.size());
+        return std::make_pair(ns, droppable);
+    };
+    auto [linearNs, linearDroppable] = timeLookups([&](const std::string& name) { return isDroppableLinear(name); });
+    auto [sortedNs, sortedDroppable] = timeLookups([&](const std::string& name) { return isDroppable(name); });
+    mismatches += linearDroppable != sortedDroppable ? 1 : 0;
+
+    Log::print<INFO>("Droppable weapon benchmark ({} names x {} iterations): linear search = {:.1f} ns/name, binary search = {:.1f} ns/name, {} mismatches", names.size(), iterations, linearNs, sortedNs, mismatches);
+    return mismatches;
+}
+
+BETTERVR_TEST(DroppableWeapons, []() { return BenchmarkDroppableWeapons(1000); });